@@ -0,0 +1,129 @@
+// Shared helpers for the benchmark programs in this directory: corpus
+// loading, timing and result reporting. Every benchmark takes the corpus
+// directory as its first argument (default: test/individual_tests) and the
+// size in megabytes of the synthetic document built from it as the second.
+
+#ifndef COOKLANG_BENCH_H_
+#define COOKLANG_BENCH_H_
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+typedef struct {
+    char *data;
+    uint32_t length;
+} BenchFile;
+
+typedef struct {
+    BenchFile *files;
+    uint32_t count;
+    uint64_t bytes;
+} BenchCorpus;
+
+static inline double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static inline bool bench_read_file(const char *path, BenchFile *file) {
+    FILE *handle = fopen(path, "rb");
+    if (!handle) {
+        return false;
+    }
+    fseek(handle, 0, SEEK_END);
+    long size = ftell(handle);
+    rewind(handle);
+    file->data = malloc((size_t)size + 1);
+    file->length = (uint32_t)fread(file->data, 1, (size_t)size, handle);
+    file->data[file->length] = '\0';
+    fclose(handle);
+    return true;
+}
+
+static inline void bench_corpus_add_directory(BenchCorpus *corpus, const char *directory) {
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        struct stat info;
+        if (stat(path, &info) != 0) {
+            continue;
+        }
+        size_t length = strlen(path);
+        if (S_ISDIR(info.st_mode)) {
+            bench_corpus_add_directory(corpus, path);
+        } else if (length > 5 && strcmp(path + length - 5, ".cook") == 0) {
+            BenchFile file;
+            if (bench_read_file(path, &file)) {
+                corpus->files = realloc(corpus->files, (corpus->count + 1) * sizeof(BenchFile));
+                corpus->files[corpus->count++] = file;
+                corpus->bytes += file.length;
+            }
+        }
+    }
+    closedir(dir);
+}
+
+static inline BenchCorpus bench_corpus_load(int argc, char **argv) {
+    BenchCorpus corpus = {NULL, 0, 0};
+    bench_corpus_add_directory(&corpus, argc > 1 ? argv[1] : "test/individual_tests");
+    if (corpus.count == 0) {
+        fprintf(stderr, "no .cook files found in %s\n", argc > 1 ? argv[1] : "test/individual_tests");
+        exit(1);
+    }
+    return corpus;
+}
+
+static inline void bench_corpus_free(BenchCorpus *corpus) {
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        free(corpus->files[i].data);
+    }
+    free(corpus->files);
+}
+
+// Concatenates the corpus files, separated by blank lines, until the
+// document holds at least the number of megabytes given as the second
+// argument (default 16).
+static inline BenchFile bench_corpus_document(const BenchCorpus *corpus, int argc, char **argv) {
+    uint64_t target = (uint64_t)((argc > 2 ? atof(argv[2]) : 16.0) * 1024 * 1024);
+    if (target == 0) {
+        target = 1;
+    }
+    BenchFile document;
+    document.data = malloc(target + corpus->bytes + 2 * corpus->count + 1);
+    document.length = 0;
+    while (document.length < target) {
+        for (uint32_t i = 0; i < corpus->count && document.length < target; i++) {
+            memcpy(document.data + document.length, corpus->files[i].data, corpus->files[i].length);
+            document.length += corpus->files[i].length;
+            document.data[document.length++] = '\n';
+            document.data[document.length++] = '\n';
+        }
+    }
+    document.data[document.length] = '\0';
+    return document;
+}
+
+static inline void bench_report(const char *name, uint64_t bytes, double seconds, const char *extra) {
+    double mb = (double)bytes / (1024.0 * 1024.0);
+    printf("  %-28s %10.2f MB/s  %8.3f s%s%s\n", name, mb / seconds, seconds,
+           extra ? "  " : "", extra ? extra : "");
+}
+
+#endif // COOKLANG_BENCH_H_
@@ -0,0 +1,101 @@
+// Heap allocations per parse, and parse throughput with the per-batch arena
+// from bindings/c/cooklang_arena.h against the system allocator.
+
+#include "bench.h"
+
+#include "cooklang_arena.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+#define BATCH_SIZE 256
+
+static size_t allocation_count;
+
+static void *counting_malloc(size_t size) {
+    allocation_count++;
+    return malloc(size);
+}
+
+static void *counting_calloc(size_t count, size_t size) {
+    allocation_count++;
+    return calloc(count, size);
+}
+
+static void *counting_realloc(void *pointer, size_t size) {
+    allocation_count++;
+    return realloc(pointer, size);
+}
+
+static void count_allocations(const BenchCorpus *corpus) {
+    ts_set_allocator(counting_malloc, counting_calloc, counting_realloc, free);
+
+    allocation_count = 0;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    size_t setup = allocation_count;
+
+    allocation_count = 0;
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        TSTree *tree = ts_parser_parse_string(parser, NULL, corpus->files[i].data,
+                                              corpus->files[i].length);
+        ts_tree_delete(tree);
+    }
+    size_t parsing = allocation_count;
+    ts_parser_delete(parser);
+
+    printf("  parser setup:               %zu allocations\n", setup);
+    printf("  per parse (reused parser):  %.1f allocations, %.1f per KB\n",
+           (double)parsing / corpus->count, (double)parsing / (corpus->bytes / 1024.0));
+
+    ts_set_allocator(malloc, calloc, realloc, free);
+}
+
+static double parse_batches(const BenchCorpus *corpus, CooklangArena *arena, unsigned rounds) {
+    double start = bench_now();
+    for (unsigned round = 0; round < rounds; round++) {
+        for (uint32_t first = 0; first < corpus->count; first += BATCH_SIZE) {
+            if (arena) {
+                cooklang_arena_activate(arena);
+            }
+            TSParser *parser = ts_parser_new();
+            ts_parser_set_language(parser, tree_sitter_cooklang());
+            for (uint32_t i = first; i < corpus->count && i < first + BATCH_SIZE; i++) {
+                TSTree *tree = ts_parser_parse_string(parser, NULL, corpus->files[i].data,
+                                                      corpus->files[i].length);
+                ts_tree_delete(tree);
+            }
+            ts_parser_delete(parser);
+            if (arena) {
+                cooklang_arena_activate(NULL);
+                cooklang_arena_reset(arena);
+            }
+        }
+    }
+    return bench_now() - start;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    double megabytes = argc > 2 ? atof(argv[2]) : 16.0;
+    unsigned rounds = (unsigned)(megabytes * 1024 * 1024 / corpus.bytes) + 1;
+
+    printf("Allocations (%u files, %.1f KB)\n", corpus.count, corpus.bytes / 1024.0);
+    count_allocations(&corpus);
+
+    printf("\nBatch parsing, %u files per batch, %u rounds\n", BATCH_SIZE, rounds);
+    ts_set_allocator(cooklang_arena_malloc, cooklang_arena_calloc, cooklang_arena_realloc,
+                     cooklang_arena_free);
+    CooklangArena *arena = cooklang_arena_new(0);
+    double system_seconds = parse_batches(&corpus, NULL, rounds);
+    double arena_seconds = parse_batches(&corpus, arena, rounds);
+    bench_report("system allocator", corpus.bytes * rounds, system_seconds, NULL);
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%.2fx", system_seconds / arena_seconds);
+    bench_report("arena allocator", corpus.bytes * rounds, arena_seconds, extra);
+    cooklang_arena_delete(arena);
+    ts_set_allocator(malloc, calloc, realloc, free);
+
+    bench_corpus_free(&corpus);
+    return 0;
+}
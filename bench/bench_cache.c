@@ -0,0 +1,192 @@
+// The parse cache under a duplicate-heavy trace, as a recipe service sees
+// it: 50k requests for 2000 distinct recipes (corpus files with a varying
+// comment appended) drawn with Zipf-distributed popularity, served by
+// several threads sharing one cache, against parsing and extracting every
+// request. The third argument sets the number of threads (default: one per
+// CPU) and the fourth the cache capacity in megabytes (default 16).
+
+#include "bench.h"
+
+#include "cooklang_parse_cache.h"
+#include "tree-sitter-cooklang.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <tree_sitter/api.h>
+
+#define REQUEST_COUNT 50000
+#define RECIPE_COUNT 2000
+#define ZIPF_EXPONENT 1.0
+#define MAX_THREADS 64
+
+typedef struct {
+    const BenchFile *recipes;
+    const uint32_t *trace;
+    uint32_t first;
+    uint32_t last;
+    CooklangCache *cache;
+    uint64_t entities;
+} Worker;
+
+static void serve_uncached(Worker *worker, TSParser *parser) {
+    CooklangEntityList entities;
+    cooklang_entity_list_init(&entities);
+    for (uint32_t i = worker->first; i < worker->last; i++) {
+        const BenchFile *recipe = &worker->recipes[worker->trace[i]];
+        TSTree *tree = ts_parser_parse_string(parser, NULL, recipe->data, recipe->length);
+        entities.length = 0;
+        cooklang_extract(recipe->data, recipe->length, &entities);
+        worker->entities += entities.length;
+        ts_tree_delete(tree);
+    }
+    cooklang_entity_list_free(&entities);
+}
+
+// Each request takes its own copy of the tree, as a caller handing it to
+// code that walks it would.
+static void serve_cached(Worker *worker, TSParser *parser) {
+    for (uint32_t i = worker->first; i < worker->last; i++) {
+        const BenchFile *recipe = &worker->recipes[worker->trace[i]];
+        CooklangCacheEntry *entry =
+            cooklang_parse_cache_get(worker->cache, parser, recipe->data, recipe->length);
+        CooklangParsedRecipe *parsed = entry->value;
+        ts_tree_delete(ts_tree_copy(parsed->tree));
+        worker->entities += parsed->entities.length;
+        cooklang_cache_release(worker->cache, entry);
+    }
+}
+
+static void *run_worker(void *payload) {
+    Worker *worker = payload;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    if (worker->cache) {
+        serve_cached(worker, parser);
+    } else {
+        serve_uncached(worker, parser);
+    }
+    ts_parser_delete(parser);
+    return NULL;
+}
+
+static double run(const BenchFile *recipes, const uint32_t *trace, CooklangCache *cache,
+                  unsigned thread_count, uint64_t *entities) {
+    Worker workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    double start = bench_now();
+    for (unsigned t = 0; t < thread_count; t++) {
+        workers[t] = (Worker){recipes, trace,
+                              (uint32_t)((uint64_t)REQUEST_COUNT * t / thread_count),
+                              (uint32_t)((uint64_t)REQUEST_COUNT * (t + 1) / thread_count),
+                              cache, 0};
+        pthread_create(&threads[t], NULL, run_worker, &workers[t]);
+    }
+    *entities = 0;
+    for (unsigned t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+        *entities += workers[t].entities;
+    }
+    return bench_now() - start;
+}
+
+// Request i asks for recipe trace[i]; recipe r is requested with
+// probability proportional to 1 / (r + 1)^ZIPF_EXPONENT.
+static uint32_t *build_trace(void) {
+    double *cumulative = malloc(RECIPE_COUNT * sizeof(double));
+    double total = 0;
+    for (uint32_t r = 0; r < RECIPE_COUNT; r++) {
+        total += 1.0 / pow(r + 1, ZIPF_EXPONENT);
+        cumulative[r] = total;
+    }
+    uint32_t *trace = malloc(REQUEST_COUNT * sizeof(uint32_t));
+    uint64_t seed = 42;
+    for (uint32_t i = 0; i < REQUEST_COUNT; i++) {
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        double target = (double)(seed >> 11) / (double)(1ull << 53) * total;
+        uint32_t low = 0;
+        uint32_t high = RECIPE_COUNT - 1;
+        while (low < high) {
+            uint32_t middle = (low + high) / 2;
+            if (cumulative[middle] < target) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        trace[i] = low;
+    }
+    free(cumulative);
+    return trace;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned thread_count = argc > 3 ? (unsigned)atoi(argv[3]) : (unsigned)(cpus > 0 ? cpus : 1);
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    if (thread_count > MAX_THREADS) {
+        thread_count = MAX_THREADS;
+    }
+    uint64_t capacity = (uint64_t)((argc > 4 ? atof(argv[4]) : 16.0) * 1024 * 1024);
+
+    BenchFile *recipes = malloc(RECIPE_COUNT * sizeof(BenchFile));
+    for (uint32_t r = 0; r < RECIPE_COUNT; r++) {
+        const BenchFile *file = &corpus.files[r % corpus.count];
+        recipes[r].data = malloc(file->length + 32);
+        memcpy(recipes[r].data, file->data, file->length);
+        recipes[r].length = file->length +
+                            (uint32_t)sprintf(recipes[r].data + file->length, "\n-- copy %u\n", r);
+    }
+    uint32_t *trace = build_trace();
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < REQUEST_COUNT; i++) {
+        bytes += recipes[trace[i]].length;
+    }
+
+    printf("Parse cache, %u requests for %u recipes, %u threads, %.0f MB capacity\n",
+           REQUEST_COUNT, RECIPE_COUNT, thread_count, (double)capacity / (1024 * 1024));
+
+    uint64_t uncached_entities;
+    double uncached = run(recipes, trace, NULL, 1, &uncached_entities);
+    char extra[128];
+    snprintf(extra, sizeof(extra), "%.0f requests/s", REQUEST_COUNT / uncached);
+    bench_report("parse every request, 1", bytes, uncached, extra);
+
+    uint64_t parallel_entities;
+    double parallel = run(recipes, trace, NULL, thread_count, &parallel_entities);
+    char name[64];
+    snprintf(name, sizeof(name), "parse every request, %u", thread_count);
+    snprintf(extra, sizeof(extra), "%.0f requests/s", REQUEST_COUNT / parallel);
+    bench_report(name, bytes, parallel, extra);
+
+    CooklangCache *cache = cooklang_parse_cache_new(capacity);
+    uint64_t cached_entities;
+    double cached = run(recipes, trace, cache, thread_count, &cached_entities);
+    CooklangCacheStats stats;
+    cooklang_cache_stats(cache, &stats);
+    snprintf(name, sizeof(name), "shared cache, %u", thread_count);
+    snprintf(extra, sizeof(extra), "%.0f requests/s, %.2fx", REQUEST_COUNT / cached,
+             parallel / cached);
+    bench_report(name, bytes, cached, extra);
+    printf("  hit rate %.1f%%, %llu misses, %llu evictions, %llu entries in %.1f MB\n",
+           100.0 * (double)stats.hits / (double)(stats.hits + stats.misses),
+           (unsigned long long)stats.misses, (unsigned long long)stats.evictions,
+           (unsigned long long)stats.entries, (double)stats.bytes / (1024 * 1024));
+    if (cached_entities != uncached_entities || parallel_entities != uncached_entities) {
+        fprintf(stderr, "entity counts differ: %llu uncached, %llu cached\n",
+                (unsigned long long)uncached_entities, (unsigned long long)cached_entities);
+        return 1;
+    }
+
+    cooklang_cache_delete(cache);
+    free(trace);
+    for (uint32_t r = 0; r < RECIPE_COUNT; r++) {
+        free(recipes[r].data);
+    }
+    free(recipes);
+    bench_corpus_free(&corpus);
+    return 0;
+}
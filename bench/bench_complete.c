@@ -0,0 +1,219 @@
+// Completing ingredient names over a library of 1M distinct names (the
+// third argument changes the count): the names in the corpus, extended
+// with combinations of the words in it, each given a skewed count.
+// Reported: building the completion trie (cooklang_complete.h) and its
+// heap, top-10 lookup latency for prefixes of one to four bytes, the same
+// lookups by filtering and ranking every name, and updating the trie for
+// a reparsed recipe.
+
+#include "bench.h"
+
+#include "cooklang_complete.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#define DEFAULT_NAME_COUNT 1000000
+#define QUERY_COUNT 1000
+#define FILTERED_QUERIES 20
+#define MAX_RESULTS 10
+
+static uint64_t heap_in_use(void) {
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static CooklangEntityList *extract_corpus(const BenchCorpus *corpus) {
+    CooklangEntityList *lists = malloc(corpus->count * sizeof(CooklangEntityList));
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        cooklang_entity_list_init(&lists[i]);
+        cooklang_extract(corpus->files[i].data, corpus->files[i].length, &lists[i]);
+    }
+    return lists;
+}
+
+// The distinct words of three letters or more in the corpus.
+static void collect_words(const BenchCorpus *corpus, CooklangInternTable *words) {
+    for (uint32_t f = 0; f < corpus->count; f++) {
+        const char *text = corpus->files[f].data;
+        for (uint32_t start = 0; start < corpus->files[f].length;) {
+            uint32_t end = start;
+            while ((text[end] >= 'a' && text[end] <= 'z') || (text[end] >= 'A' && text[end] <= 'Z')) {
+                end++;
+            }
+            if (end - start >= 3) {
+                cooklang_intern(words, text + start, end - start);
+            }
+            start = end + 1;
+        }
+    }
+}
+
+// What filtering a list of every name does per keystroke: compare each
+// name with the prefix and keep the most frequent matches.
+static uint32_t filter(const CooklangInternTable *names, const uint32_t *counts,
+                       const char *prefix, uint32_t length, uint32_t *best) {
+    uint32_t found = 0;
+    for (uint32_t id = 0; id < names->length; id++) {
+        uint32_t name_length;
+        const char *name = cooklang_intern_name(names, id, &name_length);
+        if (counts[id] == 0 || name_length < length || memcmp(name, prefix, length) != 0) {
+            continue;
+        }
+        uint32_t i = found < MAX_RESULTS ? found++ : MAX_RESULTS;
+        while (i > 0 && (counts[best[i - 1]] < counts[id] ||
+                         (counts[best[i - 1]] == counts[id] &&
+                          strcmp(cooklang_intern_name(names, best[i - 1], NULL), name) > 0))) {
+            if (i < MAX_RESULTS) {
+                best[i] = best[i - 1];
+            }
+            i--;
+        }
+        if (i < MAX_RESULTS) {
+            best[i] = id;
+        }
+    }
+    return found;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    uint32_t target = argc > 3 ? (uint32_t)atol(argv[3]) : DEFAULT_NAME_COUNT;
+    if (target == 0) {
+        target = 1;
+    }
+    CooklangEntityList *lists = extract_corpus(&corpus);
+    CooklangInternTable words;
+    cooklang_intern_table_init(&words, true);
+    collect_words(&corpus, &words);
+    if (words.length == 0) {
+        cooklang_intern(&words, "salt", 4);
+    }
+
+    // Names of up to three words; a number is appended once the
+    // combinations run short.
+    srand(1);
+    uint64_t heap = heap_in_use();
+    CooklangCompletions completions;
+    cooklang_completions_init(&completions);
+    double start = bench_now();
+    for (uint32_t f = 0; f < corpus.count; f++) {
+        cooklang_completions_add_entities(&completions, corpus.files[f].data, &lists[f], 1);
+    }
+    for (uint64_t attempt = 0; completions.names.length < target; attempt++) {
+        char name[256];
+        int length = 0;
+        int word_count = 1 + rand() % 3;
+        for (int w = 0; w < word_count; w++) {
+            const char *word = cooklang_intern_name(&words, (uint32_t)rand() % words.length, NULL);
+            length += snprintf(name + length, sizeof(name) - (size_t)length, "%s%.60s",
+                               w ? " " : "", word);
+        }
+        if (attempt > (uint64_t)target * 2) {
+            length += snprintf(name + length, sizeof(name) - (size_t)length, " %u", (unsigned)rand());
+        }
+        // A few names are common and most are rare.
+        int32_t count = 1 + 1000 / (1 + rand() % 1000);
+        if (!cooklang_completions_add(&completions, COOKLANG_ENTITY_INGREDIENT, name,
+                                      (uint32_t)length, count)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    }
+    double build_seconds = bench_now() - start;
+    uint64_t trie_heap = heap_in_use() - heap;
+
+    const CooklangInternTable *names = &completions.names;
+    const CooklangCompletionTrie *trie = &completions.tries[COOKLANG_ENTITY_INGREDIENT];
+    uint64_t bytes = names->strings_length;
+    printf("Name completion over %u distinct names (%u words from %u files, %.1f MB of names)\n",
+           names->length, words.length, corpus.count, (double)bytes / (1024 * 1024));
+    char extra[160];
+    snprintf(extra, sizeof(extra), "%.0f names/s, %u nodes, heap %.1f MB (%.0f bytes/name)",
+             names->length / build_seconds, trie->length, (double)trie_heap / (1024 * 1024),
+             (double)trie_heap / names->length);
+    bench_report("build", bytes, build_seconds, extra);
+
+    // Prefixes of names picked at random, as typed after `@`.
+    static char prefixes[QUERY_COUNT][8];
+    static uint32_t prefix_lengths[QUERY_COUNT];
+    for (uint32_t q = 0; q < QUERY_COUNT; q++) {
+        uint32_t length;
+        const char *name = cooklang_intern_name(names, (uint32_t)rand() % names->length, &length);
+        prefix_lengths[q] = 1 + (uint32_t)rand() % 4;
+        if (prefix_lengths[q] > length) {
+            prefix_lengths[q] = length;
+        }
+        memcpy(prefixes[q], name, prefix_lengths[q]);
+    }
+
+    double *latencies = malloc(QUERY_COUNT * sizeof(double));
+    CooklangCompletion results[MAX_RESULTS];
+    double total = 0;
+    uint64_t result_count = 0;
+    for (uint32_t q = 0; q < QUERY_COUNT; q++) {
+        double query_start = bench_now();
+        int32_t found = cooklang_complete(&completions, COOKLANG_ENTITY_INGREDIENT, prefixes[q],
+                                          prefix_lengths[q], results, MAX_RESULTS);
+        latencies[q] = bench_now() - query_start;
+        total += latencies[q];
+        result_count += found > 0 ? (uint64_t)found : 0;
+    }
+    qsort(latencies, QUERY_COUNT, sizeof(double), compare_doubles);
+    snprintf(extra, sizeof(extra), "p50 %.1f us, p99 %.1f us, %.1f results/query",
+             latencies[QUERY_COUNT / 2] * 1e6, latencies[QUERY_COUNT * 99 / 100] * 1e6,
+             (double)result_count / QUERY_COUNT);
+    bench_report("complete, trie", bytes * QUERY_COUNT, total, extra);
+
+    // The filter compares against the trie's answers, so both must agree.
+    double filter_total = 0;
+    bool same = true;
+    for (uint32_t q = 0; q < FILTERED_QUERIES; q++) {
+        uint32_t best[MAX_RESULTS];
+        double query_start = bench_now();
+        uint32_t found = filter(names, trie->counts, prefixes[q], prefix_lengths[q], best);
+        filter_total += bench_now() - query_start;
+        int32_t expected = cooklang_complete(&completions, COOKLANG_ENTITY_INGREDIENT, prefixes[q],
+                                             prefix_lengths[q], results, MAX_RESULTS);
+        same = same && (int32_t)(found < MAX_RESULTS ? found : MAX_RESULTS) == expected;
+        for (int32_t i = 0; same && i < expected; i++) {
+            same = strcmp(results[i].name, cooklang_intern_name(names, best[i], NULL)) == 0;
+        }
+    }
+    snprintf(extra, sizeof(extra), "%.1f us/query (%.0fx slower)%s",
+             filter_total / FILTERED_QUERIES * 1e6,
+             (filter_total / FILTERED_QUERIES) / (total / QUERY_COUNT), same ? "" : " MISMATCH");
+    bench_report("complete, filter every name", bytes * FILTERED_QUERIES, filter_total, extra);
+
+    // Reindexing a saved recipe: its old names out, its new names in.
+    uint64_t recipe_bytes = 0;
+    start = bench_now();
+    for (uint32_t f = 0; f < corpus.count; f++) {
+        cooklang_completions_add_entities(&completions, corpus.files[f].data, &lists[f], -1);
+        cooklang_completions_add_entities(&completions, corpus.files[f].data, &lists[f], 1);
+        recipe_bytes += corpus.files[f].length;
+    }
+    double update_seconds = bench_now() - start;
+    snprintf(extra, sizeof(extra), "%.2f us/recipe", update_seconds / corpus.count * 1e6);
+    bench_report("update a reparsed recipe", recipe_bytes, update_seconds, extra);
+
+    free(latencies);
+    cooklang_completions_free(&completions);
+    cooklang_intern_table_free(&words);
+    for (uint32_t f = 0; f < corpus.count; f++) {
+        cooklang_entity_list_free(&lists[f]);
+    }
+    free(lists);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Structural diff (cooklang_diff.h) between two versions of documents of
+// 1 KB, 10 KB, ... up to the number of megabytes given as the second
+// argument (default 10), built from the corpus. The second version changes
+// one quantity in the middle of the document and adds a step a third of
+// the way in. Both versions are parsed once, outside the timing; each
+// size reports the time of one diff and the size of its script.
+
+#include "bench.h"
+
+#include "cooklang_diff.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+#define MIN_SECONDS 0.2
+
+static const char INSERTED_STEP[] = "Taste and add @salt{} as needed.\n\n";
+
+// The corpus files, separated by blank lines, up to `size` bytes.
+static char *make_document(const BenchCorpus *corpus, uint64_t size, uint32_t *length) {
+    char *text = malloc(size + 1);
+    uint64_t used = 0;
+    for (uint32_t i = 0; used < size; i = (i + 1) % corpus->count) {
+        const BenchFile *file = &corpus->files[i];
+        uint64_t take = file->length + 2 <= size - used ? file->length : size - used;
+        memcpy(text + used, file->data, take);
+        used += take;
+        if (take == file->length && used + 2 <= size) {
+            memcpy(text + used, "\n\n", 2);
+            used += 2;
+        } else {
+            break;
+        }
+    }
+    text[used] = '\0';
+    *length = (uint32_t)used;
+    return text;
+}
+
+// `text` with the first digit after the middle changed, and a step
+// inserted before the first blank line after a third of it.
+static char *edit_document(const char *text, uint32_t length, uint32_t *edited_length) {
+    char *edited = malloc(length + sizeof(INSERTED_STEP));
+    const char *blank = strstr(text + length / 3, "\n\n");
+    uint32_t at = blank ? (uint32_t)(blank - text) + 2 : length;
+    memcpy(edited, text, at);
+    memcpy(edited + at, INSERTED_STEP, sizeof(INSERTED_STEP) - 1);
+    memcpy(edited + at + sizeof(INSERTED_STEP) - 1, text + at, length - at + 1);
+    *edited_length = length + (uint32_t)sizeof(INSERTED_STEP) - 1;
+    char *digit = strpbrk(edited + *edited_length / 2, "0123456789");
+    if (digit) {
+        *digit = *digit == '9' ? '1' : (char)(*digit + 1);
+    }
+    return edited;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    uint64_t max_size = (uint64_t)((argc > 2 ? atof(argv[2]) : 10.0) * 1024 * 1024);
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangDiffScript script;
+    cooklang_diff_script_init(&script);
+
+    printf("Structural diff of one changed quantity and one added step\n");
+    for (uint64_t size = 1024; size <= max_size; size *= 10) {
+        uint32_t old_length, new_length;
+        char *old_text = make_document(&corpus, size, &old_length);
+        char *new_text = edit_document(old_text, old_length, &new_length);
+        double start = bench_now();
+        TSTree *old_tree = ts_parser_parse_string(parser, NULL, old_text, old_length);
+        TSTree *new_tree = ts_parser_parse_string(parser, NULL, new_text, new_length);
+        double parse_seconds = bench_now() - start;
+
+        uint32_t runs = 0;
+        start = bench_now();
+        double seconds;
+        do {
+            script.length = 0;
+            if (!cooklang_diff(old_text, ts_tree_root_node(old_tree), new_text,
+                               ts_tree_root_node(new_tree), &script)) {
+                fprintf(stderr, "diff failed\n");
+                return 1;
+            }
+            runs++;
+            seconds = bench_now() - start;
+        } while (seconds < MIN_SECONDS);
+
+        char name[64], extra[128];
+        snprintf(name, sizeof(name), "diff, %.0f KB", (double)old_length / 1024);
+        snprintf(extra, sizeof(extra), "%9.1f us, %u edits, parsing both %.1f ms",
+                 seconds / runs * 1e6, script.length, parse_seconds * 1e3);
+        bench_report(name, old_length, seconds / runs, extra);
+
+        ts_tree_delete(old_tree);
+        ts_tree_delete(new_tree);
+        free(old_text);
+        free(new_text);
+    }
+
+    cooklang_diff_script_free(&script);
+    ts_parser_delete(parser);
+    bench_corpus_free(&corpus);
+    return 0;
+}
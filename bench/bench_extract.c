@@ -0,0 +1,72 @@
+// Throughput of the flat extractor, per scanning backend, against a full
+// tree-sitter parse of the same document.
+
+#include "bench.h"
+
+#include "cooklang_extract.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+static double time_extract(const BenchFile *document, uint32_t *entities) {
+    CooklangEntityList list;
+    cooklang_entity_list_init(&list);
+    unsigned rounds = 0;
+    double start = bench_now();
+    double elapsed;
+    do {
+        list.length = 0;
+        cooklang_extract(document->data, document->length, &list);
+        rounds++;
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.5);
+    *entities = list.length;
+    cooklang_entity_list_free(&list);
+    return elapsed / rounds;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+
+    printf("Extraction throughput (%u files, %.1f MB document)\n", corpus.count,
+           document.length / (1024.0 * 1024.0));
+
+    static const CooklangBackend backends[] = {
+        COOKLANG_BACKEND_SCALAR,
+        COOKLANG_BACKEND_SSE2,
+        COOKLANG_BACKEND_AVX2,
+    };
+    double fastest = 0;
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        if (!cooklang_extract_set_backend(backends[i])) {
+            continue;
+        }
+        uint32_t entities;
+        double seconds = time_extract(&document, &entities);
+        char name[64], extra[64];
+        snprintf(name, sizeof(name), "extract (%s)", cooklang_backend_name(backends[i]));
+        snprintf(extra, sizeof(extra), "%u entities, %.2f GB/s", entities,
+                 document.length / seconds / 1e9);
+        bench_report(name, document.length, seconds, extra);
+        if (fastest == 0 || seconds < fastest) {
+            fastest = seconds;
+        }
+    }
+    cooklang_extract_set_backend(COOKLANG_BACKEND_AUTO);
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    double start = bench_now();
+    TSTree *tree = ts_parser_parse_string(parser, NULL, document.data, document.length);
+    double seconds = bench_now() - start;
+    char extra[64];
+    snprintf(extra, sizeof(extra), "extract is %.1fx faster", seconds / fastest);
+    bench_report("tree-sitter parse", document.length, seconds, extra);
+
+    ts_tree_delete(tree);
+    ts_parser_delete(parser);
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,144 @@
+// Parsing one very large cookbook file: read into memory whole and parsed
+// as a string, against the chunked `pread` and memory-mapped inputs of
+// cooklang_file_input.h. The file is the corpus repeated up to the size
+// given as the second argument (default 500 MB) and written to the
+// directory given as the third (default /tmp). Each way of parsing runs in
+// its own process, which reports its throughput and peak resident set.
+
+#include "bench.h"
+
+#include "cooklang_file_input.h"
+#include "tree-sitter-cooklang.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+typedef enum {
+    WHOLE_FILE,
+    CHUNKED_READ,
+    MEMORY_MAP,
+} Method;
+
+static const char *const METHOD_NAMES[] = {"read whole + parse", "chunked pread", "mmap"};
+
+typedef struct {
+    double seconds;
+    uint32_t end_byte;
+    long peak_kilobytes;
+} Result;
+
+static TSTree *parse_whole_file(TSParser *parser, const char *path) {
+    BenchFile file;
+    if (!bench_read_file(path, &file)) {
+        return NULL;
+    }
+    TSTree *tree = ts_parser_parse_string(parser, NULL, file.data, file.length);
+    free(file.data);
+    return tree;
+}
+
+static Result run_child(Method method, const char *path) {
+    Result result = {0, 0, 0};
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    double start = bench_now();
+    TSTree *tree = method == WHOLE_FILE ? parse_whole_file(parser, path)
+                   : cooklang_parse_file(parser, path,
+                                         method == MEMORY_MAP ? COOKLANG_FILE_INPUT_MMAP
+                                                              : COOKLANG_FILE_INPUT_READ,
+                                         0);
+    result.seconds = bench_now() - start;
+    if (tree) {
+        result.end_byte = ts_node_end_byte(ts_tree_root_node(tree));
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.peak_kilobytes = usage.ru_maxrss;
+    // The tree is still alive at the peak; freeing it is not part of the run.
+    return result;
+}
+
+static bool measure(Method method, const char *path, Result *result) {
+    int pipes[2];
+    if (pipe(pipes) != 0) {
+        return false;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        close(pipes[0]);
+        Result measured = run_child(method, path);
+        bool written = write(pipes[1], &measured, sizeof(measured)) == (ssize_t)sizeof(measured);
+        _exit(written ? 0 : 1);
+    }
+    close(pipes[1]);
+    bool ok = child > 0 && read(pipes[0], result, sizeof(*result)) == (ssize_t)sizeof(*result);
+    close(pipes[0]);
+    if (child > 0) {
+        waitpid(child, NULL, 0);
+    }
+    return ok;
+}
+
+// Writes the corpus, separated by blank lines, until the file holds
+// `target` bytes; returns its size.
+static uint64_t write_cookbook(const BenchCorpus *corpus, const char *path, uint64_t target) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return 0;
+    }
+    uint64_t length = 0;
+    while (length < target) {
+        for (uint32_t i = 0; i < corpus->count && length < target; i++) {
+            fwrite(corpus->files[i].data, 1, corpus->files[i].length, file);
+            fputs("\n\n", file);
+            length += corpus->files[i].length + 2;
+        }
+    }
+    return fclose(file) == 0 ? length : 0;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    uint64_t target = (uint64_t)((argc > 2 ? atof(argv[2]) : 500.0) * 1024 * 1024);
+    if (target > UINT32_MAX - 1024 * 1024) {
+        target = UINT32_MAX - 1024 * 1024;
+    }
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/cooklang-cookbook-%ld.cook", argc > 3 ? argv[3] : "/tmp",
+             (long)getpid());
+    uint64_t length = write_cookbook(&corpus, path, target);
+    if (length == 0) {
+        fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("Large file parsing (%.1f MB cookbook, %.1f MB resident before parsing)\n",
+           (double)length / (1024 * 1024), (double)usage.ru_maxrss / 1024);
+
+    double baseline = 0;
+    int status = 0;
+    for (Method method = WHOLE_FILE; method <= MEMORY_MAP; method++) {
+        Result result;
+        if (!measure(method, path, &result) || result.end_byte != length) {
+            printf("  %-28s failed\n", METHOD_NAMES[method]);
+            status = 1;
+            continue;
+        }
+        if (method == WHOLE_FILE) {
+            baseline = (double)result.peak_kilobytes;
+        }
+        char extra[96];
+        snprintf(extra, sizeof(extra), "peak RSS %.1f MB (%.2fx)",
+                 (double)result.peak_kilobytes / 1024,
+                 baseline ? (double)result.peak_kilobytes / baseline : 1.0);
+        bench_report(METHOD_NAMES[method], length, result.seconds, extra);
+    }
+
+    unlink(path);
+    bench_corpus_free(&corpus);
+    return status;
+}
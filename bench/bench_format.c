@@ -0,0 +1,123 @@
+// Format-on-save latency for single-line edits in a large document: insert
+// a space somewhere in a step, apply the edit to the tree, reparse
+// incrementally and format the changed lines. Reported as average, median
+// and 99th percentile per edit, against formatting the whole document.
+
+#include "bench.h"
+
+#include "cooklang_format.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+#define EDITS 200
+
+static int compare_doubles(const void *a, const void *b) {
+    double left = *(const double *)a;
+    double right = *(const double *)b;
+    return left < right ? -1 : left > right;
+}
+
+static void report_latency(const char *name, double *samples, uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    qsort(samples, count, sizeof(double), compare_doubles);
+    double total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        total += samples[i];
+    }
+    printf("  %-28s avg %8.1f us  p50 %8.1f us  p99 %8.1f us\n", name, total / count * 1e6,
+           samples[count / 2] * 1e6, samples[count * 99 / 100] * 1e6);
+}
+
+// Advance `point` from byte `from` to byte `to`.
+static void advance_point(const char *data, uint32_t from, uint32_t to, TSPoint *point) {
+    for (uint32_t i = from; i < to; i++) {
+        if (data[i] == '\n') {
+            point->row++;
+            point->column = 0;
+        } else {
+            point->column++;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+    char *buffer = malloc(document.length + 2);
+    memcpy(buffer, document.data, document.length + 1);
+    uint32_t length = document.length;
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    TSTree *base = ts_parser_parse_string(parser, NULL, buffer, length);
+    printf("Format on save (%.1f MB document, %d single-line edits)\n",
+           length / (1024.0 * 1024.0), EDITS);
+
+    CooklangEditList edits;
+    cooklang_edit_list_init(&edits);
+    double start = bench_now();
+    cooklang_format_recipe(buffer, length, ts_tree_root_node(base), &edits);
+    double whole = bench_now() - start;
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%u edits", edits.length);
+    bench_report("format whole document", length, whole, extra);
+
+    double *reparse_samples = malloc(EDITS * sizeof(double));
+    double *format_samples = malloc(EDITS * sizeof(double));
+    uint32_t count = 0;
+    uint32_t scanned = 0;
+    TSPoint point = {0, 0};
+    for (uint32_t i = 0; i < EDITS; i++) {
+        // Double a space somewhere in the i-th slice of the document.
+        uint32_t at = (uint32_t)((uint64_t)length * i / EDITS);
+        while (at < length && buffer[at] != ' ') {
+            at++;
+        }
+        if (at == length) {
+            break;
+        }
+        TSInputEdit edit;
+        edit.start_byte = at;
+        edit.old_end_byte = at;
+        edit.new_end_byte = at + 1;
+        advance_point(buffer, scanned, at, &point);
+        scanned = at;
+        edit.start_point = edit.old_end_point = point;
+        edit.new_end_point = edit.start_point;
+        edit.new_end_point.column++;
+        memmove(buffer + at + 1, buffer + at, length - at + 1);
+        length++;
+
+        TSTree *old_tree = ts_tree_copy(base);
+        ts_tree_edit(old_tree, &edit);
+        cooklang_edit_list_clear(&edits);
+        start = bench_now();
+        TSTree *new_tree = ts_parser_parse_string(parser, old_tree, buffer, length);
+        double parsed = bench_now();
+        cooklang_format_changes(buffer, length, old_tree, new_tree, &edit, 1, &edits);
+        double formatted = bench_now();
+        reparse_samples[count] = formatted - start;
+        format_samples[count] = formatted - parsed;
+        count++;
+        ts_tree_delete(new_tree);
+        ts_tree_delete(old_tree);
+
+        memmove(buffer + at, buffer + at + 1, length - at);
+        length--;
+    }
+    report_latency("reparse + format changes", reparse_samples, count);
+    report_latency("format changes only", format_samples, count);
+
+    free(format_samples);
+    free(reparse_samples);
+    cooklang_edit_list_free(&edits);
+    ts_tree_delete(base);
+    ts_parser_delete(parser);
+    free(buffer);
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Concurrent GLR stack versions per parse, read from the parser's debug log.
+// A grammar without unresolved conflicts never needs more than one version
+// on valid input; anything above that is time spent forking and merging.
+
+#include "bench.h"
+
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+typedef struct {
+    uint64_t steps;
+    uint64_t forked_steps;
+    unsigned max_versions;
+} VersionCounts;
+
+static void count_versions(void *payload, TSLogType type, const char *message) {
+    VersionCounts *counts = payload;
+    if (type != TSLogTypeParse) {
+        return;
+    }
+    const char *field = strstr(message, "version_count:");
+    unsigned versions;
+    if (!field || sscanf(field, "version_count:%u", &versions) != 1) {
+        return;
+    }
+    counts->steps++;
+    if (versions > 1) {
+        counts->forked_steps++;
+    }
+    if (versions > counts->max_versions) {
+        counts->max_versions = versions;
+    }
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+
+    const TSLanguage *language = tree_sitter_cooklang();
+    printf("Parse table: %u states, %u symbols\n", ts_language_state_count(language),
+           ts_language_symbol_count(language));
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, language);
+    VersionCounts total = {0, 0, 0};
+    uint32_t forked_files = 0;
+    for (uint32_t i = 0; i < corpus.count; i++) {
+        VersionCounts counts = {0, 0, 0};
+        ts_parser_set_logger(parser, (TSLogger){&counts, count_versions});
+        TSTree *tree = ts_parser_parse_string(parser, NULL, corpus.files[i].data,
+                                              corpus.files[i].length);
+        ts_tree_delete(tree);
+        total.steps += counts.steps;
+        total.forked_steps += counts.forked_steps;
+        if (counts.max_versions > total.max_versions) {
+            total.max_versions = counts.max_versions;
+        }
+        if (counts.max_versions > 1) {
+            forked_files++;
+        }
+    }
+    ts_parser_set_logger(parser, (TSLogger){NULL, NULL});
+
+    printf("Stack versions (%u files, %.1f KB)\n", corpus.count, corpus.bytes / 1024.0);
+    printf("  max concurrent versions:  %10u\n", total.max_versions);
+    printf("  files that forked:        %10u\n", forked_files);
+    printf("  steps with >1 version:    %10llu of %llu\n", (unsigned long long)total.forked_steps,
+           (unsigned long long)total.steps);
+
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+    double start = bench_now();
+    TSTree *tree = ts_parser_parse_string(parser, NULL, document.data, document.length);
+    bench_report("tree-sitter parse", document.length, bench_now() - start, NULL);
+
+    ts_tree_delete(tree);
+    ts_parser_delete(parser);
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Highlighting one large document with queries/highlights.scm on 1, 2, 4,
+// ... threads, up to the third argument (default one per CPU), through
+// cooklang_highlight.h. The document is parsed once; each run reports its
+// throughput, its speedup over one thread, and whether it produced the
+// same captures.
+
+#include "bench.h"
+
+#include "cooklang_highlight.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+#define HIGHLIGHTS_QUERY "queries/highlights.scm"
+
+// 1, 2, 4, ... and then `max_threads` itself.
+static unsigned next_thread_count(unsigned threads, unsigned max_threads) {
+    return threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned max_threads = argc > 3 ? (unsigned)atoi(argv[3]) : (unsigned)(cpus > 0 ? cpus : 1);
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    BenchFile source;
+    if (!bench_read_file(HIGHLIGHTS_QUERY, &source)) {
+        fprintf(stderr, "cannot read %s\n", HIGHLIGHTS_QUERY);
+        return 1;
+    }
+    uint32_t error_offset;
+    TSQueryError error;
+    TSQuery *query =
+        ts_query_new(tree_sitter_cooklang(), source.data, source.length, &error_offset, &error);
+    if (!query) {
+        fprintf(stderr, "%s: error %d at byte %u\n", HIGHLIGHTS_QUERY, (int)error, error_offset);
+        return 1;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    double start = bench_now();
+    TSTree *tree = ts_parser_parse_string(parser, NULL, document.data, document.length);
+    double parse_seconds = bench_now() - start;
+    printf("Highlighting a %.1f MB document on up to %u threads\n",
+           (double)document.length / (1024 * 1024), max_threads);
+    bench_report("parse", document.length, parse_seconds, NULL);
+
+    double single_seconds = 0;
+    uint32_t single_length = 0;
+    for (unsigned threads = 1; threads <= max_threads;
+         threads = next_thread_count(threads, max_threads)) {
+        CooklangHighlightList highlights;
+        cooklang_highlight_list_init(&highlights);
+        start = bench_now();
+        bool ok = cooklang_highlight(query, tree, threads, &highlights);
+        double seconds = bench_now() - start;
+        if (!ok) {
+            fprintf(stderr, "highlighting on %u threads failed\n", threads);
+            return 1;
+        }
+        if (threads == 1) {
+            single_seconds = seconds;
+            single_length = highlights.length;
+        }
+        char name[64], extra[128];
+        snprintf(name, sizeof(name), "highlight, %u thread%s", threads, threads == 1 ? "" : "s");
+        snprintf(extra, sizeof(extra), "%u captures, %.2fx%s", highlights.length,
+                 single_seconds / seconds, highlights.length == single_length ? "" : " MISMATCH");
+        bench_report(name, document.length, seconds, extra);
+        cooklang_highlight_list_free(&highlights);
+    }
+
+    ts_tree_delete(tree);
+    ts_parser_delete(parser);
+    ts_query_delete(query);
+    free(source.data);
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,202 @@
+// Static HTML rendering of a recipe collection. Measured: parsing and
+// rendering the corpus in process, through cooklang_html.h; and cook2html
+// over a directory tree of the number of recipes given as the third
+// argument (default 20000, in a hundred directories under /tmp), on 1, 2,
+// 4, ... threads up to the fourth argument (default one per CPU). Each run
+// reports pages per second, its speedup over one thread, and whether it
+// wrote the same bytes. The whole run, file reads and writes included, is
+// timed from here.
+//
+// cook2html is expected next to the benchmark binary (`make tools`).
+
+#include "bench.h"
+
+#include "cooklang_html.h"
+#include "tree-sitter-cooklang.h"
+
+#include <sys/wait.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+#define DIRECTORY_COUNT 100
+
+typedef struct {
+    char root[64];
+    char recipes[80];
+    char output[80];
+    uint32_t count;
+    uint64_t bytes;
+} Collection;
+
+// 1, 2, 4, ... and then `max_threads` itself.
+static unsigned next_thread_count(unsigned threads, unsigned max_threads) {
+    return threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2;
+}
+
+static void recipe_path(const char *directory, uint32_t index, const char *extension, char *path,
+                        size_t size) {
+    snprintf(path, size, "%s/%02u/recipe-%u.%s", directory, index % DIRECTORY_COUNT, index,
+             extension);
+}
+
+static bool write_collection(Collection *collection, const BenchCorpus *corpus) {
+    char path[4096];
+    bool ok = mkdir(collection->recipes, 0755) == 0;
+    for (uint32_t i = 0; i < DIRECTORY_COUNT && ok; i++) {
+        snprintf(path, sizeof(path), "%s/%02u", collection->recipes, i);
+        ok = mkdir(path, 0755) == 0;
+    }
+    for (uint32_t i = 0; i < collection->count && ok; i++) {
+        const BenchFile *file = &corpus->files[i % corpus->count];
+        recipe_path(collection->recipes, i, "cook", path, sizeof(path));
+        FILE *stream = fopen(path, "wb");
+        ok = stream && fwrite(file->data, 1, file->length, stream) == file->length;
+        ok = stream && fclose(stream) == 0 && ok;
+        collection->bytes += file->length;
+    }
+    return ok;
+}
+
+// The pages under the output directory, removed as they are counted.
+static uint64_t remove_output(const Collection *collection) {
+    char path[4096];
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < collection->count; i++) {
+        recipe_path(collection->output, i, "html", path, sizeof(path));
+        struct stat info;
+        if (stat(path, &info) == 0) {
+            bytes += (uint64_t)info.st_size;
+            unlink(path);
+        }
+    }
+    for (uint32_t i = 0; i < DIRECTORY_COUNT; i++) {
+        snprintf(path, sizeof(path), "%s/%02u", collection->output, i);
+        rmdir(path);
+    }
+    rmdir(collection->output);
+    return bytes;
+}
+
+static void remove_collection(const Collection *collection) {
+    char path[4096];
+    remove_output(collection);
+    for (uint32_t i = 0; i < collection->count; i++) {
+        recipe_path(collection->recipes, i, "cook", path, sizeof(path));
+        unlink(path);
+    }
+    for (uint32_t i = 0; i < DIRECTORY_COUNT; i++) {
+        snprintf(path, sizeof(path), "%s/%02u", collection->recipes, i);
+        rmdir(path);
+    }
+    rmdir(collection->recipes);
+    rmdir(collection->root);
+}
+
+static void bench_in_process(const BenchCorpus *corpus) {
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText page;
+    cooklang_text_init(&page);
+    uint64_t bytes = 0, html_bytes = 0;
+    double start = bench_now();
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        const BenchFile *file = &corpus->files[i];
+        TSTree *tree = ts_parser_parse_string(parser, NULL, file->data, file->length);
+        page.length = 0;
+        cooklang_html_write_page(file->data, ts_tree_root_node(tree), "Recipe", &page);
+        ts_tree_delete(tree);
+        bytes += file->length;
+        html_bytes += page.length;
+    }
+    double seconds = bench_now() - start;
+    char extra[128];
+    snprintf(extra, sizeof(extra), "%.0f pages/s, %.1fx the source in HTML",
+             corpus->count / seconds, bytes ? (double)html_bytes / (double)bytes : 0.0);
+    bench_report("parse + render, in process", bytes, seconds, extra);
+    cooklang_text_free(&page);
+    ts_parser_delete(parser);
+}
+
+// Run cook2html on `threads` threads; returns its wall time, or a negative
+// number if it failed.
+static double run_renderer(const char *renderer, const Collection *collection, unsigned threads) {
+    char thread_argument[16];
+    snprintf(thread_argument, sizeof(thread_argument), "%u", threads);
+    double start = bench_now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Keep the renderer's own report out of the table.
+        freopen("/dev/null", "w", stderr);
+        execl(renderer, renderer, "-j", thread_argument, collection->recipes, collection->output,
+              (char *)NULL);
+        _exit(127);
+    }
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+        return -1;
+    }
+    return bench_now() - start;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    Collection collection = {.count = argc > 3 ? (uint32_t)atol(argv[3]) : 20000};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned max_threads = argc > 4 ? (unsigned)atoi(argv[4]) : (unsigned)(cpus > 0 ? cpus : 1);
+    if (collection.count == 0) {
+        collection.count = 1;
+    }
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    // The renderer binary lives next to this one.
+    const char *slash = strrchr(argv[0], '/');
+    int directory_length = slash ? (int)(slash - argv[0]) : 1;
+    char renderer[4096];
+    snprintf(renderer, sizeof(renderer), "%.*s/cook2html", directory_length,
+             slash ? argv[0] : ".");
+
+    snprintf(collection.root, sizeof(collection.root), "/tmp/cooklang-html-XXXXXX");
+    if (!mkdtemp(collection.root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(collection.recipes, sizeof(collection.recipes), "%s/recipes", collection.root);
+    snprintf(collection.output, sizeof(collection.output), "%s/html", collection.root);
+    if (!write_collection(&collection, &corpus)) {
+        fprintf(stderr, "could not write the collection to %s\n", collection.root);
+        remove_collection(&collection);
+        return 1;
+    }
+
+    printf("HTML rendering (%u recipes, %.1f MB, up to %u threads)\n", collection.count,
+           (double)collection.bytes / (1024 * 1024), max_threads);
+    bench_in_process(&corpus);
+
+    double single_seconds = 0;
+    uint64_t single_bytes = 0;
+    for (unsigned threads = 1; threads <= max_threads;
+         threads = next_thread_count(threads, max_threads)) {
+        double seconds = run_renderer(renderer, &collection, threads);
+        uint64_t html_bytes = remove_output(&collection);
+        if (seconds < 0) {
+            fprintf(stderr, "%s failed on %u threads\n", renderer, threads);
+            break;
+        }
+        if (threads == 1) {
+            single_seconds = seconds;
+            single_bytes = html_bytes;
+        }
+        char name[64], extra[128];
+        snprintf(name, sizeof(name), "cook2html, %u thread%s", threads, threads == 1 ? "" : "s");
+        snprintf(extra, sizeof(extra), "%.0f pages/s, %.2fx%s", collection.count / seconds,
+                 single_seconds / seconds, html_bytes == single_bytes ? "" : " MISMATCH");
+        bench_report(name, collection.bytes, seconds, extra);
+    }
+
+    remove_collection(&collection);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,253 @@
+// The recipe index behind cookd. Three measurements:
+//
+//   - steady-state memory per recipe: the growth of the resident set while
+//     the corpus is indexed under many paths, divided by the recipe count;
+//   - the cost of re-indexing a saved recipe after a one-character edit,
+//     against indexing the same text from scratch;
+//   - save-to-index latency of the daemon itself: a client waits on the
+//     socket while a recipe is rewritten on disk, timed until the daemon
+//     reports the update. This includes the inotify delivery.
+//
+// The daemon is expected next to the benchmark binary (`make tools`).
+
+#include "bench.h"
+
+#include "cooklang_index.h"
+#include "tree-sitter-cooklang.h"
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+#define RECIPES 10000
+#define SAVES 200
+
+static int compare_doubles(const void *a, const void *b) {
+    double left = *(const double *)a;
+    double right = *(const double *)b;
+    return left < right ? -1 : left > right;
+}
+
+static void report_latency(const char *name, double *samples, uint32_t count) {
+    if (count == 0) {
+        printf("  %-28s no samples\n", name);
+        return;
+    }
+    qsort(samples, count, sizeof(double), compare_doubles);
+    double total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        total += samples[i];
+    }
+    printf("  %-28s avg %8.1f us  p50 %8.1f us  p99 %8.1f us\n", name, total / count * 1e6,
+           samples[count / 2] * 1e6, samples[count * 99 / 100] * 1e6);
+}
+
+static uint64_t resident_bytes(void) {
+    FILE *statm = fopen("/proc/self/statm", "r");
+    unsigned long size = 0, resident = 0;
+    if (statm) {
+        if (fscanf(statm, "%lu %lu", &size, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(statm);
+    }
+    return (uint64_t)resident * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+static void bench_memory(const BenchCorpus *corpus, TSParser *parser) {
+    CooklangIndex index;
+    cooklang_index_init(&index);
+    uint64_t before = resident_bytes();
+    uint64_t bytes = 0, entities = 0;
+    char path[64];
+    double start = bench_now();
+    for (uint32_t i = 0; i < RECIPES; i++) {
+        const BenchFile *file = &corpus->files[i % corpus->count];
+        snprintf(path, sizeof(path), "recipes/%u.cook", i);
+        cooklang_index_update(&index, parser, path, file->data, file->length);
+        bytes += file->length;
+    }
+    double seconds = bench_now() - start;
+    uint64_t growth = resident_bytes() - before;
+    for (uint32_t i = 0; i < index.length; i++) {
+        entities += index.entries[i].entities.length;
+    }
+    char extra[128];
+    snprintf(extra, sizeof(extra), "%u recipes", index.length);
+    bench_report("initial indexing", bytes, seconds, extra);
+    printf("  %-28s %10.1f KB per recipe (%.0f bytes of text, %.1f entities)\n",
+           "resident memory", growth / 1024.0 / RECIPES, (double)bytes / RECIPES,
+           (double)entities / RECIPES);
+    cooklang_index_free(&index);
+}
+
+// Insert a space in the middle of `file`, alternately removing it again,
+// and re-index it under the same path or, for comparison, a new one.
+static void bench_updates(const BenchCorpus *corpus, TSParser *parser) {
+    CooklangIndex index;
+    cooklang_index_init(&index);
+    static double incremental[SAVES], fresh[SAVES];
+    CooklangText edited;
+    cooklang_text_init(&edited);
+    char path[64];
+    for (uint32_t i = 0; i < SAVES; i++) {
+        const BenchFile *file = &corpus->files[i % corpus->count];
+        snprintf(path, sizeof(path), "%u.cook", i % corpus->count);
+        cooklang_index_update(&index, parser, path, file->data, file->length);
+
+        uint32_t middle = file->length / 2;
+        edited.length = 0;
+        cooklang_text_append(&edited, file->data, middle);
+        cooklang_text_append(&edited, " ", 1);
+        cooklang_text_append(&edited, file->data + middle, file->length - middle);
+        double start = bench_now();
+        cooklang_index_update(&index, parser, path, edited.data, edited.length);
+        incremental[i] = bench_now() - start;
+
+        snprintf(path, sizeof(path), "fresh/%u.cook", i);
+        start = bench_now();
+        cooklang_index_update(&index, parser, path, edited.data, edited.length);
+        fresh[i] = bench_now() - start;
+        cooklang_index_remove(&index, path);
+    }
+    report_latency("re-index after an edit", incremental, SAVES);
+    report_latency("index from scratch", fresh, SAVES);
+    cooklang_text_free(&edited);
+    cooklang_index_free(&index);
+}
+
+static bool write_file(const char *path, const char *data, uint32_t length) {
+    FILE *stream = fopen(path, "wb");
+    if (!stream) {
+        return false;
+    }
+    bool ok = fwrite(data, 1, length, stream) == length;
+    return fclose(stream) == 0 && ok;
+}
+
+static int connect_to(const char *path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", path);
+    // The daemon indexes the directory before it listens for clients.
+    for (int attempt = 0; attempt < 500; attempt++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0) {
+            return fd;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+        struct timespec pause = {0, 10 * 1000 * 1000};
+        nanosleep(&pause, NULL);
+    }
+    return -1;
+}
+
+static bool read_line(int fd, char *line, size_t capacity) {
+    size_t length = 0;
+    while (length + 1 < capacity) {
+        ssize_t read_length = read(fd, line + length, 1);
+        if (read_length <= 0) {
+            return false;
+        }
+        if (line[length] == '\n') {
+            break;
+        }
+        length++;
+    }
+    line[length] = '\0';
+    return true;
+}
+
+static void bench_daemon(const BenchCorpus *corpus, const char *daemon) {
+    char directory[] = "/tmp/bench_index.XXXXXX";
+    if (!mkdtemp(directory)) {
+        fprintf(stderr, "cannot create a temporary directory\n");
+        return;
+    }
+    char recipes[64], socket_path[64], path[128];
+    snprintf(recipes, sizeof(recipes), "%s/recipes", directory);
+    snprintf(socket_path, sizeof(socket_path), "%s/socket", directory);
+    mkdir(recipes, 0700);
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        snprintf(path, sizeof(path), "%s/%u.cook", recipes, i);
+        write_file(path, corpus->files[i].data, corpus->files[i].length);
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl(daemon, daemon, recipes, socket_path, (char *)NULL);
+        _exit(127);
+    }
+    int fd = pid > 0 ? connect_to(socket_path) : -1;
+    static double samples[SAVES];
+    uint32_t count = 0;
+    char line[256];
+    CooklangText edited;
+    cooklang_text_init(&edited);
+    for (uint32_t i = 0; fd >= 0 && i < SAVES; i++) {
+        const BenchFile *file = &corpus->files[i % corpus->count];
+        edited.length = 0;
+        cooklang_text_append(&edited, file->data, file->length);
+        // Alternate between two versions so that every save changes the text.
+        if (i / corpus->count % 2 == 0) {
+            cooklang_text_append(&edited, "\n", 1);
+        }
+        snprintf(path, sizeof(path), "%s/%u.cook", recipes, i % corpus->count);
+        // Commands are answered in order, so the answer to `stats` means
+        // that the wait is registered.
+        if (write(fd, "wait\nstats\n", 11) != 11 || !read_line(fd, line, sizeof(line))) {
+            break;
+        }
+        double start = bench_now();
+        if (!write_file(path, edited.data, edited.length) || !read_line(fd, line, sizeof(line))) {
+            break;
+        }
+        samples[count++] = bench_now() - start;
+    }
+    report_latency("daemon: save to index", samples, count);
+
+    cooklang_text_free(&edited);
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (pid > 0) {
+        kill(pid, SIGTERM);
+        waitpid(pid, NULL, 0);
+    }
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        snprintf(path, sizeof(path), "%s/%u.cook", recipes, i);
+        unlink(path);
+    }
+    rmdir(recipes);
+    unlink(socket_path);
+    rmdir(directory);
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+
+    // The daemon binary lives next to this one.
+    const char *slash = strrchr(argv[0], '/');
+    int directory_length = slash ? (int)(slash - argv[0]) : 1;
+    char daemon[4096];
+    snprintf(daemon, sizeof(daemon), "%.*s/cookd", directory_length, slash ? argv[0] : ".");
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Recipe index (%u corpus files)\n", corpus.count);
+    bench_memory(&corpus, parser);
+    bench_updates(&corpus, parser);
+    bench_daemon(&corpus, daemon);
+
+    ts_parser_delete(parser);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,248 @@
+// Holding the names of 100k recipes in memory (the third argument changes
+// the count): a copy of every ingredient, cookware, timer and unit name,
+// against ids from interning tables (cooklang_intern.h). Both sides store
+// normalized names. Reported: the heap each needs on top of the extracted
+// entities, the time to take the names in, and the time to count
+// occurrences per ingredient by hashing strings against indexing by id.
+
+#include "bench.h"
+
+#include "cooklang_intern.h"
+#include "cooklang_quantity.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#define DEFAULT_RECIPE_COUNT 100000
+
+typedef struct {
+    char *name;
+    char *unit;
+} CopiedNames;
+
+static uint64_t heap_in_use(void) {
+#ifdef __GLIBC__
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static inline char to_lower(char c) {
+    return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+// A normalized copy, as cooklang_intern normalizes.
+static char *copy_normalized(const char *text, uint32_t length) {
+    char *copy = malloc(length + 1);
+    uint32_t written = 0;
+    bool pending_space = false;
+    for (uint32_t i = 0; i < length; i++) {
+        char c = text[i];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            pending_space = written > 0;
+            continue;
+        }
+        if (pending_space) {
+            copy[written++] = ' ';
+            pending_space = false;
+        }
+        copy[written++] = to_lower(c);
+    }
+    copy[written] = '\0';
+    return copy;
+}
+
+static bool has_name(const CooklangEntity *entity) {
+    return (entity->kind == COOKLANG_ENTITY_INGREDIENT || entity->kind == COOKLANG_ENTITY_COOKWARE ||
+            entity->kind == COOKLANG_ENTITY_TIMER) &&
+           entity->name.end > entity->name.start;
+}
+
+static void copy_names(const char *source, const CooklangEntityList *entities, CopiedNames *names) {
+    for (uint32_t i = 0; i < entities->length; i++) {
+        const CooklangEntity *entity = &entities->entities[i];
+        names[i].name = NULL;
+        names[i].unit = NULL;
+        if (has_name(entity)) {
+            names[i].name = copy_normalized(source + entity->name.start,
+                                            entity->name.end - entity->name.start);
+        }
+        if (entity->kind <= COOKLANG_ENTITY_TIMER && (entity->flags & COOKLANG_ENTITY_HAS_QUANTITY)) {
+            CooklangQuantity quantity;
+            cooklang_quantity_parse(source, entity->quantity, &quantity);
+            if (quantity.unit.end > quantity.unit.start) {
+                names[i].unit = copy_normalized(source + quantity.unit.start,
+                                                quantity.unit.end - quantity.unit.start);
+            }
+        }
+    }
+}
+
+typedef struct {
+    const char *name;
+    uint32_t hash;
+    uint32_t count;
+} Counter;
+
+static uint32_t hash_string(const char *text) {
+    uint32_t hash = 2166136261u;
+    for (; *text; text++) {
+        hash = (hash ^ (uint8_t)*text) * 16777619u;
+    }
+    return hash;
+}
+
+// Occurrences per ingredient name in a string-keyed table; returns the
+// number of distinct names.
+static uint32_t count_by_string(CopiedNames **names, CooklangEntityList *lists, uint32_t count,
+                                uint64_t *total) {
+    uint32_t slot_count = 1024, length = 0;
+    Counter *slots = calloc(slot_count, sizeof(Counter));
+    for (uint32_t r = 0; r < count; r++) {
+        for (uint32_t i = 0; i < lists[r].length; i++) {
+            const char *name = names[r][i].name;
+            if (!name || lists[r].entities[i].kind != COOKLANG_ENTITY_INGREDIENT) {
+                continue;
+            }
+            if ((length + 1) * 4 > slot_count * 3) {
+                Counter *grown = calloc(slot_count * 2, sizeof(Counter));
+                for (uint32_t s = 0; s < slot_count; s++) {
+                    if (slots[s].name) {
+                        uint32_t index = slots[s].hash & (slot_count * 2 - 1);
+                        while (grown[index].name) {
+                            index = (index + 1) & (slot_count * 2 - 1);
+                        }
+                        grown[index] = slots[s];
+                    }
+                }
+                free(slots);
+                slots = grown;
+                slot_count *= 2;
+            }
+            uint32_t hash = hash_string(name);
+            uint32_t index = hash & (slot_count - 1);
+            while (slots[index].name &&
+                   (slots[index].hash != hash || strcmp(slots[index].name, name) != 0)) {
+                index = (index + 1) & (slot_count - 1);
+            }
+            if (!slots[index].name) {
+                slots[index] = (Counter){name, hash, 0};
+                length++;
+            }
+            slots[index].count++;
+            (*total)++;
+        }
+    }
+    free(slots);
+    return length;
+}
+
+static uint32_t count_by_id(CooklangEntityIds **ids, CooklangEntityList *lists, uint32_t count,
+                            uint32_t name_count, uint64_t *total) {
+    uint32_t *counts = calloc(name_count, sizeof(uint32_t));
+    for (uint32_t r = 0; r < count; r++) {
+        for (uint32_t i = 0; i < lists[r].length; i++) {
+            uint32_t id = ids[r][i].name;
+            if (id != COOKLANG_INTERN_NONE && lists[r].entities[i].kind == COOKLANG_ENTITY_INGREDIENT) {
+                counts[id]++;
+                (*total)++;
+            }
+        }
+    }
+    uint32_t distinct = 0;
+    for (uint32_t id = 0; id < name_count; id++) {
+        distinct += counts[id] > 0;
+    }
+    free(counts);
+    return distinct;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    uint32_t count = argc > 3 ? (uint32_t)atol(argv[3]) : DEFAULT_RECIPE_COUNT;
+    if (count == 0) {
+        count = 1;
+    }
+
+    // Every recipe gets its own entity list, as in a collection held in
+    // memory.
+    CooklangEntityList *lists = malloc(count * sizeof(CooklangEntityList));
+    uint64_t bytes = 0, entity_count = 0;
+    for (uint32_t r = 0; r < count; r++) {
+        const BenchFile *file = &corpus.files[r % corpus.count];
+        cooklang_entity_list_init(&lists[r]);
+        cooklang_extract(file->data, file->length, &lists[r]);
+        bytes += file->length;
+        entity_count += lists[r].length;
+    }
+    printf("Name interning over %u recipes (%u distinct files, %llu entities)\n", count, corpus.count,
+           (unsigned long long)entity_count);
+
+    uint64_t heap = heap_in_use();
+    double start = bench_now();
+    CopiedNames **copies = malloc(count * sizeof(CopiedNames *));
+    for (uint32_t r = 0; r < count; r++) {
+        copies[r] = malloc((lists[r].length + 1) * sizeof(CopiedNames));
+        copy_names(corpus.files[r % corpus.count].data, &lists[r], copies[r]);
+    }
+    double copy_seconds = bench_now() - start;
+    uint64_t copy_heap = heap_in_use() - heap;
+
+    heap = heap_in_use();
+    start = bench_now();
+    CooklangInternTable names, units;
+    cooklang_intern_table_init(&names, true);
+    cooklang_intern_table_init(&units, true);
+    CooklangEntityIds **ids = malloc(count * sizeof(CooklangEntityIds *));
+    for (uint32_t r = 0; r < count; r++) {
+        ids[r] = malloc((lists[r].length + 1) * sizeof(CooklangEntityIds));
+        cooklang_intern_entities(&names, &units, corpus.files[r % corpus.count].data, &lists[r],
+                                 ids[r]);
+    }
+    double intern_seconds = bench_now() - start;
+    uint64_t intern_heap = heap_in_use() - heap;
+
+    char extra[128];
+    snprintf(extra, sizeof(extra), "heap %.1f MB", (double)copy_heap / (1024 * 1024));
+    bench_report("ingest, copied names", bytes, copy_seconds, extra);
+    snprintf(extra, sizeof(extra), "heap %.1f MB (%.1fx less), %u names, %u units",
+             (double)intern_heap / (1024 * 1024),
+             intern_heap ? (double)copy_heap / (double)intern_heap : 0.0, names.length,
+             units.length);
+    bench_report("ingest, interned ids", bytes, intern_seconds, extra);
+
+    uint64_t string_total = 0, id_total = 0;
+    start = bench_now();
+    uint32_t string_distinct = count_by_string(copies, lists, count, &string_total);
+    double string_seconds = bench_now() - start;
+    start = bench_now();
+    uint32_t id_distinct = count_by_id(ids, lists, count, names.length, &id_total);
+    double id_seconds = bench_now() - start;
+
+    snprintf(extra, sizeof(extra), "%.1f M occurrences/s, %u ingredients",
+             string_total / string_seconds / 1e6, string_distinct);
+    bench_report("count by string", bytes, string_seconds, extra);
+    snprintf(extra, sizeof(extra), "%.1f M occurrences/s, %u ingredients, %.1fx%s",
+             id_total / id_seconds / 1e6, id_distinct, string_seconds / id_seconds,
+             id_distinct == string_distinct && id_total == string_total ? "" : " MISMATCH");
+    bench_report("count by id", bytes, id_seconds, extra);
+
+    for (uint32_t r = 0; r < count; r++) {
+        for (uint32_t i = 0; i < lists[r].length; i++) {
+            free(copies[r][i].name);
+            free(copies[r][i].unit);
+        }
+        free(copies[r]);
+        free(ids[r]);
+        cooklang_entity_list_free(&lists[r]);
+    }
+    free(copies);
+    free(ids);
+    free(lists);
+    cooklang_intern_table_free(&names);
+    cooklang_intern_table_free(&units);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,75 @@
+// JSON export throughput in recipes per second: writing already parsed
+// trees as NDJSON into one reused buffer, and parsing plus writing, which is
+// what cook2json does per file.
+
+#include "bench.h"
+
+#include "cooklang_json.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+static void report(const char *name, uint64_t bytes, double elapsed, uint64_t recipes,
+                   uint64_t json_bytes) {
+    char extra[96];
+    snprintf(extra, sizeof(extra), "%.0f recipes/s, %.1f MB/s of JSON", recipes / elapsed,
+             json_bytes / elapsed / 1048576.0);
+    bench_report(name, bytes, elapsed, extra);
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    TSTree **trees = malloc(corpus.count * sizeof(TSTree *));
+    for (uint32_t i = 0; i < corpus.count; i++) {
+        trees[i] = ts_parser_parse_string(parser, NULL, corpus.files[i].data,
+                                          corpus.files[i].length);
+    }
+    printf("JSON export (%u files, %.1f KB)\n", corpus.count, corpus.bytes / 1024.0);
+
+    CooklangText out;
+    cooklang_text_init(&out);
+    uint64_t recipes = 0, bytes = 0, json_bytes = 0;
+    double start = bench_now();
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < corpus.count; i++) {
+            out.length = 0;
+            cooklang_json_write_recipe(corpus.files[i].data, ts_tree_root_node(trees[i]), &out);
+            cooklang_text_append(&out, "\n", 1);
+            json_bytes += out.length;
+            bytes += corpus.files[i].length;
+        }
+        recipes += corpus.count;
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.5);
+    report("write parsed trees", bytes, elapsed, recipes, json_bytes);
+
+    recipes = bytes = json_bytes = 0;
+    start = bench_now();
+    do {
+        for (uint32_t i = 0; i < corpus.count; i++) {
+            TSTree *tree = ts_parser_parse_string(parser, NULL, corpus.files[i].data,
+                                                  corpus.files[i].length);
+            out.length = 0;
+            cooklang_json_write_recipe(corpus.files[i].data, ts_tree_root_node(tree), &out);
+            cooklang_text_append(&out, "\n", 1);
+            ts_tree_delete(tree);
+            json_bytes += out.length;
+            bytes += corpus.files[i].length;
+        }
+        recipes += corpus.count;
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.5);
+    report("parse + write", bytes, elapsed, recipes, json_bytes);
+
+    cooklang_text_free(&out);
+    for (uint32_t i = 0; i < corpus.count; i++) {
+        ts_tree_delete(trees[i]);
+    }
+    free(trees);
+    ts_parser_delete(parser);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,238 @@
+// Keystroke-to-diagnostics latency of cooklsp, replayed over stdio the way
+// an editor would drive it. The benchmark opens the synthetic document,
+// types `@salt{1%tsp} ` character by character at the start of lines spread
+// through it, and times each didChange until the server publishes
+// diagnostics for that version. It runs once without debouncing, which is
+// the cost of an incremental parse plus diagnostics, and once with the
+// default interval, which is what a user sees. A final burst sends a whole
+// word without waiting, to show the debounce coalescing it into one parse.
+//
+// The server is expected next to the benchmark binary (`make tools`).
+
+#include "bench.h"
+
+#include "cooklang_json.h"
+
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define WORD "@salt{1%tsp} "
+#define WORDS 10
+
+typedef struct {
+    pid_t pid;
+    FILE *to_server;
+    FILE *from_server;
+    CooklangText message;
+    int version;
+} Client;
+
+static bool client_start(Client *client, const char *server, const char *debounce) {
+    int requests[2], responses[2];
+    if (pipe(requests) != 0 || pipe(responses) != 0) {
+        return false;
+    }
+    client->pid = fork();
+    if (client->pid < 0) {
+        return false;
+    }
+    if (client->pid == 0) {
+        dup2(requests[0], STDIN_FILENO);
+        dup2(responses[1], STDOUT_FILENO);
+        close(requests[1]);
+        close(responses[0]);
+        execl(server, server, "--debounce", debounce, (char *)NULL);
+        _exit(127);
+    }
+    close(requests[0]);
+    close(responses[1]);
+    client->to_server = fdopen(requests[1], "w");
+    client->from_server = fdopen(responses[0], "r");
+    cooklang_text_init(&client->message);
+    client->version = 1;
+    return client->to_server && client->from_server;
+}
+
+static void client_send(Client *client, const CooklangText *body) {
+    fprintf(client->to_server, "Content-Length: %u\r\n\r\n", body->length);
+    fwrite(body->data, 1, body->length, client->to_server);
+    fflush(client->to_server);
+}
+
+// Read the next message into `client->message`, NUL-terminated.
+static bool client_receive(Client *client) {
+    char header[128];
+    uint32_t length = 0;
+    while (fgets(header, sizeof(header), client->from_server)) {
+        if (strncmp(header, "Content-Length:", 15) == 0) {
+            length = (uint32_t)strtoul(header + 15, NULL, 10);
+        } else if (strcmp(header, "\r\n") == 0) {
+            CooklangText *message = &client->message;
+            message->length = 0;
+            if (!cooklang_text_reserve(message, length) ||
+                fread(message->data, 1, length, client->from_server) != length) {
+                return false;
+            }
+            message->length = length;
+            message->data[length] = '\0';
+            return true;
+        }
+    }
+    return false;
+}
+
+// Wait for the diagnostics of `version`; returns how many publications
+// arrived, or 0 if the server went away.
+static uint32_t wait_for_diagnostics(Client *client, int version) {
+    char expected[32];
+    snprintf(expected, sizeof(expected), "\"version\":%d,", version);
+    uint32_t published = 0;
+    while (client_receive(client)) {
+        if (strstr(client->message.data, "publishDiagnostics")) {
+            published++;
+            if (strstr(client->message.data, expected)) {
+                return published;
+            }
+        }
+    }
+    return 0;
+}
+
+static void client_stop(Client *client) {
+    fclose(client->to_server);
+    fclose(client->from_server);
+    waitpid(client->pid, NULL, 0);
+    cooklang_text_free(&client->message);
+}
+
+#define PUT_LITERAL(text, literal) cooklang_text_append(text, literal, sizeof(literal) - 1)
+
+static void put_number(CooklangText *text, long number) {
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%ld", number);
+    cooklang_text_append(text, digits, (uint32_t)length);
+}
+
+static void send_open(Client *client, const BenchFile *document) {
+    CooklangText body;
+    cooklang_text_init(&body);
+    PUT_LITERAL(&body, "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"initialize\",\"params\":{}}");
+    client_send(client, &body);
+    client_receive(client);
+
+    body.length = 0;
+    PUT_LITERAL(&body, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didOpen\",\"params\":"
+                       "{\"textDocument\":{\"uri\":\"file:///bench.cook\",\"languageId\":"
+                       "\"cooklang\",\"version\":1,\"text\":");
+    cooklang_json_write_string(&body, document->data, document->length);
+    PUT_LITERAL(&body, "}}}");
+    client_send(client, &body);
+    cooklang_text_free(&body);
+    wait_for_diagnostics(client, 1);
+}
+
+static void send_keystroke(Client *client, uint32_t line, uint32_t character, char c) {
+    CooklangText body;
+    cooklang_text_init(&body);
+    PUT_LITERAL(&body, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didChange\",\"params\":"
+                       "{\"textDocument\":{\"uri\":\"file:///bench.cook\",\"version\":");
+    put_number(&body, ++client->version);
+    PUT_LITERAL(&body, "},\"contentChanges\":[{\"range\":{\"start\":{\"line\":");
+    put_number(&body, line);
+    PUT_LITERAL(&body, ",\"character\":");
+    put_number(&body, character);
+    PUT_LITERAL(&body, "},\"end\":{\"line\":");
+    put_number(&body, line);
+    PUT_LITERAL(&body, ",\"character\":");
+    put_number(&body, character);
+    PUT_LITERAL(&body, "}},\"text\":");
+    cooklang_json_write_string(&body, &c, 1);
+    PUT_LITERAL(&body, "}]}}");
+    client_send(client, &body);
+    cooklang_text_free(&body);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double left = *(const double *)a;
+    double right = *(const double *)b;
+    return left < right ? -1 : left > right;
+}
+
+static void report_latency(const char *name, double *samples, uint32_t count) {
+    if (count == 0) {
+        printf("  %-28s no samples\n", name);
+        return;
+    }
+    qsort(samples, count, sizeof(double), compare_doubles);
+    double total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        total += samples[i];
+    }
+    printf("  %-28s avg %8.2f ms  p50 %8.2f ms  p99 %8.2f ms\n", name, total / count * 1e3,
+           samples[count / 2] * 1e3, samples[count * 99 / 100] * 1e3);
+}
+
+static void replay(const char *server, const char *debounce, const BenchFile *document,
+                   uint32_t lines) {
+    Client client;
+    if (!client_start(&client, server, debounce)) {
+        fprintf(stderr, "cannot start %s\n", server);
+        return;
+    }
+    send_open(&client, document);
+
+    enum { KEYSTROKES = WORDS * (sizeof(WORD) - 1) };
+    double samples[KEYSTROKES];
+    uint32_t count = 0;
+    for (uint32_t word = 0; word < WORDS; word++) {
+        uint32_t line = (uint32_t)((uint64_t)lines * word / WORDS);
+        for (uint32_t i = 0; i < sizeof(WORD) - 1; i++) {
+            double start = bench_now();
+            send_keystroke(&client, line, i, WORD[i]);
+            if (!wait_for_diagnostics(&client, client.version)) {
+                break;
+            }
+            samples[count++] = bench_now() - start;
+        }
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "keystroke, debounce %s ms", debounce);
+    report_latency(name, samples, count);
+
+    // A burst: the whole word without waiting in between.
+    double start = bench_now();
+    for (uint32_t i = 0; i < sizeof(WORD) - 1; i++) {
+        send_keystroke(&client, lines / 2, i, WORD[i]);
+    }
+    uint32_t published = wait_for_diagnostics(&client, client.version);
+    printf("  %-28s %8.2f ms for %zu keystrokes, %u parses\n", "burst", (bench_now() - start) * 1e3,
+           sizeof(WORD) - 1, published);
+    client_stop(&client);
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+    uint32_t lines = 1;
+    for (uint32_t i = 0; i < document.length; i++) {
+        lines += document.data[i] == '\n';
+    }
+
+    // The server binary lives next to this one.
+    const char *slash = strrchr(argv[0], '/');
+    int directory_length = slash ? (int)(slash - argv[0]) : 1;
+    char server[4096];
+    snprintf(server, sizeof(server), "%.*s/cooklsp", directory_length, slash ? argv[0] : ".");
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Language server (%.1f MB document, %u lines)\n", document.length / (1024.0 * 1024.0),
+           lines);
+    replay(server, "0", &document, lines);
+    replay(server, "50", &document, lines);
+
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,326 @@
+// A collection of small recipes as a directory tree against the same
+// recipes in one pack (cooklang_pack.h). The corpus is written out as the
+// number of files given as the third argument (default 20000), spread over
+// a hundred directories under /tmp, and packed. Measured: reading every
+// recipe, with the page cache warm and after dropping the files from it
+// (directory entries and inodes stay cached, which flatters the tree);
+// listing every title, extracted from each file against precomputed in
+// the pack; and opening the collection to parse a handful of recipes.
+
+#include "bench.h"
+
+#include "cooklang_extract.h"
+#include "cooklang_pack.h"
+#include "tree-sitter-cooklang.h"
+
+#include <fcntl.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+#define DIRECTORY_COUNT 100
+#define PARSED_RECIPES 10
+
+typedef struct {
+    char root[64];
+    char pack[80];
+    uint32_t count;
+    uint64_t bytes;
+    // Reused by every file read from the tree.
+    char *buffer;
+    uint32_t buffer_length;
+    uint32_t buffer_capacity;
+} Collection;
+
+static void recipe_path(uint32_t index, char *path, size_t size) {
+    snprintf(path, size, "%02u/recipe-%u.cook", index % DIRECTORY_COUNT, index);
+}
+
+static void full_path(const Collection *collection, uint32_t index, char *path, size_t size) {
+    char relative[64];
+    recipe_path(index, relative, sizeof(relative));
+    snprintf(path, size, "%s/%s", collection->root, relative);
+}
+
+// Each recipe is a corpus file under a title of its own.
+static bool write_collection(Collection *collection, const BenchCorpus *corpus) {
+    char path[4096];
+    for (uint32_t i = 0; i < DIRECTORY_COUNT; i++) {
+        snprintf(path, sizeof(path), "%s/%02u", collection->root, i);
+        if (mkdir(path, 0755) != 0) {
+            return false;
+        }
+    }
+    CooklangPackWriter writer;
+    if (!cooklang_pack_writer_open(&writer, collection->pack, true)) {
+        return false;
+    }
+    bool ok = true;
+    char *text = NULL;
+    for (uint32_t i = 0; i < collection->count && ok; i++) {
+        const BenchFile *file = &corpus->files[i % corpus->count];
+        text = realloc(text, file->length + 64);
+        int header = snprintf(text, 64, ">> title: Recipe %u\n", i);
+        memcpy(text + header, file->data, file->length);
+        uint32_t length = (uint32_t)header + file->length;
+        collection->bytes += length;
+
+        full_path(collection, i, path, sizeof(path));
+        FILE *stream = fopen(path, "wb");
+        ok = stream && fwrite(text, 1, length, stream) == length;
+        ok = stream && fclose(stream) == 0 && ok;
+        recipe_path(i, path, sizeof(path));
+        ok = ok && cooklang_pack_writer_add(&writer, path, text, length);
+    }
+    free(text);
+    return cooklang_pack_writer_finish(&writer) && ok;
+}
+
+static void remove_collection(const Collection *collection) {
+    char path[4096];
+    for (uint32_t i = 0; i < collection->count; i++) {
+        full_path(collection, i, path, sizeof(path));
+        unlink(path);
+    }
+    for (uint32_t i = 0; i < DIRECTORY_COUNT; i++) {
+        snprintf(path, sizeof(path), "%s/%02u", collection->root, i);
+        rmdir(path);
+    }
+    rmdir(collection->root);
+    unlink(collection->pack);
+}
+
+static void drop_cached(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+static void drop_collection(const Collection *collection) {
+    char path[4096];
+    for (uint32_t i = 0; i < collection->count; i++) {
+        full_path(collection, i, path, sizeof(path));
+        drop_cached(path);
+    }
+    drop_cached(collection->pack);
+}
+
+static bool read_into_buffer(Collection *collection, const char *path) {
+    FILE *stream = fopen(path, "rb");
+    if (!stream) {
+        return false;
+    }
+    collection->buffer_length = 0;
+    for (;;) {
+        if (collection->buffer_capacity - collection->buffer_length < 65536) {
+            collection->buffer_capacity = collection->buffer_capacity * 2 + 65536;
+            collection->buffer = realloc(collection->buffer, collection->buffer_capacity);
+        }
+        size_t read = fread(collection->buffer + collection->buffer_length, 1, 65536, stream);
+        collection->buffer_length += (uint32_t)read;
+        if (read < 65536) {
+            break;
+        }
+    }
+    fclose(stream);
+    return true;
+}
+
+typedef enum {
+    TOUCH,
+    TITLES,
+} Work;
+
+// Touches one byte in every 64 of a recipe; the sums must agree.
+static uint64_t touch(const char *text, uint32_t length) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < length; i += 64) {
+        sum += (uint8_t)text[i];
+    }
+    return sum;
+}
+
+static uint64_t title_length(const char *text, uint32_t length, CooklangEntityList *entities) {
+    entities->length = 0;
+    cooklang_extract(text, length, entities);
+    for (uint32_t i = 0; i < entities->length; i++) {
+        const CooklangEntity *entity = &entities->entities[i];
+        if (entity->kind == COOKLANG_ENTITY_METADATA &&
+            entity->name.end - entity->name.start == 5 &&
+            memcmp(text + entity->name.start, "title", 5) == 0) {
+            return entity->value.end - entity->value.start;
+        }
+    }
+    return 0;
+}
+
+// Walks the tree the way a tool that knows nothing of its layout would,
+// reading every recipe. Returns the bytes read and adds to `result`.
+static uint64_t walk(Collection *collection, const char *directory, Work work,
+                     CooklangEntityList *entities, uint64_t *result) {
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        return 0;
+    }
+    uint64_t bytes = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        struct stat info;
+        if (stat(path, &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            bytes += walk(collection, path, work, entities, result);
+        } else if (read_into_buffer(collection, path)) {
+            bytes += collection->buffer_length;
+            *result += work == TOUCH
+                           ? touch(collection->buffer, collection->buffer_length)
+                           : title_length(collection->buffer, collection->buffer_length, entities);
+        }
+    }
+    closedir(dir);
+    return bytes;
+}
+
+static uint64_t read_pack(const Collection *collection, Work work, uint64_t *result) {
+    CooklangPack pack;
+    if (!cooklang_pack_open(&pack, collection->pack)) {
+        return 0;
+    }
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < pack.count; i++) {
+        CooklangPackRecipe recipe;
+        if (!cooklang_pack_recipe(&pack, i, &recipe)) {
+            continue;
+        }
+        if (work == TOUCH) {
+            bytes += recipe.length;
+            *result += touch(recipe.text, recipe.length);
+        } else {
+            CooklangSpan title;
+            if (cooklang_pack_find_metadata(&recipe, "title", &title)) {
+                *result += title.end - title.start;
+            }
+        }
+    }
+    cooklang_pack_close(&pack);
+    return bytes;
+}
+
+static void compare(Collection *collection, const char *name, Work work, bool cold) {
+    CooklangEntityList entities;
+    cooklang_entity_list_init(&entities);
+    uint64_t directory_result = 0, pack_result = 0;
+    if (cold) {
+        drop_collection(collection);
+    }
+    double start = bench_now();
+    uint64_t bytes = walk(collection, collection->root, work, &entities, &directory_result);
+    double directory_seconds = bench_now() - start;
+
+    if (cold) {
+        drop_collection(collection);
+    }
+    start = bench_now();
+    read_pack(collection, work, &pack_result);
+    double pack_seconds = bench_now() - start;
+    cooklang_entity_list_free(&entities);
+
+    char label[64], extra[64];
+    snprintf(label, sizeof(label), "%s, directory", name);
+    snprintf(extra, sizeof(extra), "%.0f recipes/s", collection->count / directory_seconds);
+    bench_report(label, bytes, directory_seconds, extra);
+    snprintf(label, sizeof(label), "%s, pack", name);
+    snprintf(extra, sizeof(extra), "%.0f recipes/s (%.1fx)%s", collection->count / pack_seconds,
+             directory_seconds / pack_seconds,
+             bytes == collection->bytes && pack_result == directory_result ? "" : " MISMATCH");
+    bench_report(label, bytes, pack_seconds, extra);
+}
+
+// Opens the collection and parses PARSED_RECIPES recipes found by path, as
+// a tool answering for a few recipes would.
+static void compare_parsing(Collection *collection) {
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    char path[4096];
+    uint64_t directory_bytes = 0, pack_bytes = 0;
+
+    double start = bench_now();
+    for (uint32_t i = 0; i < PARSED_RECIPES; i++) {
+        full_path(collection, i * (collection->count / PARSED_RECIPES), path, sizeof(path));
+        if (read_into_buffer(collection, path)) {
+            TSTree *tree =
+                ts_parser_parse_string(parser, NULL, collection->buffer, collection->buffer_length);
+            directory_bytes += ts_node_end_byte(ts_tree_root_node(tree));
+            ts_tree_delete(tree);
+        }
+    }
+    double directory_seconds = bench_now() - start;
+
+    start = bench_now();
+    CooklangPack pack;
+    if (cooklang_pack_open(&pack, collection->pack)) {
+        for (uint32_t i = 0; i < PARSED_RECIPES; i++) {
+            recipe_path(i * (collection->count / PARSED_RECIPES), path, sizeof(path));
+            uint32_t index = cooklang_pack_find(&pack, path);
+            CooklangPackRecipe recipe;
+            if (index == UINT32_MAX || !cooklang_pack_recipe(&pack, index, &recipe)) {
+                continue;
+            }
+            TSTree *tree = cooklang_pack_parse(parser, &recipe);
+            pack_bytes += ts_node_end_byte(ts_tree_root_node(tree));
+            ts_tree_delete(tree);
+        }
+        cooklang_pack_close(&pack);
+    }
+    double pack_seconds = bench_now() - start;
+    ts_parser_delete(parser);
+
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%.1f us", directory_seconds * 1e6);
+    bench_report("open + parse 10, directory", directory_bytes, directory_seconds, extra);
+    snprintf(extra, sizeof(extra), "%.1f us%s", pack_seconds * 1e6,
+             pack_bytes == directory_bytes ? "" : " MISMATCH");
+    bench_report("open + parse 10, pack", pack_bytes, pack_seconds, extra);
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    Collection collection = {.count = argc > 3 ? (uint32_t)atol(argv[3]) : 20000};
+    if (collection.count < PARSED_RECIPES) {
+        collection.count = PARSED_RECIPES;
+    }
+    snprintf(collection.root, sizeof(collection.root), "/tmp/cooklang-collection-XXXXXX");
+    if (!mkdtemp(collection.root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(collection.pack, sizeof(collection.pack), "%s.pack", collection.root);
+    double start = bench_now();
+    bool written = write_collection(&collection, &corpus);
+    double seconds = bench_now() - start;
+    if (!written) {
+        fprintf(stderr, "could not write the collection to %s\n", collection.root);
+        remove_collection(&collection);
+        return 1;
+    }
+
+    printf("Recipe packs (%u recipes, %.1f MB, written and packed in %.2f s)\n", collection.count,
+           (double)collection.bytes / (1024 * 1024), seconds);
+    compare(&collection, "read all (warm)", TOUCH, false);
+    compare(&collection, "list titles", TITLES, false);
+    compare_parsing(&collection);
+    compare(&collection, "read all (cold)", TOUCH, true);
+
+    remove_collection(&collection);
+    free(collection.buffer);
+    bench_corpus_free(&corpus);
+    return 0;
+}
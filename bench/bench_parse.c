@@ -0,0 +1,108 @@
+// Parse throughput of the optimized builds of the grammar library (`make
+// release`, `make lto`, `make pgo`). Each library is loaded with dlopen and
+// parses the same corpus files and synthetic document in this process, so
+// the only difference between the rows is how src/ was compiled. Speedups
+// are relative to the first library, the release build by default.
+//
+//   bench_parse [CORPUS [MEGABYTES [LIBRARY...]]]
+//
+// Without libraries, the variants that have been built under the directory
+// of this binary are used. `make pgo` runs it on an instrumented library to
+// collect the training profile.
+
+#include "bench.h"
+
+#include <dlfcn.h>
+#include <tree_sitter/api.h>
+
+#ifdef __APPLE__
+#define LIBRARY_NAME "libtree-sitter-cooklang.dylib"
+#else
+#define LIBRARY_NAME "libtree-sitter-cooklang.so"
+#endif
+
+static const char *const VARIANTS[] = {"release", "lto", "pgo"};
+
+// Parse every corpus file and then the whole document, for at least half a
+// second; returns seconds per round.
+static double time_parse(const TSLanguage *language, const BenchCorpus *corpus,
+                         const BenchFile *document) {
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, language);
+    unsigned rounds = 0;
+    double start = bench_now();
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < corpus->count; i++) {
+            ts_tree_delete(ts_parser_parse_string(parser, NULL, corpus->files[i].data,
+                                                  corpus->files[i].length));
+        }
+        ts_tree_delete(ts_parser_parse_string(parser, NULL, document->data, document->length));
+        rounds++;
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.5);
+    ts_parser_delete(parser);
+    return elapsed / rounds;
+}
+
+// Returns the seconds per round, or 0 if the library cannot be loaded. The
+// library stays loaded: an instrumented build writes its profile at exit.
+static double bench_library(const char *name, const char *path, const BenchCorpus *corpus,
+                            const BenchFile *document, double baseline) {
+    void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    const TSLanguage *(*language)(void) = NULL;
+    if (library) {
+        *(void **)&language = dlsym(library, "tree_sitter_cooklang");
+    }
+    if (!language) {
+        printf("  %-28s not loaded: %s\n", name, dlerror());
+        return 0;
+    }
+    double seconds = time_parse(language(), corpus, document);
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%.2fx", baseline > 0 ? baseline / seconds : 1.0);
+    bench_report(name, corpus->bytes + document->length, seconds, extra);
+    return seconds;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+    printf("Grammar library builds (%u files + %.1f MB document)\n", corpus.count,
+           document.length / (1024.0 * 1024.0));
+
+    double baseline = 0;
+    if (argc > 3) {
+        for (int i = 3; i < argc; i++) {
+            double seconds = bench_library(argv[i], argv[i], &corpus, &document, baseline);
+            if (baseline == 0) {
+                baseline = seconds;
+            }
+        }
+    } else {
+        const char *slash = strrchr(argv[0], '/');
+        int directory_length = slash ? (int)(slash - argv[0]) : 1;
+        bool found = false;
+        for (size_t i = 0; i < sizeof(VARIANTS) / sizeof(VARIANTS[0]); i++) {
+            char path[4096];
+            snprintf(path, sizeof(path), "%.*s/%s/" LIBRARY_NAME, directory_length,
+                     slash ? argv[0] : ".", VARIANTS[i]);
+            struct stat status;
+            if (stat(path, &status) != 0) {
+                continue;
+            }
+            found = true;
+            double seconds = bench_library(VARIANTS[i], path, &corpus, &document, baseline);
+            if (baseline == 0) {
+                baseline = seconds;
+            }
+        }
+        if (!found) {
+            printf("  no builds found; run `make release lto pgo` first\n");
+        }
+    }
+
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
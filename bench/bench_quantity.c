@@ -0,0 +1,97 @@
+// Serving scaling throughput in quantities per second: whole parsed recipes
+// through cooklang_scale_recipe, and bare quantity spans through
+// parse/scale/format.
+
+#include "bench.h"
+
+#include "cooklang_extract.h"
+#include "cooklang_quantity.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+static const CooklangRational FACTOR = {3, 2};
+
+static void bench_recipes(const BenchCorpus *corpus) {
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    TSTree **trees = malloc(corpus->count * sizeof(TSTree *));
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        trees[i] = ts_parser_parse_string(parser, NULL, corpus->files[i].data,
+                                          corpus->files[i].length);
+    }
+
+    CooklangText out;
+    cooklang_text_init(&out);
+    uint64_t quantities = 0, bytes = 0;
+    double start = bench_now();
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < corpus->count; i++) {
+            CooklangScaleCounts counts;
+            cooklang_scale_recipe(corpus->files[i].data, corpus->files[i].length,
+                                  ts_tree_root_node(trees[i]), FACTOR, &out, &counts);
+            quantities += counts.quantities;
+            bytes += corpus->files[i].length;
+        }
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.5);
+
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%.2fM quantities/s", quantities / elapsed / 1e6);
+    bench_report("scale parsed recipes", bytes, elapsed, extra);
+
+    cooklang_text_free(&out);
+    for (uint32_t i = 0; i < corpus->count; i++) {
+        ts_tree_delete(trees[i]);
+    }
+    free(trees);
+    ts_parser_delete(parser);
+}
+
+static void bench_spans(const BenchFile *document) {
+    CooklangEntityList list;
+    cooklang_entity_list_init(&list);
+    cooklang_extract(document->data, document->length, &list);
+
+    uint64_t quantities = 0, bytes = 0;
+    double start = bench_now();
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < list.length; i++) {
+            const CooklangEntity *entity = &list.entities[i];
+            if (entity->kind != COOKLANG_ENTITY_INGREDIENT ||
+                !(entity->flags & COOKLANG_ENTITY_HAS_QUANTITY)) {
+                continue;
+            }
+            CooklangQuantity quantity;
+            char amount[128];
+            cooklang_quantity_parse(document->data, entity->quantity, &quantity);
+            cooklang_quantity_scale(&quantity, FACTOR);
+            cooklang_quantity_format(&quantity, amount, sizeof(amount));
+            quantities++;
+            bytes += entity->quantity.end - entity->quantity.start;
+        }
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.5);
+
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%.2fM quantities/s", quantities / elapsed / 1e6);
+    bench_report("parse/scale/format spans", bytes, elapsed, extra);
+    cooklang_entity_list_free(&list);
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+
+    printf("Quantity scaling by %llu/%llu (%u files, %.1f KB)\n",
+           (unsigned long long)FACTOR.numerator, (unsigned long long)FACTOR.denominator,
+           corpus.count, corpus.bytes / 1024.0);
+    bench_recipes(&corpus);
+    bench_spans(&document);
+
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
@@ -0,0 +1,110 @@
+// External scanner and internal lexer invocations per KB of input, counted
+// through the parser's debug log, and a per-branch breakdown of the external
+// scanner from its COOKLANG_SCANNER_STATS counters.
+
+#include "bench.h"
+
+#include "scanner_stats.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+typedef struct {
+    uint64_t external;
+    uint64_t internal;
+} LexCounts;
+
+static void count_lex_calls(void *payload, TSLogType type, const char *message) {
+    LexCounts *counts = payload;
+    if (type != TSLogTypeParse) {
+        return;
+    }
+    if (strncmp(message, "lex_external", 12) == 0) {
+        counts->external++;
+    } else if (strncmp(message, "lex_internal", 12) == 0) {
+        counts->internal++;
+    }
+}
+
+#ifdef COOKLANG_SCANNER_STATS
+
+#define MAX_VALID_SYMBOL_SETS 8
+
+static void print_valid_symbols(uint32_t valid_symbols) {
+    const char *separator = "";
+    for (uint32_t token = 0; token < COOKLANG_SCANNER_TOKEN_COUNT; token++) {
+        if (valid_symbols & (1u << token)) {
+            printf("%s%s", separator, cooklang_scanner_token_name(token));
+            separator = " ";
+        }
+    }
+}
+
+static void print_scanner_stats(void) {
+    CooklangScannerStats stats;
+    cooklang_scanner_stats(&stats);
+
+    printf("\nExternal scanner branches (%llu calls, %llu failed after advancing)\n",
+           (unsigned long long)stats.calls, (unsigned long long)stats.false_after_advance);
+    printf("  %-20s %10s %10s %10s %12s %10s\n", "token", "tried", "returned", "bytes",
+           "bytes/token", "wasted");
+    for (uint32_t i = 0; i < COOKLANG_SCANNER_TOKEN_COUNT; i++) {
+        const CooklangScannerTokenStats *token = &stats.tokens[i];
+        if (token->calls == 0) {
+            continue;
+        }
+        printf("  %-20s %10llu %10llu %10llu %12.1f %10llu\n", cooklang_scanner_token_name(i),
+               (unsigned long long)token->calls, (unsigned long long)token->successes,
+               (unsigned long long)token->bytes,
+               token->successes ? (double)token->bytes / token->successes : 0.0,
+               (unsigned long long)token->false_after_advance);
+    }
+
+    CooklangValidSymbolSet sets[MAX_VALID_SYMBOL_SETS];
+    uint32_t count = cooklang_scanner_valid_symbol_sets(sets, MAX_VALID_SYMBOL_SETS);
+    printf("\nMost frequent valid_symbols sets (%u distinct)\n", count);
+    for (uint32_t i = 0; i < count && i < MAX_VALID_SYMBOL_SETS; i++) {
+        printf("  %10llu  %5.1f%%  ", (unsigned long long)sets[i].calls,
+               100.0 * sets[i].calls / stats.calls);
+        print_valid_symbols(sets[i].valid_symbols);
+        printf("\n");
+    }
+}
+
+#else
+
+static void print_scanner_stats(void) {
+    printf("\nBuilt without COOKLANG_SCANNER_STATS, no per-branch breakdown\n");
+}
+
+#endif
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    LexCounts counts = {0, 0};
+#ifdef COOKLANG_SCANNER_STATS
+    cooklang_scanner_stats_reset();
+#endif
+    ts_parser_set_logger(parser, (TSLogger){&counts, count_lex_calls});
+
+    for (uint32_t i = 0; i < corpus.count; i++) {
+        TSTree *tree = ts_parser_parse_string(parser, NULL, corpus.files[i].data,
+                                              corpus.files[i].length);
+        ts_tree_delete(tree);
+    }
+
+    double kb = corpus.bytes / 1024.0;
+    printf("Lexer invocations (%u files, %.1f KB)\n", corpus.count, kb);
+    printf("  external scanner:  %10llu  %8.1f per KB\n", (unsigned long long)counts.external,
+           counts.external / kb);
+    printf("  internal lexer:    %10llu  %8.1f per KB\n", (unsigned long long)counts.internal,
+           counts.internal / kb);
+    print_scanner_stats();
+
+    ts_parser_delete(parser);
+    bench_corpus_free(&corpus);
+    return 0;
+}
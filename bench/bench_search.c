@@ -0,0 +1,180 @@
+// Full-text search over 100k recipes drawn from the corpus (the third
+// argument changes the count, the fourth the number of threads, default
+// one per CPU): building the index on one thread and on all of them, its
+// size, and query latency against scanning every recipe for the words the
+// way a substring search does. Queries are one to three words picked from
+// the corpus.
+
+#include "bench.h"
+
+#include "cooklang_search.h"
+#include "tree-sitter-cooklang.h"
+
+#include <unistd.h>
+
+#define DEFAULT_RECIPE_COUNT 100000
+#define QUERY_COUNT 1000
+#define SCANNED_QUERIES 20
+#define MAX_HITS 10
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static bool is_word_byte(uint8_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+// Appends a random word of at least three bytes from the corpus to `query`.
+static void add_random_word(const BenchCorpus *corpus, char *query, size_t size) {
+    for (;;) {
+        const BenchFile *file = &corpus->files[rand() % corpus->count];
+        if (file->length == 0) {
+            continue;
+        }
+        uint32_t i = (uint32_t)rand() % file->length;
+        while (i > 0 && is_word_byte((uint8_t)file->data[i - 1])) {
+            i--;
+        }
+        uint32_t end = i;
+        while (end < file->length && is_word_byte((uint8_t)file->data[end])) {
+            end++;
+        }
+        if (end - i >= 3 && end - i < 32) {
+            size_t length = strlen(query);
+            snprintf(query + length, size - length, "%s%.*s", length ? " " : "", (int)(end - i),
+                     file->data + i);
+            return;
+        }
+    }
+}
+
+// What the index replaces: every recipe is scanned for each word.
+static uint32_t scan(const CooklangSearchDocument *documents, uint32_t count, const char *query) {
+    char words[3][32];
+    int word_count = 0;
+    for (const char *p = query; *p && word_count < 3;) {
+        int length = 0;
+        while (p[length] && p[length] != ' ') {
+            length++;
+        }
+        snprintf(words[word_count++], sizeof(words[0]), "%.*s", length, p);
+        p += length + (p[length] == ' ');
+    }
+    uint32_t matches = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        for (int w = 0; w < word_count; w++) {
+            if (strstr(documents[i].text, words[w])) {
+                matches++;
+                break;
+            }
+        }
+    }
+    return matches;
+}
+
+static CooklangSearchIndex *timed_build(const CooklangSearchDocument *documents, uint32_t count,
+                                        unsigned threads, double *seconds) {
+    double start = bench_now();
+    CooklangSearchIndex *index =
+        cooklang_search_index_build(tree_sitter_cooklang(), documents, count, threads);
+    *seconds = bench_now() - start;
+    return index;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    uint32_t count = argc > 3 ? (uint32_t)atol(argv[3]) : DEFAULT_RECIPE_COUNT;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned threads = argc > 4 ? (unsigned)atoi(argv[4]) : (unsigned)(cpus > 0 ? cpus : 1);
+    if (count == 0) {
+        count = 1;
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    CooklangSearchDocument *documents = malloc(count * sizeof(CooklangSearchDocument));
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const BenchFile *file = &corpus.files[i % corpus.count];
+        documents[i] = (CooklangSearchDocument){file->data, file->length};
+        bytes += file->length;
+    }
+    printf("Full-text search over %u recipes (%u distinct files, %.1f MB)\n", count, corpus.count,
+           (double)bytes / (1024 * 1024));
+
+    double single_seconds, parallel_seconds;
+    CooklangSearchIndex *single = timed_build(documents, count, 1, &single_seconds);
+    CooklangSearchIndex *index = timed_build(documents, count, threads, &parallel_seconds);
+    if (!single || !index) {
+        fprintf(stderr, "could not build the index\n");
+        return 1;
+    }
+    char extra[128];
+    snprintf(extra, sizeof(extra), "%.0f recipes/s", count / single_seconds);
+    bench_report("build, 1 thread", bytes, single_seconds, extra);
+    char name[64];
+    snprintf(name, sizeof(name), "build, %u threads", threads);
+    snprintf(extra, sizeof(extra), "%.0f recipes/s, %.2fx", count / parallel_seconds,
+             single_seconds / parallel_seconds);
+    bench_report(name, bytes, parallel_seconds, extra);
+    cooklang_search_index_delete(single);
+
+    CooklangSearchStats stats;
+    cooklang_search_index_stats(index, &stats);
+    printf("  index: %u terms, %llu postings in %.2f MB (%.2f bytes each, %.1fx smaller than "
+           "8-byte pairs); %.2f MB in all, %.0f%% of the text\n",
+           stats.terms, (unsigned long long)stats.postings,
+           (double)stats.posting_bytes / (1024 * 1024),
+           (double)stats.posting_bytes / (double)stats.postings,
+           8.0 * (double)stats.postings / (double)stats.posting_bytes,
+           (double)stats.bytes / (1024 * 1024), 100.0 * (double)stats.bytes / (double)bytes);
+
+    srand(1);
+    static char queries[QUERY_COUNT][128];
+    for (uint32_t q = 0; q < QUERY_COUNT; q++) {
+        int words = 1 + rand() % 3;
+        for (int w = 0; w < words; w++) {
+            add_random_word(&corpus, queries[q], sizeof(queries[q]));
+        }
+    }
+
+    double *latencies = malloc(QUERY_COUNT * sizeof(double));
+    CooklangSearchHit hits[MAX_HITS];
+    uint64_t hit_count = 0;
+    double total = 0;
+    for (uint32_t q = 0; q < QUERY_COUNT; q++) {
+        double start = bench_now();
+        int32_t found = cooklang_search(index, queries[q], (uint32_t)strlen(queries[q]), NULL, hits,
+                                        MAX_HITS);
+        latencies[q] = bench_now() - start;
+        total += latencies[q];
+        hit_count += found > 0 ? (uint64_t)found : 0;
+    }
+    qsort(latencies, QUERY_COUNT, sizeof(double), compare_doubles);
+    snprintf(extra, sizeof(extra), "p50 %.1f us, p99 %.1f us, %.1f hits/query",
+             latencies[QUERY_COUNT / 2] * 1e6, latencies[QUERY_COUNT * 99 / 100] * 1e6,
+             (double)hit_count / QUERY_COUNT);
+    bench_report("query, index", bytes * QUERY_COUNT, total, extra);
+
+    double scan_total = 0;
+    uint64_t matches = 0;
+    for (uint32_t q = 0; q < SCANNED_QUERIES; q++) {
+        double start = bench_now();
+        matches += scan(documents, count, queries[q]);
+        scan_total += bench_now() - start;
+    }
+    snprintf(extra, sizeof(extra), "%.1f us/query (%.0fx slower), %.0f matches/query",
+             scan_total / SCANNED_QUERIES * 1e6,
+             (scan_total / SCANNED_QUERIES) / (total / QUERY_COUNT),
+             (double)matches / SCANNED_QUERIES);
+    bench_report("query, substring scan", bytes * SCANNED_QUERIES, scan_total, extra);
+
+    free(latencies);
+    cooklang_search_index_delete(index);
+    free(documents);
+    bench_corpus_free(&corpus);
+    return 0;
+}
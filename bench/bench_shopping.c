@@ -0,0 +1,135 @@
+// Shopping list aggregation over 10k recipes drawn from the corpus: one list
+// built sequentially, against per-thread partial lists merged at the end.
+// The third argument sets the number of threads (default: one per CPU).
+
+#include "bench.h"
+
+#include "cooklang_shopping.h"
+#include "tree-sitter-cooklang.h"
+
+#include <pthread.h>
+#include <unistd.h>
+#include <tree_sitter/api.h>
+
+#define RECIPE_COUNT 10000
+#define MAX_THREADS 64
+
+typedef struct {
+    const BenchCorpus *corpus;
+    TSTree **trees;
+    uint32_t first;
+    uint32_t last;
+    CooklangShoppingList list;
+} Worker;
+
+static const CooklangRational ONE = {1, 1};
+
+static void aggregate(Worker *worker) {
+    for (uint32_t i = worker->first; i < worker->last; i++) {
+        uint32_t file = i % worker->corpus->count;
+        cooklang_shopping_list_add_recipe(&worker->list, worker->corpus->files[file].data,
+                                          ts_tree_root_node(worker->trees[file]), ONE);
+    }
+}
+
+static void *run_worker(void *payload) {
+    aggregate(payload);
+    return NULL;
+}
+
+// Trees are not shared between threads, so every worker gets its own copies.
+static TSTree **copy_trees(TSTree **trees, uint32_t count) {
+    TSTree **copies = malloc(count * sizeof(TSTree *));
+    for (uint32_t i = 0; i < count; i++) {
+        copies[i] = ts_tree_copy(trees[i]);
+    }
+    return copies;
+}
+
+static void delete_trees(TSTree **trees, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        ts_tree_delete(trees[i]);
+    }
+    free(trees);
+}
+
+static double run_parallel(const BenchCorpus *corpus, TSTree **trees, unsigned thread_count,
+                           CooklangShoppingList *result) {
+    Worker workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    for (unsigned t = 0; t < thread_count; t++) {
+        workers[t].corpus = corpus;
+        workers[t].trees = copy_trees(trees, corpus->count);
+        workers[t].first = (uint32_t)((uint64_t)RECIPE_COUNT * t / thread_count);
+        workers[t].last = (uint32_t)((uint64_t)RECIPE_COUNT * (t + 1) / thread_count);
+        cooklang_shopping_list_init(&workers[t].list);
+    }
+
+    double start = bench_now();
+    for (unsigned t = 0; t < thread_count; t++) {
+        pthread_create(&threads[t], NULL, run_worker, &workers[t]);
+    }
+    for (unsigned t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+        cooklang_shopping_list_merge(result, &workers[t].list);
+    }
+    double seconds = bench_now() - start;
+
+    for (unsigned t = 0; t < thread_count; t++) {
+        cooklang_shopping_list_free(&workers[t].list);
+        delete_trees(workers[t].trees, corpus->count);
+    }
+    return seconds;
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned thread_count = argc > 3 ? (unsigned)atoi(argv[3]) : (unsigned)(cpus > 0 ? cpus : 1);
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    if (thread_count > MAX_THREADS) {
+        thread_count = MAX_THREADS;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    TSTree **trees = malloc(corpus.count * sizeof(TSTree *));
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < corpus.count; i++) {
+        trees[i] = ts_parser_parse_string(parser, NULL, corpus.files[i].data,
+                                          corpus.files[i].length);
+    }
+    for (uint32_t i = 0; i < RECIPE_COUNT; i++) {
+        bytes += corpus.files[i % corpus.count].length;
+    }
+
+    printf("Shopping list over %u recipes (%u distinct files)\n", RECIPE_COUNT, corpus.count);
+
+    Worker sequential = {&corpus, trees, 0, RECIPE_COUNT, {0}};
+    cooklang_shopping_list_init(&sequential.list);
+    double start = bench_now();
+    aggregate(&sequential);
+    double sequential_seconds = bench_now() - start;
+    char extra[96];
+    snprintf(extra, sizeof(extra), "%.0f recipes/s, %u items", RECIPE_COUNT / sequential_seconds,
+             sequential.list.length);
+    bench_report("sequential", bytes, sequential_seconds, extra);
+
+    CooklangShoppingList merged;
+    cooklang_shopping_list_init(&merged);
+    double parallel_seconds = run_parallel(&corpus, trees, thread_count, &merged);
+    char name[64];
+    snprintf(name, sizeof(name), "%u partials + merge", thread_count);
+    snprintf(extra, sizeof(extra), "%.0f recipes/s, %u items, %.2fx",
+             RECIPE_COUNT / parallel_seconds, merged.length, sequential_seconds / parallel_seconds);
+    bench_report(name, bytes, parallel_seconds, extra);
+
+    cooklang_shopping_list_free(&merged);
+    cooklang_shopping_list_free(&sequential.list);
+    delete_trees(trees, corpus.count);
+    ts_parser_delete(parser);
+    bench_corpus_free(&corpus);
+    return 0;
+}
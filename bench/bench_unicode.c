@@ -0,0 +1,184 @@
+// Word classification beyond ASCII (src/scanner_unicode.h). Two documents
+// of the size given as the second argument are built from the corpus: the
+// corpus as it is, and a multilingual copy in which the lowercase ASCII
+// letters of each line are replaced with Greek, Cyrillic, CJK or Hangul
+// ones in turn, which keeps every name a name. For each document the
+// code points are classified, first with the rule the scanner used before
+// the table (every code point above 127 is a word character) and then
+// with the table; the document is then extracted (cooklang_extract.h) and
+// parsed, both of which classify every name character.
+
+#include "bench.h"
+
+#include "cooklang_extract.h"
+#include "scanner_unicode.h"
+#include "tree-sitter-cooklang.h"
+
+#include <tree_sitter/api.h>
+
+#define MIN_SECONDS 0.5
+
+// First letter of each script, as a code point. The 26 letters from there
+// on are all letters in each.
+static const int32_t SCRIPTS[] = {0x03B1, 0x0430, 0x4E00, 0xAC00};
+
+typedef struct {
+    int32_t *data;
+    uint32_t length;
+} CodePoints;
+
+// is_word_char in src/scanner.c before the table.
+static inline bool is_word_char_previous(int32_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == '\'' || c == '"' || c > 127;
+}
+
+// is_word_char in src/scanner.c.
+static inline bool is_word_char(int32_t c) {
+    if (c < 128) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '_' || c == '-' || c == '\'' || c == '"';
+    }
+    return unicode_is_word(c);
+}
+
+static uint32_t encode_utf8(int32_t c, char *out) {
+    if (c < 0x80) {
+        out[0] = (char)c;
+        return 1;
+    }
+    if (c < 0x800) {
+        out[0] = (char)(0xC0 | (c >> 6));
+        out[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    }
+    out[0] = (char)(0xE0 | (c >> 12));
+    out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (c & 0x3F));
+    return 3;
+}
+
+static BenchFile make_multilingual(const BenchFile *document) {
+    BenchFile result;
+    result.data = malloc((size_t)document->length * 3 + 1);
+    result.length = 0;
+    uint32_t line = 0;
+    for (uint32_t i = 0; i < document->length; i++) {
+        char c = document->data[i];
+        if (c >= 'a' && c <= 'z') {
+            int32_t letter = SCRIPTS[line % (sizeof(SCRIPTS) / sizeof(SCRIPTS[0]))] + (c - 'a');
+            result.length += encode_utf8(letter, result.data + result.length);
+        } else {
+            result.data[result.length++] = c;
+            line += c == '\n';
+        }
+    }
+    result.data[result.length] = '\0';
+    return result;
+}
+
+// The code points of well-formed UTF-8 text, as the lexer passes them to
+// the scanner.
+static CodePoints decode(const BenchFile *document) {
+    CodePoints points = {malloc((size_t)document->length * sizeof(int32_t)), 0};
+    const uint8_t *bytes = (const uint8_t *)document->data;
+    for (uint32_t i = 0; i < document->length;) {
+        uint8_t byte = bytes[i];
+        uint32_t length = byte < 0x80 ? 1 : byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : 2;
+        int32_t c = length == 1 ? byte : byte & (0x3F >> (length - 1));
+        for (uint32_t j = 1; j < length && i + j < document->length; j++) {
+            c = (c << 6) | (bytes[i + j] & 0x3F);
+        }
+        points.data[points.length++] = c;
+        i += length;
+    }
+    return points;
+}
+
+static void bench_classify(const char *label, const BenchFile *document,
+                           const CodePoints *points, bool previous) {
+    uint64_t words = 0;
+    uint32_t runs = 0;
+    double seconds;
+    double start = bench_now();
+    do {
+        words = 0;
+        if (previous) {
+            for (uint32_t i = 0; i < points->length; i++) {
+                words += is_word_char_previous(points->data[i]);
+            }
+        } else {
+            for (uint32_t i = 0; i < points->length; i++) {
+                words += is_word_char(points->data[i]);
+            }
+        }
+        runs++;
+        seconds = bench_now() - start;
+    } while (seconds < MIN_SECONDS);
+
+    char name[64], extra[96];
+    snprintf(name, sizeof(name), "%s, %s", label, previous ? "previous rule" : "table");
+    snprintf(extra, sizeof(extra), "%.2f ns/code point, %.1f%% word",
+             seconds / runs / points->length * 1e9, 100.0 * (double)words / points->length);
+    bench_report(name, document->length, seconds / runs, extra);
+}
+
+static void bench_extract(const char *label, const BenchFile *document) {
+    CooklangEntityList list;
+    cooklang_entity_list_init(&list);
+    uint32_t runs = 0;
+    double seconds;
+    double start = bench_now();
+    do {
+        list.length = 0;
+        cooklang_extract(document->data, document->length, &list);
+        runs++;
+        seconds = bench_now() - start;
+    } while (seconds < MIN_SECONDS);
+
+    char name[64], extra[64];
+    snprintf(name, sizeof(name), "%s, extract", label);
+    snprintf(extra, sizeof(extra), "%u entities", list.length);
+    bench_report(name, document->length, seconds / runs, extra);
+    cooklang_entity_list_free(&list);
+}
+
+static void bench_parse(const char *label, const BenchFile *document) {
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    double start = bench_now();
+    TSTree *tree = ts_parser_parse_string(parser, NULL, document->data, document->length);
+    double seconds = bench_now() - start;
+
+    char name[64], extra[64];
+    snprintf(name, sizeof(name), "%s, parse", label);
+    snprintf(extra, sizeof(extra), "%s", ts_node_has_error(ts_tree_root_node(tree)) ?
+             "with errors" : "");
+    bench_report(name, document->length, seconds, extra);
+    ts_tree_delete(tree);
+    ts_parser_delete(parser);
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile documents[2];
+    documents[0] = bench_corpus_document(&corpus, argc, argv);
+    documents[1] = make_multilingual(&documents[0]);
+    static const char *const LABELS[] = {"ASCII", "multilingual"};
+
+    printf("Word classification (%.1f MB ASCII, %.1f MB multilingual document)\n",
+           documents[0].length / (1024.0 * 1024.0), documents[1].length / (1024.0 * 1024.0));
+    for (int i = 0; i < 2; i++) {
+        CodePoints points = decode(&documents[i]);
+        bench_classify(LABELS[i], &documents[i], &points, true);
+        bench_classify(LABELS[i], &documents[i], &points, false);
+        bench_extract(LABELS[i], &documents[i]);
+        bench_parse(LABELS[i], &documents[i]);
+        free(points.data);
+    }
+
+    free(documents[0].data);
+    free(documents[1].data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
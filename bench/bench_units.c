@@ -0,0 +1,117 @@
+// Unit lookup throughput on the ingredient units of the synthetic document:
+// the generated perfect hash against a linear scan that compares every alias
+// case-insensitively, which is what the lookup would otherwise cost.
+
+#include "bench.h"
+
+#include "cooklang_extract.h"
+#include "cooklang_quantity.h"
+#include "cooklang_units.h"
+
+#include <strings.h>
+
+// The aliases of units.json, in file order, for the linear baseline.
+static const struct {
+    const char *alias;
+    const char *name;
+} LINEAR_ALIASES[] = {
+    {"g", "g"}, {"gr", "g"}, {"gram", "g"}, {"grams", "g"}, {"gramme", "g"},
+    {"grammes", "g"}, {"kg", "kg"}, {"kgs", "kg"}, {"kilo", "kg"}, {"kilos", "kg"},
+    {"kilogram", "kg"}, {"kilograms", "kg"}, {"mg", "mg"}, {"milligram", "mg"},
+    {"milligrams", "mg"}, {"oz", "oz"}, {"ounce", "oz"}, {"ounces", "oz"}, {"lb", "lb"},
+    {"lbs", "lb"}, {"pound", "lb"}, {"pounds", "lb"}, {"ml", "ml"}, {"milliliter", "ml"},
+    {"milliliters", "ml"}, {"millilitre", "ml"}, {"millilitres", "ml"}, {"cl", "cl"},
+    {"centiliter", "cl"}, {"centiliters", "cl"}, {"centilitre", "cl"}, {"centilitres", "cl"},
+    {"dl", "dl"}, {"deciliter", "dl"}, {"deciliters", "dl"}, {"decilitre", "dl"},
+    {"decilitres", "dl"}, {"l", "l"}, {"liter", "l"}, {"liters", "l"}, {"litre", "l"},
+    {"litres", "l"}, {"tsp", "tsp"}, {"tsps", "tsp"}, {"teaspoon", "tsp"},
+    {"teaspoons", "tsp"}, {"tbsp", "tbsp"}, {"tbsps", "tbsp"}, {"tbs", "tbsp"},
+    {"tbl", "tbsp"}, {"tablespoon", "tbsp"}, {"tablespoons", "tbsp"}, {"fl oz", "fl oz"},
+    {"fl. oz", "fl oz"}, {"floz", "fl oz"}, {"fluid ounce", "fl oz"},
+    {"fluid ounces", "fl oz"}, {"cup", "cup"}, {"cups", "cup"}, {"pt", "pt"},
+    {"pint", "pt"}, {"pints", "pt"}, {"qt", "qt"}, {"quart", "qt"}, {"quarts", "qt"},
+    {"gal", "gal"}, {"gallon", "gal"}, {"gallons", "gal"}, {"s", "s"}, {"sec", "s"},
+    {"secs", "s"}, {"second", "s"}, {"seconds", "s"}, {"min", "min"}, {"mins", "min"},
+    {"minute", "min"}, {"minutes", "min"}, {"h", "h"}, {"hr", "h"}, {"hrs", "h"},
+    {"hour", "h"}, {"hours", "h"}, {"day", "d"}, {"days", "d"},
+};
+
+static const char *linear_lookup(const char *text, uint32_t length) {
+    for (size_t i = 0; i < sizeof(LINEAR_ALIASES) / sizeof(LINEAR_ALIASES[0]); i++) {
+        if (strlen(LINEAR_ALIASES[i].alias) == length &&
+            strncasecmp(LINEAR_ALIASES[i].alias, text, length) == 0) {
+            return LINEAR_ALIASES[i].name;
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    CooklangSpan *spans;
+    uint32_t count;
+    uint64_t bytes;
+} Units;
+
+static Units collect_units(const BenchFile *document) {
+    CooklangEntityList list;
+    cooklang_entity_list_init(&list);
+    cooklang_extract(document->data, document->length, &list);
+    Units units = {malloc((list.length + 1) * sizeof(CooklangSpan)), 0, 0};
+    for (uint32_t i = 0; i < list.length; i++) {
+        const CooklangEntity *entity = &list.entities[i];
+        if (entity->kind != COOKLANG_ENTITY_INGREDIENT ||
+            !(entity->flags & COOKLANG_ENTITY_HAS_QUANTITY)) {
+            continue;
+        }
+        CooklangQuantity quantity;
+        cooklang_quantity_parse(document->data, entity->quantity, &quantity);
+        if (quantity.unit.end > quantity.unit.start) {
+            units.spans[units.count++] = quantity.unit;
+            units.bytes += quantity.unit.end - quantity.unit.start;
+        }
+    }
+    cooklang_entity_list_free(&list);
+    return units;
+}
+
+static void run(const char *name, const BenchFile *document, const Units *units, bool linear) {
+    uint64_t lookups = 0, found = 0, bytes = 0;
+    double start = bench_now();
+    double elapsed;
+    do {
+        for (uint32_t i = 0; i < units->count; i++) {
+            const char *text = document->data + units->spans[i].start;
+            uint32_t length = units->spans[i].end - units->spans[i].start;
+            if (linear) {
+                found += linear_lookup(text, length) != NULL;
+            } else {
+                found += cooklang_unit_lookup(text, length) != NULL;
+            }
+        }
+        lookups += units->count;
+        bytes += units->bytes;
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.5);
+
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%.1fM lookups/s, %.0f%% known", lookups / elapsed / 1e6,
+             lookups ? 100.0 * found / lookups : 0.0);
+    bench_report(name, bytes, elapsed, extra);
+}
+
+int main(int argc, char **argv) {
+    BenchCorpus corpus = bench_corpus_load(argc, argv);
+    BenchFile document = bench_corpus_document(&corpus, argc, argv);
+    Units units = collect_units(&document);
+
+    printf("Unit lookup (%u units in %.1f MB)\n", units.count, document.length / 1048576.0);
+    if (units.count > 0) {
+        run("perfect hash", &document, &units, false);
+        run("linear strncasecmp", &document, &units, true);
+    }
+
+    free(units.spans);
+    free(document.data);
+    bench_corpus_free(&corpus);
+    return 0;
+}
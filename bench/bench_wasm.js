@@ -0,0 +1,135 @@
+// Parse throughput and load time of the WebAssembly builds of the grammar
+// (`make wasm`) under web-tree-sitter, against the native N-API binding in
+// bindings/node. Load time is what an editor pays before its first parse:
+// compiling and instantiating the .wasm module, or loading the native
+// addon.
+//
+//   node bench/bench_wasm.js [CORPUS [MEGABYTES]]
+//
+// Like the C benchmarks, the corpus defaults to test/individual_tests and
+// the synthetic document built from it to 4 MB. Needs `tree-sitter` and
+// `web-tree-sitter` installed next to the package.
+
+const fs = require('fs');
+const path = require('path');
+
+const root = path.join(__dirname, '..');
+const corpusDirectory = process.argv[2] || path.join(root, 'test/individual_tests');
+const megabytes = Number(process.argv[3] || 4);
+const builds = ['size', 'speed'];
+
+function loadCorpus(directory, files = []) {
+  for (const entry of fs.readdirSync(directory, { withFileTypes: true })) {
+    if (entry.name.startsWith('.')) {
+      continue;
+    }
+    const file = path.join(directory, entry.name);
+    if (entry.isDirectory()) {
+      loadCorpus(file, files);
+    } else if (entry.name.endsWith('.cook')) {
+      files.push(fs.readFileSync(file, 'utf8'));
+    }
+  }
+  return files;
+}
+
+// The corpus files separated by blank lines, repeated up to the target size.
+function buildDocument(files, bytes) {
+  const parts = [];
+  let length = 0;
+  while (length < bytes) {
+    for (const file of files) {
+      parts.push(file, '\n\n');
+      length += Buffer.byteLength(file) + 2;
+      if (length >= bytes) {
+        break;
+      }
+    }
+  }
+  return parts.join('');
+}
+
+// Parse every corpus file and then the document, for at least half a
+// second; returns seconds per round.
+function timeParse(parser, files, document) {
+  let rounds = 0;
+  const start = process.hrtime.bigint();
+  let elapsed;
+  do {
+    for (const input of [...files, document]) {
+      const tree = parser.parse(input);
+      // web-tree-sitter trees live in the module's memory until deleted.
+      if (tree.delete) {
+        tree.delete();
+      }
+    }
+    rounds++;
+    elapsed = Number(process.hrtime.bigint() - start) / 1e9;
+  } while (elapsed < 0.5);
+  return elapsed / rounds;
+}
+
+function report(name, bytes, seconds, extra) {
+  const mb = bytes / (1024 * 1024);
+  console.log(`  ${name.padEnd(28)} ${(mb / seconds).toFixed(2).padStart(10)} MB/s  ` +
+              `${seconds.toFixed(3).padStart(8)} s${extra ? '  ' + extra : ''}`);
+}
+
+function milliseconds(start) {
+  return Number(process.hrtime.bigint() - start) / 1e6;
+}
+
+async function main() {
+  const files = loadCorpus(corpusDirectory);
+  if (files.length === 0) {
+    console.error(`no .cook files found in ${corpusDirectory}`);
+    process.exit(1);
+  }
+  const document = buildDocument(files, megabytes * 1024 * 1024);
+  const bytes = files.reduce((total, file) => total + Buffer.byteLength(file), 0) +
+                Buffer.byteLength(document);
+  console.log(`WebAssembly builds (${files.length} files + ` +
+              `${(Buffer.byteLength(document) / (1024 * 1024)).toFixed(1)} MB document)`);
+
+  let start = process.hrtime.bigint();
+  const NativeParser = require('tree-sitter');
+  const native = require('../bindings/node');
+  const nativeParser = new NativeParser();
+  nativeParser.setLanguage(native);
+  const nativeLoad = milliseconds(start);
+  const baseline = timeParse(nativeParser, files, document);
+  report('native', bytes, baseline, `load ${nativeLoad.toFixed(1)} ms`);
+
+  // web-tree-sitter 0.25 exports classes; earlier versions export Parser
+  // with Language attached.
+  const TreeSitter = require('web-tree-sitter');
+  const Parser = TreeSitter.Parser || TreeSitter;
+  const Language = TreeSitter.Language || Parser.Language;
+  start = process.hrtime.bigint();
+  await Parser.init();
+  console.log(`  ${'web-tree-sitter runtime'.padEnd(28)} load ${milliseconds(start).toFixed(1)} ms`);
+
+  for (const build of builds) {
+    const file = path.join(root, 'build', `wasm-${build}`, 'tree-sitter-cooklang.wasm');
+    if (!fs.existsSync(file)) {
+      console.log(`  ${('wasm ' + build).padEnd(28)} not built; run \`make wasm\` first`);
+      continue;
+    }
+    const binary = fs.readFileSync(file);
+    start = process.hrtime.bigint();
+    const language = await Language.load(binary);
+    const load = milliseconds(start);
+    const parser = new Parser();
+    parser.setLanguage(language);
+    const seconds = timeParse(parser, files, document);
+    report(`wasm ${build}`, bytes, seconds,
+           `load ${load.toFixed(1)} ms, ${(binary.length / 1024).toFixed(1)} KB, ` +
+           `${(seconds / baseline).toFixed(2)}x native time`);
+    parser.delete();
+  }
+}
+
+main().catch(error => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+# Print the size of the generated parse tables, so that grammar changes show
+# up as a diff in bench/parser_stats.txt:
+#
+#     bench/parser_stats.sh > bench/parser_stats.txt
+
+set -euo pipefail
+
+parser=${1:-src/parser.c}
+
+define() {
+    awk -v name="$1" '$1 == "#define" && $2 == name { print $3 }' "$parser"
+}
+
+# Lines of a generated table, from its declaration to the closing brace.
+table() {
+    awk -v start="$1" 'index($0, start) == 1 { inside = 1; next } inside && /^};/ { exit } inside' "$parser"
+}
+
+count_cases() {
+    table "static bool $1(" | grep -c '^    case [0-9]*:' || true
+}
+
+printf '%-26s %s\n' \
+    "states" "$(define STATE_COUNT)" \
+    "large states" "$(define LARGE_STATE_COUNT)" \
+    "symbols" "$(define SYMBOL_COUNT)" \
+    "tokens" "$(define TOKEN_COUNT)" \
+    "external tokens" "$(define EXTERNAL_TOKEN_COUNT)" \
+    "productions" "$(define PRODUCTION_ID_COUNT)" \
+    "lex states" "$(count_cases ts_lex)" \
+    "keyword lex states" "$(count_cases ts_lex_keywords)" \
+    "parse action entries" "$(table 'static const TSParseActionEntry ts_parse_actions[]' | grep -c '\.entry')" \
+    "conflicting entries" "$(table 'static const TSParseActionEntry ts_parse_actions[]' | grep '\.count = [2-9]' | grep -vc 'SHIFT_REPEAT' || true)"
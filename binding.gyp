@@ -7,13 +7,18 @@
       ],
       "include_dirs": [
         "src",
+        "bindings/c",
       ],
       "sources": [
         "bindings/node/binding.cc",
+        "bindings/c/cooklang_cache.c",
         "src/parser.c",
         "src/scanner.c"
       ],
       "conditions": [
+        ["<!(node -p \"process.env.COOKLANG_SCANNER_STATS ? 1 : 0\")==1", {
+          "defines": ["COOKLANG_SCANNER_STATS"],
+        }],
         ["OS!='win'", {
           "cflags_c": [
             "-std=c11",
@@ -0,0 +1,233 @@
+#include "cooklang_arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+#define ARENA_ALIGNMENT 16
+#define DEFAULT_BLOCK_SIZE ((size_t)1 << 20)
+
+static inline size_t align_up(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// Every pointer handed out by the hooks is preceded by a header, so that
+// free and realloc can tell arena memory from system memory.
+typedef union {
+    struct {
+        size_t size;
+        CooklangArena *arena;
+    } info;
+    unsigned char padding[ARENA_ALIGNMENT];
+} Header;
+
+typedef struct Block {
+    struct Block *next;
+    size_t size;
+    size_t used;
+} Block;
+
+#define BLOCK_HEADER_SIZE align_up(sizeof(Block))
+
+struct CooklangArena {
+    Block *blocks;
+    size_t block_size;
+    Header *last;
+    CooklangArenaStats stats;
+};
+
+static THREAD_LOCAL CooklangArena *active_arena;
+
+static inline unsigned char *block_data(Block *block) {
+    return (unsigned char *)block + BLOCK_HEADER_SIZE;
+}
+
+static inline Header *header_of(void *pointer) {
+    return (Header *)pointer - 1;
+}
+
+static Block *block_new(CooklangArena *arena, size_t min_size) {
+    size_t size = arena->block_size;
+    if (size < min_size) {
+        size = min_size;
+    }
+    Block *block = malloc(BLOCK_HEADER_SIZE + size);
+    if (!block) {
+        return NULL;
+    }
+    block->next = arena->blocks;
+    block->size = size;
+    block->used = 0;
+    arena->blocks = block;
+    arena->stats.bytes_reserved += size;
+    arena->stats.blocks++;
+    return block;
+}
+
+static void *arena_alloc(CooklangArena *arena, size_t size) {
+    size_t total = align_up(sizeof(Header) + size);
+    if (total < size) {
+        return NULL;
+    }
+    Block *block = arena->blocks;
+    if (!block || block->size - block->used < total) {
+        block = block_new(arena, total);
+        if (!block) {
+            return NULL;
+        }
+    }
+    Header *header = (Header *)(block_data(block) + block->used);
+    block->used += total;
+    header->info.size = size;
+    header->info.arena = arena;
+    arena->last = header;
+    arena->stats.allocations++;
+    arena->stats.bytes_requested += size;
+    return header + 1;
+}
+
+// The most recent allocation can grow or shrink in place.
+static bool arena_resize_last(CooklangArena *arena, Header *header, size_t size) {
+    Block *block = arena->blocks;
+    if (header != arena->last || !block) {
+        return false;
+    }
+    size_t offset = (size_t)((unsigned char *)header - block_data(block));
+    size_t total = align_up(sizeof(Header) + size);
+    if (total < size || offset + total > block->size) {
+        return false;
+    }
+    block->used = offset + total;
+    arena->stats.bytes_requested += size > header->info.size ? size - header->info.size : 0;
+    header->info.size = size;
+    return true;
+}
+
+static void *system_alloc(size_t size) {
+    if (sizeof(Header) + size < size) {
+        return NULL;
+    }
+    Header *header = malloc(sizeof(Header) + size);
+    if (!header) {
+        return NULL;
+    }
+    header->info.size = size;
+    header->info.arena = NULL;
+    return header + 1;
+}
+
+CooklangArena *cooklang_arena_new(size_t block_size) {
+    CooklangArena *arena = calloc(1, sizeof(CooklangArena));
+    if (arena) {
+        arena->block_size = block_size ? block_size : DEFAULT_BLOCK_SIZE;
+    }
+    return arena;
+}
+
+void cooklang_arena_delete(CooklangArena *arena) {
+    if (!arena) {
+        return;
+    }
+    if (active_arena == arena) {
+        active_arena = NULL;
+    }
+    Block *block = arena->blocks;
+    while (block) {
+        Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+CooklangArena *cooklang_arena_activate(CooklangArena *arena) {
+    CooklangArena *previous = active_arena;
+    active_arena = arena;
+    return previous;
+}
+
+void cooklang_arena_reset(CooklangArena *arena) {
+    Block *block = arena->blocks;
+    if (!block) {
+        return;
+    }
+    while (block->next) {
+        Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    block->used = 0;
+    arena->blocks = block;
+    arena->last = NULL;
+    memset(&arena->stats, 0, sizeof(arena->stats));
+    arena->stats.bytes_reserved = block->size;
+    arena->stats.blocks = 1;
+}
+
+CooklangArenaStats cooklang_arena_stats(const CooklangArena *arena) {
+    return arena->stats;
+}
+
+void *cooklang_arena_malloc(size_t size) {
+    return active_arena ? arena_alloc(active_arena, size) : system_alloc(size);
+}
+
+void *cooklang_arena_calloc(size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *pointer = cooklang_arena_malloc(count * size);
+    if (pointer) {
+        memset(pointer, 0, count * size);
+    }
+    return pointer;
+}
+
+void *cooklang_arena_realloc(void *pointer, size_t size) {
+    if (!pointer) {
+        return cooklang_arena_malloc(size);
+    }
+    Header *header = header_of(pointer);
+    CooklangArena *arena = header->info.arena;
+    if (!arena) {
+        if (sizeof(Header) + size < size) {
+            return NULL;
+        }
+        header = realloc(header, sizeof(Header) + size);
+        if (!header) {
+            return NULL;
+        }
+        header->info.size = size;
+        return header + 1;
+    }
+
+    if (arena_resize_last(arena, header, size)) {
+        return pointer;
+    }
+    void *copy = arena_alloc(arena, size);
+    if (copy) {
+        memcpy(copy, pointer, header->info.size < size ? header->info.size : size);
+    }
+    return copy;
+}
+
+void cooklang_arena_free(void *pointer) {
+    if (!pointer) {
+        return;
+    }
+    Header *header = header_of(pointer);
+    CooklangArena *arena = header->info.arena;
+    if (!arena) {
+        free(header);
+    } else if (header == arena->last) {
+        // Give the most recent allocation back to its block.
+        arena->blocks->used = (size_t)((unsigned char *)header - block_data(arena->blocks));
+        arena->last = NULL;
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef COOKLANG_ARENA_H_
+#define COOKLANG_ARENA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-batch arena allocation for tree-sitter.
+//
+// Install the hooks once, before creating any parser:
+//
+//     ts_set_allocator(cooklang_arena_malloc, cooklang_arena_calloc,
+//                      cooklang_arena_realloc, cooklang_arena_free);
+//
+// Build the grammar with TREE_SITTER_REUSE_ALLOCATOR so that the external
+// scanner allocates through the same hooks. While an arena is active on a
+// thread, every allocation made on that thread is carved out of the arena
+// and freeing it is a no-op; everything is released at once by
+// `cooklang_arena_reset`. Threads without an active arena use the system
+// allocator as usual.
+//
+// Parsers, trees and queries allocated while an arena is active must be
+// deleted before the arena is reset, since the parser keeps its internal
+// buffers across parses.
+
+typedef struct CooklangArena CooklangArena;
+
+typedef struct {
+    size_t allocations;
+    size_t bytes_requested;
+    size_t bytes_reserved;
+    size_t blocks;
+} CooklangArenaStats;
+
+// `block_size` is the size of each chunk requested from the system; 0
+// selects a default of 1 MiB.
+CooklangArena *cooklang_arena_new(size_t block_size);
+void cooklang_arena_delete(CooklangArena *arena);
+
+// Make `arena` the target of this thread's allocations, or restore the
+// system allocator when `arena` is NULL. Returns the previously active
+// arena.
+CooklangArena *cooklang_arena_activate(CooklangArena *arena);
+
+// Release everything allocated from `arena`, keeping the first block for
+// the next batch.
+void cooklang_arena_reset(CooklangArena *arena);
+
+CooklangArenaStats cooklang_arena_stats(const CooklangArena *arena);
+
+void *cooklang_arena_malloc(size_t size);
+void *cooklang_arena_calloc(size_t count, size_t size);
+void *cooklang_arena_realloc(void *pointer, size_t size);
+void cooklang_arena_free(void *pointer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_ARENA_H_
@@ -0,0 +1,281 @@
+#include "cooklang_cache.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK Lock;
+#define lock_init(lock) InitializeSRWLock(lock)
+#define lock_destroy(lock) ((void)(lock))
+#define lock_acquire(lock) AcquireSRWLockExclusive(lock)
+#define lock_release(lock) ReleaseSRWLockExclusive(lock)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t Lock;
+#define lock_init(lock) pthread_mutex_init(lock, NULL)
+#define lock_destroy(lock) pthread_mutex_destroy(lock)
+#define lock_acquire(lock) pthread_mutex_lock(lock)
+#define lock_release(lock) pthread_mutex_unlock(lock)
+#endif
+
+#define INITIAL_SLOT_COUNT 64
+
+typedef struct Entry {
+    CooklangCacheEntry public;
+    uint64_t hash;
+    uint64_t size;
+    uint32_t references;
+    // False once evicted; the entry is freed when its last reference goes.
+    bool cached;
+    // Least recently used list, newest first.
+    struct Entry *newer;
+    struct Entry *older;
+    char key[];
+} Entry;
+
+typedef struct {
+    uint64_t hash;
+    Entry *entry;
+} Slot;
+
+struct CooklangCache {
+    Lock lock;
+    Slot *slots;
+    uint32_t slot_count;
+    Entry *newest;
+    Entry *oldest;
+    uint64_t capacity;
+    CooklangCacheDestroy destroy;
+    void *payload;
+    CooklangCacheStats stats;
+};
+
+static uint64_t hash_key(const char *key, uint32_t length) {
+    return cooklang_fnv64(COOKLANG_FNV64_BASIS, key, length);
+}
+
+CooklangCache *cooklang_cache_new(uint64_t capacity, CooklangCacheDestroy destroy, void *payload) {
+    CooklangCache *cache = calloc(1, sizeof(CooklangCache));
+    if (!cache) {
+        return NULL;
+    }
+    cache->slots = calloc(INITIAL_SLOT_COUNT, sizeof(Slot));
+    if (!cache->slots) {
+        free(cache);
+        return NULL;
+    }
+    lock_init(&cache->lock);
+    cache->slot_count = INITIAL_SLOT_COUNT;
+    cache->capacity = capacity;
+    cache->destroy = destroy;
+    cache->payload = payload;
+    return cache;
+}
+
+static void entry_free(CooklangCache *cache, Entry *entry) {
+    if (cache->destroy) {
+        cache->destroy(entry->public.value, cache->payload);
+    }
+    free(entry);
+}
+
+void cooklang_cache_delete(CooklangCache *cache) {
+    for (Entry *entry = cache->newest, *older; entry; entry = older) {
+        older = entry->older;
+        entry_free(cache, entry);
+    }
+    lock_destroy(&cache->lock);
+    free(cache->slots);
+    free(cache);
+}
+
+// The slot holding `key`, or the empty slot ending its probe sequence.
+static uint32_t find_slot(const CooklangCache *cache, const char *key, uint32_t length,
+                          uint64_t hash) {
+    uint32_t mask = cache->slot_count - 1;
+    uint32_t slot = (uint32_t)hash & mask;
+    for (;;) {
+        const Entry *entry = cache->slots[slot].entry;
+        if (!entry || (cache->slots[slot].hash == hash && entry->public.length == length &&
+                       memcmp(entry->key, key, length) == 0)) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+static bool grow_slots(CooklangCache *cache) {
+    uint32_t slot_count = cache->slot_count * 2;
+    Slot *slots = calloc(slot_count, sizeof(Slot));
+    if (!slots) {
+        return false;
+    }
+    uint32_t mask = slot_count - 1;
+    for (uint32_t i = 0; i < cache->slot_count; i++) {
+        if (cache->slots[i].entry) {
+            uint32_t slot = (uint32_t)cache->slots[i].hash & mask;
+            while (slots[slot].entry) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = cache->slots[i];
+        }
+    }
+    free(cache->slots);
+    cache->slots = slots;
+    cache->slot_count = slot_count;
+    return true;
+}
+
+// Remove `entry` from the slots and shift the rest of its cluster back, so
+// that probe sequences stay unbroken without tombstones.
+static void delete_slot(CooklangCache *cache, const Entry *entry) {
+    uint32_t mask = cache->slot_count - 1;
+    uint32_t slot = (uint32_t)entry->hash & mask;
+    while (cache->slots[slot].entry != entry) {
+        slot = (slot + 1) & mask;
+    }
+    uint32_t next = slot;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (!cache->slots[next].entry) {
+            break;
+        }
+        uint32_t home = (uint32_t)cache->slots[next].hash & mask;
+        // Move the slot back unless its home lies cyclically in (slot, next].
+        bool stays = slot <= next ? slot < home && home <= next : slot < home || home <= next;
+        if (!stays) {
+            cache->slots[slot] = cache->slots[next];
+            slot = next;
+        }
+    }
+    cache->slots[slot].entry = NULL;
+}
+
+static void unlink_entry(CooklangCache *cache, Entry *entry) {
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        cache->newest = entry->older;
+    }
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        cache->oldest = entry->newer;
+    }
+}
+
+static void link_newest(CooklangCache *cache, Entry *entry) {
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if (cache->newest) {
+        cache->newest->newer = entry;
+    } else {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+}
+
+CooklangCacheEntry *cooklang_cache_lookup(CooklangCache *cache, const char *key, uint32_t length) {
+    uint64_t hash = hash_key(key, length);
+    lock_acquire(&cache->lock);
+    Entry *entry = cache->slots[find_slot(cache, key, length, hash)].entry;
+    if (entry) {
+        entry->references++;
+        if (cache->newest != entry) {
+            unlink_entry(cache, entry);
+            link_newest(cache, entry);
+        }
+        cache->stats.hits++;
+    } else {
+        cache->stats.misses++;
+    }
+    lock_release(&cache->lock);
+    return entry ? &entry->public : NULL;
+}
+
+CooklangCacheEntry *cooklang_cache_insert(CooklangCache *cache, const char *key, uint32_t length,
+                                          void *value, uint64_t size) {
+    Entry *entry = malloc(sizeof(Entry) + length + 1);
+    if (!entry) {
+        if (cache->destroy) {
+            cache->destroy(value, cache->payload);
+        }
+        return NULL;
+    }
+    memcpy(entry->key, key, length);
+    entry->key[length] = '\0';
+    entry->public.key = entry->key;
+    entry->public.length = length;
+    entry->public.value = value;
+    entry->hash = hash_key(key, length);
+    entry->size = size + length;
+    entry->references = 1;
+    entry->cached = true;
+
+    lock_acquire(&cache->lock);
+    uint32_t slot = find_slot(cache, key, length, entry->hash);
+    Entry *existing = cache->slots[slot].entry;
+    if (existing) {
+        existing->references++;
+        lock_release(&cache->lock);
+        entry_free(cache, entry);
+        return &existing->public;
+    }
+    if ((cache->stats.entries + 1) * 4 > (uint64_t)cache->slot_count * 3) {
+        if (!grow_slots(cache)) {
+            lock_release(&cache->lock);
+            entry_free(cache, entry);
+            return NULL;
+        }
+        slot = find_slot(cache, key, length, entry->hash);
+    }
+    cache->slots[slot].hash = entry->hash;
+    cache->slots[slot].entry = entry;
+    link_newest(cache, entry);
+    cache->stats.entries++;
+    cache->stats.bytes += entry->size;
+
+    // Evict from the old end; values nobody holds are destroyed once the
+    // lock is released. An entry larger than the capacity evicts itself and
+    // lives only as long as the caller's reference.
+    Entry *garbage = NULL;
+    while (cache->stats.bytes > cache->capacity) {
+        Entry *victim = cache->oldest;
+        unlink_entry(cache, victim);
+        delete_slot(cache, victim);
+        victim->cached = false;
+        cache->stats.entries--;
+        cache->stats.bytes -= victim->size;
+        cache->stats.evictions++;
+        if (!victim->references) {
+            victim->older = garbage;
+            garbage = victim;
+        }
+    }
+    lock_release(&cache->lock);
+
+    while (garbage) {
+        Entry *next = garbage->older;
+        entry_free(cache, garbage);
+        garbage = next;
+    }
+    return &entry->public;
+}
+
+void cooklang_cache_release(CooklangCache *cache, CooklangCacheEntry *public) {
+    Entry *entry = (Entry *)public;
+    lock_acquire(&cache->lock);
+    bool dead = --entry->references == 0 && !entry->cached;
+    lock_release(&cache->lock);
+    if (dead) {
+        entry_free(cache, entry);
+    }
+}
+
+void cooklang_cache_stats(CooklangCache *cache, CooklangCacheStats *stats) {
+    lock_acquire(&cache->lock);
+    *stats = cache->stats;
+    lock_release(&cache->lock);
+}
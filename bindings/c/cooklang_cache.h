@@ -0,0 +1,76 @@
+#ifndef COOKLANG_CACHE_H_
+#define COOKLANG_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A content-addressed cache shared between threads.
+//
+// Values are keyed by the bytes they were computed from, so the same recipe
+// text maps to the same value however it arrived: a 64-bit hash finds the
+// entry and the bytes are compared to confirm it. Every entry is charged its
+// key plus the size given for its value; once the total passes the capacity
+// the least recently used entries are evicted. A looked-up entry stays
+// alive until it is released, even if it is evicted in the meantime.
+//
+// The cache takes a lock for the duration of each call, never while a value
+// is computed or destroyed; compute values between a missed lookup and the
+// insert.
+
+// Estimated bytes per syntax node, for charging parsed trees against the
+// capacity.
+#define COOKLANG_CACHE_NODE_BYTES 64
+
+typedef struct CooklangCache CooklangCache;
+
+typedef struct CooklangCacheEntry {
+    // The bytes the value was computed from, followed by a NUL; read-only.
+    const char *key;
+    uint32_t length;
+    void *value;
+} CooklangCacheEntry;
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    // Entries currently cached and the bytes charged for them.
+    uint64_t entries;
+    uint64_t bytes;
+} CooklangCacheStats;
+
+// Called with each value once its entry is evicted or replaced and no longer
+// referenced.
+typedef void (*CooklangCacheDestroy)(void *value, void *payload);
+
+// A cache holding up to `capacity` bytes, or NULL if memory ran out.
+CooklangCache *cooklang_cache_new(uint64_t capacity, CooklangCacheDestroy destroy, void *payload);
+
+// Destroy the cache and its values. Every looked-up entry must have been
+// released.
+void cooklang_cache_delete(CooklangCache *cache);
+
+// The entry for `length` bytes of `key`, referenced until released, or NULL
+// on a miss.
+CooklangCacheEntry *cooklang_cache_lookup(CooklangCache *cache, const char *key, uint32_t length);
+
+// Cache `value`, charged `size` bytes plus the key, for `length` bytes of
+// `key`, and return its entry referenced. If another thread cached the same
+// key first, `value` is destroyed and that entry is returned instead. On
+// running out of memory, `value` is destroyed and NULL returned.
+CooklangCacheEntry *cooklang_cache_insert(CooklangCache *cache, const char *key, uint32_t length,
+                                          void *value, uint64_t size);
+
+void cooklang_cache_release(CooklangCache *cache, CooklangCacheEntry *entry);
+
+void cooklang_cache_stats(CooklangCache *cache, CooklangCacheStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_CACHE_H_
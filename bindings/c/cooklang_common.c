@@ -0,0 +1,28 @@
+#include "cooklang_common.h"
+
+void cooklang_symbols_init(CooklangSymbols *symbols, const TSLanguage *language) {
+    *symbols = (CooklangSymbols){
+        COOKLANG_SYMBOL(language, "frontmatter"),
+        COOKLANG_SYMBOL(language, "frontmatter_content"),
+        COOKLANG_SYMBOL(language, "metadata"),
+        COOKLANG_SYMBOL(language, "metadata_key"),
+        COOKLANG_SYMBOL(language, "metadata_value"),
+        COOKLANG_SYMBOL(language, "section"),
+        COOKLANG_SYMBOL(language, "section_name"),
+        COOKLANG_SYMBOL(language, "step"),
+        COOKLANG_SYMBOL(language, "text"),
+        COOKLANG_SYMBOL(language, "ingredient"),
+        COOKLANG_SYMBOL(language, "ingredient_name"),
+        COOKLANG_SYMBOL(language, "cookware"),
+        COOKLANG_SYMBOL(language, "cookware_name"),
+        COOKLANG_SYMBOL(language, "timer"),
+        COOKLANG_SYMBOL(language, "timer_name"),
+        COOKLANG_SYMBOL(language, "quantity"),
+        COOKLANG_SYMBOL(language, "note"),
+        COOKLANG_SYMBOL(language, "note_content"),
+        COOKLANG_SYMBOL(language, "recipe_note"),
+        COOKLANG_SYMBOL(language, "recipe_note_text"),
+        COOKLANG_SYMBOL(language, "comment"),
+        COOKLANG_SYMBOL(language, "block_comment"),
+    };
+}
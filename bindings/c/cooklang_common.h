@@ -0,0 +1,99 @@
+#ifndef COOKLANG_COMMON_H_
+#define COOKLANG_COMMON_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Small helpers shared by the library sources. Internal.
+
+static inline bool cooklang_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline char cooklang_to_lower(char c) {
+    return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+// Trim, collapse runs of whitespace to one space and lowercase ASCII, the
+// way names are compared across recipes. Returns the length written to
+// `out`, which is at most `length`.
+static inline uint32_t cooklang_normalize(const char *text, uint32_t length, char *out) {
+    uint32_t written = 0;
+    bool pending_space = false;
+    for (uint32_t i = 0; i < length; i++) {
+        char c = text[i];
+        if (cooklang_is_space(c)) {
+            pending_space = written > 0;
+            continue;
+        }
+        if (pending_space) {
+            out[written++] = ' ';
+            pending_space = false;
+        }
+        out[written++] = cooklang_to_lower(c);
+    }
+    return written;
+}
+
+// FNV-1a over `length` bytes. Start from the basis; a hash over several
+// pieces passes the result of one call as `hash` to the next.
+#define COOKLANG_FNV32_BASIS 2166136261u
+#define COOKLANG_FNV64_BASIS 14695981039346656037u
+
+static inline uint32_t cooklang_fnv32(uint32_t hash, const char *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static inline uint64_t cooklang_fnv64(uint64_t hash, const char *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * 1099511628211u;
+    }
+    return hash;
+}
+
+// The named symbol `name`, a string literal, in `language`.
+#define COOKLANG_SYMBOL(language, name) \
+    ts_language_symbol_for_name(language, name, sizeof(name) - 1, true)
+
+// The named symbols the tree walkers look for, resolved once per walk.
+typedef struct {
+    TSSymbol frontmatter;
+    TSSymbol frontmatter_content;
+    TSSymbol metadata;
+    TSSymbol metadata_key;
+    TSSymbol metadata_value;
+    TSSymbol section;
+    TSSymbol section_name;
+    TSSymbol step;
+    TSSymbol text;
+    TSSymbol ingredient;
+    TSSymbol ingredient_name;
+    TSSymbol cookware;
+    TSSymbol cookware_name;
+    TSSymbol timer;
+    TSSymbol timer_name;
+    TSSymbol quantity;
+    TSSymbol note;
+    TSSymbol note_content;
+    TSSymbol recipe_note;
+    TSSymbol recipe_note_text;
+    TSSymbol comment;
+    TSSymbol block_comment;
+} CooklangSymbols;
+
+void cooklang_symbols_init(CooklangSymbols *symbols, const TSLanguage *language);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_COMMON_H_
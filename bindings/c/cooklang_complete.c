@@ -0,0 +1,393 @@
+#include "cooklang_complete.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NO_NODE UINT32_MAX
+#define ROOT 0
+
+// Normalize a prefix like a name, except that trailing whitespace becomes
+// one space rather than going away: `olive ` should not offer `olives`.
+static uint32_t normalize_prefix(const char *text, uint32_t length, char *out) {
+    uint32_t written = cooklang_normalize(text, length, out);
+    if (written > 0 && cooklang_is_space(text[length - 1])) {
+        out[written++] = ' ';
+    }
+    return written;
+}
+
+void cooklang_completions_init(CooklangCompletions *completions) {
+    memset(completions, 0, sizeof(*completions));
+    cooklang_intern_table_init(&completions->names, true);
+}
+
+void cooklang_completions_free(CooklangCompletions *completions) {
+    cooklang_intern_table_free(&completions->names);
+    for (uint32_t kind = 0; kind < COOKLANG_COMPLETION_KIND_COUNT; kind++) {
+        free(completions->tries[kind].nodes);
+        free(completions->tries[kind].counts);
+    }
+    cooklang_completions_init(completions);
+}
+
+static inline uint8_t first_byte(const CooklangCompletions *completions,
+                                 const CooklangCompletionNode *node) {
+    return (uint8_t)completions->names.strings[node->label];
+}
+
+static uint32_t new_node(CooklangCompletionTrie *trie, uint32_t label, uint32_t label_length,
+                         uint32_t parent) {
+    if (trie->length == trie->capacity) {
+        if (trie->capacity >= NO_NODE / 2) {
+            return NO_NODE;
+        }
+        uint32_t capacity = trie->capacity ? trie->capacity * 2 : 64;
+        CooklangCompletionNode *nodes = realloc(trie->nodes, capacity * sizeof(*nodes));
+        if (!nodes) {
+            return NO_NODE;
+        }
+        trie->nodes = nodes;
+        trie->capacity = capacity;
+    }
+    trie->nodes[trie->length] = (CooklangCompletionNode){
+        .label = label,
+        .label_length = label_length,
+        .parent = parent,
+        .first_child = NO_NODE,
+        .next_sibling = NO_NODE,
+        .name = COOKLANG_INTERN_NONE,
+        .best = 0,
+    };
+    return trie->length++;
+}
+
+static bool reserve_counts(CooklangCompletionTrie *trie, uint32_t length) {
+    if (length <= trie->count_capacity) {
+        return true;
+    }
+    uint32_t capacity = trie->count_capacity ? trie->count_capacity : 64;
+    while (capacity < length) {
+        capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2;
+    }
+    uint32_t *counts = realloc(trie->counts, capacity * sizeof(uint32_t));
+    if (!counts) {
+        return false;
+    }
+    memset(counts + trie->count_capacity, 0, (capacity - trie->count_capacity) * sizeof(uint32_t));
+    trie->counts = counts;
+    trie->count_capacity = capacity;
+    return true;
+}
+
+// The node where the name `id` ends, added to the trie with whatever edges
+// and splits it needs. Returns NO_NODE if memory ran out.
+static uint32_t insert(const CooklangCompletions *completions, CooklangCompletionTrie *trie,
+                       uint32_t id) {
+    if (trie->length == 0 && new_node(trie, 0, 0, NO_NODE) == NO_NODE) {
+        return NO_NODE;
+    }
+    uint32_t length;
+    const char *name = cooklang_intern_name(&completions->names, id, &length);
+    uint32_t offset = (uint32_t)(name - completions->names.strings);
+    uint32_t node = ROOT, depth = 0;
+    while (depth < length) {
+        // The child starting with the next byte, or where it would go.
+        uint8_t next = (uint8_t)name[depth];
+        uint32_t previous = NO_NODE, child = trie->nodes[node].first_child;
+        while (child != NO_NODE && first_byte(completions, &trie->nodes[child]) < next) {
+            previous = child;
+            child = trie->nodes[child].next_sibling;
+        }
+        uint32_t inserted = NO_NODE;
+        if (child == NO_NODE || first_byte(completions, &trie->nodes[child]) != next) {
+            inserted = new_node(trie, offset + depth, length - depth, node);
+            if (inserted == NO_NODE) {
+                return NO_NODE;
+            }
+            trie->nodes[inserted].next_sibling = child;
+            depth = length;
+        } else {
+            const char *label = completions->names.strings + trie->nodes[child].label;
+            uint32_t label_length = trie->nodes[child].label_length;
+            uint32_t common = 1;
+            while (common < label_length && depth + common < length &&
+                   label[common] == name[depth + common]) {
+                common++;
+            }
+            depth += common;
+            if (common == label_length) {
+                node = child;
+                continue;
+            }
+            // The name leaves the edge partway: a new node takes the shared
+            // bytes and the old child hangs below it with the rest.
+            inserted = new_node(trie, trie->nodes[child].label, common, node);
+            if (inserted == NO_NODE) {
+                return NO_NODE;
+            }
+            CooklangCompletionNode *nodes = trie->nodes;
+            nodes[inserted].first_child = child;
+            nodes[inserted].next_sibling = nodes[child].next_sibling;
+            nodes[inserted].best = nodes[child].best;
+            nodes[child].label += common;
+            nodes[child].label_length -= common;
+            nodes[child].parent = inserted;
+            nodes[child].next_sibling = NO_NODE;
+        }
+        if (previous == NO_NODE) {
+            trie->nodes[node].first_child = inserted;
+        } else {
+            trie->nodes[previous].next_sibling = inserted;
+        }
+        node = inserted;
+    }
+    return node;
+}
+
+// Recompute `best` from `node` up after a count went down, stopping at
+// the first node it leaves unchanged: nothing above depends on anything
+// else that changed.
+static void update_best(CooklangCompletionTrie *trie, uint32_t node) {
+    while (node != NO_NODE) {
+        CooklangCompletionNode *current = &trie->nodes[node];
+        uint32_t best = current->name != COOKLANG_INTERN_NONE ? trie->counts[current->name] : 0;
+        for (uint32_t child = current->first_child; child != NO_NODE;
+             child = trie->nodes[child].next_sibling) {
+            if (trie->nodes[child].best > best) {
+                best = trie->nodes[child].best;
+            }
+        }
+        if (best == current->best) {
+            return;
+        }
+        current->best = best;
+        node = current->parent;
+    }
+}
+
+bool cooklang_completions_add(CooklangCompletions *completions, CooklangEntityKind kind,
+                              const char *name, uint32_t length, int32_t delta) {
+    if ((unsigned)kind >= COOKLANG_COMPLETION_KIND_COUNT || delta == 0) {
+        return true;
+    }
+    CooklangCompletionTrie *trie = &completions->tries[kind];
+    uint32_t id = delta > 0 ? cooklang_intern(&completions->names, name, length)
+                            : cooklang_intern_find(&completions->names, name, length);
+    if (id == COOKLANG_INTERN_NONE) {
+        // Removing a name that was never added is not an error.
+        return delta < 0;
+    }
+    uint32_t name_length;
+    cooklang_intern_name(&completions->names, id, &name_length);
+    if (name_length == 0) {
+        return true;
+    }
+    if (!reserve_counts(trie, completions->names.length)) {
+        return false;
+    }
+    uint32_t count = trie->counts[id];
+    if (delta < 0 && count == 0) {
+        return true;
+    }
+    uint32_t node = insert(completions, trie, id);
+    if (node == NO_NODE) {
+        return false;
+    }
+    if (delta > 0) {
+        count = count > UINT32_MAX - (uint32_t)delta ? UINT32_MAX : count + (uint32_t)delta;
+    } else {
+        uint32_t removed = (uint32_t)(-(int64_t)delta);
+        count = count > removed ? count - removed : 0;
+    }
+    trie->nodes[node].name = id;
+    trie->counts[id] = count;
+    if (delta > 0) {
+        // A higher count only raises `best`, with no children to look at.
+        for (; node != NO_NODE && trie->nodes[node].best < count; node = trie->nodes[node].parent) {
+            trie->nodes[node].best = count;
+        }
+    } else {
+        update_best(trie, node);
+    }
+    return true;
+}
+
+bool cooklang_completions_add_entities(CooklangCompletions *completions, const char *source,
+                                       const CooklangEntityList *entities, int32_t delta) {
+    for (uint32_t i = 0; i < entities->length; i++) {
+        const CooklangEntity *entity = &entities->entities[i];
+        if (entity->kind < COOKLANG_COMPLETION_KIND_COUNT && entity->name.end > entity->name.start &&
+            !cooklang_completions_add(completions, (CooklangEntityKind)entity->kind,
+                                      source + entity->name.start,
+                                      entity->name.end - entity->name.start, delta)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A subtree still to expand, or a name ready to report, ranked by `key`:
+// the subtree's best count or the name's count.
+typedef struct {
+    uint32_t node;
+    uint32_t key;
+    // Bytes from the root to the end of the node's label.
+    uint32_t depth;
+    bool is_name;
+} Candidate;
+
+typedef struct {
+    const CooklangCompletions *completions;
+    const CooklangCompletionTrie *trie;
+    Candidate *items;
+    uint32_t length;
+    uint32_t capacity;
+} Queue;
+
+// Whether `a` comes out before `b`: a higher count, or the same count and a
+// path that sorts first. Every name under a node starts with the node's
+// path, and a node's own name sorts before those of its children, so among
+// equal counts names come out in alphabetical order.
+static bool ranks_before(const Queue *queue, const Candidate *a, const Candidate *b) {
+    if (a->key != b->key) {
+        return a->key > b->key;
+    }
+    const CooklangCompletionNode *x = &queue->trie->nodes[a->node];
+    const CooklangCompletionNode *y = &queue->trie->nodes[b->node];
+    // A label points into a name that runs through its node, so the node's
+    // path is the `depth` bytes before the label's end.
+    const char *strings = queue->completions->names.strings;
+    uint32_t shorter = a->depth < b->depth ? a->depth : b->depth;
+    int order = memcmp(strings + x->label + x->label_length - a->depth,
+                       strings + y->label + y->label_length - b->depth, shorter);
+    return order != 0 ? order < 0 : a->depth < b->depth;
+}
+
+static bool push(Queue *queue, Candidate candidate) {
+    if (queue->length == queue->capacity) {
+        uint32_t capacity = queue->capacity ? queue->capacity * 2 : 64;
+        Candidate *items = realloc(queue->items, capacity * sizeof(Candidate));
+        if (!items) {
+            return false;
+        }
+        queue->items = items;
+        queue->capacity = capacity;
+    }
+    uint32_t i = queue->length++;
+    while (i > 0 && ranks_before(queue, &candidate, &queue->items[(i - 1) / 2])) {
+        queue->items[i] = queue->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    queue->items[i] = candidate;
+    return true;
+}
+
+static Candidate pop(Queue *queue) {
+    Candidate top = queue->items[0];
+    Candidate last = queue->items[--queue->length];
+    uint32_t i = 0;
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= queue->length) {
+            break;
+        }
+        if (child + 1 < queue->length &&
+            ranks_before(queue, &queue->items[child + 1], &queue->items[child])) {
+            child++;
+        }
+        if (!ranks_before(queue, &queue->items[child], &last)) {
+            break;
+        }
+        queue->items[i] = queue->items[child];
+        i = child;
+    }
+    queue->items[i] = last;
+    return top;
+}
+
+// The node whose path is the shortest one starting with `prefix`, and its
+// depth, or NO_NODE if no name starts with it.
+static uint32_t find_prefix(const CooklangCompletions *completions,
+                            const CooklangCompletionTrie *trie, const char *prefix,
+                            uint32_t length, uint32_t *depth) {
+    uint32_t node = ROOT;
+    *depth = 0;
+    while (*depth < length) {
+        uint8_t next = (uint8_t)prefix[*depth];
+        uint32_t child = trie->nodes[node].first_child;
+        while (child != NO_NODE && first_byte(completions, &trie->nodes[child]) < next) {
+            child = trie->nodes[child].next_sibling;
+        }
+        if (child == NO_NODE || first_byte(completions, &trie->nodes[child]) != next) {
+            return NO_NODE;
+        }
+        const CooklangCompletionNode *edge = &trie->nodes[child];
+        uint32_t compared = length - *depth < edge->label_length ? length - *depth
+                                                                 : edge->label_length;
+        if (memcmp(completions->names.strings + edge->label, prefix + *depth, compared) != 0) {
+            return NO_NODE;
+        }
+        node = child;
+        *depth += edge->label_length;
+    }
+    return node;
+}
+
+int32_t cooklang_complete(const CooklangCompletions *completions, CooklangEntityKind kind,
+                          const char *prefix, uint32_t length, CooklangCompletion *results,
+                          uint32_t max_results) {
+    if ((unsigned)kind >= COOKLANG_COMPLETION_KIND_COUNT || max_results == 0) {
+        return 0;
+    }
+    const CooklangCompletionTrie *trie = &completions->tries[kind];
+    if (trie->length == 0) {
+        return 0;
+    }
+    if (max_results > INT32_MAX) {
+        max_results = INT32_MAX;
+    }
+    // Normalizing adds at most one byte, so short prefixes need no heap.
+    char stack[256];
+    char *key = length < sizeof(stack) ? stack : malloc((size_t)length + 1);
+    if (!key) {
+        return -1;
+    }
+    uint32_t key_length = normalize_prefix(prefix, length, key);
+    uint32_t depth;
+    uint32_t start = find_prefix(completions, trie, key, key_length, &depth);
+    if (key != stack) {
+        free(key);
+    }
+    if (start == NO_NODE || trie->nodes[start].best == 0) {
+        return 0;
+    }
+
+    Queue queue = {completions, trie, NULL, 0, 0};
+    uint32_t found = 0;
+    bool ok = push(&queue, (Candidate){start, trie->nodes[start].best, depth, false});
+    while (ok && found < max_results && queue.length > 0) {
+        Candidate candidate = pop(&queue);
+        const CooklangCompletionNode *node = &trie->nodes[candidate.node];
+        if (candidate.is_name) {
+            CooklangCompletion *result = &results[found++];
+            result->name = cooklang_intern_name(&completions->names, node->name, &result->length);
+            result->count = candidate.key;
+            continue;
+        }
+        if (node->name != COOKLANG_INTERN_NONE && trie->counts[node->name] > 0) {
+            ok = push(&queue, (Candidate){candidate.node, trie->counts[node->name],
+                                          candidate.depth, true});
+        }
+        for (uint32_t child = node->first_child; ok && child != NO_NODE;
+             child = trie->nodes[child].next_sibling) {
+            const CooklangCompletionNode *next = &trie->nodes[child];
+            if (next->best > 0) {
+                ok = push(&queue, (Candidate){child, next->best,
+                                              candidate.depth + next->label_length, false});
+            }
+        }
+    }
+    free(queue.items);
+    return ok ? (int32_t)found : -1;
+}
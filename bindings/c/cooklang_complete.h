@@ -0,0 +1,97 @@
+#ifndef COOKLANG_COMPLETE_H_
+#define COOKLANG_COMPLETE_H_
+
+#include "cooklang_extract.h"
+#include "cooklang_intern.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Prefix completion of ingredient, cookware and timer names across a
+// collection, ranked by how often each name occurs.
+//
+// Names are normalized as in a normalizing intern table (cooklang_intern.h)
+// and kept in one compressed trie per kind. Edges are labelled with runs of
+// bytes pointing into the interned names, so a trie adds no copies of them.
+// Every node records the highest count under it, and a lookup walks down to
+// the prefix, then expands the most frequent subtrees first. It stops after
+// visiting about as many nodes as the results it returns, however many
+// names share the prefix.
+//
+// Counts are kept up to date by adding a recipe's entities when it is
+// indexed and subtracting them before it is reparsed or dropped. Names
+// whose count falls to zero stay in the trie but are no longer suggested.
+// Not thread-safe.
+
+#define COOKLANG_COMPLETION_KIND_COUNT 3
+
+typedef struct {
+    // Edge label: `label_length` bytes at offset `label` in the name
+    // table's strings.
+    uint32_t label;
+    uint32_t label_length;
+    uint32_t parent;
+    uint32_t first_child;
+    uint32_t next_sibling;
+    // The name ending at this node, or COOKLANG_INTERN_NONE.
+    uint32_t name;
+    // The highest count of any name at or under this node.
+    uint32_t best;
+} CooklangCompletionNode;
+
+typedef struct {
+    // Node 0 is the root. Children are sorted by their first byte.
+    CooklangCompletionNode *nodes;
+    uint32_t length;
+    uint32_t capacity;
+    // Occurrences of each name as this kind, indexed by name id.
+    uint32_t *counts;
+    uint32_t count_capacity;
+} CooklangCompletionTrie;
+
+typedef struct {
+    CooklangInternTable names;
+    // Indexed by COOKLANG_ENTITY_INGREDIENT, _COOKWARE and _TIMER.
+    CooklangCompletionTrie tries[COOKLANG_COMPLETION_KIND_COUNT];
+} CooklangCompletions;
+
+typedef struct {
+    // Normalized and NUL-terminated, valid until the completions change.
+    const char *name;
+    uint32_t length;
+    uint32_t count;
+} CooklangCompletion;
+
+void cooklang_completions_init(CooklangCompletions *completions);
+void cooklang_completions_free(CooklangCompletions *completions);
+
+// Add `delta` occurrences of `length` bytes of `name` as `kind`, which
+// must be an ingredient, cookware or timer; a negative `delta` removes
+// them, down to zero. Returns false if memory ran out.
+bool cooklang_completions_add(CooklangCompletions *completions, CooklangEntityKind kind,
+                              const char *name, uint32_t length, int32_t delta);
+
+// Add `delta` occurrences of every ingredient, cookware and timer name in
+// `entities`, extracted from `source`: 1 when a recipe is indexed, -1 when
+// it goes away. Returns false if memory ran out.
+bool cooklang_completions_add_entities(CooklangCompletions *completions, const char *source,
+                                       const CooklangEntityList *entities, int32_t delta);
+
+// Write up to `max_results` names of `kind` that start with `length`
+// bytes of `prefix`, most frequent first and alphabetically among equal
+// counts. The prefix is normalized like the names, except that trailing
+// whitespace is kept as one space. Returns the number written, or -1 if
+// memory ran out.
+int32_t cooklang_complete(const CooklangCompletions *completions, CooklangEntityKind kind,
+                          const char *prefix, uint32_t length, CooklangCompletion *results,
+                          uint32_t max_results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_COMPLETE_H_
@@ -0,0 +1,434 @@
+#include "cooklang_diff.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Alignment gives up once the nodes between the unchanged ends need more
+// edits than this, and pairs them as they come instead; the trace it keeps
+// grows with the square of the distance.
+#define MAX_DISTANCE 1024
+
+// How far ahead a node looks for its counterpart in the other version:
+// an equal node when aligning greedily, or a changed one when pairing.
+#define PAIR_WINDOW 16
+
+#define UNMATCHED UINT32_MAX
+
+typedef struct {
+    uint8_t kind;
+    // Of the node's text.
+    uint64_t hash;
+    // Of the metadata key or the entity name, which a changed node keeps.
+    uint64_t key;
+    CooklangSpan span;
+    TSNode node;
+} Item;
+
+typedef struct {
+    Item *items;
+    uint32_t length;
+    uint32_t capacity;
+} ItemList;
+
+typedef struct {
+    const CooklangSymbols *symbols;
+    const char *old_source;
+    const char *new_source;
+    CooklangDiffScript *script;
+    bool ok;
+} Differ;
+
+void cooklang_diff_script_init(CooklangDiffScript *script) {
+    script->edits = NULL;
+    script->length = 0;
+    script->capacity = 0;
+}
+
+void cooklang_diff_script_free(CooklangDiffScript *script) {
+    free(script->edits);
+    cooklang_diff_script_init(script);
+}
+
+static CooklangSpan trim(const char *source, CooklangSpan span, char marker) {
+    while (span.start < span.end &&
+           (cooklang_is_space(source[span.start]) || (marker && source[span.start] == marker))) {
+        span.start++;
+    }
+    while (span.end > span.start &&
+           (cooklang_is_space(source[span.end - 1]) ||
+            (marker && source[span.end - 1] == marker))) {
+        span.end--;
+    }
+    return span;
+}
+
+static uint64_t hash_span(const char *source, CooklangSpan span) {
+    return cooklang_fnv64(COOKLANG_FNV64_BASIS, source + span.start, span.end - span.start);
+}
+
+static CooklangSpan node_span(const char *source, TSNode node, char marker) {
+    if (ts_node_is_null(node)) {
+        return (CooklangSpan){0, 0};
+    }
+    return trim(source, (CooklangSpan){ts_node_start_byte(node), ts_node_end_byte(node)}, marker);
+}
+
+// The first child of `node` with `symbol`, or a null node.
+static TSNode child_of(TSNode node, TSSymbol symbol) {
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_child(node, i);
+        if (ts_node_symbol(child) == symbol) {
+            return child;
+        }
+    }
+    return (TSNode){0};
+}
+
+static bool add_item(ItemList *list, const char *source, TSNode node, uint8_t kind,
+                     TSNode key_node, char key_marker) {
+    if (list->length == list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 64;
+        Item *items = realloc(list->items, capacity * sizeof(Item));
+        if (!items) {
+            return false;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    CooklangSpan span = node_span(source, node, 0);
+    list->items[list->length++] = (Item){
+        kind,
+        hash_span(source, span),
+        hash_span(source, node_span(source, key_node, key_marker)),
+        span,
+        node,
+    };
+    return true;
+}
+
+// The children of `parent` that the diff matches: the top-level nodes of a
+// recipe, or the entities of a step.
+static bool collect(const CooklangSymbols *symbols, const char *source, TSNode parent,
+                    ItemList *list) {
+    list->length = 0;
+    bool ok = true;
+    TSTreeCursor cursor = ts_tree_cursor_new(parent);
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+        do {
+            TSNode node = ts_tree_cursor_current_node(&cursor);
+            TSSymbol symbol = ts_node_symbol(node);
+            TSNode none = {0};
+            if (symbol == symbols->frontmatter) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_FRONTMATTER, none, 0);
+            } else if (symbol == symbols->metadata) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_METADATA,
+                              child_of(node, symbols->metadata_key), '>');
+            } else if (symbol == symbols->section) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_SECTION, none, 0);
+            } else if (symbol == symbols->step) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_STEP, none, 0);
+            } else if (symbol == symbols->recipe_note) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_NOTE, none, 0);
+            } else if (symbol == symbols->ingredient) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_INGREDIENT,
+                              child_of(node, symbols->ingredient_name), 0);
+            } else if (symbol == symbols->cookware) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_COOKWARE,
+                              child_of(node, symbols->cookware_name), 0);
+            } else if (symbol == symbols->timer) {
+                ok = add_item(list, source, node, COOKLANG_DIFF_TIMER,
+                              child_of(node, symbols->timer_name), 0);
+            }
+        } while (ok && ts_tree_cursor_goto_next_sibling(&cursor));
+    }
+    ts_tree_cursor_delete(&cursor);
+    return ok;
+}
+
+static inline bool same(const Item *a, const Item *b) {
+    return a->kind == b->kind && a->hash == b->hash &&
+           a->span.end - a->span.start == b->span.end - b->span.start;
+}
+
+// A linear alignment for versions too far apart for align_middle: walking
+// both in step, a node without an equal counterpart at the same point is
+// looked for up to PAIR_WINDOW nodes ahead in the other version.
+static void align_greedy(const Item *a, int32_t n, const Item *b, int32_t m, uint32_t *match,
+                         uint32_t offset) {
+    int32_t x = 0, y = 0;
+    while (x < n && y < m) {
+        int32_t skip_a = -1, skip_b = -1;
+        for (int32_t ahead = 0; ahead <= PAIR_WINDOW && skip_a < 0 && skip_b < 0; ahead++) {
+            if (y + ahead < m && same(&a[x], &b[y + ahead])) {
+                skip_b = ahead;
+            } else if (x + ahead < n && same(&a[x + ahead], &b[y])) {
+                skip_a = ahead;
+            }
+        }
+        if (skip_b >= 0) {
+            y += skip_b;
+        } else if (skip_a >= 0) {
+            x += skip_a;
+        } else {
+            x++;
+            y++;
+            continue;
+        }
+        match[x++] = (uint32_t)y++ + offset;
+    }
+}
+
+// Myers' O(ND) alignment of `a` and `b`, neither of them empty, recording
+// in `match` the index in `b`, plus `offset`, of each node of `a` on the
+// shortest edit path. Past MAX_DISTANCE, align_greedy takes over.
+static bool align_middle(const Item *a, int32_t n, const Item *b, int32_t m, uint32_t *match,
+                         uint32_t offset) {
+    int32_t max = n + m > MAX_DISTANCE ? MAX_DISTANCE : n + m;
+    // The furthest x on each diagonal k = x - y, at index k + max + 1.
+    int32_t *v = malloc((size_t)(2 * max + 3) * sizeof(int32_t));
+    // v for diagonals -d to d after each round d, from trace[d * d] on.
+    int32_t *trace = NULL;
+    size_t trace_capacity = 0;
+    if (!v) {
+        return false;
+    }
+    int32_t *diagonal = v + max + 1;
+    diagonal[1] = 0;
+    int32_t found = -1;
+    bool ok = true;
+    for (int32_t d = 0; d <= max && found < 0 && ok; d++) {
+        for (int32_t k = -d; k <= d; k += 2) {
+            // Down from diagonal k + 1 (an insertion) or right from k - 1
+            // (a deletion), whichever reaches further.
+            bool down = k == -d || (k != d && diagonal[k - 1] < diagonal[k + 1]);
+            int32_t x = down ? diagonal[k + 1] : diagonal[k - 1] + 1;
+            int32_t y = x - k;
+            while (x < n && y < m && same(&a[x], &b[y])) {
+                x++;
+                y++;
+            }
+            diagonal[k] = x;
+            if (x >= n && y >= m) {
+                found = d;
+                break;
+            }
+        }
+        size_t needed = (size_t)(d + 1) * (size_t)(d + 1);
+        if (needed > trace_capacity) {
+            size_t capacity = trace_capacity ? trace_capacity * 2 : 256;
+            while (capacity < needed) {
+                capacity *= 2;
+            }
+            int32_t *grown = realloc(trace, capacity * sizeof(int32_t));
+            ok = grown != NULL;
+            if (ok) {
+                trace = grown;
+                trace_capacity = capacity;
+            }
+        }
+        if (ok) {
+            memcpy(trace + (size_t)d * (size_t)d, diagonal - d,
+                   (size_t)(2 * d + 1) * sizeof(int32_t));
+        }
+    }
+
+    if (ok && found >= 0) {
+        int32_t x = n, y = m;
+        for (int32_t d = found; d > 0; d--) {
+            const int32_t *previous = trace + (size_t)(d - 1) * (size_t)(d - 1) + (d - 1);
+            int32_t k = x - y;
+            bool down = k == -d || (k != d && previous[k - 1] < previous[k + 1]);
+            int32_t previous_k = down ? k + 1 : k - 1;
+            int32_t previous_x = previous[previous_k];
+            int32_t previous_y = previous_x - previous_k;
+            while (x > previous_x && y > previous_y) {
+                x--;
+                y--;
+                match[x] = (uint32_t)y + offset;
+            }
+            x = previous_x;
+            y = previous_y;
+        }
+        while (x > 0 && y > 0) {
+            x--;
+            y--;
+            match[x] = (uint32_t)y + offset;
+        }
+    }
+    if (ok && found < 0) {
+        align_greedy(a, n, b, m, match, offset);
+    }
+    free(trace);
+    free(v);
+    return ok;
+}
+
+// For each node of `a`, the index of the equal node of `b` it is kept as,
+// or UNMATCHED. Unchanged nodes at both ends are matched directly.
+static bool align(const ItemList *a, const ItemList *b, uint32_t *match) {
+    uint32_t n = a->length, m = b->length;
+    for (uint32_t i = 0; i < n; i++) {
+        match[i] = UNMATCHED;
+    }
+    uint32_t start = 0;
+    while (start < n && start < m && same(&a->items[start], &b->items[start])) {
+        match[start] = start;
+        start++;
+    }
+    uint32_t end = 0;
+    while (end < n - start && end < m - start &&
+           same(&a->items[n - 1 - end], &b->items[m - 1 - end])) {
+        match[n - 1 - end] = m - 1 - end;
+        end++;
+    }
+    if (n - start - end == 0 || m - start - end == 0) {
+        return true;
+    }
+    return align_middle(a->items + start, (int32_t)(n - start - end), b->items + start,
+                        (int32_t)(m - start - end), match + start, start);
+}
+
+static void add_edit(Differ *differ, uint8_t operation, uint8_t kind, CooklangSpan old_span,
+                     CooklangSpan new_span) {
+    CooklangDiffScript *script = differ->script;
+    if (!differ->ok) {
+        return;
+    }
+    if (script->length == script->capacity) {
+        uint32_t capacity = script->capacity ? script->capacity * 2 : 16;
+        CooklangDiffEdit *edits = realloc(script->edits, capacity * sizeof(CooklangDiffEdit));
+        if (!edits) {
+            differ->ok = false;
+            return;
+        }
+        script->edits = edits;
+        script->capacity = capacity;
+    }
+    script->edits[script->length++] = (CooklangDiffEdit){operation, kind, old_span, new_span};
+}
+
+static void diff_lists(Differ *differ, const ItemList *a, const ItemList *b, uint32_t old_end,
+                       uint32_t new_end);
+
+// Whether a deleted and an inserted node can be one changed node.
+static inline bool partners(const Item *deleted, const Item *inserted) {
+    if (deleted->kind != inserted->kind) {
+        return false;
+    }
+    switch (deleted->kind) {
+        case COOKLANG_DIFF_METADATA:
+        case COOKLANG_DIFF_INGREDIENT:
+        case COOKLANG_DIFF_COOKWARE:
+        case COOKLANG_DIFF_TIMER:
+            return deleted->key == inserted->key;
+        default:
+            return true;
+    }
+}
+
+// The edits for the nodes `a` deleted and `b` inserted between two kept
+// ones, or the ends; `old_at` and `new_at` are where that is in each
+// version.
+static void diff_run(Differ *differ, const Item *a, uint32_t n, const Item *b, uint32_t m,
+                     uint32_t old_at, uint32_t new_at) {
+    // The deleted node paired with each inserted one, or UNMATCHED.
+    uint32_t *partner = m ? malloc(m * sizeof(uint32_t)) : NULL;
+    if (m && !partner) {
+        differ->ok = false;
+        return;
+    }
+    for (uint32_t j = 0; j < m; j++) {
+        partner[j] = UNMATCHED;
+    }
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        bool paired = false;
+        for (uint32_t j = next; j < m && j < next + PAIR_WINDOW && !paired; j++) {
+            if (partner[j] == UNMATCHED && partners(&a[i], &b[j])) {
+                partner[j] = i;
+                next = j + 1;
+                paired = true;
+            }
+        }
+        if (!paired) {
+            add_edit(differ, COOKLANG_DIFF_DELETE, a[i].kind, a[i].span,
+                     (CooklangSpan){new_at, new_at});
+        }
+    }
+    for (uint32_t j = 0; j < m; j++) {
+        if (partner[j] == UNMATCHED) {
+            add_edit(differ, COOKLANG_DIFF_INSERT, b[j].kind, (CooklangSpan){old_at, old_at},
+                     b[j].span);
+            continue;
+        }
+        const Item *old_item = &a[partner[j]];
+        add_edit(differ, COOKLANG_DIFF_CHANGE, b[j].kind, old_item->span, b[j].span);
+        if (b[j].kind == COOKLANG_DIFF_STEP && differ->ok) {
+            ItemList old_entities = {0}, new_entities = {0};
+            differ->ok =
+                collect(differ->symbols, differ->old_source, old_item->node, &old_entities) &&
+                collect(differ->symbols, differ->new_source, b[j].node, &new_entities);
+            if (differ->ok) {
+                diff_lists(differ, &old_entities, &new_entities, old_item->span.end,
+                           b[j].span.end);
+            }
+            free(old_entities.items);
+            free(new_entities.items);
+        }
+    }
+    free(partner);
+}
+
+// The edits from `a` to `b`; `old_end` and `new_end` are where nodes
+// after the last ones would go.
+static void diff_lists(Differ *differ, const ItemList *a, const ItemList *b, uint32_t old_end,
+                       uint32_t new_end) {
+    uint32_t *match = a->length ? malloc(a->length * sizeof(uint32_t)) : NULL;
+    if ((a->length && !match) || !align(a, b, match)) {
+        differ->ok = false;
+        free(match);
+        return;
+    }
+    uint32_t i = 0, j = 0;
+    while (differ->ok && (i < a->length || j < b->length)) {
+        if (i < a->length && match[i] == j) {
+            i++;
+            j++;
+            continue;
+        }
+        uint32_t deleted = i;
+        while (i < a->length && match[i] == UNMATCHED) {
+            i++;
+        }
+        uint32_t inserted = j;
+        j = i < a->length ? match[i] : b->length;
+        diff_run(differ, a->items + deleted, i - deleted, b->items + inserted, j - inserted,
+                 i < a->length ? a->items[i].span.start : old_end,
+                 j < b->length ? b->items[j].span.start : new_end);
+    }
+    free(match);
+}
+
+bool cooklang_diff(const char *old_source, TSNode old_root, const char *new_source,
+                   TSNode new_root, CooklangDiffScript *script) {
+    const TSLanguage *language = ts_node_language(old_root);
+    CooklangSymbols symbols;
+    cooklang_symbols_init(&symbols, language);
+    uint32_t length = script->length;
+    Differ differ = {&symbols, old_source, new_source, script, true};
+    ItemList old_items = {0}, new_items = {0};
+    differ.ok = collect(&symbols, old_source, old_root, &old_items) &&
+                collect(&symbols, new_source, new_root, &new_items);
+    if (differ.ok) {
+        diff_lists(&differ, &old_items, &new_items, ts_node_end_byte(old_root),
+                   ts_node_end_byte(new_root));
+    }
+    free(old_items.items);
+    free(new_items.items);
+    if (!differ.ok) {
+        script->length = length;
+    }
+    return differ.ok;
+}
@@ -0,0 +1,85 @@
+#ifndef COOKLANG_DIFF_H_
+#define COOKLANG_DIFF_H_
+
+#include "cooklang_extract.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Structural diff between two versions of a recipe.
+//
+// The diff matches the top-level nodes of the two syntax trees
+// (frontmatter, metadata, sections, steps and notes) rather than lines.
+// Every node is hashed once per call, over its text. Equal hashes mean an
+// unchanged node, so comparing two nodes takes constant time whatever
+// their size. Hashes are not kept between calls: hashing reads every byte
+// of both versions, so a diff takes time linear in their length, and only
+// the alignment that follows depends on the number of nodes alone. After
+// the unchanged nodes at both ends are set aside, the rest are aligned
+// with Myers' algorithm, or, for versions that are far apart, by a greedy
+// linear scan. Nodes left over between two unchanged ones are paired into
+// changes: metadata by key, and the others of one kind in order. Nodes
+// that find no partner are deletions and insertions. Inside a changed step
+// the ingredients, cookware and timers are diffed the same way, and paired
+// by name.
+//
+// Nodes are compared by a 64-bit hash of their text, so two different
+// nodes are taken as equal with a probability of about 2^-64.
+
+typedef enum {
+    COOKLANG_DIFF_DELETE,
+    COOKLANG_DIFF_INSERT,
+    COOKLANG_DIFF_CHANGE,
+} CooklangDiffOperation;
+
+typedef enum {
+    COOKLANG_DIFF_FRONTMATTER,
+    COOKLANG_DIFF_METADATA,
+    COOKLANG_DIFF_SECTION,
+    COOKLANG_DIFF_STEP,
+    COOKLANG_DIFF_NOTE,
+    COOKLANG_DIFF_INGREDIENT,
+    COOKLANG_DIFF_COOKWARE,
+    COOKLANG_DIFF_TIMER,
+} CooklangDiffKind;
+
+typedef struct {
+    uint8_t operation;
+    uint8_t kind;
+    // The node in the old version, empty for an insertion, and in the new
+    // version, empty for a deletion. An empty span is at the offset where
+    // the node was removed from, or is inserted into, its version.
+    CooklangSpan old_span;
+    CooklangSpan new_span;
+} CooklangDiffEdit;
+
+// An edit script in document order. Within a run of edits between two
+// unchanged nodes, deletions come first, then changes and insertions in
+// the order of the new version. The edits to the ingredients, cookware
+// and timers of a step directly follow the change to that step.
+typedef struct {
+    CooklangDiffEdit *edits;
+    uint32_t length;
+    uint32_t capacity;
+} CooklangDiffScript;
+
+void cooklang_diff_script_init(CooklangDiffScript *script);
+void cooklang_diff_script_free(CooklangDiffScript *script);
+
+// Append the edits that turn the recipe under `old_root` into the one
+// under `new_root`. No edits means the two have the same nodes with the
+// same text, whitespace between nodes aside. Returns false if memory ran
+// out, leaving the script as it was.
+bool cooklang_diff(const char *old_source, TSNode old_root, const char *new_source,
+                   TSNode new_root, CooklangDiffScript *script);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_DIFF_H_
@@ -0,0 +1,493 @@
+#include "cooklang_document.h"
+#include "cooklang_common.h"
+
+#include "cooklang_units.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Make room for `needed` elements of `size` bytes in `*array`.
+static bool grow(void **array, uint32_t *capacity, uint32_t needed, size_t size) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    uint32_t new_capacity = *capacity ? *capacity : 16;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    void *new_array = realloc(*array, new_capacity * size);
+    if (!new_array) {
+        return false;
+    }
+    *array = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+void cooklang_document_init(CooklangDocument *document, const char *directory) {
+    memset(document, 0, sizeof(*document));
+    cooklang_text_init(&document->text);
+    if (directory) {
+        size_t length = strlen(directory);
+        document->directory = malloc(length + 1);
+        if (document->directory) {
+            memcpy(document->directory, directory, length + 1);
+        }
+    }
+}
+
+void cooklang_document_free(CooklangDocument *document) {
+    cooklang_text_free(&document->text);
+    if (document->tree) {
+        ts_tree_delete(document->tree);
+    }
+    free(document->lines);
+    free(document->dirty);
+    free(document->diagnostics);
+    free(document->directory);
+    memset(document, 0, sizeof(*document));
+}
+
+static bool index_lines(CooklangDocument *document) {
+    document->line_count = 0;
+    const char *text = document->text.data;
+    for (uint32_t i = 0; i <= document->text.length; i++) {
+        if (i == 0 || text[i - 1] == '\n') {
+            if (!grow((void **)&document->lines, &document->line_capacity,
+                      document->line_count + 1, sizeof(uint32_t))) {
+                return false;
+            }
+            document->lines[document->line_count++] = i;
+        }
+    }
+    return true;
+}
+
+bool cooklang_document_set_text(CooklangDocument *document, const char *text, uint32_t length) {
+    document->text.length = 0;
+    if (!cooklang_text_reserve(&document->text, length)) {
+        return false;
+    }
+    memcpy(document->text.data, text, length);
+    document->text.length = length;
+    document->text.data[length] = '\0';
+    if (document->tree) {
+        ts_tree_delete(document->tree);
+        document->tree = NULL;
+    }
+    document->dirty_count = 0;
+    document->diagnostic_count = 0;
+    return index_lines(document);
+}
+
+// The end of line `line`, before its `\n` or `\r\n`.
+static uint32_t line_end(const CooklangDocument *document, uint32_t line) {
+    if (line + 1 >= document->line_count) {
+        return document->text.length;
+    }
+    uint32_t end = document->lines[line + 1] - 1;
+    if (end > document->lines[line] && document->text.data[end - 1] == '\r') {
+        end--;
+    }
+    return end;
+}
+
+// Bytes of the UTF-8 sequence starting with `lead`, and the UTF-16 code
+// units it needs.
+static inline uint32_t sequence_length(unsigned char lead, uint32_t *units) {
+    *units = lead >= 0xF0 ? 2 : 1;
+    return lead < 0xC0 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+}
+
+uint32_t cooklang_document_offset(const CooklangDocument *document, CooklangPosition position) {
+    if (position.line >= document->line_count) {
+        return document->text.length;
+    }
+    uint32_t offset = document->lines[position.line];
+    uint32_t end = line_end(document, position.line);
+    uint32_t character = 0;
+    while (offset < end && character < position.character) {
+        uint32_t units;
+        offset += sequence_length((unsigned char)document->text.data[offset], &units);
+        character += units;
+    }
+    return offset < end ? offset : end;
+}
+
+static uint32_t line_of(const CooklangDocument *document, uint32_t offset) {
+    uint32_t low = 0;
+    uint32_t high = document->line_count;
+    while (high - low > 1) {
+        uint32_t middle = low + (high - low) / 2;
+        if (document->lines[middle] <= offset) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+CooklangPosition cooklang_document_position(const CooklangDocument *document, uint32_t offset) {
+    if (offset > document->text.length) {
+        offset = document->text.length;
+    }
+    if (document->line_count == 0) {
+        return (CooklangPosition){0, 0};
+    }
+    CooklangPosition position = {line_of(document, offset), 0};
+    for (uint32_t i = document->lines[position.line]; i < offset;) {
+        uint32_t units;
+        i += sequence_length((unsigned char)document->text.data[i], &units);
+        position.character += units;
+    }
+    return position;
+}
+
+static TSPoint point_of(const CooklangDocument *document, uint32_t offset) {
+    uint32_t line = line_of(document, offset);
+    return (TSPoint){line, offset - document->lines[line]};
+}
+
+// Replace the lines starting inside (start, end] by those of the `length`
+// inserted bytes at `start`, and shift the lines after them by `delta`.
+static bool update_lines(CooklangDocument *document, uint32_t start, uint32_t end,
+                         const char *text, uint32_t length) {
+    uint32_t inserted = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        inserted += text[i] == '\n';
+    }
+    uint32_t first = line_of(document, start) + 1;
+    uint32_t last = line_of(document, end) + 1;
+    uint32_t count = document->line_count - (last - first) + inserted;
+    if (!grow((void **)&document->lines, &document->line_capacity, count, sizeof(uint32_t))) {
+        return false;
+    }
+    memmove(document->lines + first + inserted, document->lines + last,
+            (document->line_count - last) * sizeof(uint32_t));
+    uint32_t line = first;
+    for (uint32_t i = 0; i < length; i++) {
+        if (text[i] == '\n') {
+            document->lines[line++] = start + i + 1;
+        }
+    }
+    uint32_t delta = length - (end - start);
+    for (uint32_t i = first + inserted; i < count; i++) {
+        document->lines[i] += delta;
+    }
+    document->line_count = count;
+    return true;
+}
+
+bool cooklang_document_replace(CooklangDocument *document, CooklangPosition start_position,
+                               CooklangPosition end_position, const char *text,
+                               uint32_t length) {
+    if (document->line_count == 0 && !index_lines(document)) {
+        return false;
+    }
+    uint32_t start = cooklang_document_offset(document, start_position);
+    uint32_t end = cooklang_document_offset(document, end_position);
+    if (end < start) {
+        end = start;
+    }
+    uint32_t growth = length > end - start ? length - (end - start) : 0;
+    if (!grow((void **)&document->dirty, &document->dirty_capacity, document->dirty_count + 1,
+              sizeof(TSRange)) ||
+        !cooklang_text_reserve(&document->text, growth)) {
+        return false;
+    }
+
+    TSInputEdit edit;
+    edit.start_byte = start;
+    edit.old_end_byte = end;
+    edit.new_end_byte = start + length;
+    edit.start_point = point_of(document, start);
+    edit.old_end_point = point_of(document, end);
+
+    // The line index is updated against the old text, whose offsets
+    // `line_of` searches; the text itself changes after.
+    if (!update_lines(document, start, end, text, length)) {
+        return false;
+    }
+    char *data = document->text.data;
+    memmove(data + start + length, data + end, document->text.length - end);
+    memcpy(data + start, text, length);
+    document->text.length += length - (end - start);
+    data[document->text.length] = '\0';
+    edit.new_end_point = point_of(document, start + length);
+    if (document->tree) {
+        ts_tree_edit(document->tree, &edit);
+    }
+
+    // Shift the ranges and diagnostics after the edit; ranges it touches
+    // merge into its own, diagnostics it touches are dropped until the
+    // next parse recomputes them.
+    uint32_t delta = length - (end - start);
+    TSRange range = {{0, 0}, {0, 0}, start, start + length};
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < document->dirty_count; i++) {
+        TSRange dirty = document->dirty[i];
+        if (dirty.start_byte > end) {
+            dirty.start_byte += delta;
+            dirty.end_byte += delta;
+        } else if (dirty.end_byte >= start) {
+            if (dirty.start_byte < range.start_byte) {
+                range.start_byte = dirty.start_byte;
+            }
+            if (dirty.end_byte > end && dirty.end_byte + delta > range.end_byte) {
+                range.end_byte = dirty.end_byte + delta;
+            }
+            continue;
+        }
+        document->dirty[kept++] = dirty;
+    }
+    document->dirty[kept++] = range;
+    document->dirty_count = kept;
+
+    kept = 0;
+    for (uint32_t i = 0; i < document->diagnostic_count; i++) {
+        CooklangDiagnostic diagnostic = document->diagnostics[i];
+        if (diagnostic.start > end) {
+            diagnostic.start += delta;
+            diagnostic.end += delta;
+        } else if (diagnostic.end >= start) {
+            continue;
+        }
+        document->diagnostics[kept++] = diagnostic;
+    }
+    document->diagnostic_count = kept;
+    return true;
+}
+
+bool cooklang_document_needs_parse(const CooklangDocument *document) {
+    return !document->tree || document->dirty_count > 0;
+}
+
+typedef struct {
+    CooklangDocument *document;
+    TSSymbol quantity;
+    TSSymbol ingredient_name;
+    CooklangDiagnostic *found;
+    uint32_t found_count;
+    uint32_t found_capacity;
+    bool ok;
+} Checker;
+
+static void report(Checker *checker, uint32_t start, uint32_t end, CooklangDiagnosticKind kind) {
+    if (end == start && end < checker->document->text.length) {
+        end++;
+    }
+    if (!grow((void **)&checker->found, &checker->found_capacity, checker->found_count + 1,
+              sizeof(CooklangDiagnostic))) {
+        checker->ok = false;
+        return;
+    }
+    checker->found[checker->found_count++] = (CooklangDiagnostic){start, end, (uint8_t)kind};
+}
+
+static bool reference_exists(const char *directory, const char *name, uint32_t length) {
+    size_t directory_length = strlen(directory);
+    char *path = malloc(directory_length + length + sizeof("/.cook"));
+    if (!path) {
+        return true;
+    }
+    memcpy(path, directory, directory_length);
+    path[directory_length] = '/';
+    memcpy(path + directory_length + 1, name, length);
+    memcpy(path + directory_length + 1 + length, ".cook", sizeof(".cook"));
+    FILE *file = fopen(path, "rb");
+    free(path);
+    if (file) {
+        fclose(file);
+    }
+    return file != NULL;
+}
+
+// Check one node; returns whether its children need checking too.
+static bool check_node(Checker *checker, TSNode node) {
+    const char *source = checker->document->text.data;
+    uint32_t start = ts_node_start_byte(node);
+    uint32_t end = ts_node_end_byte(node);
+
+    if (ts_node_is_error(node)) {
+        // An unclosed quantity swallows the rest of the step into an error.
+        for (uint32_t i = start; i < end; i++) {
+            if (source[i] == '{' && !memchr(source + i, '}', end - i)) {
+                report(checker, i, end, COOKLANG_DIAGNOSTIC_UNCLOSED_QUANTITY);
+                return false;
+            }
+        }
+        report(checker, start, end, COOKLANG_DIAGNOSTIC_SYNTAX_ERROR);
+        return false;
+    }
+    if (ts_node_is_missing(node)) {
+        if (strcmp(ts_node_type(node), "}") == 0) {
+            TSNode parent = ts_node_parent(node);
+            report(checker, ts_node_start_byte(parent), end, COOKLANG_DIAGNOSTIC_UNCLOSED_QUANTITY);
+        } else {
+            report(checker, start, end, COOKLANG_DIAGNOSTIC_SYNTAX_ERROR);
+        }
+        return false;
+    }
+
+    TSSymbol symbol = ts_node_symbol(node);
+    if (symbol == checker->quantity) {
+        if (ts_node_has_error(node)) {
+            return true;
+        }
+        if (end - start < 2 || source[end - 1] != '}') {
+            report(checker, start, end, COOKLANG_DIAGNOSTIC_UNCLOSED_QUANTITY);
+            return false;
+        }
+        CooklangQuantity quantity;
+        cooklang_quantity_parse(source, (CooklangSpan){start + 1, end - 1}, &quantity);
+        if (quantity.unit.end > quantity.unit.start && !cooklang_unit_find(source, quantity.unit)) {
+            report(checker, quantity.unit.start, quantity.unit.end,
+                   COOKLANG_DIAGNOSTIC_UNKNOWN_UNIT);
+        }
+        return false;
+    }
+    if (symbol == checker->ingredient_name) {
+        while (start < end && (source[start] == ' ' || source[start] == '\t')) {
+            start++;
+        }
+        while (end > start && (source[end - 1] == ' ' || source[end - 1] == '\t')) {
+            end--;
+        }
+        bool reference = end - start > 2 && source[start] == '.' &&
+                         (source[start + 1] == '/' || source[start + 1] == '\\');
+        if (reference && checker->document->directory &&
+            !reference_exists(checker->document->directory, source + start + 2,
+                              end - start - 2)) {
+            report(checker, start, end, COOKLANG_DIAGNOSTIC_MISSING_REFERENCE);
+        }
+        return false;
+    }
+    return true;
+}
+
+static void check_subtree(Checker *checker, TSNode node) {
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    for (;;) {
+        if (check_node(checker, ts_tree_cursor_current_node(&cursor)) &&
+            ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return;
+            }
+        }
+    }
+}
+
+static int compare_ranges(const void *a, const void *b) {
+    const TSRange *left = a;
+    const TSRange *right = b;
+    return left->start_byte < right->start_byte ? -1 : left->start_byte > right->start_byte;
+}
+
+static int compare_diagnostics(const void *a, const void *b) {
+    const CooklangDiagnostic *left = a;
+    const CooklangDiagnostic *right = b;
+    return left->start < right->start ? -1 : left->start > right->start;
+}
+
+bool cooklang_document_parse(CooklangDocument *document, TSParser *parser) {
+    if (!cooklang_document_needs_parse(document)) {
+        return true;
+    }
+    TSTree *old_tree = document->tree;
+    TSTree *tree = ts_parser_parse_string(parser, old_tree, document->text.data,
+                                          document->text.length);
+    if (!tree) {
+        return false;
+    }
+
+    // Without an old tree everything is new.
+    uint32_t changed_count = 0;
+    TSRange *changed = old_tree ? ts_tree_get_changed_ranges(old_tree, tree, &changed_count) : NULL;
+    TSRange whole = {{0, 0}, {0, 0}, 0, document->text.length};
+    const TSRange *dirty = old_tree ? document->dirty : &whole;
+    uint32_t dirty_count = old_tree ? document->dirty_count : 1;
+    uint32_t range_count = changed_count + dirty_count;
+    TSRange *ranges = realloc(changed, range_count * sizeof(TSRange));
+    if (!ranges) {
+        free(changed);
+        ts_tree_delete(tree);
+        return false;
+    }
+    memcpy(ranges + changed_count, dirty, dirty_count * sizeof(TSRange));
+    qsort(ranges, range_count, sizeof(TSRange), compare_ranges);
+
+    TSNode root = ts_tree_root_node(tree);
+    const TSLanguage *language = ts_node_language(root);
+    Checker checker = {document, COOKLANG_SYMBOL(language, "quantity"),
+                       COOKLANG_SYMBOL(language, "ingredient_name"), NULL, 0, 0, true};
+
+    // Drop the old diagnostics of every top-level node that is checked
+    // again; nodes are visited in order, so one pass over them suffices.
+    uint32_t done = 0;
+    uint32_t next_old = 0;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; checker.ok && i < range_count; i++) {
+        uint32_t start = ranges[i].start_byte > 0 ? ranges[i].start_byte - 1 : 0;
+        TSNode node = ts_node_first_child_for_byte(root, start);
+        while (checker.ok && !ts_node_is_null(node) &&
+               ts_node_start_byte(node) <= ranges[i].end_byte) {
+            uint32_t node_start = ts_node_start_byte(node);
+            uint32_t node_end = ts_node_end_byte(node);
+            if (node_start >= done) {
+                while (next_old < document->diagnostic_count &&
+                       document->diagnostics[next_old].start < node_start) {
+                    document->diagnostics[kept++] = document->diagnostics[next_old++];
+                }
+                while (next_old < document->diagnostic_count &&
+                       document->diagnostics[next_old].start <= node_end) {
+                    next_old++;
+                }
+                check_subtree(&checker, node);
+                done = node_end;
+            }
+            node = ts_node_next_sibling(node);
+        }
+    }
+    while (next_old < document->diagnostic_count) {
+        document->diagnostics[kept++] = document->diagnostics[next_old++];
+    }
+    document->diagnostic_count = kept;
+    free(ranges);
+
+    if (checker.ok && checker.found_count > 0) {
+        if (grow((void **)&document->diagnostics, &document->diagnostic_capacity,
+                 kept + checker.found_count, sizeof(CooklangDiagnostic))) {
+            memcpy(document->diagnostics + kept, checker.found,
+                   checker.found_count * sizeof(CooklangDiagnostic));
+            document->diagnostic_count += checker.found_count;
+            qsort(document->diagnostics, document->diagnostic_count, sizeof(CooklangDiagnostic),
+                  compare_diagnostics);
+        } else {
+            checker.ok = false;
+        }
+    }
+    free(checker.found);
+    if (!checker.ok) {
+        // The diagnostics are incomplete; the next parse checks everything.
+        ts_tree_delete(tree);
+        if (old_tree) {
+            ts_tree_delete(old_tree);
+        }
+        document->tree = NULL;
+        document->dirty_count = 0;
+        document->diagnostic_count = 0;
+        return false;
+    }
+    if (old_tree) {
+        ts_tree_delete(old_tree);
+    }
+    document->tree = tree;
+    document->dirty_count = 0;
+    return true;
+}
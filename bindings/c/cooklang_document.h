@@ -0,0 +1,97 @@
+#ifndef COOKLANG_DOCUMENT_H_
+#define COOKLANG_DOCUMENT_H_
+
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An open, edited recipe: its text, a line index, an incrementally
+// reparsed tree and the diagnostics for it, as an editor integration needs
+// them.
+//
+// Edits are applied to the text and the tree right away, but the document
+// is only reparsed by `cooklang_document_parse`, so a burst of keystrokes
+// costs one parse. Diagnostics are then recomputed only for the top-level
+// nodes (lines, or multi-line steps) touched by the edits since the last
+// parse or by the ranges `ts_tree_get_changed_ranges` reports; the others
+// are kept and shifted.
+//
+// Positions are zero-based lines and UTF-16 code units within the line,
+// which is what the language server protocol uses.
+
+typedef struct {
+    uint32_t line;
+    uint32_t character;
+} CooklangPosition;
+
+typedef enum {
+    COOKLANG_DIAGNOSTIC_SYNTAX_ERROR,
+    // `{` without a closing `}`.
+    COOKLANG_DIAGNOSTIC_UNCLOSED_QUANTITY,
+    // A unit `cooklang_unit_lookup` does not know; the span is the unit.
+    COOKLANG_DIAGNOSTIC_UNKNOWN_UNIT,
+    // `@./path{}` where `path.cook` does not exist next to the document;
+    // the span is the path.
+    COOKLANG_DIAGNOSTIC_MISSING_REFERENCE,
+} CooklangDiagnosticKind;
+
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+    uint8_t kind;
+} CooklangDiagnostic;
+
+typedef struct {
+    CooklangText text;
+    TSTree *tree;
+    // Byte offset of the start of each line.
+    uint32_t *lines;
+    uint32_t line_count;
+    uint32_t line_capacity;
+    // Byte ranges of the text edited since the last parse, in current
+    // offsets.
+    TSRange *dirty;
+    uint32_t dirty_count;
+    uint32_t dirty_capacity;
+    // Sorted by start.
+    CooklangDiagnostic *diagnostics;
+    uint32_t diagnostic_count;
+    uint32_t diagnostic_capacity;
+    // Directory `./` references are resolved against, or NULL to skip
+    // reference checks.
+    char *directory;
+} CooklangDocument;
+
+// `directory` is copied and may be NULL.
+void cooklang_document_init(CooklangDocument *document, const char *directory);
+void cooklang_document_free(CooklangDocument *document);
+
+// Replace the whole text. The next parse starts from scratch.
+bool cooklang_document_set_text(CooklangDocument *document, const char *text, uint32_t length);
+
+// Replace the text between two positions, as in an LSP content change.
+// Positions past the end of a line or of the document are clamped.
+bool cooklang_document_replace(CooklangDocument *document, CooklangPosition start,
+                               CooklangPosition end, const char *text, uint32_t length);
+
+// Whether the document changed since the last parse.
+bool cooklang_document_needs_parse(const CooklangDocument *document);
+
+// Reparse the document if it changed and update its diagnostics. Returns
+// false if memory ran out, leaving the document unparsed.
+bool cooklang_document_parse(CooklangDocument *document, TSParser *parser);
+
+uint32_t cooklang_document_offset(const CooklangDocument *document, CooklangPosition position);
+CooklangPosition cooklang_document_position(const CooklangDocument *document, uint32_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_DOCUMENT_H_
@@ -0,0 +1,676 @@
+#include "cooklang_extract.h"
+#include "scanner_unicode.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#include <immintrin.h>
+#define COOKLANG_HAS_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define COOKLANG_HAS_AVX2 1
+#endif
+#endif
+
+// Bytes that can end a run of step text: the entity sigils, brackets,
+// newline, and the first byte of a comment.
+static const uint8_t SPECIAL[256] = {
+    ['@'] = 1, ['#'] = 1, ['~'] = 1, ['{'] = 1, ['}'] = 1,
+    ['('] = 1, [')'] = 1, ['\n'] = 1, ['['] = 1, ['-'] = 1,
+};
+
+// ASCII part of is_word_char in src/scanner.c. Multi-byte UTF-8 sequences
+// are decoded and looked up in the same table as the scanner's.
+static const uint8_t WORD[128] = {
+    ['a'] = 1, ['b'] = 1, ['c'] = 1, ['d'] = 1, ['e'] = 1, ['f'] = 1, ['g'] = 1,
+    ['h'] = 1, ['i'] = 1, ['j'] = 1, ['k'] = 1, ['l'] = 1, ['m'] = 1, ['n'] = 1,
+    ['o'] = 1, ['p'] = 1, ['q'] = 1, ['r'] = 1, ['s'] = 1, ['t'] = 1, ['u'] = 1,
+    ['v'] = 1, ['w'] = 1, ['x'] = 1, ['y'] = 1, ['z'] = 1,
+    ['A'] = 1, ['B'] = 1, ['C'] = 1, ['D'] = 1, ['E'] = 1, ['F'] = 1, ['G'] = 1,
+    ['H'] = 1, ['I'] = 1, ['J'] = 1, ['K'] = 1, ['L'] = 1, ['M'] = 1, ['N'] = 1,
+    ['O'] = 1, ['P'] = 1, ['Q'] = 1, ['R'] = 1, ['S'] = 1, ['T'] = 1, ['U'] = 1,
+    ['V'] = 1, ['W'] = 1, ['X'] = 1, ['Y'] = 1, ['Z'] = 1,
+    ['0'] = 1, ['1'] = 1, ['2'] = 1, ['3'] = 1, ['4'] = 1,
+    ['5'] = 1, ['6'] = 1, ['7'] = 1, ['8'] = 1, ['9'] = 1,
+    ['_'] = 1, ['-'] = 1, ['\''] = 1, ['"'] = 1,
+};
+
+typedef const char *(*FindSpecialFn)(const char *cursor, const char *end);
+
+typedef struct {
+    const char *source;
+    const char *end;
+    // Rows are counted lazily, up to the last reported entity.
+    const char *row_position;
+    uint32_t row;
+    CooklangEntityList *list;
+    FindSpecialFn find_special;
+    bool ok;
+} Extractor;
+
+static inline bool is_whitespace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static inline bool is_trimmable(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// The length in bytes of the word character at `cursor`, or 0 if it is not
+// on one. The lexer reads an invalid or truncated UTF-8 sequence as
+// U+FFFD, which is not a word character, so only well-formed sequences
+// (no overlong forms, nothing above U+10FFFF) are decoded.
+static inline uint32_t word_length(const char *cursor, const char *end) {
+    uint8_t byte = (uint8_t)*cursor;
+    if (byte < 0x80) {
+        return WORD[byte];
+    }
+    uint32_t length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : 2;
+    if (byte < 0xC2 || byte > 0xF4 || (size_t)(end - cursor) < length) {
+        return 0;
+    }
+    int32_t c = byte & (0x3F >> (length - 1));
+    for (uint32_t i = 1; i < length; i++) {
+        uint8_t next = (uint8_t)cursor[i];
+        if ((next & 0xC0) != 0x80) {
+            return 0;
+        }
+        c = (c << 6) | (next & 0x3F);
+    }
+    if ((length == 3 && c < 0x800) || (length == 4 && c < 0x10000)) {
+        return 0;
+    }
+    return unicode_is_word(c) ? length : 0;
+}
+
+static inline const char *skip_word(const char *cursor, const char *end) {
+    uint32_t length;
+    while (cursor < end && (length = word_length(cursor, end)) > 0) {
+        cursor += length;
+    }
+    return cursor;
+}
+
+static inline unsigned count_trailing_zeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+static const char *find_special_scalar(const char *cursor, const char *end) {
+    while (cursor < end && !SPECIAL[(uint8_t)*cursor]) {
+        cursor++;
+    }
+    return cursor;
+}
+
+#ifdef COOKLANG_HAS_SSE2
+static const char *find_special_sse2(const char *cursor, const char *end) {
+    const __m128i at = _mm_set1_epi8('@');
+    const __m128i hash = _mm_set1_epi8('#');
+    const __m128i tilde = _mm_set1_epi8('~');
+    const __m128i lbrace = _mm_set1_epi8('{');
+    const __m128i rbrace = _mm_set1_epi8('}');
+    const __m128i lparen = _mm_set1_epi8('(');
+    const __m128i rparen = _mm_set1_epi8(')');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i lbracket = _mm_set1_epi8('[');
+    const __m128i dash = _mm_set1_epi8('-');
+
+    while (end - cursor >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)cursor);
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, at), _mm_cmpeq_epi8(chunk, hash)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, tilde), _mm_cmpeq_epi8(chunk, lbrace))),
+            _mm_or_si128(
+                _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, rbrace), _mm_cmpeq_epi8(chunk, lparen)),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, rparen), _mm_cmpeq_epi8(chunk, newline))),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, lbracket), _mm_cmpeq_epi8(chunk, dash))));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask) {
+            return cursor + count_trailing_zeros(mask);
+        }
+        cursor += 16;
+    }
+    return find_special_scalar(cursor, end);
+}
+#endif
+
+#ifdef COOKLANG_HAS_AVX2
+__attribute__((target("avx2")))
+static const char *find_special_avx2(const char *cursor, const char *end) {
+    const __m256i at = _mm256_set1_epi8('@');
+    const __m256i hash = _mm256_set1_epi8('#');
+    const __m256i tilde = _mm256_set1_epi8('~');
+    const __m256i lbrace = _mm256_set1_epi8('{');
+    const __m256i rbrace = _mm256_set1_epi8('}');
+    const __m256i lparen = _mm256_set1_epi8('(');
+    const __m256i rparen = _mm256_set1_epi8(')');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i lbracket = _mm256_set1_epi8('[');
+    const __m256i dash = _mm256_set1_epi8('-');
+
+    while (end - cursor >= 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)cursor);
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, at), _mm256_cmpeq_epi8(chunk, hash)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, tilde), _mm256_cmpeq_epi8(chunk, lbrace))),
+            _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, rbrace), _mm256_cmpeq_epi8(chunk, lparen)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, rparen), _mm256_cmpeq_epi8(chunk, newline))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lbracket), _mm256_cmpeq_epi8(chunk, dash))));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(hits);
+        if (mask) {
+            return cursor + count_trailing_zeros(mask);
+        }
+        cursor += 32;
+    }
+    return find_special_sse2(cursor, end);
+}
+#endif
+
+static CooklangBackend selected_backend = COOKLANG_BACKEND_AUTO;
+
+static bool backend_supported(CooklangBackend backend) {
+    switch (backend) {
+        case COOKLANG_BACKEND_AUTO:
+        case COOKLANG_BACKEND_SCALAR:
+            return true;
+#ifdef COOKLANG_HAS_SSE2
+        case COOKLANG_BACKEND_SSE2:
+            return true;
+#endif
+#ifdef COOKLANG_HAS_AVX2
+        case COOKLANG_BACKEND_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+CooklangBackend cooklang_extract_backend(void) {
+    if (selected_backend != COOKLANG_BACKEND_AUTO) {
+        return selected_backend;
+    }
+    if (backend_supported(COOKLANG_BACKEND_AVX2)) {
+        return COOKLANG_BACKEND_AVX2;
+    }
+    if (backend_supported(COOKLANG_BACKEND_SSE2)) {
+        return COOKLANG_BACKEND_SSE2;
+    }
+    return COOKLANG_BACKEND_SCALAR;
+}
+
+bool cooklang_extract_set_backend(CooklangBackend backend) {
+    if (!backend_supported(backend)) {
+        return false;
+    }
+    selected_backend = backend;
+    return true;
+}
+
+const char *cooklang_backend_name(CooklangBackend backend) {
+    switch (backend) {
+        case COOKLANG_BACKEND_AUTO: return "auto";
+        case COOKLANG_BACKEND_SCALAR: return "scalar";
+        case COOKLANG_BACKEND_SSE2: return "sse2";
+        case COOKLANG_BACKEND_AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+static FindSpecialFn find_special_for(CooklangBackend backend) {
+    switch (backend) {
+#ifdef COOKLANG_HAS_AVX2
+        case COOKLANG_BACKEND_AVX2:
+            return find_special_avx2;
+#endif
+#ifdef COOKLANG_HAS_SSE2
+        case COOKLANG_BACKEND_SSE2:
+            return find_special_sse2;
+#endif
+        default:
+            return find_special_scalar;
+    }
+}
+
+void cooklang_entity_list_init(CooklangEntityList *list) {
+    list->entities = NULL;
+    list->length = 0;
+    list->capacity = 0;
+}
+
+void cooklang_entity_list_free(CooklangEntityList *list) {
+    free(list->entities);
+    cooklang_entity_list_init(list);
+}
+
+static uint32_t row_at(Extractor *ex, const char *position) {
+    const char *cursor = ex->row_position;
+    while ((cursor = memchr(cursor, '\n', (size_t)(position - cursor))) != NULL) {
+        ex->row++;
+        cursor++;
+    }
+    ex->row_position = position;
+    return ex->row;
+}
+
+static CooklangEntity *push_entity(Extractor *ex, CooklangEntityKind kind, const char *at) {
+    CooklangEntityList *list = ex->list;
+    if (list->length == list->capacity) {
+        uint32_t new_capacity = list->capacity ? list->capacity * 2 : 32;
+        CooklangEntity *entities = realloc(list->entities, new_capacity * sizeof(CooklangEntity));
+        if (!entities) {
+            ex->ok = false;
+            return NULL;
+        }
+        list->entities = entities;
+        list->capacity = new_capacity;
+    }
+    CooklangEntity *entity = &list->entities[list->length++];
+    memset(entity, 0, sizeof(*entity));
+    entity->kind = (uint8_t)kind;
+    entity->row = row_at(ex, at);
+    return entity;
+}
+
+static CooklangSpan make_span(const Extractor *ex, const char *start, const char *end) {
+    while (start < end && is_trimmable(*start)) {
+        start++;
+    }
+    while (end > start && is_trimmable(end[-1])) {
+        end--;
+    }
+    CooklangSpan span = {
+        (uint32_t)(start - ex->source),
+        (uint32_t)(end - ex->source),
+    };
+    return span;
+}
+
+static inline const char *skip_whitespace(const Extractor *ex, const char *cursor) {
+    while (cursor < ex->end && is_whitespace(*cursor)) {
+        cursor++;
+    }
+    return cursor;
+}
+
+static inline const char *line_end(const Extractor *ex, const char *cursor) {
+    const char *newline = memchr(cursor, '\n', (size_t)(ex->end - cursor));
+    return newline ? newline : ex->end;
+}
+
+static inline bool at_block_comment(const Extractor *ex, const char *cursor) {
+    return cursor + 1 < ex->end && cursor[0] == '[' && cursor[1] == '-';
+}
+
+// Block comments run from [- to the first -] and may span lines.
+static const char *skip_block_comment(const Extractor *ex, const char *cursor) {
+    cursor += 2;
+    for (;;) {
+        const char *dash = memchr(cursor, '-', (size_t)(ex->end - cursor));
+        if (!dash) {
+            cursor = ex->end;
+            break;
+        }
+        if (dash + 1 < ex->end && dash[1] == ']') {
+            cursor = dash + 2;
+            break;
+        }
+        cursor = dash + 1;
+    }
+    return cursor;
+}
+
+// Whitespace and block comments are extras and may appear between any two
+// tokens without ending the current line.
+static const char *skip_extras(const Extractor *ex, const char *cursor) {
+    for (;;) {
+        cursor = skip_whitespace(ex, cursor);
+        if (!at_block_comment(ex, cursor)) {
+            return cursor;
+        }
+        cursor = skip_block_comment(ex, cursor);
+    }
+}
+
+// Mirrors scan_multiword: a word, then further words separated by a single
+// space or tab, keeping them only if a `{` follows. Returns the end of the
+// name, or NULL if the cursor is not on a word.
+static const char *scan_multiword(const Extractor *ex, const char *cursor) {
+    const char *end = ex->end;
+    if (cursor >= end || word_length(cursor, end) == 0) {
+        return NULL;
+    }
+    cursor = skip_word(cursor, end);
+    if (cursor < end && *cursor == '{') {
+        return cursor;
+    }
+
+    const char *mark = cursor;
+    while (cursor < end && is_whitespace(*cursor)) {
+        cursor++;
+        if (cursor < end && word_length(cursor, end) > 0) {
+            cursor = skip_word(cursor, end);
+            if (cursor < end && *cursor == '{') {
+                mark = cursor;
+            }
+        } else {
+            break;
+        }
+    }
+    return mark;
+}
+
+// Mirrors scan_text_until with the `@#~{}()` delimiters. Text is not
+// reported, only the position where the scanner starts its next token:
+// before a delimiter, or after the first byte of `--` or `[-`.
+static const char *skip_text(const Extractor *ex, const char *cursor) {
+    const char *end = ex->end;
+    for (;;) {
+        cursor = ex->find_special(cursor, end);
+        if (cursor == end) {
+            return end;
+        }
+        switch (*cursor) {
+            case '[':
+            case '-':
+                if (cursor + 1 < end && cursor[1] == '-') {
+                    return cursor + 1;
+                }
+                cursor++;
+                break;
+            default:
+                return cursor;
+        }
+    }
+}
+
+// Scans a parenthesized note starting at `(`. Returns the position after
+// the closing `)`, or NULL if the note is empty or not closed on its line.
+static const char *scan_note(const Extractor *ex, const char *cursor, CooklangSpan *content) {
+    const char *start = skip_extras(ex, cursor + 1);
+    int depth = 0;
+    for (cursor = start; cursor < ex->end; cursor++) {
+        char c = *cursor;
+        if (c == '(') {
+            depth++;
+        } else if (c == ')') {
+            if (depth == 0) {
+                break;
+            }
+            depth--;
+        } else if (c == '\n') {
+            return NULL;
+        }
+    }
+    if (cursor == start || cursor == ex->end) {
+        return NULL;
+    }
+    *content = make_span(ex, start, cursor);
+    return cursor + 1;
+}
+
+// Scans an ingredient, cookware or timer starting at its sigil and returns
+// the position after the last byte that belongs to it.
+static const char *scan_entity(Extractor *ex, CooklangEntityKind kind, const char *cursor) {
+    const char *sigil = cursor;
+    const char *end = ex->end;
+    const char *name_start = skip_extras(ex, cursor + 1);
+    const char *name_end;
+    uint8_t flags = 0;
+
+    if (kind == COOKLANG_ENTITY_INGREDIENT && name_start < end && *name_start == '.') {
+        const char *after_dot = name_start + 1;
+        if (after_dot < end && (*after_dot == '/' || *after_dot == '\\')) {
+            name_end = after_dot + 1;
+            while (name_end < end && *name_end != '{' && *name_end != '(' &&
+                   *name_end != '\n' && *name_end != '@' && *name_end != '#' &&
+                   *name_end != '~') {
+                name_end++;
+            }
+            flags |= COOKLANG_ENTITY_RECIPE_REFERENCE;
+        } else {
+            name_end = scan_multiword(ex, after_dot);
+        }
+    } else {
+        name_end = scan_multiword(ex, name_start);
+    }
+
+    if (!name_end) {
+        if (kind != COOKLANG_ENTITY_TIMER) {
+            return sigil + 1;
+        }
+        name_end = name_start = sigil + 1;
+    }
+
+    CooklangSpan name = make_span(ex, name_start, name_end);
+    CooklangSpan quantity = {0, 0};
+    CooklangSpan note = {0, 0};
+    cursor = name_end;
+
+    const char *next = skip_extras(ex, cursor);
+    if (next < end && *next == '{') {
+        const char *content = skip_extras(ex, next + 1);
+        const char *close = memchr(content, '}', (size_t)(end - content));
+        if (close) {
+            quantity = make_span(ex, content, close);
+            flags |= COOKLANG_ENTITY_HAS_QUANTITY;
+            cursor = close + 1;
+            next = skip_extras(ex, cursor);
+        }
+    }
+    if (next < end && *next == '(') {
+        const char *after = scan_note(ex, next, &note);
+        if (after) {
+            flags |= COOKLANG_ENTITY_HAS_NOTE;
+            cursor = after;
+        }
+    }
+
+    CooklangEntity *entity = push_entity(ex, kind, sigil);
+    if (entity) {
+        entity->flags = flags;
+        entity->name = name;
+        entity->quantity = quantity;
+        entity->note = note;
+    }
+    return cursor;
+}
+
+// Scans the `---` delimited block at the very start of a recipe.
+static const char *scan_frontmatter(Extractor *ex, const char *cursor) {
+    const char *content = cursor + 4;
+    const char *line = content;
+    while (line < ex->end) {
+        const char *eol = line_end(ex, line);
+        if (eol - line == 3 && memcmp(line, "---", 3) == 0) {
+            CooklangEntity *entity = push_entity(ex, COOKLANG_ENTITY_FRONTMATTER, cursor);
+            if (entity) {
+                entity->value = make_span(ex, content, line);
+            }
+            return eol;
+        }
+        line = eol < ex->end ? eol + 1 : eol;
+    }
+    return cursor;
+}
+
+// Scans `>> key: value`, starting at the first `>`. Returns NULL if the key
+// is empty, in which case the scanner treats the line as step text.
+static const char *scan_metadata(Extractor *ex, const char *cursor) {
+    const char *key_start = skip_whitespace(ex, cursor + 2);
+    const char *key_end = key_start;
+    while (key_end < ex->end && *key_end != ':' && *key_end != '\n') {
+        key_end++;
+    }
+    if (key_end == key_start) {
+        return NULL;
+    }
+    if (key_end == ex->end || *key_end != ':') {
+        return key_end;
+    }
+
+    const char *value_start = skip_extras(ex, key_end + 1);
+    const char *value_end = line_end(ex, value_start);
+    CooklangSpan value = make_span(ex, value_start, value_end);
+    if (value.start == value.end) {
+        return value_end;
+    }
+
+    CooklangEntity *entity = push_entity(ex, COOKLANG_ENTITY_METADATA, cursor);
+    if (entity) {
+        entity->name = make_span(ex, key_start, key_end);
+        entity->value = value;
+    }
+    return value_end;
+}
+
+// Scans `= name =`, starting at the first `=`.
+static const char *scan_section(Extractor *ex, const char *cursor) {
+    while (cursor < ex->end && *cursor == '=') {
+        cursor++;
+    }
+    const char *name_start = skip_whitespace(ex, cursor);
+    const char *name_end = name_start;
+    while (name_end < ex->end && *name_end != '\n' && *name_end != '=') {
+        name_end++;
+    }
+
+    CooklangEntity *entity = push_entity(ex, COOKLANG_ENTITY_SECTION, cursor);
+    if (entity) {
+        entity->name = make_span(ex, name_start, name_end);
+    }
+
+    cursor = name_end;
+    while (cursor < ex->end && (*cursor == '=' || is_whitespace(*cursor))) {
+        cursor++;
+    }
+    return cursor;
+}
+
+// Handles the first token of a line, where the scanner recognizes
+// metadata, sections and full-line comments. Returns the position where
+// step scanning continues.
+static const char *scan_line_start(Extractor *ex, const char *line, const char *cursor) {
+    const char *end = ex->end;
+    char c = *cursor;
+    char next = cursor + 1 < end ? cursor[1] : '\0';
+
+    if (c == '>') {
+        if (next == '>') {
+            const char *after = scan_metadata(ex, cursor);
+            return after ? after : skip_text(ex, cursor + 2);
+        }
+        return skip_text(ex, cursor + 1);
+    }
+
+    if (c == '=') {
+        return scan_section(ex, cursor);
+    }
+
+    if (c == '-') {
+        if (cursor == line) {
+            // `---` on its own line is a frontmatter delimiter, which is
+            // only valid at the start of the recipe.
+            if (next == '-' && end - cursor >= 3 && cursor[2] == '-' &&
+                (end - cursor == 3 || cursor[3] == '\n')) {
+                return line_end(ex, cursor);
+            }
+            if (next != '-') {
+                return line_end(ex, cursor);
+            }
+        }
+        if (next == '-') {
+            return line_end(ex, cursor);
+        }
+        return skip_text(ex, cursor + 1);
+    }
+
+    if (c == '[') {
+        return line_end(ex, cursor);
+    }
+
+    return cursor;
+}
+
+static const char *scan_line(Extractor *ex, const char *line) {
+    const char *end = ex->end;
+    const char *cursor = skip_extras(ex, line);
+    if (cursor < end && *cursor != '\n') {
+        cursor = scan_line_start(ex, line, cursor);
+    }
+
+    while (cursor < end && ex->ok) {
+        cursor = skip_extras(ex, cursor);
+        if (cursor == end) {
+            break;
+        }
+        switch (*cursor) {
+            case '\n':
+                return cursor + 1;
+            case '@':
+                cursor = scan_entity(ex, COOKLANG_ENTITY_INGREDIENT, cursor);
+                break;
+            case '#':
+                cursor = scan_entity(ex, COOKLANG_ENTITY_COOKWARE, cursor);
+                break;
+            case '~':
+                cursor = scan_entity(ex, COOKLANG_ENTITY_TIMER, cursor);
+                break;
+            case '(': {
+                CooklangSpan content;
+                const char *after = scan_note(ex, cursor, &content);
+                cursor = after ? after : cursor + 1;
+                break;
+            }
+            case '{':
+            case '}':
+            case ')':
+                cursor++;
+                break;
+            case '-':
+                if (cursor + 1 < end && cursor[1] == '-') {
+                    cursor = line_end(ex, cursor);
+                } else {
+                    cursor = skip_text(ex, cursor + 1);
+                }
+                break;
+            default:
+                cursor = skip_text(ex, cursor + 1);
+                break;
+        }
+    }
+    return cursor;
+}
+
+bool cooklang_extract(const char *source, uint32_t length, CooklangEntityList *list) {
+    Extractor ex = {
+        .source = source,
+        .end = source + length,
+        .row_position = source,
+        .row = 0,
+        .list = list,
+        .find_special = find_special_for(cooklang_extract_backend()),
+        .ok = true,
+    };
+
+    const char *cursor = source;
+    if (length >= 4 && memcmp(source, "---\n", 4) == 0) {
+        cursor = scan_frontmatter(&ex, cursor);
+    }
+
+    while (cursor < ex.end && ex.ok) {
+        cursor = scan_line(&ex, cursor);
+    }
+    return ex.ok;
+}
@@ -0,0 +1,92 @@
+#ifndef COOKLANG_EXTRACT_H_
+#define COOKLANG_EXTRACT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Flat entity extraction for bulk ingestion.
+//
+// `cooklang_extract` makes a single pass over a recipe without building a
+// syntax tree and reports the ingredients, cookware, timers, metadata,
+// sections and frontmatter that `tree_sitter_cooklang` produces for the
+// same input. Token boundaries follow the rules in `src/scanner.c`, so for
+// any input that parses without errors the two agree entity for entity
+// (see `test/test_differential.c`). Input containing syntax errors is
+// extracted on a best-effort basis.
+
+typedef enum {
+    COOKLANG_ENTITY_INGREDIENT,
+    COOKLANG_ENTITY_COOKWARE,
+    COOKLANG_ENTITY_TIMER,
+    COOKLANG_ENTITY_METADATA,
+    COOKLANG_ENTITY_SECTION,
+    COOKLANG_ENTITY_FRONTMATTER,
+} CooklangEntityKind;
+
+enum {
+    COOKLANG_ENTITY_HAS_QUANTITY = 1 << 0,
+    COOKLANG_ENTITY_HAS_NOTE = 1 << 1,
+    COOKLANG_ENTITY_RECIPE_REFERENCE = 1 << 2,
+};
+
+// Half-open byte range into the source, trimmed of surrounding whitespace.
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+} CooklangSpan;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t flags;
+    uint32_t row;
+    // Ingredient, cookware or timer name, metadata key, or section name.
+    CooklangSpan name;
+    union {
+        // Text between the braces of an ingredient, cookware or timer.
+        CooklangSpan quantity;
+        // Metadata value, or the body of the frontmatter block.
+        CooklangSpan value;
+    };
+    // Text between the parentheses following an ingredient, cookware or timer.
+    CooklangSpan note;
+} CooklangEntity;
+
+typedef struct {
+    CooklangEntity *entities;
+    uint32_t length;
+    uint32_t capacity;
+} CooklangEntityList;
+
+typedef enum {
+    COOKLANG_BACKEND_AUTO,
+    COOKLANG_BACKEND_SCALAR,
+    COOKLANG_BACKEND_SSE2,
+    COOKLANG_BACKEND_AVX2,
+} CooklangBackend;
+
+void cooklang_entity_list_init(CooklangEntityList *list);
+void cooklang_entity_list_free(CooklangEntityList *list);
+
+// Append the entities of `source` to `list`. Returns false if the list
+// could not grow, in which case the entities extracted so far are kept.
+bool cooklang_extract(const char *source, uint32_t length, CooklangEntityList *list);
+
+// Select the byte scanning implementation. Returns false if the backend is
+// not supported on this machine. Not safe to call while other threads are
+// extracting.
+bool cooklang_extract_set_backend(CooklangBackend backend);
+
+// The backend currently in use, with COOKLANG_BACKEND_AUTO resolved.
+CooklangBackend cooklang_extract_backend(void);
+
+const char *cooklang_backend_name(CooklangBackend backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_EXTRACT_H_
@@ -0,0 +1,179 @@
+#define _DEFAULT_SOURCE
+
+#include "cooklang_file_input.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Mapped pages this many chunks behind the parser are kept, for the lexer
+// to look back at without faulting them in again.
+#define RETAINED_CHUNKS 4
+
+// The longest UTF-8 character. Chunks are at least this long, and a
+// buffered chunk is only reused if it has this many bytes left, since the
+// lexer asks again at the same position when a chunk ends within a
+// character.
+#define MAX_CHARACTER_BYTES 4
+
+static bool read_fully(int fd, char *buffer, uint32_t length, uint32_t offset) {
+    while (length > 0) {
+        ssize_t count = pread(fd, buffer, length, offset);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        buffer += count;
+        length -= (uint32_t)count;
+        offset += (uint32_t)count;
+    }
+    return true;
+}
+
+bool cooklang_file_input_open(CooklangFileInput *input, const char *path,
+                              CooklangFileInputMode mode, uint32_t chunk_size) {
+    memset(input, 0, sizeof(*input));
+    input->mode = mode;
+    input->chunk_size = chunk_size ? chunk_size : COOKLANG_FILE_INPUT_CHUNK_SIZE;
+    if (input->chunk_size < MAX_CHARACTER_BYTES) {
+        input->chunk_size = MAX_CHARACTER_BYTES;
+    }
+    input->fd = open(path, O_RDONLY);
+    if (input->fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(input->fd, &info) != 0) {
+        goto error;
+    }
+    if ((uint64_t)info.st_size > UINT32_MAX) {
+        errno = EFBIG;
+        goto error;
+    }
+    input->length = (uint32_t)info.st_size;
+
+    if (mode == COOKLANG_FILE_INPUT_MMAP) {
+        if (input->length) {
+            void *map = mmap(NULL, input->length, PROT_READ, MAP_PRIVATE, input->fd, 0);
+            if (map == MAP_FAILED) {
+                goto error;
+            }
+            madvise(map, input->length, MADV_SEQUENTIAL);
+            input->map = map;
+        }
+    } else {
+        input->buffer = malloc(input->chunk_size);
+        if (!input->buffer) {
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    return true;
+
+error:
+    close(input->fd);
+    input->fd = -1;
+    return false;
+}
+
+void cooklang_file_input_close(CooklangFileInput *input) {
+    if (input->map) {
+        munmap((void *)input->map, input->length);
+    }
+    free(input->buffer);
+    if (input->fd >= 0) {
+        close(input->fd);
+    }
+    memset(input, 0, sizeof(*input));
+    input->fd = -1;
+}
+
+static const char *read_buffered(void *payload, uint32_t byte_index, TSPoint position,
+                                 uint32_t *bytes_read) {
+    (void)position;
+    CooklangFileInput *input = payload;
+    if (byte_index >= input->length) {
+        *bytes_read = 0;
+        return "";
+    }
+    uint32_t buffer_end = input->buffer_start + input->buffer_length;
+    bool buffered = byte_index >= input->buffer_start && byte_index < buffer_end &&
+                    (buffer_end - byte_index >= MAX_CHARACTER_BYTES || buffer_end == input->length);
+    if (!buffered) {
+        uint32_t length = input->length - byte_index;
+        if (length > input->chunk_size) {
+            length = input->chunk_size;
+        }
+        if (!read_fully(input->fd, input->buffer, length, byte_index)) {
+            // Treat the file as ending here rather than parse garbage.
+            input->buffer_length = 0;
+            *bytes_read = 0;
+            return "";
+        }
+        input->buffer_start = byte_index;
+        input->buffer_length = length;
+        buffer_end = byte_index + length;
+    }
+    *bytes_read = buffer_end - byte_index;
+    return input->buffer + (byte_index - input->buffer_start);
+}
+
+static const char *read_mapped(void *payload, uint32_t byte_index, TSPoint position,
+                               uint32_t *bytes_read) {
+    (void)position;
+    CooklangFileInput *input = payload;
+    if (byte_index >= input->length) {
+        *bytes_read = 0;
+        return "";
+    }
+    uint32_t retained = RETAINED_CHUNKS * input->chunk_size;
+    if (byte_index > retained) {
+        uint32_t page_size = (uint32_t)sysconf(_SC_PAGESIZE);
+        uint32_t release = (byte_index - retained) & ~(page_size - 1);
+        if (release > input->released) {
+            // Clean file-backed pages; touching them again reads them back.
+            madvise((char *)input->map + input->released, release - input->released, MADV_DONTNEED);
+            input->released = release;
+        }
+    }
+    uint32_t length = input->length - byte_index;
+    *bytes_read = length < input->chunk_size ? length : input->chunk_size;
+    return input->map + byte_index;
+}
+
+TSInput cooklang_file_input(CooklangFileInput *input) {
+    return (TSInput){
+        .payload = input,
+        .read = input->mode == COOKLANG_FILE_INPUT_MMAP ? read_mapped : read_buffered,
+        .encoding = TSInputEncodingUTF8,
+    };
+}
+
+bool cooklang_file_input_slice(CooklangFileInput *input, uint32_t start, uint32_t end,
+                               char *buffer) {
+    if (start > end || end > input->length) {
+        return false;
+    }
+    if (input->map) {
+        memcpy(buffer, input->map + start, end - start);
+        return true;
+    }
+    return read_fully(input->fd, buffer, end - start, start);
+}
+
+TSTree *cooklang_parse_file(TSParser *parser, const char *path, CooklangFileInputMode mode,
+                            uint32_t chunk_size) {
+    CooklangFileInput input;
+    if (!cooklang_file_input_open(&input, path, mode, chunk_size)) {
+        return NULL;
+    }
+    TSTree *tree = ts_parser_parse(parser, NULL, cooklang_file_input(&input));
+    cooklang_file_input_close(&input);
+    return tree;
+}
@@ -0,0 +1,68 @@
+#ifndef COOKLANG_FILE_INPUT_H_
+#define COOKLANG_FILE_INPUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parsing a recipe file without reading it into memory whole.
+//
+// A `CooklangFileInput` is a `TSInput` over an open file that hands the
+// parser one chunk at a time, either from a fixed-size buffer filled with
+// `pread` or from a read-only memory mapping whose pages are dropped again
+// once the parser has moved a few chunks past them. Either way the
+// resident memory of a parse is the tree plus a few chunks, however large
+// the file. Trees are limited to 4 GiB of input, and so are files.
+
+typedef enum {
+    COOKLANG_FILE_INPUT_READ,
+    COOKLANG_FILE_INPUT_MMAP,
+} CooklangFileInputMode;
+
+// Chunk size used when none is given.
+#define COOKLANG_FILE_INPUT_CHUNK_SIZE (64 * 1024)
+
+typedef struct {
+    int fd;
+    uint32_t length;
+    uint8_t mode;
+    uint32_t chunk_size;
+    // COOKLANG_FILE_INPUT_READ: the bytes at `[buffer_start, buffer_start +
+    // buffer_length)`.
+    char *buffer;
+    uint32_t buffer_start;
+    uint32_t buffer_length;
+    // COOKLANG_FILE_INPUT_MMAP: the whole file, of which the pages below
+    // `released` have been handed back.
+    const char *map;
+    uint32_t released;
+} CooklangFileInput;
+
+// Open `path` for parsing, reading `chunk_size` bytes at a time (0 for the
+// default, and at least 4). Returns false and sets `errno` if the file cannot be opened or
+// mapped, or is larger than 4 GiB.
+bool cooklang_file_input_open(CooklangFileInput *input, const char *path,
+                              CooklangFileInputMode mode, uint32_t chunk_size);
+void cooklang_file_input_close(CooklangFileInput *input);
+
+// The input to pass to `ts_parser_parse`; valid while `input` is open.
+TSInput cooklang_file_input(CooklangFileInput *input);
+
+// Copy the bytes `[start, end)` of the file, e.g. the text of a node, to
+// `buffer`. Returns false if they could not all be read.
+bool cooklang_file_input_slice(CooklangFileInput *input, uint32_t start, uint32_t end,
+                               char *buffer);
+
+// Parse the file at `path` with `parser`; NULL if it could not be read.
+TSTree *cooklang_parse_file(TSParser *parser, const char *path, CooklangFileInputMode mode,
+                            uint32_t chunk_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_FILE_INPUT_H_
@@ -0,0 +1,429 @@
+#include "cooklang_format.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Lines are formatted into `line` and compared with the source; writes go
+// through `ok`, so a failed allocation stops all further output.
+typedef struct {
+    const char *source;
+    uint32_t length;
+    CooklangSymbols symbols;
+    CooklangEditList *list;
+    CooklangText line;
+    // A space is owed before the next byte written to `line`.
+    bool pending_space;
+    // End of the last line formatted, so overlapping ranges visit it once.
+    uint32_t done;
+    bool ok;
+} Formatter;
+
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+void cooklang_edit_list_init(CooklangEditList *list) {
+    list->edits = NULL;
+    list->length = 0;
+    list->capacity = 0;
+    cooklang_text_init(&list->text);
+}
+
+void cooklang_edit_list_free(CooklangEditList *list) {
+    free(list->edits);
+    cooklang_text_free(&list->text);
+    cooklang_edit_list_init(list);
+}
+
+void cooklang_edit_list_clear(CooklangEditList *list) {
+    list->length = 0;
+    list->text.length = 0;
+}
+
+static bool push_edit(CooklangEditList *list, uint32_t start, uint32_t end, const char *text,
+                      uint32_t text_length) {
+    if (list->length == list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 16;
+        CooklangEdit *edits = realloc(list->edits, capacity * sizeof(CooklangEdit));
+        if (!edits) {
+            return false;
+        }
+        list->edits = edits;
+        list->capacity = capacity;
+    }
+    CooklangEdit *edit = &list->edits[list->length];
+    edit->start = start;
+    edit->end = end;
+    edit->text_start = list->text.length;
+    edit->text_length = text_length;
+    if (!cooklang_text_append(&list->text, text, text_length)) {
+        return false;
+    }
+    list->length++;
+    return true;
+}
+
+static inline void put(Formatter *fmt, const char *data, uint32_t length) {
+    fmt->ok = fmt->ok && cooklang_text_append(&fmt->line, data, length);
+}
+
+static inline void put_char(Formatter *fmt, char c) {
+    put(fmt, &c, 1);
+}
+
+static void flush_space(Formatter *fmt) {
+    if (fmt->pending_space && fmt->line.length > 0 &&
+        fmt->line.data[fmt->line.length - 1] != '\n') {
+        put_char(fmt, ' ');
+    }
+    fmt->pending_space = false;
+}
+
+// Step text: runs of blanks become one space, dropped at the start and end
+// of a line.
+static void put_text(Formatter *fmt, uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; i++) {
+        char c = fmt->source[i];
+        if (is_blank(c)) {
+            fmt->pending_space = true;
+        } else if (c == '\n') {
+            fmt->pending_space = false;
+            put_char(fmt, '\n');
+        } else {
+            flush_space(fmt);
+            put_char(fmt, c);
+        }
+    }
+}
+
+// Names, notes and quantity parts: trimmed, inner whitespace collapsed.
+static void put_words(Formatter *fmt, uint32_t start, uint32_t end) {
+    bool gap = false;
+    bool any = false;
+    for (uint32_t i = start; i < end; i++) {
+        char c = fmt->source[i];
+        if (cooklang_is_space(c)) {
+            gap = any;
+            continue;
+        }
+        if (gap) {
+            put_char(fmt, ' ');
+            gap = false;
+        }
+        put_char(fmt, c);
+        any = true;
+    }
+}
+
+// Numbers and ranges lose the spaces around `/` and `-` as well, so
+// `1 / 2 - 1` becomes `1/2-1` while `1 1/2` keeps its one space.
+static void put_amount(Formatter *fmt, uint32_t start, uint32_t end) {
+    bool gap = false;
+    char last = '\0';
+    for (uint32_t i = start; i < end; i++) {
+        char c = fmt->source[i];
+        if (cooklang_is_space(c)) {
+            gap = last != '\0';
+            continue;
+        }
+        if (gap && c != '/' && c != '-' && last != '/' && last != '-') {
+            put_char(fmt, ' ');
+        }
+        gap = false;
+        put_char(fmt, c);
+        last = c;
+    }
+}
+
+// The first child of `node` with `symbol`, or a null node.
+static TSNode child_of(TSNode node, TSSymbol symbol) {
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_child(node, i);
+        if (ts_node_symbol(child) == symbol) {
+            return child;
+        }
+    }
+    return (TSNode){0};
+}
+
+static inline void put_node_words(Formatter *fmt, TSNode node) {
+    if (!ts_node_is_null(node)) {
+        put_words(fmt, ts_node_start_byte(node), ts_node_end_byte(node));
+    }
+}
+
+// `{amount%unit}`; false if the quantity is unterminated and must be kept.
+static bool put_quantity(Formatter *fmt, TSNode node) {
+    uint32_t start = ts_node_start_byte(node) + 1;
+    uint32_t end = ts_node_end_byte(node);
+    if (end <= start || fmt->source[end - 1] != '}') {
+        return false;
+    }
+    end--;
+    CooklangQuantity quantity;
+    cooklang_quantity_parse(fmt->source, (CooklangSpan){start, end}, &quantity);
+    put_char(fmt, '{');
+    if (quantity.flags & COOKLANG_QUANTITY_FIXED) {
+        put_char(fmt, '=');
+    }
+    if (quantity.kind == COOKLANG_QUANTITY_NUMBER || quantity.kind == COOKLANG_QUANTITY_RANGE) {
+        put_amount(fmt, quantity.amount.start, quantity.amount.end);
+    } else {
+        put_words(fmt, quantity.amount.start, quantity.amount.end);
+    }
+    if (quantity.unit.end > quantity.unit.start) {
+        put_char(fmt, '%');
+        put_words(fmt, quantity.unit.start, quantity.unit.end);
+    }
+    put_char(fmt, '}');
+    return true;
+}
+
+static void put_note(Formatter *fmt, TSNode note) {
+    put_char(fmt, '(');
+    put_node_words(fmt, child_of(note, fmt->symbols.note_content));
+    put_char(fmt, ')');
+}
+
+// An ingredient, cookware or timer. Anything unexpected inside it, such as
+// a comment, keeps the entity as written.
+static void put_entity(Formatter *fmt, TSNode node, TSSymbol name_symbol) {
+    const CooklangSymbols *symbols = &fmt->symbols;
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_child(node, i);
+        TSSymbol symbol = ts_node_symbol(child);
+        bool known = !ts_node_is_named(child) || symbol == name_symbol ||
+                     symbol == symbols->quantity || symbol == symbols->note;
+        if (!known || (symbol == symbols->quantity &&
+                       fmt->source[ts_node_end_byte(child) - 1] != '}')) {
+            put(fmt, fmt->source + ts_node_start_byte(node),
+                ts_node_end_byte(node) - ts_node_start_byte(node));
+            return;
+        }
+    }
+
+    put_char(fmt, fmt->source[ts_node_start_byte(node)]);
+    put_node_words(fmt, child_of(node, name_symbol));
+    TSNode quantity = child_of(node, symbols->quantity);
+    if (!ts_node_is_null(quantity)) {
+        put_quantity(fmt, quantity);
+    }
+    TSNode note = child_of(node, symbols->note);
+    if (!ts_node_is_null(note)) {
+        put_note(fmt, note);
+    }
+}
+
+static void put_step(Formatter *fmt, TSNode node) {
+    const CooklangSymbols *symbols = &fmt->symbols;
+    uint32_t position = ts_node_start_byte(node);
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_child(node, i);
+        TSSymbol symbol = ts_node_symbol(child);
+        uint32_t start = ts_node_start_byte(child);
+        uint32_t end = ts_node_end_byte(child);
+        put_text(fmt, position, start);
+        position = end;
+        if (symbol == symbols->text) {
+            put_text(fmt, start, end);
+            continue;
+        }
+        flush_space(fmt);
+        if (symbol == symbols->ingredient) {
+            put_entity(fmt, child, symbols->ingredient_name);
+        } else if (symbol == symbols->cookware) {
+            put_entity(fmt, child, symbols->cookware_name);
+        } else if (symbol == symbols->timer) {
+            put_entity(fmt, child, symbols->timer_name);
+        } else if (symbol == symbols->note) {
+            put_note(fmt, child);
+        } else {
+            // Comments are kept as written.
+            put(fmt, fmt->source + start, end - start);
+        }
+    }
+    fmt->pending_space = false;
+}
+
+// `>> key: value`, `= name` and `> text`, with the markers the scanner
+// includes in the tokens stripped off.
+static void put_marked(Formatter *fmt, const char *prefix, TSNode node, char marker) {
+    put(fmt, prefix, (uint32_t)strlen(prefix));
+    if (ts_node_is_null(node)) {
+        return;
+    }
+    uint32_t start = ts_node_start_byte(node);
+    uint32_t end = ts_node_end_byte(node);
+    while (start < end &&
+           (cooklang_is_space(fmt->source[start]) || fmt->source[start] == marker)) {
+        start++;
+    }
+    while (end > start &&
+           (cooklang_is_space(fmt->source[end - 1]) || fmt->source[end - 1] == marker)) {
+        end--;
+    }
+    if (end > start) {
+        put_char(fmt, ' ');
+        put(fmt, fmt->source + start, end - start);
+    }
+}
+
+// Format the line holding the top-level `node` and record the difference.
+static void format_node(Formatter *fmt, TSNode node) {
+    const CooklangSymbols *symbols = &fmt->symbols;
+    TSSymbol symbol = ts_node_symbol(node);
+    if ((symbol != symbols->metadata && symbol != symbols->section && symbol != symbols->step &&
+         symbol != symbols->recipe_note) ||
+        ts_node_has_error(node)) {
+        return;
+    }
+
+    // The line includes indentation before the node and blanks after it.
+    uint32_t start = ts_node_start_byte(node);
+    uint32_t end = ts_node_end_byte(node);
+    uint32_t line_start = start;
+    while (line_start > 0 && is_blank(fmt->source[line_start - 1]) &&
+           fmt->source[line_start - 1] != '\r') {
+        line_start--;
+    }
+    if (line_start == 0 || fmt->source[line_start - 1] == '\n') {
+        start = line_start;
+    }
+    while (end < fmt->length && is_blank(fmt->source[end]) && fmt->source[end] != '\r') {
+        end++;
+    }
+
+    fmt->line.length = 0;
+    fmt->pending_space = false;
+    if (symbol == symbols->step) {
+        put_step(fmt, node);
+    } else if (symbol == symbols->metadata) {
+        put_marked(fmt, ">>", child_of(node, symbols->metadata_key), '>');
+        put_char(fmt, ':');
+        put_marked(fmt, "", child_of(node, symbols->metadata_value), '\0');
+    } else if (symbol == symbols->section) {
+        put_marked(fmt, "=", child_of(node, symbols->section_name), '=');
+    } else {
+        put_marked(fmt, ">", child_of(node, symbols->recipe_note_text), '>');
+    }
+    if (!fmt->ok) {
+        return;
+    }
+
+    // Trim the edit to the bytes that differ.
+    const char *old_text = fmt->source + start;
+    const char *new_text = fmt->line.data;
+    uint32_t old_length = end - start;
+    uint32_t new_length = fmt->line.length;
+    uint32_t prefix = 0;
+    while (prefix < old_length && prefix < new_length && old_text[prefix] == new_text[prefix]) {
+        prefix++;
+    }
+    if (prefix == old_length && prefix == new_length) {
+        return;
+    }
+    uint32_t suffix = 0;
+    while (suffix < old_length - prefix && suffix < new_length - prefix &&
+           old_text[old_length - 1 - suffix] == new_text[new_length - 1 - suffix]) {
+        suffix++;
+    }
+    fmt->ok = push_edit(fmt->list, start + prefix, end - suffix, new_text + prefix,
+                        new_length - prefix - suffix);
+}
+
+static void formatter_init(Formatter *fmt, const char *source, uint32_t length, TSNode root,
+                           CooklangEditList *list) {
+    const TSLanguage *language = ts_node_language(root);
+    fmt->source = source;
+    fmt->length = length;
+    cooklang_symbols_init(&fmt->symbols, language);
+    fmt->list = list;
+    cooklang_text_init(&fmt->line);
+    fmt->pending_space = false;
+    fmt->done = 0;
+    fmt->ok = true;
+}
+
+bool cooklang_format_recipe(const char *source, uint32_t length, TSNode root,
+                            CooklangEditList *list) {
+    Formatter fmt;
+    formatter_init(&fmt, source, length, root, list);
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+        do {
+            format_node(&fmt, ts_tree_cursor_current_node(&cursor));
+        } while (fmt.ok && ts_tree_cursor_goto_next_sibling(&cursor));
+    }
+    ts_tree_cursor_delete(&cursor);
+    cooklang_text_free(&fmt.line);
+    return fmt.ok;
+}
+
+static int compare_ranges(const void *a, const void *b) {
+    const TSRange *left = a;
+    const TSRange *right = b;
+    return left->start_byte < right->start_byte ? -1 : left->start_byte > right->start_byte;
+}
+
+bool cooklang_format_changes(const char *source, uint32_t length, const TSTree *old_tree,
+                             const TSTree *new_tree, const TSInputEdit *input_edits,
+                             uint32_t input_edit_count, CooklangEditList *list) {
+    TSNode root = ts_tree_root_node(new_tree);
+    uint32_t changed_count = 0;
+    TSRange *changed = ts_tree_get_changed_ranges(old_tree, new_tree, &changed_count);
+
+    // Edits inside a token can leave the structure unchanged, so the edited
+    // bytes are visited as well as the ranges tree-sitter reports.
+    uint32_t range_count = changed_count + input_edit_count;
+    TSRange *ranges = range_count ? realloc(changed, range_count * sizeof(TSRange)) : changed;
+    if (range_count && !ranges) {
+        free(changed);
+        return false;
+    }
+    for (uint32_t i = 0; i < input_edit_count; i++) {
+        ranges[changed_count + i].start_byte = input_edits[i].start_byte;
+        ranges[changed_count + i].end_byte = input_edits[i].new_end_byte;
+    }
+    qsort(ranges, range_count, sizeof(TSRange), compare_ranges);
+
+    Formatter fmt;
+    formatter_init(&fmt, source, length, root, list);
+    for (uint32_t i = 0; fmt.ok && i < range_count; i++) {
+        // Start one byte early so that a deletion at the end of a line
+        // still finds that line.
+        uint32_t start = ranges[i].start_byte > 0 ? ranges[i].start_byte - 1 : 0;
+        TSNode node = ts_node_first_child_for_byte(root, start);
+        while (fmt.ok && !ts_node_is_null(node) && ts_node_start_byte(node) <= ranges[i].end_byte) {
+            if (ts_node_start_byte(node) >= fmt.done) {
+                format_node(&fmt, node);
+                fmt.done = ts_node_end_byte(node);
+            }
+            node = ts_node_next_sibling(node);
+        }
+    }
+    free(ranges);
+    cooklang_text_free(&fmt.line);
+    return fmt.ok;
+}
+
+bool cooklang_edit_list_apply(const CooklangEditList *list, const char *source, uint32_t length,
+                              CooklangText *out) {
+    out->length = 0;
+    uint32_t copied = 0;
+    bool ok = cooklang_text_reserve(out, length);
+    for (uint32_t i = 0; ok && i < list->length; i++) {
+        const CooklangEdit *edit = &list->edits[i];
+        ok = cooklang_text_append(out, source + copied, edit->start - copied) &&
+             cooklang_text_append(out, list->text.data + edit->text_start, edit->text_length);
+        copied = edit->end;
+    }
+    ok = ok && cooklang_text_append(out, source + copied, length - copied);
+    if (ok) {
+        out->data[out->length] = '\0';
+    }
+    return ok;
+}
@@ -0,0 +1,77 @@
+#ifndef COOKLANG_FORMAT_H_
+#define COOKLANG_FORMAT_H_
+
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Canonical formatting of parsed recipes, as minimal text edits.
+//
+// The formatter works line by line on the top-level nodes of the tree:
+//
+//   metadata      `>>  key :value ` -> `>> key: value`
+//   sections      `== Dough ==`     -> `= Dough`
+//   recipe notes  `>note`           -> `> note`
+//   steps         runs of spaces and tabs become one space, lines are
+//                 trimmed, and entities are written without inner padding:
+//                 `@olive  oil{ 1 / 2 % cup }( cold )` -> `@olive oil{1/2%cup}(cold)`
+//
+// Frontmatter, comments and lines containing syntax errors are left as
+// written. Each reformatted line yields at most one edit, trimmed to the
+// bytes that actually change.
+//
+// `cooklang_format_changes` only visits the lines that changed between two
+// trees, so format-on-save costs the same in a large file as in a small one.
+
+typedef struct {
+    // Byte range of the source to replace.
+    uint32_t start;
+    uint32_t end;
+    // Replacement, as a range of the edit list's `text`.
+    uint32_t text_start;
+    uint32_t text_length;
+} CooklangEdit;
+
+typedef struct {
+    // Edits in source order, not overlapping.
+    CooklangEdit *edits;
+    uint32_t length;
+    uint32_t capacity;
+    CooklangText text;
+} CooklangEditList;
+
+void cooklang_edit_list_init(CooklangEditList *list);
+void cooklang_edit_list_free(CooklangEditList *list);
+
+// Remove all edits, keeping the allocated memory.
+void cooklang_edit_list_clear(CooklangEditList *list);
+
+// Append the edits that format the whole recipe to `list`. Returns false if
+// the list could not grow.
+bool cooklang_format_recipe(const char *source, uint32_t length, TSNode root,
+                            CooklangEditList *list);
+
+// Append the edits that format the lines of `new_tree` touched by the
+// ranges `ts_tree_get_changed_ranges` reports, and by `input_edits`, the
+// edits applied to `old_tree` before reparsing (may be NULL). `source` is
+// the text of `new_tree`.
+bool cooklang_format_changes(const char *source, uint32_t length, const TSTree *old_tree,
+                             const TSTree *new_tree, const TSInputEdit *input_edits,
+                             uint32_t input_edit_count, CooklangEditList *list);
+
+// Write `source` with the edits of `list` applied to `out`, replacing its
+// contents.
+bool cooklang_edit_list_apply(const CooklangEditList *list, const char *source, uint32_t length,
+                              CooklangText *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_FORMAT_H_
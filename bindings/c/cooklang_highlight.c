@@ -0,0 +1,141 @@
+#include "cooklang_highlight.h"
+#include "cooklang_threads.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const TSQuery *query;
+    // This worker's copy of the tree.
+    TSTree *tree;
+    // Captured nodes starting in [start, end) are this worker's.
+    uint32_t start;
+    uint32_t end;
+    CooklangHighlightList highlights;
+    bool ok;
+} Worker;
+
+void cooklang_highlight_list_init(CooklangHighlightList *list) {
+    list->highlights = NULL;
+    list->length = 0;
+    list->capacity = 0;
+}
+
+void cooklang_highlight_list_free(CooklangHighlightList *list) {
+    free(list->highlights);
+    cooklang_highlight_list_init(list);
+}
+
+static bool reserve(CooklangHighlightList *list, uint32_t extra) {
+    if (extra > UINT32_MAX - list->length) {
+        return false;
+    }
+    if (list->length + extra <= list->capacity) {
+        return true;
+    }
+    uint32_t capacity = list->capacity ? list->capacity : 256;
+    while (capacity < list->length + extra) {
+        capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2;
+    }
+    CooklangHighlight *highlights = realloc(list->highlights, capacity * sizeof(CooklangHighlight));
+    if (!highlights) {
+        return false;
+    }
+    list->highlights = highlights;
+    list->capacity = capacity;
+    return true;
+}
+
+static void run_worker(void *payload) {
+    Worker *worker = payload;
+    worker->ok = true;
+    if (worker->start >= worker->end) {
+        return;
+    }
+    TSQueryCursor *cursor = ts_query_cursor_new();
+    if (!cursor) {
+        worker->ok = false;
+        return;
+    }
+    ts_query_cursor_set_byte_range(cursor, worker->start, worker->end);
+    ts_query_cursor_exec(cursor, worker->query, ts_tree_root_node(worker->tree));
+    TSQueryMatch match;
+    uint32_t index;
+    while (worker->ok && ts_query_cursor_next_capture(cursor, &match, &index)) {
+        TSNode node = match.captures[index].node;
+        uint32_t start = ts_node_start_byte(node);
+        // The cursor also reports nodes that only overlap the range; those
+        // starting before it belong to an earlier worker.
+        if (start < worker->start || start >= worker->end) {
+            continue;
+        }
+        worker->ok = reserve(&worker->highlights, 1);
+        if (worker->ok) {
+            worker->highlights.highlights[worker->highlights.length++] = (CooklangHighlight){
+                start, ts_node_end_byte(node), match.captures[index].index, match.pattern_index};
+        }
+    }
+    ts_query_cursor_delete(cursor);
+}
+
+// Cut the document into `count` ranges of about equal size, each starting
+// where a child of the root starts: the root's children are the steps,
+// sections, notes and metadata, so no range starts inside one. A range
+// comes out empty when one child covers more than a share.
+static void split(TSNode root, Worker *workers, unsigned count) {
+    uint32_t length = ts_node_end_byte(root);
+    uint32_t previous = 0;
+    workers[0].start = 0;
+    for (unsigned w = 1; w < count; w++) {
+        uint32_t target = (uint32_t)((uint64_t)length * w / count);
+        TSNode child = ts_node_first_child_for_byte(root, target);
+        uint32_t boundary = ts_node_is_null(child) ? length : ts_node_start_byte(child);
+        if (boundary < previous) {
+            boundary = previous;
+        }
+        workers[w - 1].end = boundary;
+        workers[w].start = boundary;
+        previous = boundary;
+    }
+    workers[count - 1].end = UINT32_MAX;
+}
+
+bool cooklang_highlight(const TSQuery *query, const TSTree *tree, unsigned thread_count,
+                        CooklangHighlightList *list) {
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    Worker *workers = calloc(thread_count, sizeof(Worker));
+    if (!workers) {
+        return false;
+    }
+    split(ts_tree_root_node(tree), workers, thread_count);
+    bool ok = true;
+    for (unsigned w = 0; w < thread_count && ok; w++) {
+        workers[w].query = query;
+        workers[w].tree = ts_tree_copy(tree);
+        cooklang_highlight_list_init(&workers[w].highlights);
+        ok = workers[w].tree != NULL;
+    }
+    ok = ok && cooklang_run_threads(run_worker, workers, sizeof(Worker), thread_count);
+
+    uint64_t total = 0;
+    for (unsigned w = 0; w < thread_count && ok; w++) {
+        ok = workers[w].ok;
+        total += workers[w].highlights.length;
+    }
+    ok = ok && total <= UINT32_MAX && reserve(list, (uint32_t)total);
+    for (unsigned w = 0; w < thread_count; w++) {
+        if (ok && workers[w].highlights.length > 0) {
+            memcpy(list->highlights + list->length, workers[w].highlights.highlights,
+                   workers[w].highlights.length * sizeof(CooklangHighlight));
+            list->length += workers[w].highlights.length;
+        }
+        if (workers[w].tree) {
+            ts_tree_delete(workers[w].tree);
+        }
+        cooklang_highlight_list_free(&workers[w].highlights);
+    }
+    free(workers);
+    return ok;
+}
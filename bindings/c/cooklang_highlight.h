@@ -0,0 +1,51 @@
+#ifndef COOKLANG_HIGHLIGHT_H_
+#define COOKLANG_HIGHLIGHT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Running a highlight query (such as `queries/highlights.scm`) over a
+// large document on several threads.
+//
+// The document is cut into byte ranges at the starts of top-level steps,
+// sections, notes and metadata, one range per thread. Each thread gets its
+// own copy of the tree (`ts_tree_copy`) and its own query cursor limited to
+// its range, and keeps the captures of nodes that start in it, so a node
+// spanning two ranges is reported once. The ranges are concatenated in
+// order, which gives the captures in the order a single cursor over the
+// whole tree returns them.
+
+typedef struct {
+    uint32_t start_byte;
+    uint32_t end_byte;
+    // The capture's index in the query, for `ts_query_capture_name_for_id`.
+    uint32_t capture;
+    uint32_t pattern;
+} CooklangHighlight;
+
+typedef struct {
+    CooklangHighlight *highlights;
+    uint32_t length;
+    uint32_t capacity;
+} CooklangHighlightList;
+
+void cooklang_highlight_list_init(CooklangHighlightList *list);
+void cooklang_highlight_list_free(CooklangHighlightList *list);
+
+// Append the captures of `query` over `tree` to `list` in document order,
+// running the query on `thread_count` threads (at least one). The tree is
+// only read, and may be used by other threads meanwhile. Returns false,
+// leaving `list` as it was, if memory ran out or a thread could not start.
+bool cooklang_highlight(const TSQuery *query, const TSTree *tree, unsigned thread_count,
+                        CooklangHighlightList *list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_HIGHLIGHT_H_
@@ -0,0 +1,623 @@
+#include "cooklang_html.h"
+#include "cooklang_common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    CooklangSpan key;
+    CooklangSpan value;
+} Entry;
+
+// Writes go through `ok`, so a failed allocation stops all further output
+// and is reported once at the end.
+typedef struct {
+    const char *source;
+    const CooklangSymbols *symbols;
+    CooklangText *out;
+    bool ok;
+} Writer;
+
+static inline void put(Writer *writer, const char *data, uint32_t length) {
+    writer->ok = writer->ok && cooklang_text_append(writer->out, data, length);
+}
+
+#define PUT_LITERAL(writer, literal) put(writer, literal, sizeof(literal) - 1)
+
+bool cooklang_html_write_escaped(CooklangText *out, const char *data, uint32_t length) {
+    // Every byte takes at most six, as `&quot;`.
+    uint64_t size = (uint64_t)length * 6;
+    if (size > UINT32_MAX || !cooklang_text_reserve(out, (uint32_t)size)) {
+        return false;
+    }
+    char *cursor = out->data + out->length;
+    for (uint32_t i = 0; i < length; i++) {
+        const char *entity;
+        switch (data[i]) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            case '\'': entity = "&#39;"; break;
+            default: *cursor++ = data[i]; continue;
+        }
+        size_t entity_length = strlen(entity);
+        memcpy(cursor, entity, entity_length);
+        cursor += entity_length;
+    }
+    out->length = (uint32_t)(cursor - out->data);
+    return true;
+}
+
+static void put_escaped(Writer *writer, CooklangSpan span) {
+    writer->ok = writer->ok && cooklang_html_write_escaped(writer->out, writer->source + span.start,
+                                                           span.end - span.start);
+}
+
+static inline bool is_trimmed(char c, char marker) {
+    return cooklang_is_space(c) || (marker && c == marker);
+}
+
+static CooklangSpan trim(const char *source, CooklangSpan span, char marker) {
+    while (span.start < span.end && is_trimmed(source[span.start], marker)) {
+        span.start++;
+    }
+    while (span.end > span.start && is_trimmed(source[span.end - 1], marker)) {
+        span.end--;
+    }
+    return span;
+}
+
+// The span of `node` without surrounding whitespace, nor the `>` or `=`
+// markers that the scanner includes in metadata keys, recipe notes and
+// section names. Empty for a null node.
+static CooklangSpan trimmed_span(const char *source, TSNode node, char marker) {
+    if (ts_node_is_null(node)) {
+        return (CooklangSpan){0, 0};
+    }
+    return trim(source, (CooklangSpan){ts_node_start_byte(node), ts_node_end_byte(node)}, marker);
+}
+
+// The first child of `node` with `symbol`, or a null node.
+static TSNode child_of(TSNode node, TSSymbol symbol) {
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_child(node, i);
+        if (ts_node_symbol(child) == symbol) {
+            return child;
+        }
+    }
+    return (TSNode){0};
+}
+
+static inline bool is_comment(const CooklangSymbols *symbols, TSSymbol symbol) {
+    return symbol == symbols->comment || symbol == symbols->block_comment;
+}
+
+// The note of an ingredient, cookware or timer, as in cooklang_json.c: a
+// note separated from its entity only by a comment still belongs to it.
+static TSNode entity_note(const CooklangSymbols *symbols, TSNode entity) {
+    TSNode note = child_of(entity, symbols->note);
+    if (!ts_node_is_null(note)) {
+        return note;
+    }
+    TSNode sibling = ts_node_next_named_sibling(entity);
+    while (!ts_node_is_null(sibling) && is_comment(symbols, ts_node_symbol(sibling))) {
+        sibling = ts_node_next_named_sibling(sibling);
+    }
+    return !ts_node_is_null(sibling) && ts_node_symbol(sibling) == symbols->note ? sibling
+                                                                                 : (TSNode){0};
+}
+
+// The amount and unit of a quantity node, separated by a space. Writes
+// nothing and returns false for an empty quantity.
+static bool put_quantity(Writer *writer, TSNode node) {
+    if (ts_node_is_null(node)) {
+        return false;
+    }
+    // Skip the braces; the closing one is missing if the parser recovered
+    // from an unterminated quantity.
+    uint32_t start = ts_node_start_byte(node) + 1;
+    uint32_t end = ts_node_end_byte(node);
+    if (end > start && writer->source[end - 1] == '}') {
+        end--;
+    }
+    if (end < start) {
+        return false;
+    }
+    CooklangQuantity quantity;
+    cooklang_quantity_parse(writer->source, (CooklangSpan){start, end}, &quantity);
+    bool amount = quantity.amount.end > quantity.amount.start;
+    bool unit = quantity.unit.end > quantity.unit.start;
+    if (amount) {
+        put_escaped(writer, quantity.amount);
+    }
+    if (amount && unit) {
+        PUT_LITERAL(writer, " ");
+    }
+    if (unit) {
+        put_escaped(writer, quantity.unit);
+    }
+    return amount || unit;
+}
+
+static inline bool is_separator(char c) {
+    return c == '/' || c == '\\';
+}
+
+static bool is_dots(const char *source, CooklangSpan segment, uint32_t count) {
+    if (segment.end - segment.start != count) {
+        return false;
+    }
+    for (uint32_t i = segment.start; i < segment.end; i++) {
+        if (source[i] != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether `name` is a reference to another recipe whose page the link can
+// point at: it starts with `./`, no segment is `..`, so the link cannot
+// leave the output directory, and the last segment names a recipe.
+static bool is_reference(const char *source, CooklangSpan name) {
+    const char *text = source + name.start;
+    if (name.end - name.start < 3 || text[0] != '.' || !is_separator(text[1])) {
+        return false;
+    }
+    uint32_t last = name.start + 2;
+    for (uint32_t i = last; i <= name.end; i++) {
+        if (i == name.end || is_separator(source[i])) {
+            if (is_dots(source, (CooklangSpan){last, i}, 2)) {
+                return false;
+            }
+            if (i == name.end) {
+                return i > last && !is_dots(source, (CooklangSpan){last, i}, 1);
+            }
+            last = i + 1;
+        }
+    }
+    return false;
+}
+
+// RFC 3986 unreserved characters, which a path segment keeps as they are.
+static inline bool is_unreserved(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+// A path segment with every other byte percent-encoded, which leaves
+// nothing to escape for the attribute either.
+static void put_segment(Writer *writer, CooklangSpan segment) {
+    static const char HEX[] = "0123456789ABCDEF";
+    for (uint32_t i = segment.start; i < segment.end; i++) {
+        unsigned char c = (unsigned char)writer->source[i];
+        if (is_unreserved((char)c)) {
+            put(writer, (const char *)&c, 1);
+        } else {
+            char encoded[3] = {'%', HEX[c >> 4], HEX[c & 15]};
+            put(writer, encoded, 3);
+        }
+    }
+}
+
+// An ingredient name, as a link to the page of the recipe it refers to if
+// it is a reference: `./sauces/tomato` links to `sauces/tomato.html` and
+// reads `tomato`. Segments are percent-encoded, and empty and `.` ones are
+// dropped.
+static void put_ingredient_name(Writer *writer, CooklangSpan name, const char *class_name) {
+    if (!is_reference(writer->source, name)) {
+        PUT_LITERAL(writer, "<span class=\"");
+        put(writer, class_name, (uint32_t)strlen(class_name));
+        PUT_LITERAL(writer, "\">");
+        put_escaped(writer, name);
+        PUT_LITERAL(writer, "</span>");
+        return;
+    }
+    PUT_LITERAL(writer, "<a class=\"");
+    put(writer, class_name, (uint32_t)strlen(class_name));
+    PUT_LITERAL(writer, " reference\" href=\"");
+    uint32_t last = name.start + 2;
+    for (uint32_t i = name.start + 2; i < name.end; i++) {
+        if (is_separator(writer->source[i])) {
+            CooklangSpan segment = {last, i};
+            if (segment.end > segment.start && !is_dots(writer->source, segment, 1)) {
+                put_segment(writer, segment);
+                PUT_LITERAL(writer, "/");
+            }
+            last = i + 1;
+        }
+    }
+    put_segment(writer, (CooklangSpan){last, name.end});
+    PUT_LITERAL(writer, ".html\">");
+    put_escaped(writer, (CooklangSpan){last, name.end});
+    PUT_LITERAL(writer, "</a>");
+}
+
+// Every ingredient or cookware (`kind`) of the recipe's steps, one list
+// item each, in step order. Nothing is written when there are none.
+static void put_entity_list(Writer *writer, TSTreeCursor *cursor, TSSymbol kind,
+                            TSSymbol name_symbol, const char *class_name, const char *heading) {
+    const CooklangSymbols *symbols = writer->symbols;
+    bool open = false;
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return;
+    }
+    do {
+        if (ts_node_symbol(ts_tree_cursor_current_node(cursor)) != symbols->step ||
+            !ts_tree_cursor_goto_first_child(cursor)) {
+            continue;
+        }
+        do {
+            TSNode entity = ts_tree_cursor_current_node(cursor);
+            if (ts_node_symbol(entity) != kind) {
+                continue;
+            }
+            if (!open) {
+                PUT_LITERAL(writer, "<section class=\"");
+                put(writer, class_name, (uint32_t)strlen(class_name));
+                PUT_LITERAL(writer, "\">\n<h2>");
+                put(writer, heading, (uint32_t)strlen(heading));
+                PUT_LITERAL(writer, "</h2>\n<ul>\n");
+                open = true;
+            }
+            PUT_LITERAL(writer, "<li>");
+            uint32_t mark = writer->out->length;
+            PUT_LITERAL(writer, "<span class=\"quantity\">");
+            if (put_quantity(writer, child_of(entity, symbols->quantity))) {
+                PUT_LITERAL(writer, "</span> ");
+            } else if (writer->ok) {
+                writer->out->length = mark;
+            }
+            CooklangSpan name = trimmed_span(writer->source, child_of(entity, name_symbol), 0);
+            if (kind == symbols->ingredient) {
+                put_ingredient_name(writer, name, "name");
+            } else {
+                PUT_LITERAL(writer, "<span class=\"name\">");
+                put_escaped(writer, name);
+                PUT_LITERAL(writer, "</span>");
+            }
+            TSNode note = entity_note(symbols, entity);
+            CooklangSpan note_text = ts_node_is_null(note)
+                                         ? (CooklangSpan){0, 0}
+                                         : trimmed_span(writer->source,
+                                                        child_of(note, symbols->note_content), 0);
+            if (note_text.end > note_text.start) {
+                PUT_LITERAL(writer, " <span class=\"note\">");
+                put_escaped(writer, note_text);
+                PUT_LITERAL(writer, "</span>");
+            }
+            PUT_LITERAL(writer, "</li>\n");
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+    if (open) {
+        PUT_LITERAL(writer, "</ul>\n</section>\n");
+    }
+}
+
+// An ingredient, cookware or timer inside a step.
+static void put_inline_entity(Writer *writer, TSNode entity, TSSymbol symbol) {
+    const CooklangSymbols *symbols = writer->symbols;
+    if (symbol == symbols->ingredient) {
+        put_ingredient_name(writer,
+                            trimmed_span(writer->source,
+                                         child_of(entity, symbols->ingredient_name), 0),
+                            "ingredient");
+    } else if (symbol == symbols->cookware) {
+        PUT_LITERAL(writer, "<span class=\"cookware\">");
+        put_escaped(writer,
+                    trimmed_span(writer->source, child_of(entity, symbols->cookware_name), 0));
+        PUT_LITERAL(writer, "</span>");
+    } else {
+        // A timer reads as its duration, or as its name without one.
+        PUT_LITERAL(writer, "<span class=\"timer\">");
+        if (!put_quantity(writer, child_of(entity, symbols->quantity))) {
+            put_escaped(writer,
+                        trimmed_span(writer->source, child_of(entity, symbols->timer_name), 0));
+        }
+        PUT_LITERAL(writer, "</span>");
+    }
+}
+
+// A step's text as written, with its entities marked up and its comments
+// and their surrounding whitespace run left out, as cooklang_json.c splits
+// step items.
+static void put_step(Writer *writer, TSTreeCursor *cursor) {
+    const CooklangSymbols *symbols = writer->symbols;
+    PUT_LITERAL(writer, "<li>");
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        uint32_t position = ts_node_start_byte(ts_tree_cursor_current_node(cursor));
+        uint32_t text_end = position;
+        bool note_attaches = false;
+        do {
+            TSNode child = ts_tree_cursor_current_node(cursor);
+            TSSymbol symbol = ts_node_symbol(child);
+            if (symbol == symbols->text) {
+                text_end = ts_node_end_byte(child);
+                note_attaches = false;
+                continue;
+            }
+            if (symbol == symbols->note && note_attaches) {
+                position = text_end = ts_node_end_byte(child);
+                note_attaches = false;
+                continue;
+            }
+            bool entity = symbol == symbols->ingredient || symbol == symbols->cookware ||
+                          symbol == symbols->timer;
+            uint32_t start = ts_node_start_byte(child);
+            if (start > text_end && (entity || symbol == symbols->note)) {
+                text_end = start;
+            }
+            if (text_end > position) {
+                put_escaped(writer, (CooklangSpan){position, text_end});
+            }
+            position = text_end = ts_node_end_byte(child);
+            if (!is_comment(symbols, symbol)) {
+                note_attaches = entity && ts_node_is_null(child_of(child, symbols->note));
+            }
+            if (entity) {
+                put_inline_entity(writer, child, symbol);
+            } else if (symbol == symbols->note) {
+                PUT_LITERAL(writer, "<span class=\"note\">");
+                put_escaped(writer, trimmed_span(writer->source,
+                                                 child_of(child, symbols->note_content), 0));
+                PUT_LITERAL(writer, "</span>");
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        if (text_end > position) {
+            put_escaped(writer, (CooklangSpan){position, text_end});
+        }
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    PUT_LITERAL(writer, "</li>\n");
+}
+
+static void put_method(Writer *writer, TSTreeCursor *cursor) {
+    const CooklangSymbols *symbols = writer->symbols;
+    bool section_open = false, list_open = false;
+    uint32_t step_number = 0;
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        return;
+    }
+    do {
+        TSNode node = ts_tree_cursor_current_node(cursor);
+        TSSymbol symbol = ts_node_symbol(node);
+        if (symbol != symbols->section && symbol != symbols->step &&
+            symbol != symbols->recipe_note) {
+            continue;
+        }
+        if (list_open && symbol != symbols->step) {
+            PUT_LITERAL(writer, "</ol>\n");
+            list_open = false;
+        }
+        if (section_open && symbol == symbols->section) {
+            PUT_LITERAL(writer, "</section>\n");
+            section_open = false;
+        }
+        if (!section_open) {
+            PUT_LITERAL(writer, "<section class=\"method\">\n");
+            section_open = true;
+            step_number = 0;
+        }
+        if (symbol == symbols->section) {
+            CooklangSpan name =
+                trimmed_span(writer->source, child_of(node, symbols->section_name), '=');
+            if (name.end > name.start) {
+                PUT_LITERAL(writer, "<h2>");
+                put_escaped(writer, name);
+                PUT_LITERAL(writer, "</h2>\n");
+            }
+        } else if (symbol == symbols->recipe_note) {
+            PUT_LITERAL(writer, "<aside class=\"note\"><p>");
+            TSNode text = child_of(node, symbols->recipe_note_text);
+            put_escaped(writer, trimmed_span(writer->source, text, '>'));
+            PUT_LITERAL(writer, "</p></aside>\n");
+        } else {
+            if (!list_open) {
+                if (step_number == 0) {
+                    PUT_LITERAL(writer, "<ol class=\"steps\">\n");
+                } else {
+                    char start[48];
+                    int length = snprintf(start, sizeof(start),
+                                          "<ol class=\"steps\" start=\"%u\">\n", step_number + 1);
+                    put(writer, start, (uint32_t)length);
+                }
+                list_open = true;
+            }
+            step_number++;
+            put_step(writer, cursor);
+        }
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+    if (list_open) {
+        PUT_LITERAL(writer, "</ol>\n");
+    }
+    if (section_open) {
+        PUT_LITERAL(writer, "</section>\n");
+    }
+}
+
+static bool add_entry(Entry **entries, uint32_t *length, uint32_t *capacity, Entry entry) {
+    if (*length == *capacity) {
+        uint32_t grown = *capacity ? *capacity * 2 : 8;
+        Entry *resized = realloc(*entries, grown * sizeof(Entry));
+        if (!resized) {
+            return false;
+        }
+        *entries = resized;
+        *capacity = grown;
+    }
+    (*entries)[(*length)++] = entry;
+    return true;
+}
+
+// The `key: value` lines at the top level of YAML frontmatter. Nested and
+// multi-line values are not metadata a page header can show, and are
+// skipped; quotes around a value are dropped.
+static bool add_frontmatter(const char *source, TSNode content, Entry **entries, uint32_t *length,
+                            uint32_t *capacity) {
+    uint32_t end = ts_node_end_byte(content);
+    for (uint32_t line = ts_node_start_byte(content); line < end;) {
+        uint32_t line_end = line;
+        while (line_end < end && source[line_end] != '\n') {
+            line_end++;
+        }
+        uint32_t colon = line;
+        while (colon < line_end && source[colon] != ':') {
+            colon++;
+        }
+        if (!cooklang_is_space(source[line]) && source[line] != '#' && source[line] != '-' &&
+            colon < line_end) {
+            CooklangSpan key = trim(source, (CooklangSpan){line, colon}, 0);
+            CooklangSpan value = trim(source, (CooklangSpan){colon + 1, line_end}, 0);
+            if (value.end - value.start >= 2 && (source[value.start] == '"' ||
+                                                 source[value.start] == '\'') &&
+                source[value.end - 1] == source[value.start]) {
+                value.start++;
+                value.end--;
+            }
+            if (key.end > key.start && value.end > value.start &&
+                !add_entry(entries, length, capacity, (Entry){key, value})) {
+                return false;
+            }
+        }
+        line = line_end + 1;
+    }
+    return true;
+}
+
+static bool is_title(const char *source, CooklangSpan key) {
+    static const char TITLE[] = "title";
+    if (key.end - key.start != sizeof(TITLE) - 1) {
+        return false;
+    }
+    for (uint32_t i = 0; i < sizeof(TITLE) - 1; i++) {
+        char c = source[key.start + i];
+        if ((c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c) != TITLE[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The title, escaped: the `title` metadata, or else the caller's.
+static void put_title(Writer *writer, const Entry *title_entry, const char *title) {
+    if (title_entry) {
+        put_escaped(writer, title_entry->value);
+    } else if (title) {
+        writer->ok = writer->ok &&
+                     cooklang_html_write_escaped(writer->out, title, (uint32_t)strlen(title));
+    }
+}
+
+// The start of the document: for a page, the HTML head, then the article
+// and its header.
+static void put_start(Writer *writer, TSTreeCursor *cursor, const char *title, bool page) {
+    const CooklangSymbols *symbols = writer->symbols;
+    Entry *entries = NULL;
+    uint32_t length = 0, capacity = 0;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSNode node = ts_tree_cursor_current_node(cursor);
+            TSSymbol symbol = ts_node_symbol(node);
+            if (symbol == symbols->frontmatter) {
+                TSNode content = child_of(node, symbols->frontmatter_content);
+                if (!ts_node_is_null(content)) {
+                    writer->ok = writer->ok && add_frontmatter(writer->source, content, &entries,
+                                                               &length, &capacity);
+                }
+            } else if (symbol == symbols->metadata) {
+                Entry entry = {
+                    trimmed_span(writer->source, child_of(node, symbols->metadata_key), '>'),
+                    trimmed_span(writer->source, child_of(node, symbols->metadata_value), 0),
+                };
+                if (entry.key.end > entry.key.start) {
+                    writer->ok = writer->ok && add_entry(&entries, &length, &capacity, entry);
+                }
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+
+    const Entry *title_entry = NULL;
+    for (uint32_t i = 0; i < length && !title_entry; i++) {
+        if (is_title(writer->source, entries[i].key) &&
+            entries[i].value.end > entries[i].value.start) {
+            title_entry = &entries[i];
+        }
+    }
+    bool titled = title_entry || (title && *title);
+    if (page) {
+        PUT_LITERAL(writer, "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>");
+        put_title(writer, title_entry, title);
+        PUT_LITERAL(writer, "</title>\n</head>\n<body>\n");
+    }
+    PUT_LITERAL(writer, "<article class=\"recipe\">\n");
+    if (!titled && length == 0) {
+        free(entries);
+        return;
+    }
+    PUT_LITERAL(writer, "<header>\n");
+    if (titled) {
+        PUT_LITERAL(writer, "<h1>");
+        put_title(writer, title_entry, title);
+        PUT_LITERAL(writer, "</h1>\n");
+    }
+    bool open = false;
+    for (uint32_t i = 0; i < length; i++) {
+        if (&entries[i] == title_entry) {
+            continue;
+        }
+        if (!open) {
+            PUT_LITERAL(writer, "<dl class=\"metadata\">");
+            open = true;
+        }
+        PUT_LITERAL(writer, "<dt>");
+        put_escaped(writer, entries[i].key);
+        PUT_LITERAL(writer, "</dt><dd>");
+        put_escaped(writer, entries[i].value);
+        PUT_LITERAL(writer, "</dd>");
+    }
+    if (open) {
+        PUT_LITERAL(writer, "</dl>\n");
+    }
+    PUT_LITERAL(writer, "</header>\n");
+    free(entries);
+}
+
+static bool write_document(const char *source, TSNode root, const char *title, bool page,
+                           CooklangText *out) {
+    const TSLanguage *language = ts_node_language(root);
+    CooklangSymbols symbols;
+    cooklang_symbols_init(&symbols, language);
+    Writer writer = {source, &symbols, out, true};
+
+    // As in cooklang_json.c, one pass over the top level per part of the
+    // page, sharing one cursor.
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    put_start(&writer, &cursor, title, page);
+    put_entity_list(&writer, &cursor, symbols.ingredient, symbols.ingredient_name, "ingredients",
+                    "Ingredients");
+    put_entity_list(&writer, &cursor, symbols.cookware, symbols.cookware_name, "cookware",
+                    "Cookware");
+    put_method(&writer, &cursor);
+    PUT_LITERAL(&writer, "</article>\n");
+    if (page) {
+        PUT_LITERAL(&writer, "</body>\n</html>\n");
+    }
+    ts_tree_cursor_delete(&cursor);
+    return writer.ok;
+}
+
+bool cooklang_html_write_recipe(const char *source, TSNode root, const char *title,
+                                CooklangText *out) {
+    return write_document(source, root, title, false, out);
+}
+
+bool cooklang_html_write_page(const char *source, TSNode root, const char *title,
+                              CooklangText *out) {
+    return write_document(source, root, title, true, out);
+}
@@ -0,0 +1,73 @@
+#ifndef COOKLANG_HTML_H_
+#define COOKLANG_HTML_H_
+
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// HTML rendering of parsed recipes.
+//
+// A recipe is written as one semantic `<article>`, straight from the
+// syntax tree into the output buffer, for a page template to wrap:
+//
+//   <article class="recipe">
+//   <header>
+//   <h1>Bread</h1>
+//   <dl class="metadata"><dt>servings</dt><dd>4</dd></dl>
+//   </header>
+//   <section class="ingredients">
+//   <h2>Ingredients</h2>
+//   <ul>
+//   <li><span class="quantity">500 g</span> <span class="name">flour</span>
+//     <span class="note">sifted</span></li>
+//   </ul>
+//   </section>
+//   <section class="cookware">...</section>
+//   <section class="method">
+//   <h2>Dough</h2>
+//   <ol class="steps">
+//   <li>Mix the <span class="ingredient">flour</span> in a
+//     <span class="cookware">bowl</span> for <span class="timer">10 min</span>.</li>
+//   </ol>
+//   <aside class="note"><p>Keep it covered.</p></aside>
+//   </section>
+//   </article>
+//
+// The title comes from `title` metadata, or else from the caller. Metadata
+// lists `>> key: value` lines and the top-level `key: value` lines of the
+// frontmatter. The ingredient and cookware lists have one item per
+// occurrence, in step order, like cooklang_json.h. An ingredient that
+// refers to another recipe (`@./sauces/tomato{}`) links to `sauces/tomato.html`,
+// with each path segment percent-encoded; a reference with a `..` segment,
+// which could point outside the pages, is written as a plain name.
+// Steps keep their text as written, without comments; a recipe note
+// interrupts the step list, and numbering carries on after it. Each
+// `= Section` starts a new method section, numbered from one. Every piece
+// of recipe text is escaped, and steps inside syntax errors are left out.
+
+// Append the recipe in the tree under `root` to `out`. `title`, which may
+// be NULL, is used when the recipe has no `title` metadata. Returns false
+// if `out` could not grow, leaving a partial document at its end.
+bool cooklang_html_write_recipe(const char *source, TSNode root, const char *title,
+                                CooklangText *out);
+
+// Like cooklang_html_write_recipe, as a whole page: a minimal HTML5
+// document whose `<title>` is the recipe's, around the article.
+bool cooklang_html_write_page(const char *source, TSNode root, const char *title,
+                              CooklangText *out);
+
+// Append `length` bytes of `data` with `&`, `<`, `>`, `"` and `'` escaped,
+// for text or a quoted attribute value.
+bool cooklang_html_write_escaped(CooklangText *out, const char *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_HTML_H_
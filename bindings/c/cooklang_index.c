@@ -0,0 +1,227 @@
+#include "cooklang_index.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_COUNT 64
+#define EMPTY_SLOT UINT32_MAX
+
+void cooklang_index_init(CooklangIndex *index) {
+    memset(index, 0, sizeof(*index));
+}
+
+static void entry_free(CooklangIndexEntry *entry) {
+    free(entry->path);
+    cooklang_text_free(&entry->text);
+    if (entry->tree) {
+        ts_tree_delete(entry->tree);
+    }
+    cooklang_entity_list_free(&entry->entities);
+}
+
+void cooklang_index_free(CooklangIndex *index) {
+    for (uint32_t i = 0; i < index->length; i++) {
+        entry_free(&index->entries[i]);
+    }
+    free(index->entries);
+    free(index->slots);
+    cooklang_index_init(index);
+}
+
+static uint32_t hash_path(const char *path) {
+    return cooklang_fnv32(COOKLANG_FNV32_BASIS, path, strlen(path));
+}
+
+// The slot holding `path`, or the empty slot ending its probe sequence.
+static uint32_t find_slot(const CooklangIndex *index, const char *path, uint32_t hash) {
+    uint32_t mask = index->slot_count - 1;
+    uint32_t slot = hash & mask;
+    while (index->slots[slot].entry != EMPTY_SLOT &&
+           (index->slots[slot].hash != hash ||
+            strcmp(index->entries[index->slots[slot].entry].path, path) != 0)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+CooklangIndexEntry *cooklang_index_find(const CooklangIndex *index, const char *path) {
+    if (!index->slot_count) {
+        return NULL;
+    }
+    uint32_t slot = find_slot(index, path, hash_path(path));
+    uint32_t entry = index->slots[slot].entry;
+    return entry == EMPTY_SLOT ? NULL : &index->entries[entry];
+}
+
+static bool grow_slots(CooklangIndex *index) {
+    uint32_t slot_count = index->slot_count ? index->slot_count * 2 : INITIAL_SLOT_COUNT;
+    CooklangIndexSlot *slots = malloc(slot_count * sizeof(CooklangIndexSlot));
+    if (!slots) {
+        return false;
+    }
+    for (uint32_t i = 0; i < slot_count; i++) {
+        slots[i].entry = EMPTY_SLOT;
+    }
+    uint32_t mask = slot_count - 1;
+    for (uint32_t i = 0; i < index->slot_count; i++) {
+        if (index->slots[i].entry != EMPTY_SLOT) {
+            uint32_t slot = index->slots[i].hash & mask;
+            while (slots[slot].entry != EMPTY_SLOT) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = index->slots[i];
+        }
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->slot_count = slot_count;
+    return true;
+}
+
+// Remove a slot and shift the rest of its cluster back, so that probe
+// sequences stay unbroken without tombstones.
+static void delete_slot(CooklangIndex *index, uint32_t slot) {
+    uint32_t mask = index->slot_count - 1;
+    uint32_t next = slot;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (index->slots[next].entry == EMPTY_SLOT) {
+            break;
+        }
+        uint32_t home = index->slots[next].hash & mask;
+        // Move the slot back unless its home lies cyclically in (slot, next].
+        bool stays = slot <= next ? slot < home && home <= next : slot < home || home <= next;
+        if (!stays) {
+            index->slots[slot] = index->slots[next];
+            slot = next;
+        }
+    }
+    index->slots[slot].entry = EMPTY_SLOT;
+}
+
+bool cooklang_index_remove(CooklangIndex *index, const char *path) {
+    if (!index->slot_count) {
+        return false;
+    }
+    uint32_t slot = find_slot(index, path, hash_path(path));
+    uint32_t entry = index->slots[slot].entry;
+    if (entry == EMPTY_SLOT) {
+        return false;
+    }
+    delete_slot(index, slot);
+    entry_free(&index->entries[entry]);
+
+    // Move the last entry into the gap and repoint its slot.
+    uint32_t last = --index->length;
+    if (entry != last) {
+        index->entries[entry] = index->entries[last];
+        uint32_t moved = find_slot(index, index->entries[entry].path,
+                                   hash_path(index->entries[entry].path));
+        index->slots[moved].entry = entry;
+    }
+    index->generation++;
+    return true;
+}
+
+static CooklangIndexEntry *add_entry(CooklangIndex *index, const char *path) {
+    if ((index->length + 1) * 4 > index->slot_count * 3 && !grow_slots(index)) {
+        return NULL;
+    }
+    if (index->length == index->capacity) {
+        uint32_t capacity = index->capacity ? index->capacity * 2 : 64;
+        CooklangIndexEntry *entries = realloc(index->entries, capacity * sizeof(CooklangIndexEntry));
+        if (!entries) {
+            return NULL;
+        }
+        index->entries = entries;
+        index->capacity = capacity;
+    }
+    size_t path_length = strlen(path);
+    char *copy = malloc(path_length + 1);
+    if (!copy) {
+        return NULL;
+    }
+    memcpy(copy, path, path_length + 1);
+    uint32_t hash = hash_path(path);
+    uint32_t slot = find_slot(index, path, hash);
+    index->slots[slot].hash = hash;
+    index->slots[slot].entry = index->length;
+
+    CooklangIndexEntry *entry = &index->entries[index->length++];
+    entry->path = copy;
+    cooklang_text_init(&entry->text);
+    entry->tree = NULL;
+    cooklang_entity_list_init(&entry->entities);
+    return entry;
+}
+
+static TSPoint advance_point(TSPoint point, const char *text, uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; i++) {
+        if (text[i] == '\n') {
+            point.row++;
+            point.column = 0;
+        } else {
+            point.column++;
+        }
+    }
+    return point;
+}
+
+bool cooklang_index_update(CooklangIndex *index, TSParser *parser, const char *path,
+                           const char *text, uint32_t length) {
+    CooklangIndexEntry *entry = cooklang_index_find(index, path);
+    if (!entry) {
+        entry = add_entry(index, path);
+        if (!entry) {
+            return false;
+        }
+    }
+    const char *old_text = entry->text.data;
+    uint32_t old_length = entry->text.length;
+    if (entry->tree && old_length == length && memcmp(old_text, text, length) == 0) {
+        return true;
+    }
+
+    // One edit covering everything between the common prefix and suffix.
+    if (entry->tree) {
+        uint32_t prefix = 0;
+        while (prefix < old_length && prefix < length && old_text[prefix] == text[prefix]) {
+            prefix++;
+        }
+        uint32_t suffix = 0;
+        while (suffix < old_length - prefix && suffix < length - prefix &&
+               old_text[old_length - 1 - suffix] == text[length - 1 - suffix]) {
+            suffix++;
+        }
+        TSInputEdit edit;
+        edit.start_byte = prefix;
+        edit.old_end_byte = old_length - suffix;
+        edit.new_end_byte = length - suffix;
+        edit.start_point = advance_point((TSPoint){0, 0}, old_text, 0, prefix);
+        edit.old_end_point = advance_point(edit.start_point, old_text, prefix, edit.old_end_byte);
+        edit.new_end_point = advance_point(edit.start_point, text, prefix, edit.new_end_byte);
+        ts_tree_edit(entry->tree, &edit);
+    }
+
+    entry->text.length = 0;
+    bool ok = cooklang_text_append(&entry->text, text, length) &&
+              cooklang_text_reserve(&entry->text, 0);
+    TSTree *tree = NULL;
+    if (ok) {
+        entry->text.data[length] = '\0';
+        tree = ts_parser_parse_string(parser, entry->tree, entry->text.data, length);
+    }
+    if (entry->tree) {
+        ts_tree_delete(entry->tree);
+    }
+    entry->tree = tree;
+    entry->entities.length = 0;
+    ok = tree && cooklang_extract(entry->text.data, length, &entry->entities);
+    if (!ok) {
+        cooklang_index_remove(index, path);
+        return false;
+    }
+    index->generation++;
+    return true;
+}
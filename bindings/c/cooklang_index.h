@@ -0,0 +1,68 @@
+#ifndef COOKLANG_INDEX_H_
+#define COOKLANG_INDEX_H_
+
+#include "cooklang_extract.h"
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An in-memory index of recipe files: their text, tree and extracted
+// entities, keyed by path.
+//
+// Updating a recipe that is already indexed reparses it incrementally: the
+// old and new text are compared, the changed byte range becomes one
+// `ts_tree_edit`, and the old tree is passed to the parser, so saving a
+// one-line change costs about as much as parsing that line.
+
+typedef struct {
+    char *path;
+    CooklangText text;
+    TSTree *tree;
+    CooklangEntityList entities;
+} CooklangIndexEntry;
+
+typedef struct {
+    uint32_t hash;
+    uint32_t entry;
+} CooklangIndexSlot;
+
+typedef struct {
+    // Entries in no particular order; removal moves the last one into the
+    // gap.
+    CooklangIndexEntry *entries;
+    uint32_t length;
+    uint32_t capacity;
+    // Open-addressing index over `entries` by path; internal.
+    CooklangIndexSlot *slots;
+    uint32_t slot_count;
+    // Incremented by every update and removal that changed the index.
+    uint64_t generation;
+} CooklangIndex;
+
+void cooklang_index_init(CooklangIndex *index);
+void cooklang_index_free(CooklangIndex *index);
+
+// The entry for `path`, or NULL.
+CooklangIndexEntry *cooklang_index_find(const CooklangIndex *index, const char *path);
+
+// Index `length` bytes of `text` as the content of `path`, replacing and
+// incrementally reparsing what was indexed for it before. Unchanged text
+// is left alone. Returns false if memory ran out or parsing failed, in
+// which case `path` is no longer indexed.
+bool cooklang_index_update(CooklangIndex *index, TSParser *parser, const char *path,
+                           const char *text, uint32_t length);
+
+// Drop `path`; returns false if it was not indexed.
+bool cooklang_index_remove(CooklangIndex *index, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_INDEX_H_
@@ -0,0 +1,218 @@
+#include "cooklang_intern.h"
+#include "cooklang_quantity.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_COUNT 64
+#define EMPTY_SLOT UINT32_MAX
+
+static uint32_t hash_name(const char *name, uint32_t length) {
+    return cooklang_fnv32(COOKLANG_FNV32_BASIS, name, length);
+}
+
+void cooklang_intern_table_init(CooklangInternTable *table, bool normalize) {
+    memset(table, 0, sizeof(*table));
+    table->normalize = normalize;
+}
+
+void cooklang_intern_table_free(CooklangInternTable *table) {
+    free(table->offsets);
+    free(table->strings);
+    free(table->slots);
+    cooklang_intern_table_init(table, table->normalize);
+}
+
+static uint32_t name_length(const CooklangInternTable *table, uint32_t id) {
+    return table->offsets[id + 1] - table->offsets[id] - 1;
+}
+
+// The id of the `length` bytes at `name`, which are already normalized if
+// the table normalizes.
+static uint32_t find(const CooklangInternTable *table, const char *name, uint32_t length,
+                     uint32_t hash) {
+    if (!table->slot_count) {
+        return COOKLANG_INTERN_NONE;
+    }
+    uint32_t mask = table->slot_count - 1;
+    for (uint32_t index = hash & mask; table->slots[index].id != EMPTY_SLOT;
+         index = (index + 1) & mask) {
+        const CooklangInternSlot *slot = &table->slots[index];
+        if (slot->hash == hash && name_length(table, slot->id) == length &&
+            memcmp(table->strings + table->offsets[slot->id], name, length) == 0) {
+            return slot->id;
+        }
+    }
+    return COOKLANG_INTERN_NONE;
+}
+
+static void insert_slot(CooklangInternSlot *slots, uint32_t slot_count, uint32_t hash,
+                        uint32_t id) {
+    uint32_t mask = slot_count - 1;
+    uint32_t index = hash & mask;
+    while (slots[index].id != EMPTY_SLOT) {
+        index = (index + 1) & mask;
+    }
+    slots[index].hash = hash;
+    slots[index].id = id;
+}
+
+static bool grow_slots(CooklangInternTable *table) {
+    uint32_t slot_count = table->slot_count ? table->slot_count * 2 : INITIAL_SLOT_COUNT;
+    CooklangInternSlot *slots = malloc(slot_count * sizeof(CooklangInternSlot));
+    if (!slots) {
+        return false;
+    }
+    for (uint32_t i = 0; i < slot_count; i++) {
+        slots[i].id = EMPTY_SLOT;
+    }
+    for (uint32_t i = 0; i < table->slot_count; i++) {
+        if (table->slots[i].id != EMPTY_SLOT) {
+            insert_slot(slots, slot_count, table->slots[i].hash, table->slots[i].id);
+        }
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = slot_count;
+    return true;
+}
+
+static bool reserve_strings(CooklangInternTable *table, uint32_t extra) {
+    if (extra > UINT32_MAX - table->strings_length) {
+        return false;
+    }
+    if (table->strings_length + extra <= table->strings_capacity) {
+        return true;
+    }
+    uint32_t capacity = table->strings_capacity ? table->strings_capacity : 1024;
+    while (capacity < table->strings_length + extra) {
+        capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2;
+    }
+    char *strings = realloc(table->strings, capacity);
+    if (!strings) {
+        return false;
+    }
+    table->strings = strings;
+    table->strings_capacity = capacity;
+    return true;
+}
+
+static bool reserve_offsets(CooklangInternTable *table) {
+    if (table->length + 1 < table->capacity) {
+        return true;
+    }
+    if (table->length >= COOKLANG_INTERN_NONE - 2) {
+        return false;
+    }
+    uint32_t capacity = table->capacity ? table->capacity * 2 : 64;
+    uint32_t *offsets = realloc(table->offsets, capacity * sizeof(uint32_t));
+    if (!offsets) {
+        return false;
+    }
+    if (!table->offsets) {
+        offsets[0] = 0;
+    }
+    table->offsets = offsets;
+    table->capacity = capacity;
+    return true;
+}
+
+uint32_t cooklang_intern(CooklangInternTable *table, const char *name, uint32_t length) {
+    uint32_t hash = 0;
+    uint32_t id = COOKLANG_INTERN_NONE;
+    if (!table->normalize) {
+        hash = hash_name(name, length);
+        id = find(table, name, length, hash);
+        if (id != COOKLANG_INTERN_NONE) {
+            return id;
+        }
+    }
+    // A name to normalize is written to the end of `strings` first, and
+    // kept there only if it turns out to be new.
+    if (!reserve_strings(table, length + 1)) {
+        return COOKLANG_INTERN_NONE;
+    }
+    char *key = table->strings + table->strings_length;
+    if (table->normalize) {
+        length = cooklang_normalize(name, length, key);
+        hash = hash_name(key, length);
+        id = find(table, key, length, hash);
+        if (id != COOKLANG_INTERN_NONE) {
+            return id;
+        }
+    } else {
+        memcpy(key, name, length);
+    }
+
+    if ((table->length + 1) * 4 > table->slot_count * 3 && !grow_slots(table)) {
+        return COOKLANG_INTERN_NONE;
+    }
+    if (!reserve_offsets(table)) {
+        return COOKLANG_INTERN_NONE;
+    }
+    key[length] = '\0';
+    table->strings_length += length + 1;
+    id = table->length++;
+    table->offsets[table->length] = table->strings_length;
+    insert_slot(table->slots, table->slot_count, hash, id);
+    return id;
+}
+
+uint32_t cooklang_intern_find(const CooklangInternTable *table, const char *name, uint32_t length) {
+    if (!table->normalize) {
+        return find(table, name, length, hash_name(name, length));
+    }
+    // Normalizing never lengthens a name, so short names need no heap.
+    char stack[256];
+    char *key = length <= sizeof(stack) ? stack : malloc(length);
+    if (!key) {
+        return COOKLANG_INTERN_NONE;
+    }
+    length = cooklang_normalize(name, length, key);
+    uint32_t id = find(table, key, length, hash_name(key, length));
+    if (key != stack) {
+        free(key);
+    }
+    return id;
+}
+
+const char *cooklang_intern_name(const CooklangInternTable *table, uint32_t id, uint32_t *length) {
+    if (length) {
+        *length = name_length(table, id);
+    }
+    return table->strings + table->offsets[id];
+}
+
+bool cooklang_intern_entities(CooklangInternTable *names, CooklangInternTable *units,
+                              const char *source, const CooklangEntityList *entities,
+                              CooklangEntityIds *ids) {
+    for (uint32_t i = 0; i < entities->length; i++) {
+        const CooklangEntity *entity = &entities->entities[i];
+        ids[i].name = COOKLANG_INTERN_NONE;
+        ids[i].unit = COOKLANG_INTERN_NONE;
+        if (entity->kind != COOKLANG_ENTITY_INGREDIENT && entity->kind != COOKLANG_ENTITY_COOKWARE &&
+            entity->kind != COOKLANG_ENTITY_TIMER) {
+            continue;
+        }
+        if (entity->name.end > entity->name.start) {
+            ids[i].name = cooklang_intern(names, source + entity->name.start,
+                                          entity->name.end - entity->name.start);
+            if (ids[i].name == COOKLANG_INTERN_NONE) {
+                return false;
+            }
+        }
+        if (entity->flags & COOKLANG_ENTITY_HAS_QUANTITY) {
+            CooklangQuantity quantity;
+            cooklang_quantity_parse(source, entity->quantity, &quantity);
+            if (quantity.unit.end > quantity.unit.start) {
+                ids[i].unit = cooklang_intern(units, source + quantity.unit.start,
+                                              quantity.unit.end - quantity.unit.start);
+                if (ids[i].unit == COOKLANG_INTERN_NONE) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef COOKLANG_INTERN_H_
+#define COOKLANG_INTERN_H_
+
+#include "cooklang_extract.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Interning of ingredient, cookware, timer and unit names.
+//
+// A table stores each distinct name once and numbers the names 0, 1, 2, ...
+// in order of first appearance. The id of a name never changes, so a
+// collection can keep four bytes per entity instead of a copy of its name,
+// and aggregate or search by integer. A normalizing table trims names,
+// collapses inner whitespace and lowercases ASCII first, the way shopping
+// lists group ingredients, so that `Olive  Oil` and `olive oil` get the
+// same id. A table is not thread-safe.
+
+#define COOKLANG_INTERN_NONE UINT32_MAX
+
+typedef struct {
+    uint32_t hash;
+    uint32_t id;
+} CooklangInternSlot;
+
+typedef struct {
+    // Start of each name in `strings`, plus one past the last; every name
+    // is followed by a NUL.
+    uint32_t *offsets;
+    uint32_t length;
+    uint32_t capacity;
+    char *strings;
+    uint32_t strings_length;
+    uint32_t strings_capacity;
+    // Open-addressing index over the names; internal.
+    CooklangInternSlot *slots;
+    uint32_t slot_count;
+    bool normalize;
+} CooklangInternTable;
+
+void cooklang_intern_table_init(CooklangInternTable *table, bool normalize);
+void cooklang_intern_table_free(CooklangInternTable *table);
+
+// The id of `length` bytes of `name`, added to the table if it is new.
+// Returns COOKLANG_INTERN_NONE if the table could not grow.
+uint32_t cooklang_intern(CooklangInternTable *table, const char *name, uint32_t length);
+
+// The id of `name` if it is in the table, or COOKLANG_INTERN_NONE.
+uint32_t cooklang_intern_find(const CooklangInternTable *table, const char *name, uint32_t length);
+
+// The name with id `id`, NUL-terminated, as stored (normalized if the
+// table normalizes). `length` may be NULL.
+const char *cooklang_intern_name(const CooklangInternTable *table, uint32_t id, uint32_t *length);
+
+typedef struct {
+    // The entity's name, or COOKLANG_INTERN_NONE for metadata, sections,
+    // frontmatter and unnamed timers.
+    uint32_t name;
+    // The unit of the entity's quantity, or COOKLANG_INTERN_NONE when it
+    // has none.
+    uint32_t unit;
+} CooklangEntityIds;
+
+// Intern the names of the ingredients, cookware and timers in `entities`,
+// extracted from `source`, into `names`, and the units of their quantities
+// into `units`, which may be the same table. `ids` receives one entry per
+// entity. Returns false if a table could not grow.
+bool cooklang_intern_entities(CooklangInternTable *names, CooklangInternTable *units,
+                              const char *source, const CooklangEntityList *entities,
+                              CooklangEntityIds *ids);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_INTERN_H_
@@ -0,0 +1,469 @@
+#include "cooklang_json.h"
+#include "cooklang_common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Writes go through `ok`, so a failed allocation stops all further output
+// and is reported once at the end.
+typedef struct {
+    const char *source;
+    const CooklangSymbols *symbols;
+    CooklangText *out;
+    bool ok;
+} Writer;
+
+static inline void put(Writer *writer, const char *data, uint32_t length) {
+    writer->ok = writer->ok && cooklang_text_append(writer->out, data, length);
+}
+
+#define PUT_LITERAL(writer, literal) put(writer, literal, sizeof(literal) - 1)
+
+// The comma before every array element but the first.
+static inline void put_separator(Writer *writer, bool *first) {
+    if (!*first) {
+        put(writer, ",", 1);
+    }
+    *first = false;
+}
+
+// The length of the well-formed UTF-8 sequence at `data`, or 0 if there
+// is none: a stray continuation byte, an overlong form, a surrogate, a
+// code point above U+10FFFF, or a sequence cut short.
+static uint32_t utf8_sequence_length(const uint8_t *data, uint32_t available) {
+    uint8_t lead = data[0];
+    uint32_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+    if (lead < 0xC2 || lead > 0xF4 || available < length) {
+        return 0;
+    }
+    // The second byte's range also rules out the overlong forms, the
+    // surrogates and anything beyond U+10FFFF.
+    uint8_t low = lead == 0xE0 ? 0xA0 : lead == 0xF0 ? 0x90 : 0x80;
+    uint8_t high = lead == 0xED ? 0x9F : lead == 0xF4 ? 0x8F : 0xBF;
+    if (data[1] < low || data[1] > high) {
+        return 0;
+    }
+    for (uint32_t i = 2; i < length; i++) {
+        if ((data[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+bool cooklang_json_write_string(CooklangText *out, const char *data, uint32_t length) {
+    static const char HEX[] = "0123456789abcdef";
+    // Every byte takes at most six, as a \u00XX escape or a \ufffd in
+    // place of invalid UTF-8.
+    uint64_t size = (uint64_t)length * 6 + 2;
+    if (size > UINT32_MAX - 1 - (uint64_t)out->length ||
+        !cooklang_text_reserve(out, (uint32_t)size)) {
+        return false;
+    }
+    const uint8_t *bytes = (const uint8_t *)data;
+    char *cursor = out->data + out->length;
+    *cursor++ = '"';
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t c = bytes[i];
+        if (c >= 0x80) {
+            uint32_t sequence = utf8_sequence_length(bytes + i, length - i);
+            if (sequence == 0) {
+                memcpy(cursor, "\\ufffd", 6);
+                cursor += 6;
+            } else {
+                memcpy(cursor, bytes + i, sequence);
+                cursor += sequence;
+                i += sequence - 1;
+            }
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            *cursor++ = (char)c;
+            continue;
+        }
+        *cursor++ = '\\';
+        switch (c) {
+            case '"': *cursor++ = '"'; break;
+            case '\\': *cursor++ = '\\'; break;
+            case '\n': *cursor++ = 'n'; break;
+            case '\r': *cursor++ = 'r'; break;
+            case '\t': *cursor++ = 't'; break;
+            default:
+                memcpy(cursor, "u00", 3);
+                cursor[3] = HEX[c >> 4];
+                cursor[4] = HEX[c & 0xF];
+                cursor += 5;
+                break;
+        }
+    }
+    *cursor++ = '"';
+    out->length = (uint32_t)(cursor - out->data);
+    return true;
+}
+
+static void put_string(Writer *writer, CooklangSpan span) {
+    writer->ok = writer->ok && cooklang_json_write_string(writer->out, writer->source + span.start,
+                                                          span.end - span.start);
+}
+
+static inline bool is_trimmed(char c, char marker) {
+    return cooklang_is_space(c) || (marker && c == marker);
+}
+
+// The span of `node` without surrounding whitespace, nor the `>` or `=`
+// markers that the scanner includes in metadata keys, recipe notes and
+// section names.
+static CooklangSpan trimmed_span(const char *source, TSNode node, char marker) {
+    uint32_t start = ts_node_start_byte(node);
+    uint32_t end = ts_node_end_byte(node);
+    while (start < end && is_trimmed(source[start], marker)) {
+        start++;
+    }
+    while (end > start && is_trimmed(source[end - 1], marker)) {
+        end--;
+    }
+    return (CooklangSpan){start, end};
+}
+
+// A trimmed string, or null for a missing or blank node.
+static void put_optional(Writer *writer, TSNode node, char marker) {
+    CooklangSpan span = ts_node_is_null(node) ? (CooklangSpan){0, 0}
+                                              : trimmed_span(writer->source, node, marker);
+    if (span.end > span.start) {
+        put_string(writer, span);
+    } else {
+        PUT_LITERAL(writer, "null");
+    }
+}
+
+// Whole numbers exactly, and others in the fewest significant digits that
+// read back as the same double.
+static void put_rational(Writer *writer, CooklangRational value) {
+    char number[32];
+    int length;
+    if (value.denominator == 1) {
+        length = snprintf(number, sizeof(number), "%llu", (unsigned long long)value.numerator);
+    } else {
+        double real = (double)value.numerator / (double)value.denominator;
+        int precision = 15;
+        do {
+            length = snprintf(number, sizeof(number), "%.*g", precision, real);
+        } while (precision++ < 17 && strtod(number, NULL) != real);
+    }
+    put(writer, number, (uint32_t)length);
+}
+
+// The first child of `node` with `symbol`, or a null node.
+static TSNode child_of(TSNode node, TSSymbol symbol) {
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_child(node, i);
+        if (ts_node_symbol(child) == symbol) {
+            return child;
+        }
+    }
+    return (TSNode){0};
+}
+
+static inline bool is_comment(const CooklangSymbols *symbols, TSSymbol symbol) {
+    return symbol == symbols->comment || symbol == symbols->block_comment;
+}
+
+// The note of an ingredient, cookware or timer. A note separated from its
+// entity only by a comment is parsed as a step item of its own; it still
+// belongs to the entity, as in the extractor.
+static TSNode entity_note(const CooklangSymbols *symbols, TSNode entity) {
+    TSNode note = child_of(entity, symbols->note);
+    if (!ts_node_is_null(note)) {
+        return note;
+    }
+    TSNode sibling = ts_node_next_named_sibling(entity);
+    while (!ts_node_is_null(sibling) && is_comment(symbols, ts_node_symbol(sibling))) {
+        sibling = ts_node_next_named_sibling(sibling);
+    }
+    return !ts_node_is_null(sibling) && ts_node_symbol(sibling) == symbols->note ? sibling
+                                                                                 : (TSNode){0};
+}
+
+static void put_quantity(Writer *writer, TSNode node) {
+    // Skip the braces; the closing one is missing if the parser recovered
+    // from an unterminated quantity.
+    uint32_t start = ts_node_start_byte(node) + 1;
+    uint32_t end = ts_node_end_byte(node);
+    if (end > start && writer->source[end - 1] == '}') {
+        end--;
+    }
+    CooklangQuantity quantity;
+    if (end >= start) {
+        cooklang_quantity_parse(writer->source, (CooklangSpan){start, end}, &quantity);
+    }
+    if (end < start || (quantity.kind == COOKLANG_QUANTITY_EMPTY &&
+                        quantity.unit.end == quantity.unit.start)) {
+        PUT_LITERAL(writer, "null");
+        return;
+    }
+
+    PUT_LITERAL(writer, "{\"text\":");
+    put_string(writer, (CooklangSpan){start, end});
+    PUT_LITERAL(writer, ",\"amount\":");
+    put_string(writer, quantity.amount);
+    PUT_LITERAL(writer, ",\"unit\":");
+    put_string(writer, quantity.unit);
+    if (quantity.kind == COOKLANG_QUANTITY_NUMBER || quantity.kind == COOKLANG_QUANTITY_RANGE) {
+        PUT_LITERAL(writer, ",\"low\":");
+        put_rational(writer, quantity.low);
+        PUT_LITERAL(writer, ",\"high\":");
+        put_rational(writer, quantity.high);
+    } else {
+        PUT_LITERAL(writer, ",\"low\":null,\"high\":null");
+    }
+    if (quantity.flags & COOKLANG_QUANTITY_FIXED) {
+        PUT_LITERAL(writer, ",\"fixed\":true}");
+    } else {
+        PUT_LITERAL(writer, ",\"fixed\":false}");
+    }
+}
+
+// Write every ingredient, cookware or timer (`kind`) of the recipe's steps,
+// in the order step items count them.
+static void put_entities(Writer *writer, TSTreeCursor *cursor, TSSymbol kind, TSSymbol name_symbol) {
+    const CooklangSymbols *symbols = writer->symbols;
+    bool first = true;
+    PUT_LITERAL(writer, "[");
+    if (!ts_tree_cursor_goto_first_child(cursor)) {
+        PUT_LITERAL(writer, "]");
+        return;
+    }
+    do {
+        if (ts_node_symbol(ts_tree_cursor_current_node(cursor)) != symbols->step ||
+            !ts_tree_cursor_goto_first_child(cursor)) {
+            continue;
+        }
+        do {
+            TSNode entity = ts_tree_cursor_current_node(cursor);
+            if (ts_node_symbol(entity) != kind) {
+                continue;
+            }
+            TSNode name = child_of(entity, name_symbol);
+            TSNode quantity = child_of(entity, symbols->quantity);
+            TSNode note = entity_note(symbols, entity);
+            put_separator(writer, &first);
+            PUT_LITERAL(writer, "{\"name\":");
+            put_optional(writer, name, 0);
+            PUT_LITERAL(writer, ",\"quantity\":");
+            if (ts_node_is_null(quantity)) {
+                PUT_LITERAL(writer, "null");
+            } else {
+                put_quantity(writer, quantity);
+            }
+            PUT_LITERAL(writer, ",\"note\":");
+            put_optional(writer, ts_node_is_null(note) ? note : child_of(note, symbols->note_content),
+                         0);
+            if (kind == symbols->ingredient) {
+                CooklangSpan span = ts_node_is_null(name) ? (CooklangSpan){0, 0}
+                                                          : trimmed_span(writer->source, name, 0);
+                const char *text = writer->source + span.start;
+                bool reference = span.end - span.start >= 2 && text[0] == '.' &&
+                                 (text[1] == '/' || text[1] == '\\');
+                if (reference) {
+                    PUT_LITERAL(writer, ",\"reference\":true");
+                } else {
+                    PUT_LITERAL(writer, ",\"reference\":false");
+                }
+            }
+            PUT_LITERAL(writer, "}");
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+    PUT_LITERAL(writer, "]");
+}
+
+static void put_text_item(Writer *writer, bool *first, CooklangSpan span) {
+    put_separator(writer, first);
+    PUT_LITERAL(writer, "{\"type\":\"text\",\"value\":");
+    put_string(writer, span);
+    PUT_LITERAL(writer, "}");
+}
+
+// Steps as they appear in the source, with the text between entities kept
+// as written. `counts` holds the next ingredient, cookware and timer index.
+static void put_step(Writer *writer, TSTreeCursor *cursor, uint32_t counts[3]) {
+    const CooklangSymbols *symbols = writer->symbols;
+    bool first = true;
+    PUT_LITERAL(writer, "{\"type\":\"step\",\"items\":[");
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        uint32_t position = ts_node_start_byte(ts_tree_cursor_current_node(cursor));
+        uint32_t text_end = position;
+        // Set after an entity without a note of its own, until anything but
+        // a comment follows; see entity_note.
+        bool note_attaches = false;
+        do {
+            TSNode child = ts_tree_cursor_current_node(cursor);
+            TSSymbol symbol = ts_node_symbol(child);
+            if (symbol == symbols->text) {
+                text_end = ts_node_end_byte(child);
+                note_attaches = false;
+                continue;
+            }
+            if (symbol == symbols->note && note_attaches) {
+                position = text_end = ts_node_end_byte(child);
+                note_attaches = false;
+                continue;
+            }
+            // Anything else ends the text run, including the whitespace
+            // before it.
+            uint32_t start = ts_node_start_byte(child);
+            if (start > text_end && (symbol == symbols->ingredient || symbol == symbols->cookware ||
+                                     symbol == symbols->timer || symbol == symbols->note)) {
+                text_end = start;
+            }
+            if (text_end > position) {
+                put_text_item(writer, &first, (CooklangSpan){position, text_end});
+            }
+            position = text_end = ts_node_end_byte(child);
+
+            const char *type = NULL;
+            uint32_t index = 0;
+            if (symbol == symbols->ingredient) {
+                type = "ingredient";
+                index = counts[0]++;
+            } else if (symbol == symbols->cookware) {
+                type = "cookware";
+                index = counts[1]++;
+            } else if (symbol == symbols->timer) {
+                type = "timer";
+                index = counts[2]++;
+            }
+            if (!is_comment(symbols, symbol)) {
+                note_attaches = type && ts_node_is_null(child_of(child, symbols->note));
+            }
+            if (type) {
+                char item[64];
+                int length = snprintf(item, sizeof(item), "{\"type\":\"%s\",\"index\":%u}",
+                                      type, index);
+                put_separator(writer, &first);
+                put(writer, item, (uint32_t)length);
+            } else if (symbol == symbols->note) {
+                put_separator(writer, &first);
+                PUT_LITERAL(writer, "{\"type\":\"note\",\"value\":");
+                put_optional(writer, child_of(child, symbols->note_content), 0);
+                PUT_LITERAL(writer, "}");
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        if (text_end > position) {
+            put_text_item(writer, &first, (CooklangSpan){position, text_end});
+        }
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    PUT_LITERAL(writer, "]}");
+}
+
+static void put_sections(Writer *writer, TSTreeCursor *cursor) {
+    const CooklangSymbols *symbols = writer->symbols;
+    uint32_t counts[3] = {0, 0, 0};
+    // The unnamed section before the first `=` line is written only if it
+    // has content, or if the recipe has no sections at all.
+    bool open = false, first_content = true;
+    PUT_LITERAL(writer, "[");
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSNode node = ts_tree_cursor_current_node(cursor);
+            TSSymbol symbol = ts_node_symbol(node);
+            if (symbol == symbols->section) {
+                if (open) {
+                    PUT_LITERAL(writer, "]},");
+                }
+                PUT_LITERAL(writer, "{\"name\":");
+                put_optional(writer, child_of(node, symbols->section_name), '=');
+                PUT_LITERAL(writer, ",\"content\":[");
+                open = true;
+                first_content = true;
+                continue;
+            }
+            if (symbol != symbols->step && symbol != symbols->recipe_note) {
+                continue;
+            }
+            if (!open) {
+                PUT_LITERAL(writer, "{\"name\":null,\"content\":[");
+                open = true;
+            }
+            put_separator(writer, &first_content);
+            if (symbol == symbols->step) {
+                put_step(writer, cursor, counts);
+            } else {
+                PUT_LITERAL(writer, "{\"type\":\"note\",\"value\":");
+                put_optional(writer, child_of(node, symbols->recipe_note_text), '>');
+                PUT_LITERAL(writer, "}");
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    if (open) {
+        PUT_LITERAL(writer, "]}]");
+    } else {
+        PUT_LITERAL(writer, "{\"name\":null,\"content\":[]}]");
+    }
+}
+
+static void put_metadata(Writer *writer, TSTreeCursor *cursor) {
+    const CooklangSymbols *symbols = writer->symbols;
+    TSNode frontmatter = {0};
+    bool first = true;
+    PUT_LITERAL(writer, "{\"metadata\":[");
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSNode node = ts_tree_cursor_current_node(cursor);
+            TSSymbol symbol = ts_node_symbol(node);
+            if (symbol == symbols->frontmatter) {
+                frontmatter = node;
+            } else if (symbol == symbols->metadata) {
+                put_separator(writer, &first);
+                PUT_LITERAL(writer, "{\"key\":");
+                put_optional(writer, child_of(node, symbols->metadata_key), '>');
+                PUT_LITERAL(writer, ",\"value\":");
+                put_optional(writer, child_of(node, symbols->metadata_value), 0);
+                PUT_LITERAL(writer, "}");
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    PUT_LITERAL(writer, "],\"frontmatter\":");
+    TSNode content = ts_node_is_null(frontmatter)
+                         ? frontmatter
+                         : child_of(frontmatter, symbols->frontmatter_content);
+    if (ts_node_is_null(content)) {
+        if (ts_node_is_null(frontmatter)) {
+            PUT_LITERAL(writer, "null");
+        } else {
+            PUT_LITERAL(writer, "\"\"");
+        }
+    } else {
+        // Kept verbatim: it is YAML, and indentation matters.
+        put_string(writer, (CooklangSpan){ts_node_start_byte(content), ts_node_end_byte(content)});
+    }
+}
+
+bool cooklang_json_write_recipe(const char *source, TSNode root, CooklangText *out) {
+    const TSLanguage *language = ts_node_language(root);
+    CooklangSymbols symbols;
+    cooklang_symbols_init(&symbols, language);
+    Writer writer = {source, &symbols, out, true};
+
+    // One pass over the top level for the metadata and sections, then one
+    // for each entity list; the cursor is the only state kept between them.
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    put_metadata(&writer, &cursor);
+    PUT_LITERAL(&writer, ",\"sections\":");
+    put_sections(&writer, &cursor);
+    PUT_LITERAL(&writer, ",\"ingredients\":");
+    put_entities(&writer, &cursor, symbols.ingredient, symbols.ingredient_name);
+    PUT_LITERAL(&writer, ",\"cookware\":");
+    put_entities(&writer, &cursor, symbols.cookware, symbols.cookware_name);
+    PUT_LITERAL(&writer, ",\"timers\":");
+    put_entities(&writer, &cursor, symbols.timer, symbols.timer_name);
+    PUT_LITERAL(&writer, "}");
+    ts_tree_cursor_delete(&cursor);
+    return writer.ok;
+}
@@ -0,0 +1,52 @@
+#ifndef COOKLANG_JSON_H_
+#define COOKLANG_JSON_H_
+
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// JSON export of parsed recipes.
+//
+// A recipe is written as one JSON object on a single line, straight from
+// the syntax tree into the output buffer, so a batch of recipes appended
+// with a newline after each is NDJSON. The document has this shape:
+//
+//   {"metadata":[{"key":"servings","value":"4"}],
+//    "frontmatter":null,
+//    "sections":[{"name":null,"content":[
+//      {"type":"step","items":[
+//        {"type":"text","value":"Add "},
+//        {"type":"ingredient","index":0}]},
+//      {"type":"note","value":"Serve warm."}]}],
+//    "ingredients":[{"name":"salt","quantity":{"text":"1%tsp","amount":"1",
+//      "unit":"tsp","low":1,"high":1,"fixed":false},"note":null,
+//      "reference":false}],
+//    "cookware":[],
+//    "timers":[]}
+//
+// Step items refer to ingredients, cookware and timers by their index in
+// the lists that follow. Names, values and notes are trimmed; text items
+// keep their spacing, so the items of a step read back as the step with
+// its entities and comments taken out. `low` and `high` are null unless the
+// amount is a number or range. Steps inside syntax errors are left out.
+
+// Append the recipe in the tree under `root` to `out`. Returns false if
+// `out` could not grow, leaving a partial document at its end.
+bool cooklang_json_write_recipe(const char *source, TSNode root, CooklangText *out);
+
+// Append `length` bytes of `data` as a JSON string, quotes included.
+// Invalid UTF-8 is written as \ufffd, one for each byte that does not
+// belong to a well-formed sequence. Returns false if `out` could not grow.
+bool cooklang_json_write_string(CooklangText *out, const char *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_JSON_H_
@@ -0,0 +1,380 @@
+#define _DEFAULT_SOURCE
+
+#include "cooklang_pack.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HEADER_SIZE 32
+#define INDEX_RECORD_SIZE 40
+#define METADATA_RECORD_SIZE 16
+
+static const char MAGIC[8] = {'C', 'O', 'O', 'K', 'P', 'A', 'C', 'K'};
+
+static void put_u32(uint8_t *bytes, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void put_u64(uint8_t *bytes, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t get_u32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 |
+           (uint32_t)bytes[3] << 24;
+}
+
+static uint64_t get_u64(const uint8_t *bytes) {
+    return (uint64_t)get_u32(bytes) | (uint64_t)get_u32(bytes + 4) << 32;
+}
+
+static void write_bytes(CooklangPackWriter *writer, const void *bytes, size_t length) {
+    if (!writer->failed && fwrite(bytes, 1, length, writer->file) != length) {
+        writer->failed = true;
+    }
+    writer->offset += length;
+}
+
+bool cooklang_pack_writer_open(CooklangPackWriter *writer, const char *path, bool metadata) {
+    memset(writer, 0, sizeof(*writer));
+    writer->metadata = metadata;
+    cooklang_entity_list_init(&writer->entities);
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        return false;
+    }
+    // The header is written last, once the index is in place.
+    static const uint8_t PLACEHOLDER[HEADER_SIZE];
+    write_bytes(writer, PLACEHOLDER, HEADER_SIZE);
+    return !writer->failed;
+}
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static CooklangSpan trim(const char *text, uint32_t start, uint32_t end) {
+    while (start < end && is_blank(text[start])) {
+        start++;
+    }
+    while (end > start && is_blank(text[end - 1])) {
+        end--;
+    }
+    return (CooklangSpan){start, end};
+}
+
+static void write_metadata_record(CooklangPackWriter *writer, CooklangSpan key, CooklangSpan value,
+                                  uint32_t *count) {
+    uint8_t record[METADATA_RECORD_SIZE];
+    put_u32(record, key.start);
+    put_u32(record + 4, key.end);
+    put_u32(record + 8, value.start);
+    put_u32(record + 12, value.end);
+    write_bytes(writer, record, sizeof(record));
+    (*count)++;
+}
+
+// Top-level `key: value` lines of a frontmatter block; nested and list
+// entries are left for a YAML parser.
+static void write_frontmatter(CooklangPackWriter *writer, const char *text, CooklangSpan body,
+                              uint32_t *count) {
+    uint32_t line = body.start;
+    while (line < body.end) {
+        uint32_t end = line;
+        while (end < body.end && text[end] != '\n') {
+            end++;
+        }
+        uint32_t colon = line;
+        while (colon < end && text[colon] != ':') {
+            colon++;
+        }
+        bool top_level = !is_blank(text[line]) && text[line] != '-' && text[line] != '#';
+        CooklangSpan key = trim(text, line, colon);
+        if (top_level && colon < end && key.start < key.end) {
+            write_metadata_record(writer, key, trim(text, colon + 1, end), count);
+        }
+        line = end + 1;
+    }
+}
+
+bool cooklang_pack_writer_add(CooklangPackWriter *writer, const char *path, const char *text,
+                              uint32_t length) {
+    if (writer->length == writer->capacity) {
+        uint32_t capacity = writer->capacity ? writer->capacity * 2 : 256;
+        CooklangPackWriterEntry *entries =
+            realloc(writer->entries, capacity * sizeof(CooklangPackWriterEntry));
+        if (!entries) {
+            writer->failed = true;
+            return false;
+        }
+        writer->entries = entries;
+        writer->capacity = capacity;
+    }
+    size_t path_length = strlen(path);
+    char *copy = malloc(path_length + 1);
+    if (!copy || path_length > UINT32_MAX) {
+        free(copy);
+        writer->failed = true;
+        return false;
+    }
+    memcpy(copy, path, path_length + 1);
+
+    CooklangPackWriterEntry *entry = &writer->entries[writer->length++];
+    entry->path = copy;
+    entry->text_offset = writer->offset;
+    entry->text_length = length;
+    write_bytes(writer, text, length);
+    write_bytes(writer, "", 1);
+
+    entry->metadata_offset = writer->offset;
+    entry->metadata_count = 0;
+    if (writer->metadata) {
+        writer->entities.length = 0;
+        if (!cooklang_extract(text, length, &writer->entities)) {
+            writer->failed = true;
+        }
+        for (uint32_t i = 0; i < writer->entities.length; i++) {
+            const CooklangEntity *entity = &writer->entities.entities[i];
+            if (entity->kind == COOKLANG_ENTITY_METADATA) {
+                write_metadata_record(writer, entity->name, entity->value, &entry->metadata_count);
+            } else if (entity->kind == COOKLANG_ENTITY_FRONTMATTER) {
+                write_frontmatter(writer, text, entity->value, &entry->metadata_count);
+            }
+        }
+    }
+    return !writer->failed;
+}
+
+static int compare_entries(const void *a, const void *b) {
+    return strcmp(((const CooklangPackWriterEntry *)a)->path,
+                  ((const CooklangPackWriterEntry *)b)->path);
+}
+
+bool cooklang_pack_writer_finish(CooklangPackWriter *writer) {
+    if (writer->length > 1) {
+        qsort(writer->entries, writer->length, sizeof(CooklangPackWriterEntry), compare_entries);
+    }
+    for (uint32_t i = 1; i < writer->length; i++) {
+        if (strcmp(writer->entries[i - 1].path, writer->entries[i].path) == 0) {
+            writer->failed = true;
+        }
+    }
+
+    uint64_t *path_offsets = malloc((writer->length + 1) * sizeof(uint64_t));
+    if (!path_offsets) {
+        writer->failed = true;
+    }
+    for (uint32_t i = 0; i < writer->length && path_offsets; i++) {
+        path_offsets[i] = writer->offset;
+        write_bytes(writer, writer->entries[i].path, strlen(writer->entries[i].path) + 1);
+    }
+    uint64_t index_offset = writer->offset;
+    for (uint32_t i = 0; i < writer->length && path_offsets; i++) {
+        const CooklangPackWriterEntry *entry = &writer->entries[i];
+        uint8_t record[INDEX_RECORD_SIZE];
+        put_u64(record, path_offsets[i]);
+        put_u64(record + 8, entry->text_offset);
+        put_u64(record + 16, entry->metadata_offset);
+        put_u32(record + 24, (uint32_t)strlen(entry->path));
+        put_u32(record + 28, entry->text_length);
+        put_u32(record + 32, entry->metadata_count);
+        put_u32(record + 36, 0);
+        write_bytes(writer, record, sizeof(record));
+    }
+    free(path_offsets);
+
+    uint8_t header[HEADER_SIZE];
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    put_u32(header + 8, COOKLANG_PACK_VERSION);
+    put_u32(header + 12, writer->length);
+    put_u64(header + 16, index_offset);
+    put_u64(header + 24, writer->offset);
+    if (fseek(writer->file, 0, SEEK_SET) != 0 ||
+        fwrite(header, 1, sizeof(header), writer->file) != sizeof(header)) {
+        writer->failed = true;
+    }
+    if (fclose(writer->file) != 0) {
+        writer->failed = true;
+    }
+
+    for (uint32_t i = 0; i < writer->length; i++) {
+        free(writer->entries[i].path);
+    }
+    free(writer->entries);
+    cooklang_entity_list_free(&writer->entities);
+    bool ok = !writer->failed;
+    memset(writer, 0, sizeof(*writer));
+    return ok;
+}
+
+static const uint8_t *index_record(const CooklangPack *pack, uint32_t index) {
+    uint64_t index_offset = get_u64(pack->data + 16);
+    return pack->data + index_offset + (uint64_t)index * INDEX_RECORD_SIZE;
+}
+
+// Whether `length` bytes at `offset` and a NUL after them lie in the pack.
+static bool valid_string(const CooklangPack *pack, uint64_t offset, uint32_t length,
+                         uint64_t limit) {
+    return offset <= limit && length < limit - offset && pack->data[offset + length] == '\0';
+}
+
+// Checks the header, and every index record and path. Recipe texts and
+// metadata records are checked only when a recipe is read, so that opening
+// a pack reads nothing but its index and paths.
+static bool validate(const CooklangPack *pack) {
+    if (pack->size < HEADER_SIZE || memcmp(pack->data, MAGIC, sizeof(MAGIC)) != 0 ||
+        get_u32(pack->data + 8) != COOKLANG_PACK_VERSION || get_u64(pack->data + 24) != pack->size) {
+        return false;
+    }
+    uint64_t index_offset = get_u64(pack->data + 16);
+    uint64_t count = get_u32(pack->data + 12);
+    if (index_offset < HEADER_SIZE || index_offset > pack->size ||
+        (pack->size - index_offset) / INDEX_RECORD_SIZE < count) {
+        return false;
+    }
+
+    const char *previous = NULL;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *record = index_record(pack, i);
+        uint64_t path_offset = get_u64(record);
+        uint64_t text_offset = get_u64(record + 8);
+        uint64_t metadata_offset = get_u64(record + 16);
+        uint32_t path_length = get_u32(record + 24);
+        uint32_t text_length = get_u32(record + 28);
+        uint32_t metadata_count = get_u32(record + 32);
+        if (!valid_string(pack, path_offset, path_length, index_offset) ||
+            text_offset > index_offset || text_length >= index_offset - text_offset ||
+            metadata_offset > index_offset ||
+            (index_offset - metadata_offset) / METADATA_RECORD_SIZE < metadata_count) {
+            return false;
+        }
+        const char *path = (const char *)pack->data + path_offset;
+        if (strlen(path) != path_length || (previous && strcmp(previous, path) >= 0)) {
+            return false;
+        }
+        previous = path;
+    }
+    return true;
+}
+
+bool cooklang_pack_open_memory(CooklangPack *pack, const void *data, uint64_t size) {
+    pack->data = data;
+    pack->size = size;
+    pack->mapped = false;
+    pack->count = 0;
+    if (!validate(pack)) {
+        return false;
+    }
+    pack->count = get_u32(pack->data + 12);
+    return true;
+}
+
+bool cooklang_pack_open(CooklangPack *pack, const char *path) {
+    memset(pack, 0, sizeof(*pack));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= HEADER_SIZE) {
+        map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    if (!cooklang_pack_open_memory(pack, map, (uint64_t)info.st_size)) {
+        munmap(map, (size_t)info.st_size);
+        memset(pack, 0, sizeof(*pack));
+        return false;
+    }
+    // Recipes are read in no particular order once the index is checked.
+    madvise(map, (size_t)info.st_size, MADV_RANDOM);
+    pack->mapped = true;
+    return true;
+}
+
+void cooklang_pack_close(CooklangPack *pack) {
+    if (pack->mapped) {
+        munmap((void *)pack->data, (size_t)pack->size);
+    }
+    memset(pack, 0, sizeof(*pack));
+}
+
+bool cooklang_pack_recipe(const CooklangPack *pack, uint32_t index, CooklangPackRecipe *recipe) {
+    const uint8_t *record = index_record(pack, index);
+    recipe->path = (const char *)pack->data + get_u64(record);
+    recipe->text = (const char *)pack->data + get_u64(record + 8);
+    recipe->metadata = pack->data + get_u64(record + 16);
+    recipe->path_length = get_u32(record + 24);
+    recipe->length = get_u32(record + 28);
+    recipe->metadata_count = get_u32(record + 32);
+    // The bounds were checked on opening; the contents are checked here.
+    if (recipe->text[recipe->length] != '\0') {
+        return false;
+    }
+    for (uint32_t i = 0; i < recipe->metadata_count; i++) {
+        CooklangSpan key, value;
+        cooklang_pack_metadata(recipe, i, &key, &value);
+        if (key.start > key.end || key.end > recipe->length || value.start > value.end ||
+            value.end > recipe->length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t cooklang_pack_find(const CooklangPack *pack, const char *path) {
+    uint32_t low = 0;
+    uint32_t high = pack->count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        const char *candidate = (const char *)pack->data + get_u64(index_record(pack, middle));
+        int order = strcmp(candidate, path);
+        if (order == 0) {
+            return middle;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return UINT32_MAX;
+}
+
+void cooklang_pack_metadata(const CooklangPackRecipe *recipe, uint32_t index, CooklangSpan *key,
+                            CooklangSpan *value) {
+    const uint8_t *record = recipe->metadata + (uint64_t)index * METADATA_RECORD_SIZE;
+    key->start = get_u32(record);
+    key->end = get_u32(record + 4);
+    value->start = get_u32(record + 8);
+    value->end = get_u32(record + 12);
+}
+
+bool cooklang_pack_find_metadata(const CooklangPackRecipe *recipe, const char *key,
+                                 CooklangSpan *value) {
+    size_t key_length = strlen(key);
+    for (uint32_t i = 0; i < recipe->metadata_count; i++) {
+        CooklangSpan name;
+        cooklang_pack_metadata(recipe, i, &name, value);
+        if (name.end - name.start == key_length &&
+            memcmp(recipe->text + name.start, key, key_length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TSTree *cooklang_pack_parse(TSParser *parser, const CooklangPackRecipe *recipe) {
+    return ts_parser_parse_string(parser, NULL, recipe->text, recipe->length);
+}
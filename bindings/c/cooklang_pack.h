@@ -0,0 +1,124 @@
+#ifndef COOKLANG_PACK_H_
+#define COOKLANG_PACK_H_
+
+#include "cooklang_extract.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A pack: many recipes in one file, for collections where opening and
+// reading thousands of small files costs more than parsing them.
+//
+// A pack is read through a memory mapping, so opening one reads its index
+// and paths and nothing else, and a recipe's text is read from disk when it
+// is first touched. Recipes are parsed only when asked for. The metadata of each
+// recipe (`>> key: value` lines, and top-level `key: value` lines of its
+// frontmatter) can be precomputed when the pack is built, so listing a
+// collection by title needs neither parsing nor extraction.
+//
+// Layout, all integers little-endian:
+//
+//   header    "COOKPACK", u32 version, u32 recipe count, u64 index offset,
+//             u64 file size
+//   recipes   each recipe's text and a NUL, followed by its metadata
+//             records of four u32s: key start and end, value start and
+//             end, as byte offsets into the text
+//   paths     each path and a NUL
+//   index     one record per recipe, sorted by path: u64 path offset, u64
+//             text offset, u64 metadata offset, u32 path length, u32 text
+//             length, u32 metadata count, u32 reserved
+
+#define COOKLANG_PACK_VERSION 1
+
+typedef struct {
+    char *path;
+    uint64_t text_offset;
+    uint64_t metadata_offset;
+    uint32_t text_length;
+    uint32_t metadata_count;
+} CooklangPackWriterEntry;
+
+typedef struct {
+    FILE *file;
+    uint64_t offset;
+    bool metadata;
+    bool failed;
+    CooklangPackWriterEntry *entries;
+    uint32_t length;
+    uint32_t capacity;
+    CooklangEntityList entities;
+} CooklangPackWriter;
+
+// Start writing a pack to `path`, with precomputed metadata if `metadata`
+// is true. Returns false if the file cannot be created.
+bool cooklang_pack_writer_open(CooklangPackWriter *writer, const char *path, bool metadata);
+
+// Add `length` bytes of `text` as the recipe at `path`, a relative path
+// such as `desserts/flan.cook`. Returns false if writing failed.
+bool cooklang_pack_writer_add(CooklangPackWriter *writer, const char *path, const char *text,
+                              uint32_t length);
+
+// Write the index and close the file. Returns false if writing failed at
+// any point or two recipes had the same path; the file is then not a
+// valid pack.
+bool cooklang_pack_writer_finish(CooklangPackWriter *writer);
+
+typedef struct {
+    const uint8_t *data;
+    uint64_t size;
+    uint32_t count;
+    // Whether `data` is a mapping owned by the pack; internal.
+    bool mapped;
+} CooklangPack;
+
+typedef struct {
+    const char *path;
+    uint32_t path_length;
+    // NUL-terminated, and valid while the pack is open.
+    const char *text;
+    uint32_t length;
+    uint32_t metadata_count;
+    // The metadata records; read them with `cooklang_pack_metadata`.
+    const uint8_t *metadata;
+} CooklangPackRecipe;
+
+// Map the pack at `path`. Returns false if it cannot be read or is not a
+// valid pack.
+bool cooklang_pack_open(CooklangPack *pack, const char *path);
+
+// Use the `size` bytes at `data`, which must outlive the pack, as a pack.
+bool cooklang_pack_open_memory(CooklangPack *pack, const void *data, uint64_t size);
+
+void cooklang_pack_close(CooklangPack *pack);
+
+// The recipe at position `index` in path order. Returns false if its text
+// or metadata is damaged; only the index is checked when a pack is opened.
+bool cooklang_pack_recipe(const CooklangPack *pack, uint32_t index, CooklangPackRecipe *recipe);
+
+// The position of the recipe at `path`, or UINT32_MAX.
+uint32_t cooklang_pack_find(const CooklangPack *pack, const char *path);
+
+// The `index`th metadata key and value of `recipe`, as spans of its text.
+void cooklang_pack_metadata(const CooklangPackRecipe *recipe, uint32_t index, CooklangSpan *key,
+                            CooklangSpan *value);
+
+// The value of the first metadata entry of `recipe` named `key`. Returns
+// false if there is none, or the pack was built without metadata.
+bool cooklang_pack_find_metadata(const CooklangPackRecipe *recipe, const char *key,
+                                 CooklangSpan *value);
+
+// Parse `recipe` with `parser`. The tree refers to the pack's text, which
+// stays valid while the pack is open.
+TSTree *cooklang_pack_parse(TSParser *parser, const CooklangPackRecipe *recipe);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_PACK_H_
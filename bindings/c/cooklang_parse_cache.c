@@ -0,0 +1,45 @@
+#include "cooklang_parse_cache.h"
+
+#include <stdlib.h>
+
+static void parsed_recipe_free(void *value, void *payload) {
+    (void)payload;
+    CooklangParsedRecipe *recipe = value;
+    ts_tree_delete(recipe->tree);
+    cooklang_entity_list_free(&recipe->entities);
+    free(recipe);
+}
+
+CooklangCache *cooklang_parse_cache_new(uint64_t capacity) {
+    return cooklang_cache_new(capacity, parsed_recipe_free, NULL);
+}
+
+CooklangCacheEntry *cooklang_parse_cache_get(CooklangCache *cache, TSParser *parser,
+                                             const char *text, uint32_t length) {
+    CooklangCacheEntry *entry = cooklang_cache_lookup(cache, text, length);
+    if (entry) {
+        return entry;
+    }
+
+    // Parse outside the cache's lock; if another thread caches the same
+    // text meanwhile, the insert keeps theirs.
+    CooklangParsedRecipe *recipe = malloc(sizeof(CooklangParsedRecipe));
+    if (!recipe) {
+        return NULL;
+    }
+    cooklang_entity_list_init(&recipe->entities);
+    recipe->tree = ts_parser_parse_string(parser, NULL, text, length);
+    if (!recipe->tree || !cooklang_extract(text, length, &recipe->entities)) {
+        if (recipe->tree) {
+            ts_tree_delete(recipe->tree);
+        }
+        cooklang_entity_list_free(&recipe->entities);
+        free(recipe);
+        return NULL;
+    }
+    uint64_t size = sizeof(CooklangParsedRecipe) +
+                    recipe->entities.capacity * sizeof(CooklangEntity) +
+                    ts_node_descendant_count(ts_tree_root_node(recipe->tree)) *
+                        (uint64_t)COOKLANG_CACHE_NODE_BYTES;
+    return cooklang_cache_insert(cache, text, length, recipe, size);
+}
@@ -0,0 +1,41 @@
+#ifndef COOKLANG_PARSE_CACHE_H_
+#define COOKLANG_PARSE_CACHE_H_
+
+#include "cooklang_cache.h"
+#include "cooklang_extract.h"
+
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parsed recipes in a `CooklangCache`: the tree and extracted entities of
+// each distinct recipe text, computed once and shared by every thread that
+// asks for the same text again.
+
+typedef struct {
+    TSTree *tree;
+    CooklangEntityList entities;
+} CooklangParsedRecipe;
+
+// A cache whose values are `CooklangParsedRecipe`s, each charged its text
+// and `COOKLANG_CACHE_NODE_BYTES` per syntax node. Delete it with
+// `cooklang_cache_delete`.
+CooklangCache *cooklang_parse_cache_new(uint64_t capacity);
+
+// The parsed recipe for `length` bytes of `text`, parsing it with `parser`
+// on a miss. The entry's value is the `CooklangParsedRecipe` and its key
+// the text the tree refers to, both read-only. A syntax tree is not for use
+// on several threads at once, so take `ts_tree_copy` of the tree to walk or
+// edit it. Release the entry with `cooklang_cache_release`. Returns NULL if
+// parsing failed or memory ran out.
+CooklangCacheEntry *cooklang_parse_cache_get(CooklangCache *cache, TSParser *parser,
+                                             const char *text, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_PARSE_CACHE_H_
@@ -0,0 +1,472 @@
+#include "cooklang_quantity.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Decimal amounts are serialized with this many places at most.
+#define DECIMAL_PLACES 3
+#define DECIMAL_SCALE 1000
+
+// Longest serialized amount: two 20-digit mixed numbers and a dash.
+#define FORMAT_BUFFER_SIZE 128
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline const char *skip_spaces(const char *cursor, const char *end) {
+    while (cursor < end && cooklang_is_space(*cursor)) {
+        cursor++;
+    }
+    return cursor;
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b) {
+    while (b) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static inline bool mul_overflows(uint64_t a, uint64_t b, uint64_t *result) {
+    if (a != 0 && b > UINT64_MAX / a) {
+        return true;
+    }
+    *result = a * b;
+    return false;
+}
+
+static inline bool add_overflows(uint64_t a, uint64_t b, uint64_t *result) {
+    if (b > UINT64_MAX - a) {
+        return true;
+    }
+    *result = a + b;
+    return false;
+}
+
+static CooklangRational reduce(uint64_t numerator, uint64_t denominator) {
+    uint64_t divisor = gcd(numerator, denominator);
+    if (divisor > 1) {
+        numerator /= divisor;
+        denominator /= divisor;
+    }
+    return (CooklangRational){numerator, denominator};
+}
+
+bool cooklang_rational_add(CooklangRational a, CooklangRational b, CooklangRational *result) {
+    uint64_t divisor = gcd(a.denominator, b.denominator);
+    uint64_t denominator, left, right, numerator;
+    if (mul_overflows(a.denominator / divisor, b.denominator, &denominator) ||
+        mul_overflows(a.numerator, b.denominator / divisor, &left) ||
+        mul_overflows(b.numerator, a.denominator / divisor, &right) ||
+        add_overflows(left, right, &numerator)) {
+        return false;
+    }
+    *result = reduce(numerator, denominator);
+    return true;
+}
+
+bool cooklang_rational_mul(CooklangRational a, CooklangRational b, CooklangRational *result) {
+    // Cancel across before multiplying to keep the terms small.
+    uint64_t left = gcd(a.numerator, b.denominator);
+    uint64_t right = gcd(b.numerator, a.denominator);
+    uint64_t numerator, denominator;
+    if (mul_overflows(a.numerator / left, b.numerator / right, &numerator) ||
+        mul_overflows(a.denominator / right, b.denominator / left, &denominator)) {
+        return false;
+    }
+    *result = reduce(numerator, denominator);
+    return true;
+}
+
+static bool parse_integer(const char **cursor, const char *end, uint64_t *value, uint32_t *digits) {
+    const char *start = *cursor;
+    uint64_t result = 0;
+    while (*cursor < end && is_digit(**cursor)) {
+        if (mul_overflows(result, 10, &result) ||
+            add_overflows(result, (uint64_t)(**cursor - '0'), &result)) {
+            return false;
+        }
+        (*cursor)++;
+    }
+    *value = result;
+    *digits = (uint32_t)(*cursor - start);
+    return true;
+}
+
+// `digits`, `digits.digits`, `.digits`, `digits/digits` or
+// `digits digits/digits`, with optional spaces around the slash.
+static bool parse_number(const char **cursor, const char *end, CooklangRational *value,
+                         uint8_t *flags) {
+    const char *p = *cursor;
+    uint64_t whole;
+    uint32_t digits;
+    if (!parse_integer(&p, end, &whole, &digits)) {
+        return false;
+    }
+
+    if (p < end && *p == '.') {
+        p++;
+        uint64_t fraction;
+        uint32_t places;
+        if (!parse_integer(&p, end, &fraction, &places) || digits + places == 0) {
+            return false;
+        }
+        uint64_t scale = 1, numerator;
+        for (uint32_t i = 0; i < places; i++) {
+            if (mul_overflows(scale, 10, &scale)) {
+                return false;
+            }
+        }
+        if (mul_overflows(whole, scale, &numerator) ||
+            add_overflows(numerator, fraction, &numerator)) {
+            return false;
+        }
+        *value = reduce(numerator, scale);
+        *cursor = p;
+        return true;
+    }
+    if (digits == 0) {
+        return false;
+    }
+
+    // A slash makes `whole` a numerator; a second integer followed by a
+    // slash makes it the whole part of a mixed number.
+    const char *after_whole = p;
+    p = skip_spaces(p, end);
+    uint64_t numerator = whole;
+    uint64_t mixed_whole = 0;
+    if (p < end && is_digit(*p)) {
+        if (!parse_integer(&p, end, &numerator, &digits)) {
+            return false;
+        }
+        p = skip_spaces(p, end);
+        if (p == end || *p != '/') {
+            *value = (CooklangRational){whole, 1};
+            *cursor = after_whole;
+            return true;
+        }
+        mixed_whole = whole;
+    }
+    if (p == end || *p != '/') {
+        *value = (CooklangRational){whole, 1};
+        *cursor = after_whole;
+        return true;
+    }
+
+    p = skip_spaces(p + 1, end);
+    uint64_t denominator;
+    if (!parse_integer(&p, end, &denominator, &digits) || digits == 0 || denominator == 0) {
+        return false;
+    }
+    uint64_t total;
+    if (mul_overflows(mixed_whole, denominator, &total) ||
+        add_overflows(total, numerator, &total)) {
+        return false;
+    }
+    *value = reduce(total, denominator);
+    *flags |= COOKLANG_QUANTITY_FRACTION;
+    *cursor = p;
+    return true;
+}
+
+static CooklangSpan span_of(const char *source, const char *start, const char *end) {
+    while (start < end && cooklang_is_space(*start)) {
+        start++;
+    }
+    while (end > start && cooklang_is_space(end[-1])) {
+        end--;
+    }
+    return (CooklangSpan){(uint32_t)(start - source), (uint32_t)(end - source)};
+}
+
+void cooklang_quantity_parse(const char *source, CooklangSpan span, CooklangQuantity *quantity) {
+    const char *start = source + span.start;
+    const char *end = source + span.end;
+    const char *separator = memchr(start, '%', (size_t)(end - start));
+
+    memset(quantity, 0, sizeof(*quantity));
+    quantity->amount = span_of(source, start, separator ? separator : end);
+    quantity->unit = separator ? span_of(source, separator + 1, end)
+                               : (CooklangSpan){span.end, span.end};
+
+    const char *p = source + quantity->amount.start;
+    const char *amount_end = source + quantity->amount.end;
+    if (p < amount_end && *p == '=') {
+        quantity->flags |= COOKLANG_QUANTITY_FIXED;
+        quantity->amount = span_of(source, p + 1, amount_end);
+        p = source + quantity->amount.start;
+    }
+    if (p == amount_end) {
+        quantity->kind = COOKLANG_QUANTITY_EMPTY;
+        return;
+    }
+
+    quantity->kind = COOKLANG_QUANTITY_TEXT;
+    uint8_t flags = quantity->flags;
+    CooklangRational low, high;
+    if (!parse_number(&p, amount_end, &low, &flags)) {
+        return;
+    }
+    high = low;
+    p = skip_spaces(p, amount_end);
+    CooklangQuantityKind kind = COOKLANG_QUANTITY_NUMBER;
+    if (p < amount_end && *p == '-') {
+        p = skip_spaces(p + 1, amount_end);
+        if (!parse_number(&p, amount_end, &high, &flags)) {
+            return;
+        }
+        p = skip_spaces(p, amount_end);
+        kind = COOKLANG_QUANTITY_RANGE;
+    }
+    if (p != amount_end) {
+        return;
+    }
+    quantity->kind = (uint8_t)kind;
+    quantity->flags = flags;
+    quantity->low = low;
+    quantity->high = high;
+}
+
+bool cooklang_quantity_scale(CooklangQuantity *quantity, CooklangRational factor) {
+    if ((quantity->kind != COOKLANG_QUANTITY_NUMBER && quantity->kind != COOKLANG_QUANTITY_RANGE) ||
+        (quantity->flags & COOKLANG_QUANTITY_FIXED)) {
+        return true;
+    }
+    if (factor.denominator == 0) {
+        return false;
+    }
+    CooklangRational low, high;
+    if (!cooklang_rational_mul(quantity->low, factor, &low) ||
+        !cooklang_rational_mul(quantity->high, factor, &high)) {
+        return false;
+    }
+    quantity->low = low;
+    quantity->high = high;
+    return true;
+}
+
+static char *format_integer(char *out, uint64_t value) {
+    char digits[20];
+    int length = 0;
+    do {
+        digits[length++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (length) {
+        *out++ = digits[--length];
+    }
+    return out;
+}
+
+static char *format_fraction(char *out, CooklangRational value) {
+    uint64_t whole = value.numerator / value.denominator;
+    uint64_t remainder = value.numerator % value.denominator;
+    if (whole || !remainder) {
+        out = format_integer(out, whole);
+        if (!remainder) {
+            return out;
+        }
+        *out++ = ' ';
+    }
+    out = format_integer(out, remainder);
+    *out++ = '/';
+    return format_integer(out, value.denominator);
+}
+
+static char *format_decimal(char *out, CooklangRational value) {
+    uint64_t whole = value.numerator / value.denominator;
+    uint64_t remainder = value.numerator % value.denominator;
+    // Round the remainder to DECIMAL_PLACES, half up. The remainder is
+    // below the denominator, so compute in long double only if the exact
+    // product would overflow.
+    uint64_t scaled;
+    if (mul_overflows(remainder, DECIMAL_SCALE, &scaled) ||
+        add_overflows(scaled, value.denominator / 2, &scaled)) {
+        scaled = (uint64_t)((long double)remainder * DECIMAL_SCALE / value.denominator + 0.5L);
+    } else {
+        scaled /= value.denominator;
+    }
+    if (scaled >= DECIMAL_SCALE) {
+        whole++;
+        scaled -= DECIMAL_SCALE;
+    }
+    out = format_integer(out, whole);
+    if (scaled) {
+        char places[DECIMAL_PLACES];
+        int length = DECIMAL_PLACES;
+        for (int i = DECIMAL_PLACES - 1; i >= 0; i--) {
+            places[i] = (char)('0' + scaled % 10);
+            scaled /= 10;
+        }
+        while (places[length - 1] == '0') {
+            length--;
+        }
+        *out++ = '.';
+        memcpy(out, places, (size_t)length);
+        out += length;
+    }
+    return out;
+}
+
+uint32_t cooklang_quantity_format(const CooklangQuantity *quantity, char *out, uint32_t capacity) {
+    if (quantity->kind != COOKLANG_QUANTITY_NUMBER && quantity->kind != COOKLANG_QUANTITY_RANGE) {
+        if (capacity) {
+            out[0] = '\0';
+        }
+        return 0;
+    }
+    char *(*format)(char *, CooklangRational) =
+        (quantity->flags & COOKLANG_QUANTITY_FRACTION) ? format_fraction : format_decimal;
+
+    char buffer[FORMAT_BUFFER_SIZE];
+    char *end = format(buffer, quantity->low);
+    if (quantity->kind == COOKLANG_QUANTITY_RANGE) {
+        *end++ = '-';
+        end = format(end, quantity->high);
+    }
+    uint32_t length = (uint32_t)(end - buffer);
+    if (capacity) {
+        uint32_t copied = length < capacity ? length : capacity - 1;
+        memcpy(out, buffer, copied);
+        out[copied] = '\0';
+    }
+    return length;
+}
+
+void cooklang_text_init(CooklangText *text) {
+    text->data = NULL;
+    text->length = 0;
+    text->capacity = 0;
+}
+
+void cooklang_text_free(CooklangText *text) {
+    free(text->data);
+    cooklang_text_init(text);
+}
+
+bool cooklang_text_reserve(CooklangText *text, uint32_t extra) {
+    uint64_t needed = (uint64_t)text->length + extra + 1;
+    if (needed <= text->capacity) {
+        return true;
+    }
+    if (needed > UINT32_MAX) {
+        return false;
+    }
+    uint64_t capacity = text->capacity ? text->capacity : 256;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    if (capacity > UINT32_MAX) {
+        capacity = UINT32_MAX;
+    }
+    char *data = realloc(text->data, (size_t)capacity);
+    if (!data) {
+        return false;
+    }
+    text->data = data;
+    text->capacity = (uint32_t)capacity;
+    return true;
+}
+
+bool cooklang_text_append(CooklangText *text, const char *data, uint32_t length) {
+    if (!cooklang_text_reserve(text, length)) {
+        return false;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    return true;
+}
+
+typedef struct {
+    const char *source;
+    CooklangRational factor;
+    CooklangText *out;
+    CooklangScaleCounts counts;
+    uint32_t copied;
+} Scaler;
+
+static bool scale_quantity(Scaler *scaler, TSNode node) {
+    // Skip the braces; the closing one is missing if the parser recovered
+    // from an unterminated quantity.
+    uint32_t start = ts_node_start_byte(node) + 1;
+    uint32_t end = ts_node_end_byte(node);
+    if (end > start && scaler->source[end - 1] == '}') {
+        end--;
+    }
+    if (end < start) {
+        return true;
+    }
+    CooklangQuantity quantity;
+    cooklang_quantity_parse(scaler->source, (CooklangSpan){start, end}, &quantity);
+    scaler->counts.quantities++;
+    if (quantity.kind != COOKLANG_QUANTITY_NUMBER && quantity.kind != COOKLANG_QUANTITY_RANGE) {
+        return true;
+    }
+    if ((quantity.flags & COOKLANG_QUANTITY_FIXED) || !cooklang_quantity_scale(&quantity, scaler->factor)) {
+        return true;
+    }
+
+    char amount[FORMAT_BUFFER_SIZE];
+    uint32_t length = cooklang_quantity_format(&quantity, amount, sizeof(amount));
+    if (!cooklang_text_append(scaler->out, scaler->source + scaler->copied,
+                              quantity.amount.start - scaler->copied) ||
+        !cooklang_text_append(scaler->out, amount, length)) {
+        return false;
+    }
+    scaler->copied = quantity.amount.end;
+    scaler->counts.scaled++;
+    return true;
+}
+
+bool cooklang_scale_recipe(const char *source, uint32_t length, TSNode root,
+                           CooklangRational factor, CooklangText *out,
+                           CooklangScaleCounts *counts) {
+    const TSLanguage *language = ts_node_language(root);
+    TSSymbol ingredient = COOKLANG_SYMBOL(language, "ingredient");
+    TSSymbol quantity = COOKLANG_SYMBOL(language, "quantity");
+
+    Scaler scaler = {source, factor, out, {0, 0}, 0};
+    out->length = 0;
+    bool ok = cooklang_text_reserve(out, length);
+
+    // Visit the tree in source order, looking for quantities only among the
+    // children of ingredients.
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    while (ok) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        if (ts_node_symbol(node) == ingredient) {
+            if (ts_tree_cursor_goto_first_child(&cursor)) {
+                do {
+                    TSNode child = ts_tree_cursor_current_node(&cursor);
+                    if (ts_node_symbol(child) == quantity && !scale_quantity(&scaler, child)) {
+                        ok = false;
+                    }
+                } while (ok && ts_tree_cursor_goto_next_sibling(&cursor));
+                ts_tree_cursor_goto_parent(&cursor);
+            }
+        } else if (ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                goto done;
+            }
+        }
+    }
+done:
+    ts_tree_cursor_delete(&cursor);
+
+    ok = ok && cooklang_text_append(out, source + scaler.copied, length - scaler.copied);
+    if (ok) {
+        out->data[out->length] = '\0';
+    }
+    if (counts) {
+        *counts = scaler.counts;
+    }
+    return ok;
+}
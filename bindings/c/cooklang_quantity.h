@@ -0,0 +1,108 @@
+#ifndef COOKLANG_QUANTITY_H_
+#define COOKLANG_QUANTITY_H_
+
+#include "cooklang_extract.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Quantity evaluation and serving scaling.
+//
+// The text between the braces of a quantity, `{amount%unit}`, is evaluated
+// into exact rationals. Amounts may be integers (`2`), decimals (`0.25`),
+// fractions (`1/2`), mixed numbers (`1 1/2`) or ranges of any of these
+// (`2-3`). A leading `=` marks the amount as fixed, so it is never scaled.
+// Anything else (`some`, `a pinch`) is kept as text.
+
+// A non-negative rational in lowest terms, with a non-zero denominator.
+typedef struct {
+    uint64_t numerator;
+    uint64_t denominator;
+} CooklangRational;
+
+// Exact arithmetic on rationals. Both return false, leaving `result`
+// untouched, if the terms do not fit in 64 bits.
+bool cooklang_rational_add(CooklangRational a, CooklangRational b, CooklangRational *result);
+bool cooklang_rational_mul(CooklangRational a, CooklangRational b, CooklangRational *result);
+
+typedef enum {
+    COOKLANG_QUANTITY_EMPTY,
+    COOKLANG_QUANTITY_NUMBER,
+    COOKLANG_QUANTITY_RANGE,
+    COOKLANG_QUANTITY_TEXT,
+} CooklangQuantityKind;
+
+enum {
+    // The amount starts with `=` and is not scaled.
+    COOKLANG_QUANTITY_FIXED = 1 << 0,
+    // The amount was written with a fraction, and is serialized as one.
+    COOKLANG_QUANTITY_FRACTION = 1 << 1,
+};
+
+typedef struct {
+    uint8_t kind;
+    uint8_t flags;
+    // For a number, `low == high`.
+    CooklangRational low;
+    CooklangRational high;
+    // The amount without the `=` marker, and the unit after `%`, both
+    // trimmed of whitespace. The unit is empty when there is no `%`.
+    CooklangSpan amount;
+    CooklangSpan unit;
+} CooklangQuantity;
+
+// Evaluate the quantity text in `span` of `source`, excluding the braces.
+void cooklang_quantity_parse(const char *source, CooklangSpan span, CooklangQuantity *quantity);
+
+// Multiply a number or range by `factor`. Fixed amounts and text are left
+// alone. Returns false, leaving the quantity unchanged, if the result does
+// not fit in 64 bits.
+bool cooklang_quantity_scale(CooklangQuantity *quantity, CooklangRational factor);
+
+// Serialize the amount of a number or range the way it was written:
+// fractions as (mixed) fractions, everything else as decimals with at most
+// three places. Writes at most `capacity` bytes, NUL-terminated if there is
+// room, and returns the full length like snprintf. Returns 0 for empty and
+// text quantities.
+uint32_t cooklang_quantity_format(const CooklangQuantity *quantity, char *out, uint32_t capacity);
+
+typedef struct {
+    char *data;
+    uint32_t length;
+    uint32_t capacity;
+} CooklangText;
+
+void cooklang_text_init(CooklangText *text);
+void cooklang_text_free(CooklangText *text);
+
+// Make room for `extra` more bytes and a NUL after `length`. Returns false
+// if the buffer could not grow.
+bool cooklang_text_reserve(CooklangText *text, uint32_t extra);
+
+// Append `length` bytes of `data`. The result is not NUL-terminated.
+bool cooklang_text_append(CooklangText *text, const char *data, uint32_t length);
+
+typedef struct {
+    uint32_t quantities;
+    uint32_t scaled;
+} CooklangScaleCounts;
+
+// Write `source` to `out`, replacing its contents, with the quantity of
+// every ingredient in the tree under `root` multiplied by `factor`.
+// Cookware and timer quantities are copied as written. `out` is reused
+// across calls, so scaling a recipe allocates only when it outgrows the
+// buffer. `counts` may be NULL. Returns false if `out` could not grow.
+bool cooklang_scale_recipe(const char *source, uint32_t length, TSNode root,
+                           CooklangRational factor, CooklangText *out,
+                           CooklangScaleCounts *counts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_QUANTITY_H_
@@ -0,0 +1,574 @@
+#include "cooklang_search.h"
+#include "cooklang_intern.h"
+#include "cooklang_threads.h"
+#include "cooklang_common.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FIELD_COUNT COOKLANG_SEARCH_FIELD_COUNT
+#define INDEXED_SYMBOL_COUNT 5
+// Longer runs are not words anyone searches for, and are skipped.
+#define MAX_TERM_LENGTH 64
+#define MAX_VARINT_BYTES 5
+#define K1 1.2
+#define B 0.75
+
+const float COOKLANG_SEARCH_DEFAULT_WEIGHTS[COOKLANG_SEARCH_FIELD_COUNT] = {1.0f, 1.0f, 2.0f};
+
+typedef struct {
+    // Start of the list in `data`, and its number of postings.
+    uint64_t offset;
+    uint32_t count;
+} PostingList;
+
+struct CooklangSearchIndex {
+    uint32_t document_count;
+    // Words per document in each field, and their averages.
+    uint32_t *field_lengths[FIELD_COUNT];
+    double average_lengths[FIELD_COUNT];
+    CooklangInternTable terms;
+    // One list per term and field: term * FIELD_COUNT + field.
+    PostingList *lists;
+    uint8_t *data;
+    uint64_t data_length;
+    uint64_t posting_count;
+};
+
+static inline bool is_word_byte(uint8_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+// Find the next word of `text` at or after `*position`, lowercased into
+// `word`. Returns false at the end of the text.
+static bool next_word(const char *text, uint32_t length, uint32_t *position, char *word,
+                      uint32_t *word_length) {
+    uint32_t i = *position;
+    for (;;) {
+        while (i < length && !is_word_byte((uint8_t)text[i])) {
+            i++;
+        }
+        if (i == length) {
+            *position = i;
+            return false;
+        }
+        uint32_t start = i;
+        while (i < length && is_word_byte((uint8_t)text[i])) {
+            i++;
+        }
+        if (i - start <= MAX_TERM_LENGTH) {
+            for (uint32_t j = start; j < i; j++) {
+                char c = text[j];
+                word[j - start] = c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+            }
+            *word_length = i - start;
+            *position = i;
+            return true;
+        }
+    }
+}
+
+static uint32_t put_varint(uint8_t *out, uint32_t value) {
+    uint32_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+static inline uint32_t get_varint(const uint8_t **in) {
+    const uint8_t *bytes = *in;
+    uint32_t value = *bytes & 0x7F;
+    for (int shift = 7; *bytes++ & 0x80; shift += 7) {
+        value |= (uint32_t)(*bytes & 0x7F) << shift;
+    }
+    *in = bytes;
+    return value;
+}
+
+// Building
+//
+// Each worker parses and indexes a contiguous range of documents into a
+// partial index: a term table of its own, and a (key, document, count)
+// triple for every word of every field of every document, where the key is
+// term * FIELD_COUNT + field. Triples are appended in document order, so
+// the stable counting sort by key at the end leaves each key's documents in
+// order, and merging the workers in order keeps them so.
+
+typedef struct {
+    uint32_t key;
+    uint32_t document;
+    uint32_t count;
+} Triple;
+
+typedef struct {
+    TSSymbol symbols[INDEXED_SYMBOL_COUNT];
+    CooklangSearchField fields[INDEXED_SYMBOL_COUNT];
+} IndexedSymbols;
+
+typedef struct {
+    const TSLanguage *language;
+    const CooklangSearchDocument *documents;
+    uint32_t first;
+    uint32_t last;
+    uint32_t *const *field_lengths;
+    CooklangInternTable terms;
+    Triple *triples;
+    uint64_t triple_count;
+    uint64_t triple_capacity;
+    // The keys of the document being indexed, one per word.
+    uint32_t *keys;
+    uint32_t key_count;
+    uint32_t key_capacity;
+    // Where each key's triples start once sorted, and one past the last.
+    uint64_t *starts;
+    bool ok;
+} Worker;
+
+static bool add_key(Worker *worker, uint32_t key) {
+    if (worker->key_count == worker->key_capacity) {
+        uint32_t capacity = worker->key_capacity ? worker->key_capacity * 2 : 256;
+        uint32_t *keys = realloc(worker->keys, capacity * sizeof(uint32_t));
+        if (!keys) {
+            return false;
+        }
+        worker->keys = keys;
+        worker->key_capacity = capacity;
+    }
+    worker->keys[worker->key_count++] = key;
+    return true;
+}
+
+static bool add_words(Worker *worker, const char *text, uint32_t length, CooklangSearchField field,
+                      uint32_t document) {
+    char word[MAX_TERM_LENGTH];
+    uint32_t word_length;
+    uint32_t position = 0;
+    while (next_word(text, length, &position, word, &word_length)) {
+        uint32_t term = cooklang_intern(&worker->terms, word, word_length);
+        if (term == COOKLANG_INTERN_NONE || term >= UINT32_MAX / FIELD_COUNT ||
+            !add_key(worker, term * FIELD_COUNT + field)) {
+            return false;
+        }
+        worker->field_lengths[field][document]++;
+    }
+    return true;
+}
+
+static bool add_triple(Worker *worker, Triple triple) {
+    if (worker->triple_count == worker->triple_capacity) {
+        uint64_t capacity = worker->triple_capacity ? worker->triple_capacity * 2 : 4096;
+        Triple *triples = realloc(worker->triples, capacity * sizeof(Triple));
+        if (!triples) {
+            return false;
+        }
+        worker->triples = triples;
+        worker->triple_capacity = capacity;
+    }
+    worker->triples[worker->triple_count++] = triple;
+    return true;
+}
+
+static int compare_keys(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static bool add_document(Worker *worker, TSParser *parser, const IndexedSymbols *indexed,
+                         uint32_t document) {
+    const CooklangSearchDocument *source = &worker->documents[document];
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source->text, source->length);
+    if (!tree) {
+        return false;
+    }
+    bool ok = true;
+    worker->key_count = 0;
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    while (ok) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        TSSymbol symbol = ts_node_symbol(node);
+        int i = 0;
+        while (i < INDEXED_SYMBOL_COUNT && indexed->symbols[i] != symbol) {
+            i++;
+        }
+        if (i < INDEXED_SYMBOL_COUNT) {
+            uint32_t start = ts_node_start_byte(node);
+            ok = add_words(worker, source->text + start, ts_node_end_byte(node) - start,
+                           indexed->fields[i], document);
+        } else if (ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                goto done;
+            }
+        }
+    }
+done:
+    ts_tree_cursor_delete(&cursor);
+    ts_tree_delete(tree);
+
+    // One triple per distinct key, counting its words.
+    qsort(worker->keys, worker->key_count, sizeof(uint32_t), compare_keys);
+    for (uint32_t i = 0; i < worker->key_count && ok;) {
+        uint32_t j = i + 1;
+        while (j < worker->key_count && worker->keys[j] == worker->keys[i]) {
+            j++;
+        }
+        ok = add_triple(worker, (Triple){worker->keys[i], document, j - i});
+        i = j;
+    }
+    return ok;
+}
+
+static bool sort_triples(Worker *worker) {
+    size_t key_count = (size_t)worker->terms.length * FIELD_COUNT;
+    worker->starts = calloc(key_count + 1, sizeof(uint64_t));
+    uint64_t *next = malloc((key_count + 1) * sizeof(uint64_t));
+    Triple *sorted = malloc((worker->triple_count + 1) * sizeof(Triple));
+    if (!worker->starts || !next || !sorted) {
+        free(next);
+        free(sorted);
+        return false;
+    }
+    for (uint64_t i = 0; i < worker->triple_count; i++) {
+        worker->starts[worker->triples[i].key + 1]++;
+    }
+    for (size_t key = 0; key < key_count; key++) {
+        worker->starts[key + 1] += worker->starts[key];
+    }
+    memcpy(next, worker->starts, (key_count + 1) * sizeof(uint64_t));
+    for (uint64_t i = 0; i < worker->triple_count; i++) {
+        sorted[next[worker->triples[i].key]++] = worker->triples[i];
+    }
+    free(next);
+    free(worker->triples);
+    worker->triples = sorted;
+    return true;
+}
+
+static void run_worker(void *payload) {
+    Worker *worker = payload;
+    const TSLanguage *language = worker->language;
+    IndexedSymbols indexed = {
+        {COOKLANG_SYMBOL(language, "text_content"), COOKLANG_SYMBOL(language, "note_content"),
+         COOKLANG_SYMBOL(language, "recipe_note_text"),
+         COOKLANG_SYMBOL(language, "ingredient_name"),
+         COOKLANG_SYMBOL(language, "cookware_name")},
+        {COOKLANG_SEARCH_TEXT, COOKLANG_SEARCH_NOTES, COOKLANG_SEARCH_NOTES, COOKLANG_SEARCH_NAMES,
+         COOKLANG_SEARCH_NAMES},
+    };
+    TSParser *parser = ts_parser_new();
+    worker->ok = parser && ts_parser_set_language(parser, language);
+    for (uint32_t document = worker->first; document < worker->last && worker->ok; document++) {
+        worker->ok = add_document(worker, parser, &indexed, document);
+    }
+    if (parser) {
+        ts_parser_delete(parser);
+    }
+    free(worker->keys);
+    worker->keys = NULL;
+    worker->ok = worker->ok && sort_triples(worker);
+}
+
+static bool reserve_data(CooklangSearchIndex *index, uint64_t *capacity, uint64_t extra) {
+    if (index->data_length + extra <= *capacity) {
+        return true;
+    }
+    uint64_t grown = *capacity ? *capacity : 65536;
+    while (grown < index->data_length + extra) {
+        grown *= 2;
+    }
+    uint8_t *data = realloc(index->data, grown);
+    if (!data) {
+        return false;
+    }
+    index->data = data;
+    *capacity = grown;
+    return true;
+}
+
+// Give every term of every worker its id in the index, then write each
+// term's postings field by field, the workers' in order.
+static bool merge(CooklangSearchIndex *index, Worker *workers, unsigned worker_count) {
+    uint32_t **ids = calloc(worker_count, sizeof(uint32_t *));
+    bool ok = ids != NULL;
+    for (unsigned w = 0; w < worker_count && ok; w++) {
+        const CooklangInternTable *terms = &workers[w].terms;
+        ids[w] = malloc(((size_t)terms->length + 1) * sizeof(uint32_t));
+        ok = ids[w] != NULL;
+        for (uint32_t term = 0; term < terms->length && ok; term++) {
+            uint32_t length;
+            const char *name = cooklang_intern_name(terms, term, &length);
+            ids[w][term] = cooklang_intern(&index->terms, name, length);
+            ok = ids[w][term] != COOKLANG_INTERN_NONE && ids[w][term] < UINT32_MAX / FIELD_COUNT;
+        }
+    }
+
+    // The other way round: each worker's term for each id in the index.
+    uint32_t term_count = index->terms.length;
+    uint32_t *terms = ok ? malloc(((size_t)term_count * worker_count + 1) * sizeof(uint32_t)) : NULL;
+    index->lists = ok ? calloc((size_t)term_count * FIELD_COUNT + 1, sizeof(PostingList)) : NULL;
+    ok = ok && terms && index->lists;
+    for (unsigned w = 0; w < worker_count && ok; w++) {
+        for (uint32_t id = 0; id < term_count; id++) {
+            terms[(size_t)id * worker_count + w] = COOKLANG_INTERN_NONE;
+        }
+        for (uint32_t term = 0; term < workers[w].terms.length; term++) {
+            terms[(size_t)ids[w][term] * worker_count + w] = term;
+        }
+    }
+
+    uint64_t capacity = 0;
+    for (uint32_t id = 0; id < term_count && ok; id++) {
+        for (int field = 0; field < FIELD_COUNT && ok; field++) {
+            PostingList *list = &index->lists[(size_t)id * FIELD_COUNT + field];
+            list->offset = index->data_length;
+            uint32_t previous = 0;
+            for (unsigned w = 0; w < worker_count && ok; w++) {
+                uint32_t term = terms[(size_t)id * worker_count + w];
+                if (term == COOKLANG_INTERN_NONE) {
+                    continue;
+                }
+                const Worker *worker = &workers[w];
+                uint32_t key = term * FIELD_COUNT + field;
+                uint64_t start = worker->starts[key], end = worker->starts[key + 1];
+                ok = reserve_data(index, &capacity, (end - start) * 2 * MAX_VARINT_BYTES);
+                for (uint64_t i = start; i < end && ok; i++) {
+                    const Triple *triple = &worker->triples[i];
+                    uint8_t *out = index->data + index->data_length;
+                    uint32_t written = put_varint(out, triple->document - previous);
+                    written += put_varint(out + written, triple->count);
+                    index->data_length += written;
+                    previous = triple->document;
+                    list->count++;
+                }
+                index->posting_count += end - start;
+            }
+        }
+    }
+
+    for (unsigned w = 0; ids && w < worker_count; w++) {
+        free(ids[w]);
+    }
+    free(ids);
+    free(terms);
+    return ok;
+}
+
+CooklangSearchIndex *cooklang_search_index_build(const TSLanguage *language,
+                                                 const CooklangSearchDocument *documents,
+                                                 uint32_t count, unsigned thread_count) {
+    CooklangSearchIndex *index = calloc(1, sizeof(CooklangSearchIndex));
+    if (!index) {
+        return NULL;
+    }
+    index->document_count = count;
+    cooklang_intern_table_init(&index->terms, false);
+    bool ok = true;
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        index->field_lengths[field] = calloc((size_t)count + 1, sizeof(uint32_t));
+        ok = ok && index->field_lengths[field];
+    }
+
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    if (thread_count > count) {
+        thread_count = count > 0 ? count : 1;
+    }
+    Worker *workers = ok ? calloc(thread_count, sizeof(Worker)) : NULL;
+    ok = workers != NULL;
+    for (unsigned w = 0; w < thread_count && ok; w++) {
+        Worker *worker = &workers[w];
+        worker->language = language;
+        worker->documents = documents;
+        worker->first = (uint32_t)((uint64_t)count * w / thread_count);
+        worker->last = (uint32_t)((uint64_t)count * (w + 1) / thread_count);
+        worker->field_lengths = index->field_lengths;
+        cooklang_intern_table_init(&worker->terms, false);
+    }
+    ok = ok && cooklang_run_threads(run_worker, workers, sizeof(Worker), thread_count);
+    for (unsigned w = 0; w < thread_count && ok; w++) {
+        ok = workers[w].ok;
+    }
+    ok = ok && merge(index, workers, thread_count);
+
+    for (unsigned w = 0; workers && w < thread_count; w++) {
+        cooklang_intern_table_free(&workers[w].terms);
+        free(workers[w].triples);
+        free(workers[w].keys);
+        free(workers[w].starts);
+    }
+    free(workers);
+    if (!ok) {
+        cooklang_search_index_delete(index);
+        return NULL;
+    }
+
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        uint64_t total = 0;
+        for (uint32_t document = 0; document < count; document++) {
+            total += index->field_lengths[field][document];
+        }
+        index->average_lengths[field] = count ? (double)total / count : 0;
+    }
+    return index;
+}
+
+void cooklang_search_index_delete(CooklangSearchIndex *index) {
+    if (!index) {
+        return;
+    }
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        free(index->field_lengths[field]);
+    }
+    cooklang_intern_table_free(&index->terms);
+    free(index->lists);
+    free(index->data);
+    free(index);
+}
+
+void cooklang_search_index_stats(const CooklangSearchIndex *index, CooklangSearchStats *stats) {
+    const CooklangInternTable *terms = &index->terms;
+    stats->documents = index->document_count;
+    stats->terms = terms->length;
+    stats->postings = index->posting_count;
+    stats->posting_bytes = index->data_length;
+    stats->bytes = sizeof(*index) + index->data_length +
+                   (uint64_t)terms->length * FIELD_COUNT * sizeof(PostingList) +
+                   (uint64_t)index->document_count * FIELD_COUNT * sizeof(uint32_t) +
+                   terms->strings_length + ((uint64_t)terms->length + 1) * sizeof(uint32_t) +
+                   (uint64_t)terms->slot_count * sizeof(CooklangInternSlot);
+}
+
+// Searching
+
+// Whether `a` ranks below `b`: a lower score, or the same score and a later
+// document.
+static inline bool ranks_below(const CooklangSearchHit *a, const CooklangSearchHit *b) {
+    return a->score < b->score || (a->score == b->score && a->document > b->document);
+}
+
+// Restore the heap, lowest-ranked hit first, below position `i`.
+static void sift_down(CooklangSearchHit *heap, uint32_t length, uint32_t i) {
+    for (;;) {
+        uint32_t lowest = i;
+        uint32_t left = 2 * i + 1, right = 2 * i + 2;
+        if (left < length && ranks_below(&heap[left], &heap[lowest])) {
+            lowest = left;
+        }
+        if (right < length && ranks_below(&heap[right], &heap[lowest])) {
+            lowest = right;
+        }
+        if (lowest == i) {
+            return;
+        }
+        CooklangSearchHit swap = heap[i];
+        heap[i] = heap[lowest];
+        heap[lowest] = swap;
+        i = lowest;
+    }
+}
+
+static void sift_up(CooklangSearchHit *heap, uint32_t i) {
+    while (i > 0 && ranks_below(&heap[i], &heap[(i - 1) / 2])) {
+        CooklangSearchHit swap = heap[i];
+        heap[i] = heap[(i - 1) / 2];
+        heap[(i - 1) / 2] = swap;
+        i = (i - 1) / 2;
+    }
+}
+
+static void score_list(const CooklangSearchIndex *index, uint32_t term, int field, float weight,
+                       float *scores, uint32_t *touched, uint32_t *touched_count) {
+    const PostingList *list = &index->lists[(size_t)term * FIELD_COUNT + field];
+    if (list->count == 0) {
+        return;
+    }
+    double frequency = list->count;
+    double idf = log(1.0 + (index->document_count - frequency + 0.5) / (frequency + 0.5));
+    double average = index->average_lengths[field] > 0 ? index->average_lengths[field] : 1;
+    const uint32_t *lengths = index->field_lengths[field];
+    const uint8_t *in = index->data + list->offset;
+    uint32_t document = 0;
+    for (uint32_t i = 0; i < list->count; i++) {
+        document += get_varint(&in);
+        double count = get_varint(&in);
+        double norm = K1 * (1 - B + B * lengths[document] / average);
+        float score = (float)(weight * idf * count * (K1 + 1) / (count + norm));
+        if (scores[document] == 0) {
+            touched[(*touched_count)++] = document;
+        }
+        scores[document] += score;
+    }
+}
+
+int32_t cooklang_search(const CooklangSearchIndex *index, const char *query, uint32_t length,
+                        const float *weights, CooklangSearchHit *hits, uint32_t max_hits) {
+    if (!weights) {
+        weights = COOKLANG_SEARCH_DEFAULT_WEIGHTS;
+    }
+    if (max_hits == 0 || index->document_count == 0) {
+        return 0;
+    }
+    float *scores = calloc(index->document_count, sizeof(float));
+    uint32_t *touched = malloc(index->document_count * sizeof(uint32_t));
+    if (!scores || !touched) {
+        free(scores);
+        free(touched);
+        return -1;
+    }
+    uint32_t touched_count = 0;
+
+    // Each distinct word of the query counts once.
+    uint32_t seen[64];
+    uint32_t seen_count = 0;
+    char word[MAX_TERM_LENGTH];
+    uint32_t word_length;
+    uint32_t position = 0;
+    while (seen_count < 64 && next_word(query, length, &position, word, &word_length)) {
+        uint32_t term = cooklang_intern_find(&index->terms, word, word_length);
+        bool repeated = term == COOKLANG_INTERN_NONE;
+        for (uint32_t i = 0; i < seen_count && !repeated; i++) {
+            repeated = seen[i] == term;
+        }
+        if (repeated) {
+            continue;
+        }
+        seen[seen_count++] = term;
+        for (int field = 0; field < FIELD_COUNT; field++) {
+            if (weights[field] > 0) {
+                score_list(index, term, field, weights[field], scores, touched, &touched_count);
+            }
+        }
+    }
+
+    // Keep the best `max_hits` in a heap with the lowest-ranked on top.
+    uint32_t hit_count = 0;
+    for (uint32_t i = 0; i < touched_count; i++) {
+        CooklangSearchHit hit = {touched[i], scores[touched[i]]};
+        if (hit_count < max_hits) {
+            hits[hit_count] = hit;
+            sift_up(hits, hit_count++);
+        } else if (ranks_below(&hits[0], &hit)) {
+            hits[0] = hit;
+            sift_down(hits, hit_count, 0);
+        }
+    }
+    // Popping the lowest-ranked to the end leaves the best first.
+    for (uint32_t end = hit_count; end > 1; end--) {
+        CooklangSearchHit swap = hits[0];
+        hits[0] = hits[end - 1];
+        hits[end - 1] = swap;
+        sift_down(hits, end - 1, 0);
+    }
+    free(scores);
+    free(touched);
+    return (int32_t)hit_count;
+}
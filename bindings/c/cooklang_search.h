@@ -0,0 +1,82 @@
+#ifndef COOKLANG_SEARCH_H_
+#define COOKLANG_SEARCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A full-text index over a collection of recipes, ranked with BM25.
+//
+// Every recipe is parsed, and the words of its step text (`text_content`),
+// its notes (`note_content` and `recipe_note_text`) and its ingredient and
+// cookware names are indexed as separate fields, so a word in a name can
+// count for more than the same word in a step. A word is a run of ASCII
+// letters and digits and non-ASCII bytes, lowercased in ASCII; comments,
+// quantities and metadata are not indexed.
+//
+// Each posting list is stored as varints: the gap to the previous recipe
+// and the word's count in the field. The index is built on several threads,
+// each parsing and indexing a contiguous share of the recipes; the shares
+// are merged in order, so postings stay sorted without a sort. A built
+// index is read-only, and can be searched from any number of threads.
+
+typedef enum {
+    COOKLANG_SEARCH_TEXT,
+    COOKLANG_SEARCH_NOTES,
+    COOKLANG_SEARCH_NAMES,
+    COOKLANG_SEARCH_FIELD_COUNT,
+} CooklangSearchField;
+
+typedef struct CooklangSearchIndex CooklangSearchIndex;
+
+typedef struct {
+    const char *text;
+    uint32_t length;
+} CooklangSearchDocument;
+
+typedef struct {
+    // Position of the recipe in the documents the index was built from.
+    uint32_t document;
+    float score;
+} CooklangSearchHit;
+
+typedef struct {
+    uint32_t documents;
+    uint32_t terms;
+    // Entries over all posting lists of all fields.
+    uint64_t postings;
+    // Bytes of the compressed posting lists, and of the whole index.
+    uint64_t posting_bytes;
+    uint64_t bytes;
+} CooklangSearchStats;
+
+// Index `count` recipes with `language` on `thread_count` threads (at
+// least one). Returns NULL if memory ran out or a thread could not start.
+CooklangSearchIndex *cooklang_search_index_build(const TSLanguage *language,
+                                                 const CooklangSearchDocument *documents,
+                                                 uint32_t count, unsigned thread_count);
+
+void cooklang_search_index_delete(CooklangSearchIndex *index);
+
+void cooklang_search_index_stats(const CooklangSearchIndex *index, CooklangSearchStats *stats);
+
+// Field weights used when none are given: names 2, text and notes 1.
+extern const float COOKLANG_SEARCH_DEFAULT_WEIGHTS[COOKLANG_SEARCH_FIELD_COUNT];
+
+// Rank the recipes containing any word of `query` by the sum, over the
+// query's words and the fields, of each field's weight times its BM25
+// score (k1 = 1.2, b = 0.75). `weights` may be NULL for the defaults; a
+// zero weight leaves a field out. Writes up to `max_hits` hits, best
+// first, and returns how many were written, or -1 if memory ran out.
+int32_t cooklang_search(const CooklangSearchIndex *index, const char *query, uint32_t length,
+                        const float *weights, CooklangSearchHit *hits, uint32_t max_hits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_SEARCH_H_
@@ -0,0 +1,264 @@
+#include "cooklang_shopping.h"
+#include "cooklang_units.h"
+#include "cooklang_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_COUNT 64
+#define EMPTY_SLOT UINT32_MAX
+
+// Amount of one ingredient occurrence, or of a whole item when merging.
+typedef struct {
+    CooklangRational low;
+    CooklangRational high;
+    uint32_t occurrences;
+    uint8_t flags;
+} Amount;
+
+static uint32_t hash_key(const char *name, uint32_t name_length, const char *unit,
+                         uint32_t unit_length) {
+    // With a separator so that ("ab", "c") and ("a", "bc") differ.
+    uint32_t hash = cooklang_fnv32(COOKLANG_FNV32_BASIS, name, name_length);
+    hash = cooklang_fnv32(hash, "\xFF", 1);
+    return cooklang_fnv32(hash, unit, unit_length);
+}
+
+void cooklang_shopping_list_init(CooklangShoppingList *list) {
+    memset(list, 0, sizeof(*list));
+}
+
+void cooklang_shopping_list_free(CooklangShoppingList *list) {
+    free(list->items);
+    free(list->strings);
+    free(list->slots);
+    cooklang_shopping_list_init(list);
+}
+
+void cooklang_shopping_list_clear(CooklangShoppingList *list) {
+    list->length = 0;
+    list->strings_length = 0;
+    for (uint32_t i = 0; i < list->slot_count; i++) {
+        list->slots[i].item = EMPTY_SLOT;
+    }
+}
+
+static bool reserve_strings(CooklangShoppingList *list, uint32_t extra) {
+    if (list->strings_length + extra <= list->strings_capacity) {
+        return true;
+    }
+    uint32_t capacity = list->strings_capacity ? list->strings_capacity : 1024;
+    while (capacity < list->strings_length + extra) {
+        capacity *= 2;
+    }
+    char *strings = realloc(list->strings, capacity);
+    if (!strings) {
+        return false;
+    }
+    list->strings = strings;
+    list->strings_capacity = capacity;
+    return true;
+}
+
+static void insert_slot(CooklangShoppingSlot *slots, uint32_t slot_count, uint32_t hash,
+                        uint32_t item) {
+    uint32_t mask = slot_count - 1;
+    uint32_t index = hash & mask;
+    while (slots[index].item != EMPTY_SLOT) {
+        index = (index + 1) & mask;
+    }
+    slots[index].hash = hash;
+    slots[index].item = item;
+}
+
+static bool grow_slots(CooklangShoppingList *list) {
+    uint32_t slot_count = list->slot_count ? list->slot_count * 2 : INITIAL_SLOT_COUNT;
+    CooklangShoppingSlot *slots = malloc(slot_count * sizeof(CooklangShoppingSlot));
+    if (!slots) {
+        return false;
+    }
+    for (uint32_t i = 0; i < slot_count; i++) {
+        slots[i].item = EMPTY_SLOT;
+    }
+    for (uint32_t i = 0; i < list->slot_count; i++) {
+        if (list->slots[i].item != EMPTY_SLOT) {
+            insert_slot(slots, slot_count, list->slots[i].hash, list->slots[i].item);
+        }
+    }
+    free(list->slots);
+    list->slots = slots;
+    list->slot_count = slot_count;
+    return true;
+}
+
+static void add_amount(CooklangShoppingItem *item, const Amount *amount) {
+    item->occurrences += amount->occurrences;
+    item->flags |= amount->flags & (COOKLANG_SHOPPING_UNQUANTIFIED | COOKLANG_SHOPPING_OVERFLOW);
+    if (!(amount->flags & COOKLANG_SHOPPING_HAS_AMOUNT)) {
+        return;
+    }
+    if (!(item->flags & COOKLANG_SHOPPING_HAS_AMOUNT)) {
+        item->low = amount->low;
+        item->high = amount->high;
+        item->flags |= COOKLANG_SHOPPING_HAS_AMOUNT;
+    } else if (!(item->flags & COOKLANG_SHOPPING_OVERFLOW)) {
+        CooklangRational low, high;
+        if (cooklang_rational_add(item->low, amount->low, &low) &&
+            cooklang_rational_add(item->high, amount->high, &high)) {
+            item->low = low;
+            item->high = high;
+        } else {
+            item->flags |= COOKLANG_SHOPPING_OVERFLOW;
+        }
+    }
+}
+
+// Normalize the key at the end of `strings`, then either fold the amount
+// into the matching item, dropping the key again, or keep the key for a
+// new item.
+static bool add_occurrence(CooklangShoppingList *list, const char *name, uint32_t name_length,
+                           const char *unit, uint32_t unit_length, const Amount *amount) {
+    if (!reserve_strings(list, name_length + unit_length + 1)) {
+        return false;
+    }
+    char *key = list->strings + list->strings_length;
+    name_length = cooklang_normalize(name, name_length, key);
+    unit_length = cooklang_normalize(unit, unit_length, key + name_length);
+    uint32_t hash = hash_key(key, name_length, key + name_length, unit_length);
+
+    if (list->slot_count) {
+        uint32_t mask = list->slot_count - 1;
+        for (uint32_t index = hash & mask; list->slots[index].item != EMPTY_SLOT;
+             index = (index + 1) & mask) {
+            const CooklangShoppingSlot *slot = &list->slots[index];
+            CooklangShoppingItem *item = &list->items[slot->item];
+            if (slot->hash == hash && item->name.end - item->name.start == name_length &&
+                item->unit.end - item->unit.start == unit_length &&
+                memcmp(list->strings + item->name.start, key, name_length + unit_length) == 0) {
+                add_amount(item, amount);
+                return true;
+            }
+        }
+    }
+
+    if ((list->length + 1) * 4 > list->slot_count * 3 && !grow_slots(list)) {
+        return false;
+    }
+    if (list->length == list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 64;
+        CooklangShoppingItem *items = realloc(list->items, capacity * sizeof(CooklangShoppingItem));
+        if (!items) {
+            return false;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    CooklangShoppingItem *item = &list->items[list->length];
+    memset(item, 0, sizeof(*item));
+    uint32_t start = list->strings_length;
+    item->name = (CooklangSpan){start, start + name_length};
+    item->unit = (CooklangSpan){start + name_length, start + name_length + unit_length};
+    list->strings_length += name_length + unit_length;
+    add_amount(item, amount);
+    insert_slot(list->slots, list->slot_count, hash, list->length++);
+    return true;
+}
+
+bool cooklang_shopping_list_merge(CooklangShoppingList *list, const CooklangShoppingList *other) {
+    for (uint32_t i = 0; i < other->length; i++) {
+        const CooklangShoppingItem *item = &other->items[i];
+        Amount amount = {item->low, item->high, item->occurrences, item->flags};
+        if (!add_occurrence(list, other->strings + item->name.start,
+                            item->name.end - item->name.start,
+                            other->strings + item->unit.start,
+                            item->unit.end - item->unit.start, &amount)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool add_ingredient(CooklangShoppingList *list, const char *source, TSTreeCursor *cursor,
+                           const CooklangSymbols *symbols, CooklangRational factor) {
+    TSNode name = {0};
+    TSNode quantity_node = {0};
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSNode child = ts_tree_cursor_current_node(cursor);
+            TSSymbol symbol = ts_node_symbol(child);
+            if (symbol == symbols->ingredient_name) {
+                name = child;
+            } else if (symbol == symbols->quantity) {
+                quantity_node = child;
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    if (ts_node_is_null(name)) {
+        return true;
+    }
+    const char *name_start = source + ts_node_start_byte(name);
+    uint32_t name_length = ts_node_end_byte(name) - ts_node_start_byte(name);
+    if (name_length >= 2 && name_start[0] == '.' && (name_start[1] == '/' || name_start[1] == '\\')) {
+        return true;
+    }
+
+    Amount amount = {{0, 1}, {0, 1}, 1, COOKLANG_SHOPPING_UNQUANTIFIED};
+    const char *unit = "";
+    uint32_t unit_length = 0;
+    if (!ts_node_is_null(quantity_node)) {
+        uint32_t start = ts_node_start_byte(quantity_node) + 1;
+        uint32_t end = ts_node_end_byte(quantity_node);
+        if (end > start && source[end - 1] == '}') {
+            end--;
+        }
+        if (end >= start) {
+            CooklangQuantity quantity;
+            cooklang_quantity_parse(source, (CooklangSpan){start, end}, &quantity);
+            const CooklangUnit *base = cooklang_quantity_normalize(&quantity, source);
+            if (base) {
+                unit = base->name;
+                unit_length = (uint32_t)strlen(base->name);
+            } else {
+                unit = source + quantity.unit.start;
+                unit_length = quantity.unit.end - quantity.unit.start;
+            }
+            if (quantity.kind == COOKLANG_QUANTITY_NUMBER || quantity.kind == COOKLANG_QUANTITY_RANGE) {
+                amount.flags = COOKLANG_SHOPPING_HAS_AMOUNT;
+                if (!cooklang_quantity_scale(&quantity, factor)) {
+                    amount.flags |= COOKLANG_SHOPPING_OVERFLOW;
+                }
+                amount.low = quantity.low;
+                amount.high = quantity.high;
+            }
+        }
+    }
+    return add_occurrence(list, name_start, name_length, unit, unit_length, &amount);
+}
+
+bool cooklang_shopping_list_add_recipe(CooklangShoppingList *list, const char *source,
+                                       TSNode root, CooklangRational factor) {
+    const TSLanguage *language = ts_node_language(root);
+    CooklangSymbols symbols;
+    cooklang_symbols_init(&symbols, language);
+
+    bool ok = true;
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    while (ok) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        if (ts_node_symbol(node) == symbols.ingredient) {
+            ok = add_ingredient(list, source, &cursor, &symbols, factor);
+        } else if (ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                goto done;
+            }
+        }
+    }
+done:
+    ts_tree_cursor_delete(&cursor);
+    return ok;
+}
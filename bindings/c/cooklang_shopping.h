@@ -0,0 +1,82 @@
+#ifndef COOKLANG_SHOPPING_H_
+#define COOKLANG_SHOPPING_H_
+
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shopping list aggregation over parsed recipes.
+//
+// Ingredients are grouped by normalized name (trimmed, inner whitespace
+// collapsed, ASCII lowercased) and by unit, and their amounts are summed
+// exactly. Known units are converted to their base unit first (see
+// cooklang_units.h), so `{100%g}` and `{0.25%kg}` add up to 350 g; other
+// units are trimmed and lowercased. A list is not thread-safe, but lists
+// built on separate threads can be combined with
+// `cooklang_shopping_list_merge`, so a large batch can be aggregated in
+// parallel partials followed by a merge.
+
+enum {
+    // At least one amount was summed into `low` and `high`.
+    COOKLANG_SHOPPING_HAS_AMOUNT = 1 << 0,
+    // At least one occurrence had no amount, or one that was not a number.
+    COOKLANG_SHOPPING_UNQUANTIFIED = 1 << 1,
+    // A sum did not fit in 64 bits; `low` and `high` stopped growing.
+    COOKLANG_SHOPPING_OVERFLOW = 1 << 2,
+};
+
+typedef struct {
+    // Byte ranges of the normalized name and unit in the list's `strings`.
+    CooklangSpan name;
+    CooklangSpan unit;
+    // Summed amounts; equal unless a range was added.
+    CooklangRational low;
+    CooklangRational high;
+    uint32_t occurrences;
+    uint8_t flags;
+} CooklangShoppingItem;
+
+typedef struct {
+    uint32_t hash;
+    uint32_t item;
+} CooklangShoppingSlot;
+
+typedef struct {
+    // Items in order of first appearance.
+    CooklangShoppingItem *items;
+    uint32_t length;
+    uint32_t capacity;
+    char *strings;
+    uint32_t strings_length;
+    uint32_t strings_capacity;
+    // Open-addressing index over `items`; internal.
+    CooklangShoppingSlot *slots;
+    uint32_t slot_count;
+} CooklangShoppingList;
+
+void cooklang_shopping_list_init(CooklangShoppingList *list);
+void cooklang_shopping_list_free(CooklangShoppingList *list);
+
+// Remove all items, keeping the allocated memory.
+void cooklang_shopping_list_clear(CooklangShoppingList *list);
+
+// Add the ingredients in the tree under `root`, with their amounts
+// multiplied by `factor`. Recipe references (`@./path`) are skipped.
+// Returns false if the list could not grow.
+bool cooklang_shopping_list_add_recipe(CooklangShoppingList *list, const char *source,
+                                       TSNode root, CooklangRational factor);
+
+// Add every item of `other` to `list`.
+bool cooklang_shopping_list_merge(CooklangShoppingList *list, const CooklangShoppingList *other);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_SHOPPING_H_
@@ -0,0 +1,70 @@
+#include "cooklang_threads.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+typedef struct {
+    void (*run)(void *worker);
+    void *worker;
+} Task;
+
+#ifdef _WIN32
+static DWORD WINAPI task_thread(void *payload) {
+    Task *task = payload;
+    task->run(task->worker);
+    return 0;
+}
+#else
+static void *task_thread(void *payload) {
+    Task *task = payload;
+    task->run(task->worker);
+    return NULL;
+}
+#endif
+
+bool cooklang_run_threads(void (*run)(void *worker), void *workers, size_t size,
+                          unsigned count) {
+    if (count == 0) {
+        return true;
+    }
+#ifdef _WIN32
+    HANDLE *threads = calloc(count, sizeof(HANDLE));
+#else
+    pthread_t *threads = calloc(count, sizeof(pthread_t));
+#endif
+    Task *tasks = calloc(count, sizeof(Task));
+    bool *started = calloc(count, sizeof(bool));
+    bool ok = threads && tasks && started;
+    for (unsigned i = 1; i < count && ok; i++) {
+        tasks[i] = (Task){run, (char *)workers + i * size};
+#ifdef _WIN32
+        threads[i] = CreateThread(NULL, 0, task_thread, &tasks[i], 0, NULL);
+        started[i] = threads[i] != NULL;
+#else
+        started[i] = pthread_create(&threads[i], NULL, task_thread, &tasks[i]) == 0;
+#endif
+        ok = started[i];
+    }
+    if (ok) {
+        run(workers);
+    }
+    for (unsigned i = 1; i < count && threads && started; i++) {
+        if (started[i]) {
+#ifdef _WIN32
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+#else
+            pthread_join(threads[i], NULL);
+#endif
+        }
+    }
+    free(threads);
+    free(tasks);
+    free(started);
+    return ok;
+}
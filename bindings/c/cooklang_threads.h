@@ -0,0 +1,27 @@
+#ifndef COOKLANG_THREADS_H_
+#define COOKLANG_THREADS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Running a task per worker on threads of its own, for the libraries that
+// split work into independent shares (cooklang_search.h,
+// cooklang_highlight.h). Internal; pthreads, or Win32 threads on Windows.
+
+// Call `run` on each of the `count` workers in `workers`, `size` bytes
+// apart: the first on the calling thread, every other on a thread of its
+// own, and return once all are done. Returns false if a thread could not
+// start, in which case the first worker is not run and the rest may not
+// have been.
+bool cooklang_run_threads(void (*run)(void *worker), void *workers, size_t size,
+                          unsigned count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_THREADS_H_
@@ -0,0 +1,112 @@
+#include "cooklang_units.h"
+#include "cooklang_common.h"
+
+#include <string.h>
+
+typedef struct {
+    const char *alias;
+    uint8_t length;
+    uint8_t unit;
+} UnitAlias;
+
+#include "cooklang_units_table.h"
+
+// No alias is longer than this; longer text is not looked up.
+#define MAX_UNIT_LENGTH 32
+
+// Must match hash in generate_units.js.
+static inline uint32_t unit_hash(const char *key, uint32_t length, uint32_t seed) {
+    uint32_t hash = cooklang_fnv32(COOKLANG_FNV32_BASIS ^ seed, key, length);
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bu;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static const CooklangUnit *find_alias(const char *key, uint32_t length) {
+    uint32_t bucket = unit_hash(key, length, 0) % ALIAS_BUCKET_COUNT;
+    uint32_t slot = unit_hash(key, length, ALIAS_SEEDS[bucket]) % ALIAS_SLOT_COUNT;
+    const UnitAlias *alias = &ALIASES[slot];
+    if (alias->length == length && memcmp(alias->alias, key, length) == 0) {
+        return &UNITS[alias->unit];
+    }
+    return NULL;
+}
+
+const CooklangUnit *cooklang_unit_lookup(const char *text, uint32_t length) {
+    while (length > 0 && cooklang_is_space(*text)) {
+        text++;
+        length--;
+    }
+    while (length > 0 && cooklang_is_space(text[length - 1])) {
+        length--;
+    }
+    if (length > 1 && text[length - 1] == '.') {
+        length--;
+    }
+    // Empty slots of the table have length 0, so the empty string never
+    // reaches it.
+    if (length == 0) {
+        return NULL;
+    }
+
+    // Collapse inner whitespace into a copy, then try the exact spelling
+    // before the lowercased one.
+    char key[MAX_UNIT_LENGTH];
+    uint32_t key_length = 0;
+    bool has_upper = false;
+    for (uint32_t i = 0; i < length; i++) {
+        if (cooklang_is_space(text[i]) && cooklang_is_space(text[i - 1])) {
+            continue;
+        }
+        if (key_length == MAX_UNIT_LENGTH) {
+            return NULL;
+        }
+        char c = cooklang_is_space(text[i]) ? ' ' : text[i];
+        has_upper |= c >= 'A' && c <= 'Z';
+        key[key_length++] = c;
+    }
+
+    const CooklangUnit *unit = find_alias(key, key_length);
+    if (unit || !has_upper) {
+        return unit;
+    }
+    for (uint32_t i = 0; i < key_length; i++) {
+        key[i] = cooklang_to_lower(key[i]);
+    }
+    return find_alias(key, key_length);
+}
+
+const CooklangUnit *cooklang_unit_find(const char *source, CooklangSpan span) {
+    return cooklang_unit_lookup(source + span.start, span.end - span.start);
+}
+
+uint32_t cooklang_unit_count(void) {
+    return UNIT_COUNT;
+}
+
+const CooklangUnit *cooklang_unit_at(uint32_t index) {
+    return index < UNIT_COUNT ? &UNITS[index] : NULL;
+}
+
+const CooklangUnit *cooklang_quantity_normalize(CooklangQuantity *quantity, const char *source) {
+    const CooklangUnit *unit = cooklang_unit_find(source, quantity->unit);
+    if (!unit) {
+        return NULL;
+    }
+    if (quantity->kind != COOKLANG_QUANTITY_NUMBER && quantity->kind != COOKLANG_QUANTITY_RANGE) {
+        return unit;
+    }
+    CooklangRational low, high;
+    if (!cooklang_rational_mul(quantity->low, unit->factor, &low) ||
+        !cooklang_rational_mul(quantity->high, unit->factor, &high)) {
+        return NULL;
+    }
+    quantity->low = low;
+    quantity->high = high;
+    // `1/2 cup` is 118.294 ml, not a fraction with a seven-digit denominator.
+    if (unit != unit->base) {
+        quantity->flags &= (uint8_t)~COOKLANG_QUANTITY_FRACTION;
+    }
+    return unit->base;
+}
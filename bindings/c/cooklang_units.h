@@ -0,0 +1,67 @@
+#ifndef COOKLANG_UNITS_H_
+#define COOKLANG_UNITS_H_
+
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Unit lookup and conversion to base units.
+//
+// The units, their aliases and their factors live in `units.json`, which
+// `generate_units.js` compiles into a perfect hash in
+// `cooklang_units_table.h`. A lookup costs two hashes and one string
+// compare, whatever the number of aliases.
+//
+// Aliases match exactly first (`T` is a tablespoon, `t` a teaspoon) and
+// then ASCII case-insensitively (`Cups`, `TBSP`). Surrounding whitespace
+// and a trailing `.` are ignored, and inner whitespace is collapsed.
+
+typedef enum {
+    COOKLANG_DIMENSION_MASS,
+    COOKLANG_DIMENSION_VOLUME,
+    COOKLANG_DIMENSION_TIME,
+    COOKLANG_DIMENSION_TEMPERATURE,
+    COOKLANG_DIMENSION_LENGTH,
+} CooklangDimension;
+
+typedef struct CooklangUnit CooklangUnit;
+
+struct CooklangUnit {
+    // Canonical symbol, e.g. `tbsp`.
+    const char *name;
+    // The unit amounts are converted to; its own base for a base unit.
+    // Temperature scales are offset from each other, so every temperature
+    // unit is its own base and is never converted.
+    const CooklangUnit *base;
+    uint8_t dimension;
+    // Base units per unit, e.g. 1000 for `kg`.
+    CooklangRational factor;
+};
+
+// The unit named by `length` bytes of `text`, or NULL if it is unknown.
+const CooklangUnit *cooklang_unit_lookup(const char *text, uint32_t length);
+
+// The unit of a quantity, as in `cooklang_unit_lookup(source + span.start, ...)`.
+const CooklangUnit *cooklang_unit_find(const char *source, CooklangSpan span);
+
+// The known units in `units.json` order, e.g. for completion lists.
+uint32_t cooklang_unit_count(void);
+const CooklangUnit *cooklang_unit_at(uint32_t index);
+
+// Look up the unit of a parsed quantity and convert a number or range to
+// its base unit, returning the base unit. Empty and text quantities have
+// nothing to convert and get their own unit back. Returns NULL, leaving the
+// quantity unchanged, if the unit is unknown or the result does not fit in
+// 64 bits. Fixed amounts are converted too; only scaling leaves them alone.
+const CooklangUnit *cooklang_quantity_normalize(CooklangQuantity *quantity, const char *source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COOKLANG_UNITS_H_
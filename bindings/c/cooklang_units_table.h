@@ -0,0 +1,151 @@
+// Generated by generate_units.js from units.json. Do not edit.
+
+#define UNIT_COUNT 25
+#define ALIAS_COUNT 106
+#define ALIAS_SLOT_COUNT 256
+#define ALIAS_BUCKET_COUNT 53
+
+static const CooklangUnit UNITS[UNIT_COUNT] = {
+    {"g", &UNITS[0], COOKLANG_DIMENSION_MASS, {1u, 1u}},
+    {"kg", &UNITS[0], COOKLANG_DIMENSION_MASS, {1000u, 1u}},
+    {"mg", &UNITS[0], COOKLANG_DIMENSION_MASS, {1u, 1000u}},
+    {"oz", &UNITS[0], COOKLANG_DIMENSION_MASS, {45359237u, 1600000u}},
+    {"lb", &UNITS[0], COOKLANG_DIMENSION_MASS, {45359237u, 100000u}},
+    {"ml", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {1u, 1u}},
+    {"cl", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {10u, 1u}},
+    {"dl", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {100u, 1u}},
+    {"l", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {1000u, 1u}},
+    {"tsp", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {157725491u, 32000000u}},
+    {"tbsp", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {473176473u, 32000000u}},
+    {"fl oz", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {473176473u, 16000000u}},
+    {"cup", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {473176473u, 2000000u}},
+    {"pt", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {473176473u, 1000000u}},
+    {"qt", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {473176473u, 500000u}},
+    {"gal", &UNITS[5], COOKLANG_DIMENSION_VOLUME, {473176473u, 125000u}},
+    {"s", &UNITS[16], COOKLANG_DIMENSION_TIME, {1u, 1u}},
+    {"min", &UNITS[16], COOKLANG_DIMENSION_TIME, {60u, 1u}},
+    {"h", &UNITS[16], COOKLANG_DIMENSION_TIME, {3600u, 1u}},
+    {"d", &UNITS[16], COOKLANG_DIMENSION_TIME, {86400u, 1u}},
+    {"\302\260C", &UNITS[20], COOKLANG_DIMENSION_TEMPERATURE, {1u, 1u}},
+    {"\302\260F", &UNITS[21], COOKLANG_DIMENSION_TEMPERATURE, {1u, 1u}},
+    {"mm", &UNITS[22], COOKLANG_DIMENSION_LENGTH, {1u, 1u}},
+    {"cm", &UNITS[22], COOKLANG_DIMENSION_LENGTH, {10u, 1u}},
+    {"inch", &UNITS[22], COOKLANG_DIMENSION_LENGTH, {127u, 5u}},
+};
+
+static const uint16_t ALIAS_SEEDS[ALIAS_BUCKET_COUNT] = {
+    1, 3, 1, 1, 0, 1, 1, 1, 1, 1, 0, 3,
+    1, 1, 1, 1, 2, 2, 1, 1, 2, 1, 1, 0,
+    2, 2, 1, 2, 2, 1, 4, 2, 7, 1, 3, 2,
+    2, 1, 1, 5, 2, 1, 5, 3, 2, 1, 1, 1,
+    4, 1, 1, 3, 6,
+};
+
+static const UnitAlias ALIASES[ALIAS_SLOT_COUNT] = {
+    [0] = {"deciliter", 9, 7},
+    [3] = {"grammes", 7, 0},
+    [4] = {"floz", 4, 11},
+    [12] = {"centiliters", 11, 6},
+    [13] = {"quart", 5, 14},
+    [14] = {"fluid ounce", 11, 11},
+    [15] = {"min", 3, 17},
+    [16] = {"tbs", 3, 10},
+    [23] = {"deg f", 5, 21},
+    [25] = {"sec", 3, 16},
+    [26] = {"liters", 6, 8},
+    [33] = {"dl", 2, 7},
+    [34] = {"fl. oz", 6, 11},
+    [38] = {"grams", 5, 0},
+    [39] = {"millilitre", 10, 5},
+    [41] = {"T", 1, 10},
+    [42] = {"millilitres", 11, 5},
+    [45] = {"millimetres", 11, 22},
+    [46] = {"milligram", 9, 2},
+    [48] = {"deciliters", 10, 7},
+    [49] = {"gr", 2, 0},
+    [51] = {"centilitre", 10, 6},
+    [52] = {"\302\260c", 3, 20},
+    [54] = {"milligrams", 10, 2},
+    [56] = {"cm", 2, 23},
+    [57] = {"decilitre", 9, 7},
+    [59] = {"tbsp", 4, 10},
+    [61] = {"hrs", 3, 18},
+    [64] = {"centimetres", 11, 23},
+    [67] = {"oz", 2, 3},
+    [68] = {"tablespoon", 10, 10},
+    [70] = {"gramme", 6, 0},
+    [72] = {"tsp", 3, 9},
+    [73] = {"s", 1, 16},
+    [74] = {"centimeter", 10, 23},
+    [75] = {"l", 1, 8},
+    [78] = {"mm", 2, 22},
+    [79] = {"minutes", 7, 17},
+    [83] = {"cups", 4, 12},
+    [88] = {"degc", 4, 20},
+    [93] = {"quarts", 6, 14},
+    [94] = {"teaspoons", 9, 9},
+    [95] = {"gram", 4, 0},
+    [97] = {"fluid ounces", 12, 11},
+    [98] = {"teaspoon", 8, 9},
+    [102] = {"celsius", 7, 20},
+    [104] = {"centimeters", 11, 23},
+    [106] = {"inch", 4, 24},
+    [107] = {"inches", 6, 24},
+    [117] = {"kg", 2, 1},
+    [119] = {"ounces", 6, 3},
+    [121] = {"\302\260f", 3, 21},
+    [122] = {"days", 4, 19},
+    [125] = {"g", 1, 0},
+    [127] = {"litres", 6, 8},
+    [129] = {"tablespoons", 11, 10},
+    [131] = {"gallon", 6, 15},
+    [132] = {"millimetre", 10, 22},
+    [133] = {"milliliters", 11, 5},
+    [135] = {"hr", 2, 18},
+    [137] = {"minute", 6, 17},
+    [139] = {"kilo", 4, 1},
+    [140] = {"qt", 2, 14},
+    [142] = {"centiliter", 10, 6},
+    [143] = {"degf", 4, 21},
+    [144] = {"t", 1, 9},
+    [145] = {"hours", 5, 18},
+    [146] = {"mg", 2, 2},
+    [147] = {"seconds", 7, 16},
+    [149] = {"lb", 2, 4},
+    [151] = {"pounds", 6, 4},
+    [154] = {"liter", 5, 8},
+    [155] = {"milliliter", 10, 5},
+    [157] = {"tbl", 3, 10},
+    [159] = {"litre", 5, 8},
+    [163] = {"pt", 2, 13},
+    [164] = {"ml", 2, 5},
+    [166] = {"fahrenheit", 10, 21},
+    [168] = {"gal", 3, 15},
+    [173] = {"decilitres", 10, 7},
+    [177] = {"pint", 4, 13},
+    [178] = {"millimeters", 11, 22},
+    [185] = {"millimeter", 10, 22},
+    [187] = {"second", 6, 16},
+    [191] = {"deg c", 5, 20},
+    [192] = {"lbs", 3, 4},
+    [197] = {"kgs", 3, 1},
+    [199] = {"gallons", 7, 15},
+    [202] = {"kilos", 5, 1},
+    [205] = {"pound", 5, 4},
+    [207] = {"kilogram", 8, 1},
+    [209] = {"day", 3, 19},
+    [210] = {"mins", 4, 17},
+    [211] = {"secs", 4, 16},
+    [214] = {"centimetre", 10, 23},
+    [216] = {"hour", 4, 18},
+    [220] = {"cup", 3, 12},
+    [221] = {"kilograms", 9, 1},
+    [224] = {"cl", 2, 6},
+    [228] = {"tsps", 4, 9},
+    [229] = {"pints", 5, 13},
+    [230] = {"fl oz", 5, 11},
+    [242] = {"tbsps", 5, 10},
+    [247] = {"centilitres", 11, 6},
+    [249] = {"h", 1, 18},
+    [250] = {"ounce", 5, 3},
+};
@@ -0,0 +1,130 @@
+#!/usr/bin/env node
+// Generates src/scanner_unicode.h: the word characters of is_word_char in
+// src/scanner.c, as a two-stage bit table over every code point.
+//
+// A word character is a letter, a mark, a number, a connector punctuation
+// or a symbol other than a math symbol (general categories L, M, N, Pc,
+// So, Sc and Sk), the zero-width joiner and non-joiner, which join the
+// letters of Indic and Persian words, and the typographic apostrophe, as
+// ASCII `'` is one. Symbols keep names such as `🍅`, `Kerrygold® butter`
+// and `Häagen-Dazs™` whole, as they were before the table. Spaces,
+// dashes, other punctuation and math symbols are not, nor is U+FFFD, which
+// stands for malformed UTF-8. Below 128 the table follows the scanner's
+// ASCII rules instead.
+//
+// The code points are cut into blocks of 256. The first stage maps a
+// block number to one of the distinct blocks in the second stage, each a
+// 256-bit set, so that the many blocks that are all letters or all
+// non-letters are stored once. Categories come from the Unicode data built
+// into Node. The table is checked in and not rebuilt by make; the
+// generator refuses to run on a Node whose Unicode version differs from
+// UNICODE_VERSION, so moving to a newer version is a deliberate change to
+// that constant, reviewed with the table it produces.
+//
+//   node bindings/c/generate_unicode.js
+
+const fs = require('fs');
+const path = require('path');
+
+const OUTPUT = path.join(__dirname, '..', '..', 'src', 'scanner_unicode.h');
+const BLOCK_BITS = 8;
+const BLOCK_SIZE = 1 << BLOCK_BITS;
+const MAX_CODE_POINT = 0x10FFFF;
+const UNICODE_VERSION = '16.0';
+
+const WORD = /^[\p{L}\p{M}\p{N}\p{Pc}\p{So}\p{Sc}\p{Sk}\u200C\u200D\u2019]$/u;
+// The ASCII part of is_word_char.
+const ASCII_WORD = /^[A-Za-z0-9_\-'"]$/;
+
+function isWord(c) {
+  if (c < 128) {
+    return ASCII_WORD.test(String.fromCharCode(c));
+  }
+  if ((c >= 0xD800 && c <= 0xDFFF) || c === 0xFFFD) {
+    return false;
+  }
+  return WORD.test(String.fromCodePoint(c));
+}
+
+function build() {
+  let limit = 0;
+  for (let c = 0; c <= MAX_CODE_POINT; c++) {
+    if (isWord(c)) {
+      limit = c + 1;
+    }
+  }
+  const blockCount = Math.ceil(limit / BLOCK_SIZE);
+  const stage1 = [];
+  const stage2 = [];
+  const indices = new Map();
+  for (let block = 0; block < blockCount; block++) {
+    const words = new Array(BLOCK_SIZE / 32).fill(0);
+    for (let i = 0; i < BLOCK_SIZE; i++) {
+      if (isWord(block * BLOCK_SIZE + i)) {
+        words[i >> 5] = (words[i >> 5] | (1 << (i & 31))) >>> 0;
+      }
+    }
+    const key = words.join(',');
+    if (!indices.has(key)) {
+      indices.set(key, stage2.length);
+      stage2.push(words);
+    }
+    stage1.push(indices.get(key));
+  }
+  if (stage2.length > 256) {
+    throw new Error(`${stage2.length} distinct blocks do not fit a byte index`);
+  }
+  return { limit: blockCount * BLOCK_SIZE, stage1, stage2 };
+}
+
+function hex(word) {
+  return '0x' + word.toString(16).toUpperCase().padStart(8, '0');
+}
+
+function render(table) {
+  const { limit, stage1, stage2 } = table;
+  const lines = [];
+  lines.push(`// Generated by generate_unicode.js from the Unicode ${UNICODE_VERSION} ` +
+             'data in Node. Do not edit.');
+  lines.push('');
+  lines.push('#ifndef TREE_SITTER_COOKLANG_SCANNER_UNICODE_H_');
+  lines.push('#define TREE_SITTER_COOKLANG_SCANNER_UNICODE_H_');
+  lines.push('');
+  lines.push('#include <stdbool.h>');
+  lines.push('#include <stdint.h>');
+  lines.push('');
+  lines.push('// No word characters at or above this code point.');
+  lines.push(`#define UNICODE_WORD_LIMIT 0x${limit.toString(16).toUpperCase()}`);
+  lines.push(`#define UNICODE_WORD_BLOCK_COUNT ${stage2.length}`);
+  lines.push('');
+  lines.push(`static const uint8_t UNICODE_WORD_STAGE1[UNICODE_WORD_LIMIT >> ${BLOCK_BITS}] = {`);
+  for (let i = 0; i < stage1.length; i += 16) {
+    lines.push('    ' + stage1.slice(i, i + 16).join(', ') + ',');
+  }
+  lines.push('};');
+  lines.push('');
+  lines.push('static const uint32_t UNICODE_WORD_STAGE2[UNICODE_WORD_BLOCK_COUNT]' +
+             `[${BLOCK_SIZE / 32}] = {`);
+  for (const words of stage2) {
+    lines.push('    {' + words.slice(0, 4).map(hex).join(', ') + ',');
+    lines.push('     ' + words.slice(4).map(hex).join(', ') + '},');
+  }
+  lines.push('};');
+  lines.push('');
+  lines.push('static inline bool unicode_is_word(int32_t c) {');
+  lines.push('    if (c < 0 || c >= UNICODE_WORD_LIMIT) {');
+  lines.push('        return false;');
+  lines.push('    }');
+  lines.push('    const uint32_t *block =');
+  lines.push(`        UNICODE_WORD_STAGE2[UNICODE_WORD_STAGE1[c >> ${BLOCK_BITS}]];`);
+  lines.push(`    return (block[(c >> 5) & ${BLOCK_SIZE / 32 - 1}] >> (c & 31)) & 1;`);
+  lines.push('}');
+  lines.push('');
+  lines.push('#endif // TREE_SITTER_COOKLANG_SCANNER_UNICODE_H_');
+  return lines.join('\n') + '\n';
+}
+
+if (process.versions.unicode !== UNICODE_VERSION) {
+  throw new Error(`Node has Unicode ${process.versions.unicode}, not ${UNICODE_VERSION}`);
+}
+fs.writeFileSync(OUTPUT, render(build()));
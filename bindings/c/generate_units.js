@@ -0,0 +1,168 @@
+#!/usr/bin/env node
+// Generates cooklang_units_table.h from units.json: the unit records and a
+// perfect hash over every alias, so that a lookup is two hashes and one
+// string compare.
+//
+// The hash is hash-and-displace: an alias first picks a bucket with seed 0,
+// and the bucket's seed then places it in a slot. Buckets are seeded
+// largest first until every alias has a slot of its own.
+//
+//   node bindings/c/generate_units.js
+
+const fs = require('fs');
+const path = require('path');
+
+const INPUT = path.join(__dirname, 'units.json');
+const OUTPUT = path.join(__dirname, 'cooklang_units_table.h');
+const MAX_SEED = 0xFFFF;
+// MAX_UNIT_LENGTH in cooklang_units.c.
+const MAX_ALIAS_LENGTH = 32;
+
+// Must match unit_hash in cooklang_units.c.
+function hash(bytes, seed) {
+  let h = (2166136261 ^ seed) >>> 0;
+  for (const byte of bytes) {
+    h = Math.imul(h ^ byte, 16777619) >>> 0;
+  }
+  h ^= h >>> 16;
+  h = Math.imul(h, 0x45d9f3b) >>> 0;
+  h ^= h >>> 16;
+  return h >>> 0;
+}
+
+function gcd(a, b) {
+  while (b) {
+    [a, b] = [b, a % b];
+  }
+  return a;
+}
+
+// "28.349523125" -> [28349523125n, 1000000000n] in lowest terms.
+function parseFactor(text) {
+  const match = /^(\d+)(?:\.(\d+))?$/.exec(text);
+  if (!match) {
+    throw new Error(`bad factor ${text}`);
+  }
+  const places = match[2] ? match[2].length : 0;
+  let numerator = BigInt(match[1] + (match[2] || ''));
+  let denominator = 10n ** BigInt(places);
+  const divisor = gcd(numerator, denominator);
+  numerator /= divisor;
+  denominator /= divisor;
+  if (numerator === 0n || numerator >= 2n ** 64n || denominator >= 2n ** 64n) {
+    throw new Error(`factor ${text} does not fit in 64 bits`);
+  }
+  return [numerator, denominator];
+}
+
+function cString(text) {
+  let out = '"';
+  for (const byte of Buffer.from(text, 'utf8')) {
+    if (byte >= 0x20 && byte < 0x7F && byte !== 0x22 && byte !== 0x5C) {
+      out += String.fromCharCode(byte);
+    } else {
+      out += '\\' + byte.toString(8).padStart(3, '0');
+    }
+  }
+  return out + '"';
+}
+
+function build(data) {
+  const units = data.units;
+  const names = new Map(units.map((unit, index) => [unit.name, index]));
+  const aliases = [];
+  const seen = new Set();
+  units.forEach((unit, index) => {
+    if (!data.dimensions.includes(unit.dimension)) {
+      throw new Error(`${unit.name}: unknown dimension ${unit.dimension}`);
+    }
+    if (!names.has(unit.base) || units[names.get(unit.base)].factor !== '1') {
+      throw new Error(`${unit.name}: base ${unit.base} is not a unit with factor 1`);
+    }
+    for (const alias of unit.aliases) {
+      if (seen.has(alias)) {
+        throw new Error(`duplicate alias ${alias}`);
+      }
+      seen.add(alias);
+      const bytes = Buffer.from(alias, 'utf8');
+      if (bytes.length > MAX_ALIAS_LENGTH) {
+        throw new Error(`alias ${alias} is too long`);
+      }
+      aliases.push({ alias, bytes, unit: index });
+    }
+  });
+
+  let slotCount = 1;
+  while (slotCount < aliases.length * 5 / 4) {
+    slotCount *= 2;
+  }
+  const bucketCount = Math.max(1, Math.ceil(aliases.length / 2));
+  const buckets = Array.from({ length: bucketCount }, () => []);
+  for (const entry of aliases) {
+    buckets[hash(entry.bytes, 0) % bucketCount].push(entry);
+  }
+
+  const order = buckets.map((_, index) => index)
+    .sort((a, b) => buckets[b].length - buckets[a].length || a - b);
+  const seeds = new Array(bucketCount).fill(0);
+  const slots = new Array(slotCount).fill(null);
+  for (const index of order) {
+    const bucket = buckets[index];
+    if (bucket.length === 0) {
+      break;
+    }
+    let placed = false;
+    for (let seed = 1; seed <= MAX_SEED && !placed; seed++) {
+      const taken = bucket.map(entry => hash(entry.bytes, seed) % slotCount);
+      if (taken.some((slot, i) => slots[slot] || taken.indexOf(slot) !== i)) {
+        continue;
+      }
+      taken.forEach((slot, i) => { slots[slot] = bucket[i]; });
+      seeds[index] = seed;
+      placed = true;
+    }
+    if (!placed) {
+      throw new Error(`no seed places bucket ${index}`);
+    }
+  }
+
+  return { units, names, aliases, slotCount, bucketCount, seeds, slots };
+}
+
+function render(data, table) {
+  const { units, names, slotCount, bucketCount, seeds, slots } = table;
+  const lines = [];
+  lines.push('// Generated by generate_units.js from units.json. Do not edit.');
+  lines.push('');
+  lines.push(`#define UNIT_COUNT ${units.length}`);
+  lines.push(`#define ALIAS_COUNT ${table.aliases.length}`);
+  lines.push(`#define ALIAS_SLOT_COUNT ${slotCount}`);
+  lines.push(`#define ALIAS_BUCKET_COUNT ${bucketCount}`);
+  lines.push('');
+  lines.push('static const CooklangUnit UNITS[UNIT_COUNT] = {');
+  for (const unit of units) {
+    const [numerator, denominator] = parseFactor(unit.factor);
+    const dimension = `COOKLANG_DIMENSION_${unit.dimension.toUpperCase()}`;
+    lines.push(`    {${cString(unit.name)}, &UNITS[${names.get(unit.base)}], ${dimension}, ` +
+               `{${numerator}u, ${denominator}u}},`);
+  }
+  lines.push('};');
+  lines.push('');
+  lines.push('static const uint16_t ALIAS_SEEDS[ALIAS_BUCKET_COUNT] = {');
+  for (let i = 0; i < seeds.length; i += 12) {
+    lines.push('    ' + seeds.slice(i, i + 12).join(', ') + ',');
+  }
+  lines.push('};');
+  lines.push('');
+  lines.push('static const UnitAlias ALIASES[ALIAS_SLOT_COUNT] = {');
+  slots.forEach((entry, slot) => {
+    if (entry) {
+      lines.push(`    [${slot}] = {${cString(entry.alias)}, ${entry.bytes.length}, ${entry.unit}},`);
+    }
+  });
+  lines.push('};');
+  return lines.join('\n') + '\n';
+}
+
+const data = JSON.parse(fs.readFileSync(INPUT, 'utf8'));
+fs.writeFileSync(OUTPUT, render(data, build(data)));
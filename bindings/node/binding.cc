@@ -1,5 +1,11 @@
 #include <napi.h>
 
+#include <string>
+#include <vector>
+
+#include "cooklang_cache.h"
+#include "scanner_stats.h"
+
 typedef struct TSLanguage TSLanguage;
 
 extern "C" TSLanguage *tree_sitter_cooklang();
@@ -9,11 +15,130 @@ const napi_type_tag LANGUAGE_TYPE_TAG = {
   0x8AF2E5212AD58ABF, 0xD5006CAD83ABBA16
 };
 
+static Napi::Value ScannerStats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+#ifdef COOKLANG_SCANNER_STATS
+    CooklangScannerStats stats;
+    cooklang_scanner_stats(&stats);
+
+    auto result = Napi::Object::New(env);
+    result["calls"] = Napi::Number::New(env, stats.calls);
+    result["falseAfterAdvance"] = Napi::Number::New(env, stats.false_after_advance);
+    auto tokens = Napi::Object::New(env);
+    for (uint32_t i = 0; i < COOKLANG_SCANNER_TOKEN_COUNT; i++) {
+        auto token = Napi::Object::New(env);
+        token["calls"] = Napi::Number::New(env, stats.tokens[i].calls);
+        token["successes"] = Napi::Number::New(env, stats.tokens[i].successes);
+        token["bytes"] = Napi::Number::New(env, stats.tokens[i].bytes);
+        token["falseAfterAdvance"] = Napi::Number::New(env, stats.tokens[i].false_after_advance);
+        tokens[cooklang_scanner_token_name(i)] = token;
+    }
+    result["tokens"] = tokens;
+
+    uint32_t count = cooklang_scanner_valid_symbol_sets(nullptr, 0);
+    std::vector<CooklangValidSymbolSet> sets(count);
+    count = cooklang_scanner_valid_symbol_sets(sets.data(), count);
+    auto valid_symbol_sets = Napi::Array::New(env, count);
+    for (uint32_t i = 0; i < count; i++) {
+        auto names = Napi::Array::New(env);
+        for (uint32_t token = 0; token < COOKLANG_SCANNER_TOKEN_COUNT; token++) {
+            if (sets[i].valid_symbols & (1u << token)) {
+                names[names.Length()] = Napi::String::New(env, cooklang_scanner_token_name(token));
+            }
+        }
+        auto set = Napi::Object::New(env);
+        set["validSymbols"] = names;
+        set["calls"] = Napi::Number::New(env, sets[i].calls);
+        valid_symbol_sets[i] = set;
+    }
+    result["validSymbolSets"] = valid_symbol_sets;
+    return result;
+#else
+    return env.Null();
+#endif
+}
+
+static void ResetScannerStats(const Napi::CallbackInfo &) {
+#ifdef COOKLANG_SCANNER_STATS
+    cooklang_scanner_stats_reset();
+#endif
+}
+
+// Parse caches hold references to JavaScript values, so they live and die
+// on the thread of the environment that created them.
+static void DeleteReference(void *value, void *) {
+    delete static_cast<Napi::Reference<Napi::Value> *>(value);
+}
+
+static void DeleteCache(Napi::Env, CooklangCache *cache) {
+    cooklang_cache_delete(cache);
+}
+
+static Napi::Value CacheNew(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    double capacity = info[0].As<Napi::Number>().DoubleValue();
+    CooklangCache *cache = cooklang_cache_new(static_cast<uint64_t>(capacity), DeleteReference, nullptr);
+    if (!cache) {
+        throw Napi::Error::New(env, "out of memory");
+    }
+    return Napi::External<CooklangCache>::New(env, cache, DeleteCache);
+}
+
+// The value of a referenced entry; releases the entry.
+static Napi::Value TakeEntry(CooklangCache *cache, CooklangCacheEntry *entry) {
+    Napi::Value value = static_cast<Napi::Reference<Napi::Value> *>(entry->value)->Value();
+    cooklang_cache_release(cache, entry);
+    return value;
+}
+
+static Napi::Value CacheGet(const Napi::CallbackInfo &info) {
+    CooklangCache *cache = info[0].As<Napi::External<CooklangCache>>().Data();
+    std::string key = info[1].As<Napi::String>().Utf8Value();
+    CooklangCacheEntry *entry = cooklang_cache_lookup(cache, key.data(), static_cast<uint32_t>(key.size()));
+    if (!entry) {
+        return info.Env().Undefined();
+    }
+    return TakeEntry(cache, entry);
+}
+
+static Napi::Value CachePut(const Napi::CallbackInfo &info) {
+    CooklangCache *cache = info[0].As<Napi::External<CooklangCache>>().Data();
+    std::string key = info[1].As<Napi::String>().Utf8Value();
+    double size = info[3].As<Napi::Number>().DoubleValue();
+    auto reference = new Napi::Reference<Napi::Value>(Napi::Persistent(info[2]));
+    CooklangCacheEntry *entry = cooklang_cache_insert(cache, key.data(), static_cast<uint32_t>(key.size()),
+                                                      reference, static_cast<uint64_t>(size));
+    if (!entry) {
+        throw Napi::Error::New(info.Env(), "out of memory");
+    }
+    return TakeEntry(cache, entry);
+}
+
+static Napi::Value CacheStats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    CooklangCacheStats stats;
+    cooklang_cache_stats(info[0].As<Napi::External<CooklangCache>>().Data(), &stats);
+    auto result = Napi::Object::New(env);
+    result["hits"] = Napi::Number::New(env, stats.hits);
+    result["misses"] = Napi::Number::New(env, stats.misses);
+    result["evictions"] = Napi::Number::New(env, stats.evictions);
+    result["entries"] = Napi::Number::New(env, stats.entries);
+    result["bytes"] = Napi::Number::New(env, stats.bytes);
+    return result;
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports["name"] = Napi::String::New(env, "cooklang");
     auto language = Napi::External<TSLanguage>::New(env, tree_sitter_cooklang());
     language.TypeTag(&LANGUAGE_TYPE_TAG);
     exports["language"] = language;
+    exports["scannerStats"] = Napi::Function::New(env, ScannerStats, "scannerStats");
+    exports["resetScannerStats"] = Napi::Function::New(env, ResetScannerStats, "resetScannerStats");
+    exports["cacheNew"] = Napi::Function::New(env, CacheNew, "cacheNew");
+    exports["cacheGet"] = Napi::Function::New(env, CacheGet, "cacheGet");
+    exports["cachePut"] = Napi::Function::New(env, CachePut, "cachePut");
+    exports["cacheStats"] = Napi::Function::New(env, CacheStats, "cacheStats");
+    exports["cacheNodeBytes"] = Napi::Number::New(env, COOKLANG_CACHE_NODE_BYTES);
     return exports;
 }
 
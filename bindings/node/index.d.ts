@@ -18,10 +18,66 @@ type NodeInfo =
       children: ChildNode[];
     });
 
+type ScannerTokenStats = {
+  calls: number;
+  successes: number;
+  bytes: number;
+  falseAfterAdvance: number;
+};
+
+type ScannerStats = {
+  calls: number;
+  falseAfterAdvance: number;
+  tokens: { [name: string]: ScannerTokenStats };
+  validSymbolSets: { validSymbols: string[]; calls: number }[];
+};
+
+type ParseBudget = {
+  /** Parse at most this many bytes of the input's UTF-8 encoding. */
+  maxBytes?: number;
+  /** Stop reading input after this long, and give up at twice as long. */
+  timeoutMs?: number;
+  /**
+   * Polled while parsing; return true to cancel. The parse runs on this
+   * thread, so the flag must be set elsewhere, e.g. in a SharedArrayBuffer.
+   */
+  isCancelled?: () => boolean;
+};
+
+type BudgetedParse = {
+  /** The tree of the input read before the budget ran out, if any. */
+  tree: any | null;
+  status: "complete" | "budgetExceeded" | "cancelled";
+};
+
+type CacheStats = {
+  hits: number;
+  misses: number;
+  evictions: number;
+  /** Trees currently cached and the bytes charged for them. */
+  entries: number;
+  bytes: number;
+};
+
+/** Parsed trees keyed by the input they were parsed from; cached trees are shared and read-only. */
+declare class ParseCache {
+  /** A cache holding up to `capacity` bytes. */
+  constructor(capacity: number);
+  /** The tree of `input`, parsed with `parser`, set to this language, unless it is cached. */
+  get(parser: any, input: string): any;
+  stats(): CacheStats;
+}
+
 type Language = {
   name: string;
   language: unknown;
   nodeTypeInfo: NodeInfo[];
+  /** External scanner counters, or null unless built with COOKLANG_SCANNER_STATS. */
+  scannerStats(): ScannerStats | null;
+  resetScannerStats(): void;
+  /** Parse untrusted input with `parser`, set to this language, within a budget. */
+  parseWithBudget(parser: any, input: string, budget?: ParseBudget): BudgetedParse;
+  ParseCache: typeof ParseCache;
 };
 
 declare const language: Language;
@@ -5,3 +5,111 @@ module.exports = require("node-gyp-build")(root);
 try {
   module.exports.nodeTypeInfo = require("../../src/node-types.json");
 } catch (_) {}
+
+// Input is handed to the parser in chunks of this many characters, so that
+// a parse whose time runs out stops reading within one chunk.
+const CHUNK_SIZE = 4096;
+
+// A parse that has not wrapped up by this multiple of its timeout is
+// cancelled outright.
+const HARD_STOP_FACTOR = 2;
+
+// Runtimes before tree-sitter 0.25 ignore `progressCallback`, which would
+// leave a budgeted parse without its hard stop. So each kind of parser is
+// tried once on an input long enough for the callback to be called.
+const PROBE_INPUT = "Add @salt{1%tsp} and ~{2%min}.\n".repeat(64);
+const probedParsers = new WeakSet();
+
+function checkProgressCallback(parser) {
+  const kind = Object.getPrototypeOf(parser);
+  if (probedParsers.has(kind)) {
+    return;
+  }
+  let called = false;
+  const progressCallback = () => {
+    called = true;
+    return false;
+  };
+  parser.parse((index) => PROBE_INPUT.slice(index, index + CHUNK_SIZE), null, { progressCallback });
+  if (!called) {
+    throw new Error("parseWithBudget needs a tree-sitter runtime whose parse() takes " +
+                    "progressCallback: the tree-sitter package 0.25 or later");
+  }
+  probedParsers.add(kind);
+}
+
+// Parse untrusted input with a budget. Input beyond `maxBytes` (UTF-8) is
+// not parsed. Once `timeoutMs` has passed the parser is told the input has
+// ended, so it returns the tree of what it has read so far; if that takes
+// until twice the timeout, or `isCancelled()` returns true, the parse is
+// cancelled and there is no tree. Either way the status says so. Throws if
+// the runtime cannot cancel a parse.
+module.exports.parseWithBudget = function parseWithBudget(parser, input, options = {}) {
+  checkProgressCallback(parser);
+  const { maxBytes, timeoutMs, isCancelled } = options;
+  let status = "complete";
+  if (maxBytes !== undefined && Buffer.byteLength(input) > maxBytes) {
+    // A streaming decode drops a character cut in half at the end.
+    input = new TextDecoder().decode(Buffer.from(input).subarray(0, maxBytes), { stream: true });
+    status = "budgetExceeded";
+  }
+
+  const start = performance.now();
+  const overTime = (factor) =>
+    timeoutMs !== undefined && performance.now() - start >= timeoutMs * factor;
+  let stopped = false;
+  let cancelled = false;
+  const read = (index) => {
+    if (index >= input.length) {
+      return "";
+    }
+    if (stopped || overTime(1)) {
+      stopped = true;
+      return "";
+    }
+    return input.slice(index, index + CHUNK_SIZE);
+  };
+  const progressCallback = () => {
+    cancelled = Boolean(isCancelled && isCancelled());
+    return cancelled || overTime(HARD_STOP_FACTOR);
+  };
+
+  const tree = parser.parse(read, null, { progressCallback }) || null;
+  if (!tree) {
+    // Otherwise the next parse would resume this one.
+    parser.reset();
+    return { tree: null, status: cancelled ? "cancelled" : "budgetExceeded" };
+  }
+  return { tree, status: stopped ? "budgetExceeded" : status };
+};
+
+// Parsed trees keyed by the input they were parsed from. Parsing an input
+// that was parsed before returns the cached tree, shared with every other
+// caller, so treat it as read-only. The least recently used trees are
+// evicted once the cache holds more than `capacity` bytes, counting each
+// tree's input plus an estimate per syntax node. The cache itself is the one
+// in bindings/c; it belongs to the thread that created it.
+class ParseCache {
+  constructor(capacity) {
+    this.cache = module.exports.cacheNew(capacity);
+  }
+
+  // The tree of `input`, parsed with `parser`, set to this language, unless
+  // it is cached.
+  get(parser, input) {
+    const { cacheGet, cachePut, cacheNodeBytes } = module.exports;
+    let tree = cacheGet(this.cache, input);
+    if (tree === undefined) {
+      tree = parser.parse(input);
+      tree = cachePut(this.cache, input, tree, tree.rootNode.descendantCount * cacheNodeBytes);
+    }
+    return tree;
+  }
+
+  // The hits, misses, evictions, entries and bytes of the cache.
+  stats() {
+    return module.exports.cacheStats(this.cache);
+  }
+}
+
+module.exports.ParseCache = ParseCache;
@@ -1,5 +1,192 @@
 "Cooklang grammar for tree-sitter"
 
-from ._binding import language
+import mmap
+import os
+from enum import Enum
+from time import monotonic
+from typing import NamedTuple
 
-__all__ = ["language"]
+from ._binding import (
+    CACHE_NODE_BYTES,
+    cache_get,
+    cache_new,
+    cache_put,
+    cache_stats,
+    language,
+    reset_scanner_stats,
+    scanner_stats,
+)
+
+__all__ = [
+    "language",
+    "scanner_stats",
+    "reset_scanner_stats",
+    "ParseStatus",
+    "BudgetedParse",
+    "parse_with_budget",
+    "ParseCache",
+    "FILE_CHUNK_SIZE",
+    "parse_file",
+]
+
+# Input is handed to the parser in chunks of this many bytes, so that a
+# parse whose time runs out stops reading within one chunk.
+_CHUNK_SIZE = 4096
+
+# A parse that has not wrapped up by this multiple of its timeout is
+# cancelled outright.
+_HARD_STOP_FACTOR = 2
+
+
+class ParseStatus(Enum):
+    COMPLETE = "complete"
+    BUDGET_EXCEEDED = "budget_exceeded"
+    CANCELLED = "cancelled"
+
+
+class BudgetedParse(NamedTuple):
+    tree: object
+    status: ParseStatus
+
+
+def parse_with_budget(parser, source, *, max_bytes=None, timeout=None, cancel=None):
+    """Parse untrusted UTF-8 `source` with `parser`, set to this language.
+
+    Bytes beyond `max_bytes` are not parsed. Once `timeout` seconds have
+    passed the parser is told the input has ended, so it returns the tree of
+    what it has read so far; if that takes until twice the timeout, or
+    `cancel.is_set()` (e.g. a `threading.Event`) becomes true, the parse is
+    cancelled and the tree is None. Needs py-tree-sitter 0.25 or later, whose
+    `Parser.parse` takes a progress callback; raises RuntimeError otherwise.
+    """
+    status = ParseStatus.COMPLETE
+    if max_bytes is not None and len(source) > max_bytes:
+        end = max_bytes
+        # Do not cut a character in half.
+        while end > 0 and source[end] & 0xC0 == 0x80:
+            end -= 1
+        source = source[:end]
+        status = ParseStatus.BUDGET_EXCEEDED
+
+    start = monotonic()
+    stopped = False
+    cancelled = False
+
+    def over_time(factor):
+        return timeout is not None and monotonic() - start >= timeout * factor
+
+    def read(offset, _point):
+        nonlocal stopped
+        if offset >= len(source):
+            return b""
+        if stopped or over_time(1):
+            stopped = True
+            return b""
+        return source[offset:offset + _CHUNK_SIZE]
+
+    def progress(_offset, _has_error):
+        nonlocal cancelled
+        cancelled = cancel is not None and cancel.is_set()
+        return cancelled or over_time(_HARD_STOP_FACTOR)
+
+    try:
+        tree = parser.parse(read, progress_callback=progress)
+    except TypeError as error:
+        if "progress_callback" not in str(error):
+            raise
+        raise RuntimeError(
+            "parse_with_budget needs py-tree-sitter 0.25 or later, "
+            "whose Parser.parse takes progress_callback"
+        ) from error
+    if tree is None:
+        # Otherwise the next parse would resume this one.
+        parser.reset()
+        return BudgetedParse(None, ParseStatus.CANCELLED if cancelled else ParseStatus.BUDGET_EXCEEDED)
+    return BudgetedParse(tree, ParseStatus.BUDGET_EXCEEDED if stopped else status)
+
+
+# The chunk size `parse_file` reads files in by default; the
+# COOKLANG_FILE_INPUT_CHUNK_SIZE of bindings/c/cooklang_file_input.h.
+FILE_CHUNK_SIZE = 64 * 1024
+
+# Mapped pages this many chunks behind the parser are kept.
+_RETAINED_CHUNKS = 4
+
+# The longest UTF-8 character, and so the shortest chunk the lexer can use.
+_MAX_CHARACTER_BYTES = 4
+
+
+def parse_file(parser, path, *, chunk_size=FILE_CHUNK_SIZE, use_mmap=False):
+    """Parse the file at `path` with `parser`, set to this language, without
+    reading it into memory whole.
+
+    The parser is handed `chunk_size` bytes at a time, read with `os.pread`
+    or, with `use_mmap`, sliced from a memory mapping whose pages are handed
+    back once the parser has moved past them. Either way the memory a parse
+    takes is the tree plus a few chunks, however large the file. This reads
+    the way bindings/c/cooklang_file_input.h does.
+    """
+    chunk_size = max(chunk_size, _MAX_CHARACTER_BYTES)
+    with open(path, "rb") as file:
+        length = os.fstat(file.fileno()).st_size
+        if use_mmap and length > 0:
+            with mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ) as mapping:
+                return parser.parse(_mapped_reader(mapping, length, chunk_size))
+        if hasattr(os, "pread"):
+            def read(offset, _point):
+                return os.pread(file.fileno(), chunk_size, offset) if offset < length else b""
+        else:
+            def read(offset, _point):
+                if offset >= length:
+                    return b""
+                file.seek(offset)
+                return file.read(chunk_size)
+        return parser.parse(read)
+
+
+def _mapped_reader(mapping, length, chunk_size):
+    released = 0
+    retained = _RETAINED_CHUNKS * chunk_size
+    can_release = hasattr(mapping, "madvise") and hasattr(mmap, "MADV_DONTNEED")
+
+    def read(offset, _point):
+        nonlocal released
+        if offset >= length:
+            return b""
+        if can_release and offset > retained:
+            release = (offset - retained) // mmap.PAGESIZE * mmap.PAGESIZE
+            if release > released:
+                # Clean file-backed pages; touching them again reads them back.
+                mapping.madvise(mmap.MADV_DONTNEED, released, release - released)
+                released = release
+        return mapping[offset:offset + chunk_size]
+
+    return read
+
+
+class ParseCache:
+    """Parsed trees keyed by the source they were parsed from, shared between threads.
+
+    Parsing a source that was parsed before returns a copy of the cached
+    tree. The least recently used trees are evicted once the cache holds
+    more than `capacity` bytes, counting each tree's source plus an estimate
+    per syntax node. The cache itself is the one in bindings/c.
+    """
+
+    def __init__(self, capacity):
+        self._cache = cache_new(capacity)
+
+    def get(self, parser, source):
+        """The tree of the bytes `source`, parsed with `parser`, set to this
+        language, unless it is cached."""
+        tree = cache_get(self._cache, source)
+        if tree is None:
+            tree = parser.parse(source)
+            size = tree.root_node.descendant_count * CACHE_NODE_BYTES
+            tree = cache_put(self._cache, source, tree, size)
+        # Callers may edit what they are given.
+        return tree.copy()
+
+    def stats(self):
+        """The hits, misses, evictions, entries and bytes of the cache."""
+        return cache_stats(self._cache)
@@ -1 +1,41 @@
+from enum import Enum
+from threading import Event
+from os import PathLike
+from typing import Any, Dict, NamedTuple, Optional, Union
+
 def language() -> int: ...
+def scanner_stats() -> Optional[Dict[str, Any]]: ...
+def reset_scanner_stats() -> None: ...
+
+class ParseStatus(Enum):
+    COMPLETE = "complete"
+    BUDGET_EXCEEDED = "budget_exceeded"
+    CANCELLED = "cancelled"
+
+class BudgetedParse(NamedTuple):
+    tree: Optional[Any]
+    status: ParseStatus
+
+def parse_with_budget(
+    parser: Any,
+    source: bytes,
+    *,
+    max_bytes: Optional[int] = None,
+    timeout: Optional[float] = None,
+    cancel: Optional[Event] = None,
+) -> BudgetedParse: ...
+
+FILE_CHUNK_SIZE: int
+
+def parse_file(
+    parser: Any,
+    path: Union[str, bytes, PathLike],
+    *,
+    chunk_size: int = ...,
+    use_mmap: bool = False,
+) -> Any: ...
+
+class ParseCache:
+    def __init__(self, capacity: int) -> None: ...
+    def get(self, parser: Any, source: bytes) -> Any: ...
+    def stats(self) -> Dict[str, int]: ...
@@ -1,5 +1,8 @@
 #include <Python.h>
 
+#include "cooklang_cache.h"
+#include "scanner_stats.h"
+
 typedef struct TSLanguage TSLanguage;
 
 TSLanguage *tree_sitter_cooklang(void);
@@ -8,9 +11,235 @@ static PyObject* _binding_language(PyObject *self, PyObject *args) {
     return PyLong_FromVoidPtr(tree_sitter_cooklang());
 }
 
+static int set_counter(PyObject *dict, const char *key, uint64_t value) {
+    PyObject *number = PyLong_FromUnsignedLongLong(value);
+    if (!number) {
+        return -1;
+    }
+    int result = PyDict_SetItemString(dict, key, number);
+    Py_DECREF(number);
+    return result;
+}
+
+#ifdef COOKLANG_SCANNER_STATS
+
+static PyObject *token_names(uint32_t valid_symbols) {
+    PyObject *names = PyList_New(0);
+    for (uint32_t token = 0; names && token < COOKLANG_SCANNER_TOKEN_COUNT; token++) {
+        if (!(valid_symbols & (1u << token))) {
+            continue;
+        }
+        PyObject *name = PyUnicode_FromString(cooklang_scanner_token_name(token));
+        if (!name || PyList_Append(names, name) < 0) {
+            Py_XDECREF(name);
+            Py_CLEAR(names);
+            break;
+        }
+        Py_DECREF(name);
+    }
+    return names;
+}
+
+static PyObject *valid_symbol_sets(void) {
+    uint32_t count = cooklang_scanner_valid_symbol_sets(NULL, 0);
+    CooklangValidSymbolSet *sets = PyMem_Malloc((count + 1) * sizeof(CooklangValidSymbolSet));
+    if (!sets) {
+        return PyErr_NoMemory();
+    }
+    count = cooklang_scanner_valid_symbol_sets(sets, count);
+
+    PyObject *list = PyList_New(0);
+    for (uint32_t i = 0; list && i < count; i++) {
+        PyObject *names = token_names(sets[i].valid_symbols);
+        PyObject *entry = names ? Py_BuildValue("(NK)", names, (unsigned long long)sets[i].calls) : NULL;
+        if (!entry || PyList_Append(list, entry) < 0) {
+            Py_XDECREF(entry);
+            Py_CLEAR(list);
+            break;
+        }
+        Py_DECREF(entry);
+    }
+    PyMem_Free(sets);
+    return list;
+}
+
+static PyObject* _binding_scanner_stats(PyObject *self, PyObject *args) {
+    CooklangScannerStats stats;
+    cooklang_scanner_stats(&stats);
+
+    PyObject *result = PyDict_New();
+    PyObject *tokens = PyDict_New();
+    if (!result || !tokens ||
+        set_counter(result, "calls", stats.calls) < 0 ||
+        set_counter(result, "false_after_advance", stats.false_after_advance) < 0 ||
+        PyDict_SetItemString(result, "tokens", tokens) < 0) {
+        goto error;
+    }
+    for (uint32_t i = 0; i < COOKLANG_SCANNER_TOKEN_COUNT; i++) {
+        PyObject *token = PyDict_New();
+        if (!token ||
+            set_counter(token, "calls", stats.tokens[i].calls) < 0 ||
+            set_counter(token, "successes", stats.tokens[i].successes) < 0 ||
+            set_counter(token, "bytes", stats.tokens[i].bytes) < 0 ||
+            set_counter(token, "false_after_advance", stats.tokens[i].false_after_advance) < 0 ||
+            PyDict_SetItemString(tokens, cooklang_scanner_token_name(i), token) < 0) {
+            Py_XDECREF(token);
+            goto error;
+        }
+        Py_DECREF(token);
+    }
+    PyObject *sets = valid_symbol_sets();
+    if (!sets || PyDict_SetItemString(result, "valid_symbol_sets", sets) < 0) {
+        Py_XDECREF(sets);
+        goto error;
+    }
+    Py_DECREF(sets);
+    Py_DECREF(tokens);
+    return result;
+
+error:
+    Py_XDECREF(tokens);
+    Py_XDECREF(result);
+    return NULL;
+}
+
+static PyObject* _binding_reset_scanner_stats(PyObject *self, PyObject *args) {
+    cooklang_scanner_stats_reset();
+    Py_RETURN_NONE;
+}
+
+#else
+
+static PyObject* _binding_scanner_stats(PyObject *self, PyObject *args) {
+    Py_RETURN_NONE;
+}
+
+static PyObject* _binding_reset_scanner_stats(PyObject *self, PyObject *args) {
+    Py_RETURN_NONE;
+}
+
+#endif
+
+// Parse caches hold Python objects, so every call that may destroy one is
+// made with the GIL held.
+#define CACHE_CAPSULE "tree_sitter_cooklang.ParseCache"
+
+static void release_object(void *value, void *payload) {
+    (void)payload;
+    Py_DECREF((PyObject *)value);
+}
+
+static void delete_cache(PyObject *capsule) {
+    cooklang_cache_delete(PyCapsule_GetPointer(capsule, CACHE_CAPSULE));
+}
+
+static PyObject* _binding_cache_new(PyObject *self, PyObject *args) {
+    unsigned long long capacity;
+    if (!PyArg_ParseTuple(args, "K", &capacity)) {
+        return NULL;
+    }
+    CooklangCache *cache = cooklang_cache_new(capacity, release_object, NULL);
+    if (!cache) {
+        return PyErr_NoMemory();
+    }
+    PyObject *capsule = PyCapsule_New(cache, CACHE_CAPSULE, delete_cache);
+    if (!capsule) {
+        cooklang_cache_delete(cache);
+    }
+    return capsule;
+}
+
+// The object of a referenced entry, with a new reference of its own.
+static PyObject *take_entry(CooklangCache *cache, CooklangCacheEntry *entry) {
+    PyObject *value = entry->value;
+    Py_INCREF(value);
+    cooklang_cache_release(cache, entry);
+    return value;
+}
+
+static PyObject* _binding_cache_get(PyObject *self, PyObject *args) {
+    PyObject *capsule;
+    const char *key;
+    Py_ssize_t length;
+    if (!PyArg_ParseTuple(args, "Oy#", &capsule, &key, &length)) {
+        return NULL;
+    }
+    CooklangCache *cache = PyCapsule_GetPointer(capsule, CACHE_CAPSULE);
+    if (!cache) {
+        return NULL;
+    }
+    if (length > UINT32_MAX) {
+        Py_RETURN_NONE;
+    }
+    CooklangCacheEntry *entry = cooklang_cache_lookup(cache, key, (uint32_t)length);
+    if (!entry) {
+        Py_RETURN_NONE;
+    }
+    return take_entry(cache, entry);
+}
+
+static PyObject* _binding_cache_put(PyObject *self, PyObject *args) {
+    PyObject *capsule;
+    const char *key;
+    Py_ssize_t length;
+    PyObject *value;
+    unsigned long long size;
+    if (!PyArg_ParseTuple(args, "Oy#OK", &capsule, &key, &length, &value, &size)) {
+        return NULL;
+    }
+    CooklangCache *cache = PyCapsule_GetPointer(capsule, CACHE_CAPSULE);
+    if (!cache) {
+        return NULL;
+    }
+    if (length > UINT32_MAX) {
+        Py_INCREF(value);
+        return value;
+    }
+    // The cache owns a reference; it gives it back if another thread got
+    // there first.
+    Py_INCREF(value);
+    CooklangCacheEntry *entry = cooklang_cache_insert(cache, key, (uint32_t)length, value, size);
+    if (!entry) {
+        return PyErr_NoMemory();
+    }
+    return take_entry(cache, entry);
+}
+
+static PyObject* _binding_cache_stats(PyObject *self, PyObject *capsule) {
+    CooklangCache *cache = PyCapsule_GetPointer(capsule, CACHE_CAPSULE);
+    if (!cache) {
+        return NULL;
+    }
+    CooklangCacheStats stats;
+    cooklang_cache_stats(cache, &stats);
+    PyObject *result = PyDict_New();
+    if (!result ||
+        set_counter(result, "hits", stats.hits) < 0 ||
+        set_counter(result, "misses", stats.misses) < 0 ||
+        set_counter(result, "evictions", stats.evictions) < 0 ||
+        set_counter(result, "entries", stats.entries) < 0 ||
+        set_counter(result, "bytes", stats.bytes) < 0) {
+        Py_XDECREF(result);
+        return NULL;
+    }
+    return result;
+}
+
 static PyMethodDef methods[] = {
     {"language", _binding_language, METH_NOARGS,
      "Get the tree-sitter language for this grammar."},
+    {"scanner_stats", _binding_scanner_stats, METH_NOARGS,
+     "Get the external scanner counters, or None unless built with COOKLANG_SCANNER_STATS."},
+    {"reset_scanner_stats", _binding_reset_scanner_stats, METH_NOARGS,
+     "Reset the external scanner counters."},
+    {"cache_new", _binding_cache_new, METH_VARARGS,
+     "Create a parse cache holding up to the given number of bytes."},
+    {"cache_get", _binding_cache_get, METH_VARARGS,
+     "Get the object cached for the given bytes, or None."},
+    {"cache_put", _binding_cache_put, METH_VARARGS,
+     "Cache an object, charged the given size, for the given bytes; returns the cached object."},
+    {"cache_stats", _binding_cache_stats, METH_O,
+     "Get the counters of a parse cache."},
     {NULL, NULL, 0, NULL}
 };
 
@@ -23,5 +252,9 @@ static struct PyModuleDef module = {
 };
 
 PyMODINIT_FUNC PyInit__binding(void) {
-    return PyModule_Create(&module);
+    PyObject *result = PyModule_Create(&module);
+    if (result && PyModule_AddIntConstant(result, "CACHE_NODE_BYTES", COOKLANG_CACHE_NODE_BYTES) < 0) {
+        Py_CLEAR(result);
+    }
+    return result;
 }
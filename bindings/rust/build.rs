@@ -19,4 +19,13 @@ fn main() {
 
     c_config.compile("parser");
     println!("cargo:rerun-if-changed={}", parser_path.to_str().unwrap());
+
+    // The parse cache is plain C with no tree-sitter dependency.
+    let clib_dir = std::path::Path::new("bindings").join("c");
+    let cache_path = clib_dir.join("cooklang_cache.c");
+    cc::Build::new()
+        .include(&clib_dir)
+        .file(&cache_path)
+        .compile("cooklang_cache");
+    println!("cargo:rerun-if-changed={}", cache_path.to_str().unwrap());
 }
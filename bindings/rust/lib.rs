@@ -15,7 +15,16 @@
 //! [Parser]: https://docs.rs/tree-sitter/*/tree_sitter/struct.Parser.html
 //! [tree-sitter]: https://tree-sitter.github.io/
 
-use tree_sitter::Language;
+use std::cell::Cell;
+use std::ffi::{c_char, c_void};
+use std::fs::File;
+use std::io;
+use std::path::Path;
+use std::ptr::NonNull;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::time::{Duration, Instant};
+
+use tree_sitter::{Language, ParseOptions, ParseState, Parser, Point, Tree};
 
 extern "C" {
     fn tree_sitter_cooklang() -> Language;
@@ -42,6 +51,303 @@ pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
 /// The code folding query for this grammar.
 pub const FOLDS_QUERY: &str = include_str!("../../queries/folds.scm");
 
+/// Input is handed to the parser in chunks of this many bytes, so that a parse whose time runs
+/// out stops reading within one chunk.
+const CHUNK_SIZE: usize = 4096;
+
+/// A parse that has not wrapped up by this multiple of its timeout is cancelled outright.
+const HARD_STOP_FACTOR: u32 = 2;
+
+/// Limits for [parse_with_budget].
+#[derive(Clone, Copy, Debug, Default)]
+pub struct ParseBudget<'a> {
+    /// Parse at most this many bytes of the source.
+    pub max_bytes: Option<usize>,
+    /// Stop reading the source after this long, and give up at twice as long.
+    pub timeout: Option<Duration>,
+    /// Polled while parsing; set it from another thread to cancel.
+    pub cancel: Option<&'a AtomicBool>,
+}
+
+/// How a parse with [parse_with_budget] ended.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum ParseStatus {
+    Complete,
+    BudgetExceeded,
+    Cancelled,
+}
+
+/// The result of [parse_with_budget].
+#[derive(Debug)]
+pub struct BudgetedParse {
+    /// The tree of the source read before the budget ran out, if any.
+    pub tree: Option<Tree>,
+    pub status: ParseStatus,
+}
+
+/// Parse untrusted `source` with `parser`, set to this language, within `budget`.
+///
+/// Bytes beyond `max_bytes` are not parsed. Once `timeout` has passed the parser is told the
+/// source has ended, so it returns the tree of what it has read so far; if that takes until twice
+/// the timeout, or `cancel` is set, the parse is cancelled and there is no tree.
+pub fn parse_with_budget(
+    parser: &mut Parser,
+    source: &[u8],
+    budget: &ParseBudget,
+) -> BudgetedParse {
+    let mut status = ParseStatus::Complete;
+    let mut source = source;
+    if let Some(max_bytes) = budget.max_bytes {
+        if source.len() > max_bytes {
+            // Do not cut a UTF-8 character in half.
+            let mut end = max_bytes;
+            while end > 0 && source[end] & 0xC0 == 0x80 {
+                end -= 1;
+            }
+            source = &source[..end];
+            status = ParseStatus::BudgetExceeded;
+        }
+    }
+
+    let start = Instant::now();
+    let over_time = |factor: u32| {
+        budget
+            .timeout
+            .is_some_and(|timeout| start.elapsed() >= timeout * factor)
+    };
+    let stopped = Cell::new(false);
+    let cancelled = Cell::new(false);
+    let mut read = |offset: usize, _: Point| -> &[u8] {
+        if offset >= source.len() {
+            return &[];
+        }
+        if stopped.get() || over_time(1) {
+            stopped.set(true);
+            return &[];
+        }
+        &source[offset..(offset + CHUNK_SIZE).min(source.len())]
+    };
+    let mut progress = |_: &ParseState| -> bool {
+        cancelled.set(
+            budget
+                .cancel
+                .is_some_and(|cancel| cancel.load(Ordering::Relaxed)),
+        );
+        cancelled.get() || over_time(HARD_STOP_FACTOR)
+    };
+
+    let options = ParseOptions::new().progress_callback(&mut progress);
+    match parser.parse_with_options(&mut read, None, Some(options)) {
+        Some(tree) => BudgetedParse {
+            tree: Some(tree),
+            status: if stopped.get() {
+                ParseStatus::BudgetExceeded
+            } else {
+                status
+            },
+        },
+        None => {
+            // Otherwise the next parse would resume this one.
+            parser.reset();
+            BudgetedParse {
+                tree: None,
+                status: if cancelled.get() {
+                    ParseStatus::Cancelled
+                } else {
+                    ParseStatus::BudgetExceeded
+                },
+            }
+        }
+    }
+}
+
+/// The chunk size [parse_file] reads files in by default; the `COOKLANG_FILE_INPUT_CHUNK_SIZE` of
+/// `bindings/c/cooklang_file_input.h`.
+pub const FILE_CHUNK_SIZE: usize = 64 * 1024;
+
+/// The longest UTF-8 character, and so the shortest chunk the lexer can work with.
+const MAX_CHARACTER_BYTES: usize = 4;
+
+#[cfg(unix)]
+fn read_exact_at(file: &File, buffer: &mut [u8], offset: u64) -> io::Result<()> {
+    std::os::unix::fs::FileExt::read_exact_at(file, buffer, offset)
+}
+
+#[cfg(windows)]
+fn read_exact_at(file: &File, mut buffer: &mut [u8], mut offset: u64) -> io::Result<()> {
+    while !buffer.is_empty() {
+        match std::os::windows::fs::FileExt::seek_read(file, buffer, offset) {
+            Ok(0) => return Err(io::ErrorKind::UnexpectedEof.into()),
+            Ok(count) => {
+                buffer = &mut buffer[count..];
+                offset += count as u64;
+            }
+            Err(error) if error.kind() == io::ErrorKind::Interrupted => {}
+            Err(error) => return Err(error),
+        }
+    }
+    Ok(())
+}
+
+/// Parse the file at `path` with `parser`, set to this language, without reading it into memory
+/// whole.
+///
+/// The parser is handed `chunk_size` bytes at a time, read from the file as it asks for them, so
+/// that the memory a parse takes is the tree plus a chunk however large the file is. Files are
+/// limited to 4 GiB, as trees are. This reads the way the `pread` mode of
+/// `bindings/c/cooklang_file_input.h` does.
+pub fn parse_file(
+    parser: &mut Parser,
+    path: impl AsRef<Path>,
+    chunk_size: usize,
+) -> io::Result<Option<Tree>> {
+    let file = File::open(path)?;
+    let length = file.metadata()?.len();
+    if length > u32::MAX as u64 {
+        return Err(io::Error::new(
+            io::ErrorKind::InvalidInput,
+            "files over 4 GiB cannot be parsed",
+        ));
+    }
+    let length = length as usize;
+    let chunk_size = chunk_size.max(MAX_CHARACTER_BYTES);
+    let error = Cell::new(None);
+    let mut read = |offset: usize, _: Point| -> Vec<u8> {
+        if offset >= length {
+            return Vec::new();
+        }
+        let mut chunk = vec![0; chunk_size.min(length - offset)];
+        match read_exact_at(&file, &mut chunk, offset as u64) {
+            Ok(()) => chunk,
+            Err(read_error) => {
+                // End the input here; the partial tree is discarded below.
+                error.set(Some(read_error));
+                Vec::new()
+            }
+        }
+    };
+    let tree = parser.parse_with_options(&mut read, None, None);
+    match error.into_inner() {
+        Some(read_error) => Err(read_error),
+        None => Ok(tree),
+    }
+}
+
+/// Estimated bytes per syntax node, for charging trees against a [ParseCache]'s capacity; the
+/// `COOKLANG_CACHE_NODE_BYTES` of `bindings/c/cooklang_cache.h`.
+const CACHE_NODE_BYTES: u64 = 64;
+
+#[repr(C)]
+struct CooklangCache {
+    _private: [u8; 0],
+}
+
+#[repr(C)]
+struct CooklangCacheEntry {
+    key: *const c_char,
+    length: u32,
+    value: *mut c_void,
+}
+
+/// Counters of a [ParseCache].
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    pub hits: u64,
+    pub misses: u64,
+    pub evictions: u64,
+    /// Trees currently cached and the bytes charged for them.
+    pub entries: u64,
+    pub bytes: u64,
+}
+
+type CacheDestroy = unsafe extern "C" fn(value: *mut c_void, payload: *mut c_void);
+
+extern "C" {
+    fn cooklang_cache_new(
+        capacity: u64,
+        destroy: Option<CacheDestroy>,
+        payload: *mut c_void,
+    ) -> *mut CooklangCache;
+    fn cooklang_cache_delete(cache: *mut CooklangCache);
+    fn cooklang_cache_lookup(
+        cache: *mut CooklangCache,
+        key: *const c_char,
+        length: u32,
+    ) -> *mut CooklangCacheEntry;
+    fn cooklang_cache_insert(
+        cache: *mut CooklangCache,
+        key: *const c_char,
+        length: u32,
+        value: *mut c_void,
+        size: u64,
+    ) -> *mut CooklangCacheEntry;
+    fn cooklang_cache_release(cache: *mut CooklangCache, entry: *mut CooklangCacheEntry);
+    fn cooklang_cache_stats(cache: *mut CooklangCache, stats: *mut CacheStats);
+}
+
+unsafe extern "C" fn drop_tree(value: *mut c_void, _payload: *mut c_void) {
+    drop(Box::from_raw(value as *mut Tree));
+}
+
+/// Parsed trees keyed by the source they were parsed from, shared between threads.
+///
+/// Parsing a source that was parsed before returns a copy of the cached tree, which costs about
+/// as much as cloning a [Tree]. The least recently used trees are evicted once the cache holds
+/// more than its capacity, counting each tree's source plus an estimate per syntax node. This is
+/// the cache in `bindings/c/cooklang_cache.h`; its lock is never held while parsing.
+pub struct ParseCache {
+    raw: NonNull<CooklangCache>,
+}
+
+// The C cache serializes access to its entries, and trees are only handed out as copies.
+unsafe impl Send for ParseCache {}
+unsafe impl Sync for ParseCache {}
+
+impl ParseCache {
+    /// A cache holding up to `capacity` bytes.
+    pub fn new(capacity: u64) -> Self {
+        let raw = unsafe { cooklang_cache_new(capacity, Some(drop_tree), std::ptr::null_mut()) };
+        ParseCache {
+            raw: NonNull::new(raw).expect("Failed to allocate the parse cache"),
+        }
+    }
+
+    /// The tree of `source`, parsed with `parser`, set to this language, unless it is cached.
+    /// Returns `None` if parsing failed or the source is larger than 4 GiB.
+    pub fn get(&self, parser: &mut Parser, source: &[u8]) -> Option<Tree> {
+        let length = u32::try_from(source.len()).ok()?;
+        let key = source.as_ptr() as *const c_char;
+        unsafe {
+            let mut entry = cooklang_cache_lookup(self.raw.as_ptr(), key, length);
+            if entry.is_null() {
+                let tree = parser.parse(source, None)?;
+                let size = tree.root_node().descendant_count() as u64 * CACHE_NODE_BYTES;
+                let value = Box::into_raw(Box::new(tree)) as *mut c_void;
+                entry = cooklang_cache_insert(self.raw.as_ptr(), key, length, value, size);
+                if entry.is_null() {
+                    return None;
+                }
+            }
+            let tree = (*((*entry).value as *const Tree)).clone();
+            cooklang_cache_release(self.raw.as_ptr(), entry);
+            Some(tree)
+        }
+    }
+
+    pub fn stats(&self) -> CacheStats {
+        let mut stats = CacheStats::default();
+        unsafe { cooklang_cache_stats(self.raw.as_ptr(), &mut stats) };
+        stats
+    }
+}
+
+impl Drop for ParseCache {
+    fn drop(&mut self) {
+        unsafe { cooklang_cache_delete(self.raw.as_ptr()) };
+    }
+}
+
 #[cfg(test)]
 mod tests {
     #[test]
@@ -61,6 +367,87 @@ mod tests {
             .expect("Error loading Cooklang grammar via LANGUAGE constant");
     }
 
+    #[test]
+    fn test_parse_with_budget() {
+        let mut parser = tree_sitter::Parser::new();
+        parser
+            .set_language(&super::language())
+            .expect("Error loading Cooklang grammar");
+        let source = "Add @salt{1%tsp} to the #pot{}.\n".repeat(1000);
+
+        let parse = super::parse_with_budget(&mut parser, source.as_bytes(), &Default::default());
+        assert_eq!(parse.status, super::ParseStatus::Complete);
+        assert_eq!(parse.tree.unwrap().root_node().end_byte(), source.len());
+
+        let budget = super::ParseBudget {
+            max_bytes: Some(100),
+            ..Default::default()
+        };
+        let parse = super::parse_with_budget(&mut parser, source.as_bytes(), &budget);
+        assert_eq!(parse.status, super::ParseStatus::BudgetExceeded);
+        assert!(parse.tree.unwrap().root_node().end_byte() <= 100);
+
+        let cancel = std::sync::atomic::AtomicBool::new(true);
+        let budget = super::ParseBudget {
+            cancel: Some(&cancel),
+            ..Default::default()
+        };
+        let parse = super::parse_with_budget(&mut parser, source.as_bytes(), &budget);
+        assert_eq!(parse.status, super::ParseStatus::Cancelled);
+        assert!(parse.tree.is_none());
+    }
+
+    #[test]
+    fn test_parse_file() {
+        let mut parser = tree_sitter::Parser::new();
+        parser
+            .set_language(&super::language())
+            .expect("Error loading Cooklang grammar");
+        let source = "Whisk @egg yolks{4} with @sugar{100%g} in a #bowl{} — ½ hour.\n".repeat(100);
+        let path = std::env::temp_dir().join(format!("cooklang-parse-file-{}", std::process::id()));
+        std::fs::write(&path, &source).unwrap();
+        let expected = parser.parse(&source, None).unwrap();
+        for chunk_size in [1, 5, super::FILE_CHUNK_SIZE] {
+            let tree = super::parse_file(&mut parser, &path, chunk_size)
+                .unwrap()
+                .unwrap();
+            assert_eq!(tree.root_node().to_sexp(), expected.root_node().to_sexp());
+            assert_eq!(tree.root_node().end_byte(), source.len());
+        }
+        std::fs::remove_file(&path).unwrap();
+        assert!(super::parse_file(&mut parser, &path, super::FILE_CHUNK_SIZE).is_err());
+    }
+
+    #[test]
+    fn test_parse_cache() {
+        let cache = super::ParseCache::new(1 << 20);
+        let source = b"Boil @water{1%l} in a #pot{}.\n".to_vec();
+        let trees: Vec<_> = std::thread::scope(|scope| {
+            let workers: Vec<_> = (0..4)
+                .map(|_| {
+                    scope.spawn(|| {
+                        let mut parser = tree_sitter::Parser::new();
+                        parser
+                            .set_language(&super::language())
+                            .expect("Error loading Cooklang grammar");
+                        cache.get(&mut parser, &source).unwrap()
+                    })
+                })
+                .collect();
+            workers
+                .into_iter()
+                .map(|worker| worker.join().unwrap())
+                .collect()
+        });
+        for tree in &trees {
+            assert_eq!(tree.root_node().to_sexp(), trees[0].root_node().to_sexp());
+        }
+        let stats = cache.stats();
+        assert_eq!(stats.hits + stats.misses, 4);
+        assert_eq!(stats.entries, 1);
+        assert!(stats.bytes > source.len() as u64);
+    }
+
     #[test]
     fn test_query_constants_are_accessible() {
         // Verify that all query constants are non-empty
@@ -24,14 +24,6 @@ module.exports = grammar({
     $.block_comment
   ],
 
-  word: $ => $.word,
-
-  conflicts: $ => [
-    [$.ingredient],
-    [$.cookware],
-    [$.timer]
-  ],
-
   rules: {
     recipe: $ => seq(
       optional($.frontmatter),
@@ -82,26 +74,26 @@ module.exports = grammar({
 
     text: $ => $.text_content,
 
-    ingredient: $ => seq(
+    ingredient: $ => prec.right(seq(
       '@',
       field('name', $.ingredient_name),
       optional($.quantity),
       optional($.note)
-    ),
+    )),
 
-    cookware: $ => seq(
+    cookware: $ => prec.right(seq(
       '#',
       field('name', $.cookware_name),
       optional($.quantity),
       optional($.note)
-    ),
+    )),
 
-    timer: $ => seq(
+    timer: $ => prec.right(seq(
       '~',
       optional(field('name', $.timer_name)),
       optional($.quantity),
       optional($.note)
-    ),
+    )),
 
     quantity: $ => seq(
       '{',
@@ -124,8 +116,6 @@ module.exports = grammar({
     recipe_note: $ => seq(
       '>',
       optional(field('text', $.recipe_note_text))
-    ),
-
-    word: $ => /[a-zA-Z0-9_\-']+/
+    )
   }
 });
\ No newline at end of file
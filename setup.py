@@ -1,3 +1,4 @@
+from os import environ
 from os.path import isdir, join
 from platform import system
 
@@ -35,8 +36,9 @@ setup(
             name="_binding",
             sources=[
                 "bindings/python/tree_sitter_cooklang/binding.c",
+                "bindings/c/cooklang_cache.c",
                 "src/parser.c",
-                # NOTE: if your language uses an external scanner, add it here.
+                "src/scanner.c",
             ],
             extra_compile_args=[
                 "-std=c11",
@@ -47,8 +49,8 @@ setup(
             define_macros=[
                 ("Py_LIMITED_API", "0x03080000"),
                 ("PY_SSIZE_T_CLEAN", None)
-            ],
-            include_dirs=["src"],
+            ] + ([("COOKLANG_SCANNER_STATS", None)] if environ.get("COOKLANG_SCANNER_STATS") else []),
+            include_dirs=["src", "bindings/c"],
             py_limited_api=True,
         )
     ],
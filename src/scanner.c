@@ -1,9 +1,11 @@
 #include "tree_sitter/parser.h"
+#include "tree_sitter/alloc.h"
+#include "scanner_stats.h"
+#include "scanner_unicode.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <wctype.h>
-#include <stdlib.h>
 
 enum TokenType {
     NEWLINE,
@@ -19,13 +21,17 @@ enum TokenType {
     COMMENT_BLOCK,
     RECIPE_NOTE_TEXT,
     WHITESPACE_TOKEN,
-    EOF
+    EOF_TOKEN
 };
 
+// Tokens shorter than this are collected without touching the heap.
+#define BUFFER_INLINE_CAPACITY 256
+
 typedef struct {
     uint32_t length;
     uint32_t capacity;
     char *data;
+    char inline_data[BUFFER_INLINE_CAPACITY];
 } Buffer;
 
 typedef struct {
@@ -33,16 +39,28 @@ typedef struct {
     bool in_metadata;
     bool at_line_start;
     int paren_depth;
+#ifdef COOKLANG_SCANNER_STATS
+    int branch;
+#endif
 } Scanner;
 
+#ifdef COOKLANG_SCANNER_STATS
+#define STATS_BRANCH(scanner, token) stats_branch(scanner, token)
+static inline void stats_branch(Scanner *scanner, enum TokenType token);
+#else
+#define STATS_BRANCH(scanner, token) ((void)0)
+#endif
+
 static inline void buffer_init(Buffer *buffer) {
     buffer->length = 0;
-    buffer->capacity = 16;
-    buffer->data = malloc(buffer->capacity);
+    buffer->capacity = BUFFER_INLINE_CAPACITY;
+    buffer->data = buffer->inline_data;
 }
 
 static inline void buffer_free(Buffer *buffer) {
-    free(buffer->data);
+    if (buffer->data != buffer->inline_data) {
+        ts_free(buffer->data);
+    }
 }
 
 static inline void buffer_grow(Buffer *buffer, uint32_t min_capacity) {
@@ -50,7 +68,12 @@ static inline void buffer_grow(Buffer *buffer, uint32_t min_capacity) {
     while (new_capacity < min_capacity) {
         new_capacity *= 2;
     }
-    buffer->data = realloc(buffer->data, new_capacity);
+    if (buffer->data == buffer->inline_data) {
+        buffer->data = ts_malloc(new_capacity);
+        memcpy(buffer->data, buffer->inline_data, buffer->length);
+    } else {
+        buffer->data = ts_realloc(buffer->data, new_capacity);
+    }
     buffer->capacity = new_capacity;
 }
 
@@ -65,13 +88,18 @@ static inline void buffer_clear(Buffer *buffer) {
     buffer->length = 0;
 }
 
+// Beyond ASCII, letters, marks and numbers are word characters, while
+// spaces, dashes and other punctuation end a word (see scanner_unicode.h,
+// generated by bindings/c/generate_unicode.js).
 static inline bool is_word_char(int32_t c) {
-    return (c >= 'a' && c <= 'z') ||
-           (c >= 'A' && c <= 'Z') ||
-           (c >= '0' && c <= '9') ||
-           c == '_' || c == '-' ||
-           c == '\'' || c == '"' ||
-           c > 127; // Unicode characters
+    if (c < 128) {
+        return (c >= 'a' && c <= 'z') ||
+               (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') ||
+               c == '_' || c == '-' ||
+               c == '\'' || c == '"';
+    }
+    return unicode_is_word(c);
 }
 
 static inline bool is_whitespace(int32_t c) {
@@ -191,7 +219,7 @@ static bool scan_text_until(TSLexer *lexer, Buffer *buffer, const char *delimite
 }
 
 void *tree_sitter_cooklang_external_scanner_create() {
-    Scanner *scanner = malloc(sizeof(Scanner));
+    Scanner *scanner = ts_malloc(sizeof(Scanner));
     buffer_init(&scanner->buffer);
     scanner->in_metadata = false;
     scanner->at_line_start = true;
@@ -202,7 +230,7 @@ void *tree_sitter_cooklang_external_scanner_create() {
 void tree_sitter_cooklang_external_scanner_destroy(void *payload) {
     Scanner *scanner = (Scanner *)payload;
     buffer_free(&scanner->buffer);
-    free(scanner);
+    ts_free(scanner);
 }
 
 unsigned tree_sitter_cooklang_external_scanner_serialize(void *payload, char *buffer) {
@@ -222,11 +250,54 @@ void tree_sitter_cooklang_external_scanner_deserialize(void *payload, const char
     }
 }
 
-bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, const bool *valid_symbols) {
-    Scanner *scanner = (Scanner *)payload;
+// Whether the scanner is certain to produce a token starting at `c`, the
+// first character after a run of whitespace. Once whitespace has been
+// skipped, returning false would rewind the lexer to before it, where the
+// internal lexer has no token to offer, so anything that may fail or that
+// belongs to the internal lexer is left to the next call. This must hold
+// for any valid set, including error recovery's, where every token is.
+static inline bool scans_after_whitespace(const Scanner *scanner, int32_t c,
+                                          const bool *valid_symbols) {
+    switch (c) {
+        case '\n':
+            return valid_symbols[NEWLINE];
+        case 0:
+        case '[': case '-': case '>': case '=': case ':': case '.':
+        case '@': case '#': case '~': case '{': case '}': case '(': case ')':
+            return false;
+    }
+    if (is_word_char(c) && (valid_symbols[INGREDIENT_NAME] || valid_symbols[COOKWARE_NAME] ||
+                            valid_symbols[TIMER_NAME])) {
+        return true;
+    }
+    return valid_symbols[NOTE_CONTENT] || valid_symbols[TEXT_CONTENT] ||
+           (scanner->in_metadata && valid_symbols[METADATA_VALUE]);
+}
 
-    // Handle block comments FIRST - they have highest priority and can appear anywhere
+static bool scan(Scanner *scanner, TSLexer *lexer, const bool *valid_symbols) {
+    // Whitespace is the most common lookahead, so check it first. It is
+    // skipped as padding of the following token, which saves a call per
+    // run of whitespace whenever that token is one this scanner produces.
+    // Otherwise a zero-width whitespace token carries the padding and the
+    // next call (or the internal lexer) takes it from there. Indentation
+    // stays a token of its own: as padding of the first token in the file
+    // it would move the start of the root node past it.
+    if (is_whitespace(lexer->lookahead) && valid_symbols[WHITESPACE_TOKEN]) {
+        STATS_BRANCH(scanner, WHITESPACE_TOKEN);
+        bool indentation = scanner->at_line_start && lexer->get_column(lexer) == 0;
+        do {
+            lexer->advance(lexer, !indentation);
+        } while (is_whitespace(lexer->lookahead));
+
+        if (indentation || !scans_after_whitespace(scanner, lexer->lookahead, valid_symbols)) {
+            lexer->result_symbol = WHITESPACE_TOKEN;
+            return true;
+        }
+    }
+
+    // Handle block comments - they have highest priority and can appear anywhere
     if (lexer->lookahead == '[' && valid_symbols[COMMENT_BLOCK]) {
+        STATS_BRANCH(scanner, COMMENT_BLOCK);
         lexer->advance(lexer, false);
         if (lexer->lookahead == '-') {
             lexer->advance(lexer, false);
@@ -253,16 +324,6 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
         }
     }
 
-    // Handle whitespace as a token (for extras)
-    if (is_whitespace(lexer->lookahead) && valid_symbols[WHITESPACE_TOKEN]) {
-        lexer->result_symbol = WHITESPACE_TOKEN;
-        lexer->advance(lexer, false);
-        while (is_whitespace(lexer->lookahead)) {
-            lexer->advance(lexer, false);
-        }
-        return true;
-    }
-    
     // Skip whitespace if not handling it as a token
     while (is_whitespace(lexer->lookahead)) {
         lexer->advance(lexer, true);
@@ -275,8 +336,9 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle EOF
     if (lexer->eof(lexer)) {
-        if (valid_symbols[EOF]) {
-            lexer->result_symbol = EOF;
+        if (valid_symbols[EOF_TOKEN]) {
+            STATS_BRANCH(scanner, EOF_TOKEN);
+            lexer->result_symbol = EOF_TOKEN;
             return true;
         }
         return false;
@@ -285,6 +347,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
     // Handle newlines
     if (lexer->lookahead == '\n') {
         if (valid_symbols[NEWLINE]) {
+            STATS_BRANCH(scanner, NEWLINE);
             lexer->advance(lexer, false);
             scanner->at_line_start = true;
             lexer->result_symbol = NEWLINE;
@@ -295,6 +358,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle recipe notes (at start of line with single >)
     if (scanner->at_line_start && lexer->lookahead == '>' && valid_symbols[RECIPE_NOTE_TEXT]) {
+        STATS_BRANCH(scanner, RECIPE_NOTE_TEXT);
         lexer->advance(lexer, false);
 
         // If it's not >>, it's a recipe note
@@ -322,6 +386,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle metadata (at start of line with >>)
     if (scanner->at_line_start && lexer->lookahead == '>' && valid_symbols[METADATA_KEY]) {
+        STATS_BRANCH(scanner, METADATA_KEY);
         lexer->advance(lexer, false);
         if (lexer->lookahead == '>') {
             lexer->advance(lexer, false);
@@ -357,6 +422,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle metadata value (after colon in metadata line)
     if (scanner->in_metadata && valid_symbols[METADATA_VALUE]) {
+        STATS_BRANCH(scanner, METADATA_VALUE);
         // Skip the colon if present
         if (lexer->lookahead == ':') {
             lexer->advance(lexer, false);
@@ -383,6 +449,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle section headers (at start of line with =)
     if (scanner->at_line_start && lexer->lookahead == '=' && valid_symbols[SECTION_NAME]) {
+        STATS_BRANCH(scanner, SECTION_NAME);
         int equals_count = 0;
         while (lexer->lookahead == '=') {
             equals_count++;
@@ -422,6 +489,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle comments (both at line start and inline)
     if (lexer->lookahead == '-' && valid_symbols[COMMENT_LINE]) {
+        STATS_BRANCH(scanner, COMMENT_LINE);
         // Check if this could be frontmatter (--- at line start)
         if (scanner->at_line_start && lexer->get_column(lexer) == 0) {
             // Peek ahead to see if it's ---
@@ -490,6 +558,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle ingredient names (after @)
     if (valid_symbols[INGREDIENT_NAME]) {
+        STATS_BRANCH(scanner, INGREDIENT_NAME);
         // Check for recipe reference (starts with . and / or \)
         if (lexer->lookahead == '.') {
             buffer_clear(&scanner->buffer);
@@ -525,6 +594,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle cookware names (after #)
     if (valid_symbols[COOKWARE_NAME]) {
+        STATS_BRANCH(scanner, COOKWARE_NAME);
         if (scan_multiword(lexer, &scanner->buffer)) {
             scanner->at_line_start = false;
             lexer->result_symbol = COOKWARE_NAME;
@@ -534,6 +604,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle timer names (after ~)
     if (valid_symbols[TIMER_NAME]) {
+        STATS_BRANCH(scanner, TIMER_NAME);
         if (scan_multiword(lexer, &scanner->buffer)) {
             scanner->at_line_start = false;
             lexer->result_symbol = TIMER_NAME;
@@ -543,6 +614,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle note content (inside parentheses)
     if (valid_symbols[NOTE_CONTENT]) {
+        STATS_BRANCH(scanner, NOTE_CONTENT);
         buffer_clear(&scanner->buffer);
         int paren_depth = scanner->paren_depth;
 
@@ -577,6 +649,7 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     // Handle plain text content
     if (valid_symbols[TEXT_CONTENT]) {
+        STATS_BRANCH(scanner, TEXT_CONTENT);
         // Don't start text with special line starters
         if (scanner->at_line_start) {
             if (lexer->lookahead == '-' || lexer->lookahead == '=' || lexer->lookahead == '[') {
@@ -604,3 +677,187 @@ bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, c
 
     return false;
 }
+
+#ifdef COOKLANG_SCANNER_STATS
+
+#include <stdlib.h>
+
+#define TOKEN_TYPE_COUNT (EOF_TOKEN + 1)
+#define NO_BRANCH -1
+
+_Static_assert(TOKEN_TYPE_COUNT == COOKLANG_SCANNER_TOKEN_COUNT,
+               "scanner_stats.h is out of date with enum TokenType");
+
+static CooklangScannerStats stats;
+static uint64_t valid_symbol_set_calls[1u << TOKEN_TYPE_COUNT];
+
+static inline void stats_branch(Scanner *scanner, enum TokenType token) {
+    scanner->branch = token;
+    stats.tokens[token].calls++;
+}
+
+// Sits between the parser's lexer and the scanner to measure how far each
+// scan moves: `position` counts the bytes advanced over, and the token
+// starts after the last skipped character.
+typedef struct {
+    TSLexer base;
+    TSLexer *inner;
+    uint32_t position;
+    uint32_t token_start;
+    uint32_t token_end;
+    bool advanced;
+    bool marked;
+} StatsLexer;
+
+static inline uint32_t utf8_length(int32_t c) {
+    return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+}
+
+static void stats_advance(TSLexer *lexer, bool skip) {
+    StatsLexer *self = (StatsLexer *)lexer;
+    if (!self->inner->eof(self->inner)) {
+        self->position += utf8_length(self->inner->lookahead);
+    }
+    self->inner->advance(self->inner, skip);
+    self->base.lookahead = self->inner->lookahead;
+    self->advanced = true;
+    if (skip) {
+        self->token_start = self->position;
+    }
+}
+
+static void stats_mark_end(TSLexer *lexer) {
+    StatsLexer *self = (StatsLexer *)lexer;
+    self->inner->mark_end(self->inner);
+    self->token_end = self->position;
+    self->marked = true;
+}
+
+static uint32_t stats_get_column(TSLexer *lexer) {
+    StatsLexer *self = (StatsLexer *)lexer;
+    return self->inner->get_column(self->inner);
+}
+
+static bool stats_is_at_included_range_start(const TSLexer *lexer) {
+    const StatsLexer *self = (const StatsLexer *)lexer;
+    return self->inner->is_at_included_range_start(self->inner);
+}
+
+static bool stats_eof(const TSLexer *lexer) {
+    const StatsLexer *self = (const StatsLexer *)lexer;
+    return self->inner->eof(self->inner);
+}
+
+static void stats_log(const TSLexer *lexer, const char *format, ...) {
+    (void)lexer;
+    (void)format;
+}
+
+static bool scan_with_stats(Scanner *scanner, TSLexer *lexer, const bool *valid_symbols) {
+    uint32_t valid_set = 0;
+    for (int i = 0; i < TOKEN_TYPE_COUNT; i++) {
+        valid_set |= (uint32_t)valid_symbols[i] << i;
+    }
+    valid_symbol_set_calls[valid_set]++;
+    stats.calls++;
+
+    StatsLexer stats_lexer = {
+        .base = {
+            .lookahead = lexer->lookahead,
+            .advance = stats_advance,
+            .mark_end = stats_mark_end,
+            .get_column = stats_get_column,
+            .is_at_included_range_start = stats_is_at_included_range_start,
+            .eof = stats_eof,
+            .log = stats_log,
+        },
+        .inner = lexer,
+    };
+    scanner->branch = NO_BRANCH;
+    bool result = scan(scanner, &stats_lexer.base, valid_symbols);
+
+    if (result) {
+        lexer->result_symbol = stats_lexer.base.result_symbol;
+        uint32_t end = stats_lexer.marked ? stats_lexer.token_end : stats_lexer.position;
+        CooklangScannerTokenStats *token = &stats.tokens[lexer->result_symbol];
+        token->successes++;
+        token->bytes += end > stats_lexer.token_start ? end - stats_lexer.token_start : 0;
+    } else if (stats_lexer.advanced) {
+        stats.false_after_advance++;
+        if (scanner->branch != NO_BRANCH) {
+            stats.tokens[scanner->branch].false_after_advance++;
+        }
+    }
+    return result;
+}
+
+void cooklang_scanner_stats(CooklangScannerStats *result) {
+    *result = stats;
+}
+
+static int compare_valid_symbol_sets(const void *a, const void *b) {
+    uint64_t left = ((const CooklangValidSymbolSet *)a)->calls;
+    uint64_t right = ((const CooklangValidSymbolSet *)b)->calls;
+    return left < right ? 1 : left > right ? -1 : 0;
+}
+
+uint32_t cooklang_scanner_valid_symbol_sets(CooklangValidSymbolSet *sets, uint32_t capacity) {
+    uint32_t count = 0;
+    for (uint32_t mask = 0; mask < (1u << TOKEN_TYPE_COUNT); mask++) {
+        count += valid_symbol_set_calls[mask] > 0;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    CooklangValidSymbolSet *all = ts_malloc(count * sizeof(CooklangValidSymbolSet));
+    if (!all) {
+        return 0;
+    }
+    uint32_t index = 0;
+    for (uint32_t mask = 0; mask < (1u << TOKEN_TYPE_COUNT); mask++) {
+        if (valid_symbol_set_calls[mask] > 0) {
+            all[index].valid_symbols = mask;
+            all[index].calls = valid_symbol_set_calls[mask];
+            index++;
+        }
+    }
+    qsort(all, count, sizeof(CooklangValidSymbolSet), compare_valid_symbol_sets);
+    memcpy(sets, all, (count < capacity ? count : capacity) * sizeof(CooklangValidSymbolSet));
+    ts_free(all);
+    return count;
+}
+
+void cooklang_scanner_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+    memset(valid_symbol_set_calls, 0, sizeof(valid_symbol_set_calls));
+}
+
+const char *cooklang_scanner_token_name(uint32_t token) {
+    static const char *const names[] = {
+        [NEWLINE] = "_newline",
+        [INGREDIENT_NAME] = "ingredient_name",
+        [COOKWARE_NAME] = "cookware_name",
+        [TIMER_NAME] = "timer_name",
+        [TEXT_CONTENT] = "text_content",
+        [NOTE_CONTENT] = "note_content",
+        [METADATA_KEY] = "metadata_key",
+        [METADATA_VALUE] = "metadata_value",
+        [SECTION_NAME] = "section_name",
+        [COMMENT_LINE] = "comment_line",
+        [COMMENT_BLOCK] = "comment_block",
+        [RECIPE_NOTE_TEXT] = "recipe_note_text",
+        [WHITESPACE_TOKEN] = "_whitespace_token",
+        [EOF_TOKEN] = "_eof",
+    };
+    return token < sizeof(names) / sizeof(names[0]) ? names[token] : NULL;
+}
+
+#endif
+
+bool tree_sitter_cooklang_external_scanner_scan(void *payload, TSLexer *lexer, const bool *valid_symbols) {
+#ifdef COOKLANG_SCANNER_STATS
+    return scan_with_stats((Scanner *)payload, lexer, valid_symbols);
+#else
+    return scan((Scanner *)payload, lexer, valid_symbols);
+#endif
+}
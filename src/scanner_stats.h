@@ -0,0 +1,62 @@
+#ifndef TREE_SITTER_COOKLANG_SCANNER_STATS_H_
+#define TREE_SITTER_COOKLANG_SCANNER_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Counters for the external scanner, collected when src/scanner.c is built
+// with COOKLANG_SCANNER_STATS defined. Without it the scanner is compiled
+// exactly as before and the functions below are neither declared nor
+// exported, so callers guard their use with the same define.
+//
+// The counters are process-wide and not synchronised: collect them while
+// parsing on one thread at a time.
+
+// One entry per external token, in the order of `externals` in grammar.js.
+#define COOKLANG_SCANNER_TOKEN_COUNT 14
+
+typedef struct {
+    uint64_t calls;               // scans that tried this token's branch
+    uint64_t successes;           // scans that returned this token
+    uint64_t bytes;               // total length of the returned tokens
+    uint64_t false_after_advance; // scans that advanced in this branch, then failed
+} CooklangScannerTokenStats;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t false_after_advance;
+    CooklangScannerTokenStats tokens[COOKLANG_SCANNER_TOKEN_COUNT];
+} CooklangScannerStats;
+
+// A combination of `valid_symbols` the parser passed to the scanner, as a
+// bit mask indexed like `tokens` above.
+typedef struct {
+    uint32_t valid_symbols;
+    uint64_t calls;
+} CooklangValidSymbolSet;
+
+#ifdef COOKLANG_SCANNER_STATS
+
+// Copies the counters into `stats`.
+void cooklang_scanner_stats(CooklangScannerStats *stats);
+
+// Writes up to `capacity` of the `valid_symbols` combinations seen so far,
+// most frequent first, and returns how many distinct combinations there are.
+uint32_t cooklang_scanner_valid_symbol_sets(CooklangValidSymbolSet *sets, uint32_t capacity);
+
+void cooklang_scanner_stats_reset(void);
+
+// The grammar name of external token `token`, or NULL if out of range.
+const char *cooklang_scanner_token_name(uint32_t token);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_COOKLANG_SCANNER_STATS_H_
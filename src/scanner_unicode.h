@@ -0,0 +1,549 @@
+// Generated by generate_unicode.js from the Unicode 16.0 data in Node. Do not edit.
+
+#ifndef TREE_SITTER_COOKLANG_SCANNER_UNICODE_H_
+#define TREE_SITTER_COOKLANG_SCANNER_UNICODE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// No word characters at or above this code point.
+#define UNICODE_WORD_LIMIT 0xE0200
+#define UNICODE_WORD_BLOCK_COUNT 148
+
+static const uint8_t UNICODE_WORD_STAGE1[UNICODE_WORD_LIMIT >> 8] = {
+    0, 1, 1, 2, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+    14, 1, 15, 16, 17, 1, 18, 19, 20, 21, 22, 23, 24, 1, 1, 25,
+    26, 27, 28, 29, 30, 31, 32, 33, 1, 28, 28, 34, 35, 36, 37, 38,
+    39, 40, 41, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 42, 1, 43, 44, 45, 46, 47, 48, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 49, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 1, 50, 51, 1, 52, 53, 54,
+    55, 56, 57, 58, 59, 60, 1, 61, 62, 63, 64, 65, 66, 67, 68, 69,
+    70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85,
+    1, 1, 1, 86, 87, 88, 28, 28, 28, 28, 28, 28, 28, 28, 28, 89,
+    1, 1, 1, 1, 90, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 91, 1, 1, 92, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 93, 28, 28, 28, 28, 28, 28, 1, 1, 94, 95, 28, 96, 97, 98,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 99, 1, 1, 1, 1, 100, 101, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 102,
+    1, 103, 104, 28, 28, 28, 28, 28, 28, 28, 28, 28, 105, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 106, 1, 107, 108,
+    109, 110, 111, 112, 113, 114, 115, 116, 1, 1, 117, 28, 28, 28, 28, 118,
+    119, 120, 121, 28, 122, 123, 28, 124, 125, 126, 28, 28, 127, 128, 129, 28,
+    130, 131, 132, 1, 1, 1, 133, 134, 135, 1, 136, 137, 28, 28, 28, 28,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 138, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 139, 140, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 141, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 142, 1, 1, 143, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 1, 1, 144, 28, 28, 28, 28, 28,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 145, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 146, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 147,
+};
+
+static const uint32_t UNICODE_WORD_STAGE2[UNICODE_WORD_BLOCK_COUNT][8] = {
+    {0x00000000, 0x03FF2084, 0x87FFFFFE, 0x07FFFFFE,
+     0x00000000, 0x773DC77C, 0xFF7FFFFF, 0xFF7FFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xBCFFFFFF,
+     0xFFFFD770, 0xFFFFFFFB, 0xFFFFFFFF, 0xFFBFFFFF},
+    {0xFFFFFFFF, 0xFFFEFFFF, 0x027FFFFF, 0xFFFFFFFF,
+     0xFFFEE1FF, 0xBFFFFFFF, 0xFFFF00B6, 0x000787FF},
+    {0x07FFC800, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFC3FF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xDFEFFFFF, 0xFFFFFFFF},
+    {0xFFFF0000, 0xFFFFFFFF, 0xFFFFE7FF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0x0003FFFF, 0xFFFFFFFF, 0xE47FFFFF},
+    {0xFFFFFFFF, 0x00003FFF, 0x0FFFFFFF, 0xFFFF07FF,
+     0xFF807FFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFB},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFEFFCF,
+     0xFFF99FEF, 0xF3C5FDFF, 0xB080799F, 0x5FFFFFCF},
+    {0xFFF987EE, 0xD36DFDFF, 0x5E023987, 0x003FFFC0,
+     0xFFFBBFEE, 0xF3EDFDFF, 0x00013BBF, 0xFE02FFCF},
+    {0xFFF99FEE, 0xF3EDFDFF, 0xB0E0399F, 0x00FFFFCF,
+     0xD63DC7EC, 0xC3FFC718, 0x00813DC7, 0x07FFFFC0},
+    {0xFFFDDFFF, 0xF3FFFDFF, 0x27603DDF, 0xFF00FFCF,
+     0xFFFDDFEF, 0xF3EFFDFF, 0x60603DDF, 0x000EFFCF},
+    {0xFFFDDFFF, 0xFFFFFFFF, 0xFFF0FDDF, 0xFFFFFFCF,
+     0xFC7FFFEE, 0x2FFBFFFF, 0xFF5F847F, 0x000CFFC0},
+    {0xFFFFFFFE, 0x87FFFFFF, 0x03FF7FFF, 0x00000000,
+     0xFFFFF7D6, 0x3FFFFFAF, 0xF3FF7F5F, 0x00000000},
+    {0xFFE8000F, 0xC3FFFFFF, 0xFFFFFEFF, 0xFFFE1FFF,
+     0xFEFFFFDF, 0xDFFFFFFF, 0x01E0DFFF, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF03FF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF20BF, 0xF7FFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x3D7F3DFF, 0xFFFFFFFF,
+     0xFFFF3DFF, 0x7F3DFFFF, 0xFF7FFF3D, 0xFFFFFFFF},
+    {0xFF3DFFFF, 0xFFFFFFFF, 0xE7FFFFFF, 0x1FFFFE00,
+     0x03FFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x3F3FFFFF},
+    {0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFBFFF,
+     0x07FFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0x01FFC7FF},
+    {0x803FFFFF, 0x001FFFFF, 0x000FFFFF, 0x000DDFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x388FFFFF, 0x03FF03FF},
+    {0x03FFB800, 0xFFFFFFFF, 0xFFFFFFFF, 0x01FFFFFF,
+     0xFFFFFFFF, 0xFFFF07FF, 0xFFFFFFFF, 0x003FFFFF},
+    {0x7FFFFFFF, 0x0FFF0FFF, 0xFFFFFFC1, 0x001F3FFF,
+     0xFFFFFFFF, 0xFFFF0FFF, 0xC7FF03FF, 0xFFFFFFFF},
+    {0x0FFFFFFF, 0xFFFFFFFF, 0x7FFFFFFF, 0x9FFFFFFF,
+     0x03FF03FF, 0xFFFF0080, 0x00007FFF, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x03FF1FFF, 0x1FFFFFFE,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000FFFFF},
+    {0xFFFFFFFF, 0x00FFFFFF, 0xFFFFE3FF, 0x3FFFFFFF,
+     0xFFFF07FF, 0xE7FFFFFF, 0xFFF70000, 0x07FFFFFF},
+    {0x3F3FFFFF, 0xFFFFFFFF, 0xAAFF3F3F, 0x3FFFFFFF,
+     0xFFFFFFFF, 0xFFDFFFFF, 0xEFCFFFDF, 0x7FDCFFFF},
+    {0x02003000, 0x80000000, 0x00100001, 0x83F30000,
+     0x1FFF03FF, 0xFFFFFFFF, 0xFFFF0001, 0x0001FFFF},
+    {0xFEFFFFFF, 0xFFFFFFFF, 0xFFFFF7E0, 0xFFFFFFFF,
+     0xF3E00FFF, 0xFFFFBFB6, 0xFFEB3FFF, 0x000FFFFF},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFF0FF, 0xFFFFF9FC, 0xFFFFFFFF, 0xEFFFFFFF,
+     0x07FFFFFF, 0xFFF00000, 0x0FFFFFFF, 0xFFFFFFFC},
+    {0xFFFFFFFF, 0x000003FF, 0x000007FF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFF7FFFFF, 0xFFFFFFFD, 0x00FFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF7FFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFC000FF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0x0000FFFF, 0xFFFFE060, 0xFFCFFFFF,
+     0xFFBFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x200FFFFF},
+    {0xFFFFFFFF, 0xFFFF20BF, 0xFFFFFFFF, 0x800080FF,
+     0x007FFFFF, 0x7F7F7F7F, 0x7F7F7F7F, 0xFFFFFFFF},
+    {0x00000000, 0x00008000, 0x00030000, 0x00000000,
+     0xFBFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000FFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x003FFFFF, 0xFFFF0000},
+    {0x000C00F0, 0xDFFEFFFF, 0xFFFFFFFE, 0xFFFFFFFF,
+     0xFE7FFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0xF7FFFFFF},
+    {0xFFFFFFE0, 0xFFFEFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFF7FFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF803F},
+    {0x7FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFF1FFF, 0xFFFFFFFF, 0xFFFF007F, 0x3FFFFFFF},
+    {0xFFFF1FFF, 0x00000FFF, 0xFFFFFFFF, 0xBFF7FFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0003FFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x1FEB3FFF, 0xFFFC0000},
+    {0xFFFFFFFF, 0x03FF1FFF, 0xFFFFFFFF, 0x000FFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x03FF003F, 0xE8FFFFFF},
+    {0xFFFFFFFF, 0xFFFF3FFF, 0x000FFFFF, 0x1FFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x03FF8001, 0x7FFFFFFF},
+    {0xFFFFFFFF, 0x007FFFFF, 0x03FF3FFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x38000007, 0x007CFFFF},
+    {0x007E7E7E, 0xFFFF7F7F, 0xFFFFFFFF, 0xFFFF0FFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FF37FF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFF000F, 0xFFFFF87F, 0x0FFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF3FFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x03FFFFFF, 0x00000000},
+    {0xE0F8007F, 0x5F7FFDFF, 0xFFFFFFDB, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFF80007, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0x3FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFCFFFF, 0xFFFFFFFF, 0x000080FF, 0xFFFF0000},
+    {0x0000FFFF, 0x0018FFFF, 0x0000E000, 0xFFDF0200,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x1FFFFFFF},
+    {0x03FF0010, 0xC7FFFFFE, 0x07FFFFFF, 0xFFFFFFC0,
+     0xFFFFFFFF, 0x7FFFFFFF, 0x1CFCFCFC, 0x1000617B},
+    {0xFFFFEFFF, 0xB7FFFF7F, 0x3FFF3FFF, 0x00000000,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x07FFFFFF},
+    {0xFFFFFF80, 0xFF8FFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0x1FFF7FFF, 0x00000001, 0xFFFF0000, 0x3FFFFFFF},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x1FFFFFFF, 0xFFFFFFFF, 0x0001FFFF, 0x0FFFFFFF},
+    {0xFFFFFFFF, 0xFFFFE00F, 0xFFFF07FF, 0x07FFFFFF,
+     0x3FFFFFFF, 0xFFFFFFFF, 0x003EFF0F, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0x3FFFFFFF, 0xFFFF03FF, 0xFF0FFFFF, 0x0FFFFFFF},
+    {0xFFFFFFFF, 0xFFFF00FF, 0xFFFFFFFF, 0xF7FF000F,
+     0xFFB7F7FF, 0x1BFBFFFB, 0xFFFFFFFF, 0x000FFFFF},
+    {0xFFFFFFFF, 0x007FFFFF, 0x003FFFFF, 0x000000FF,
+     0xFFFFFFBF, 0x07FDFFFF, 0x00000000, 0x00000000},
+    {0xFFFFFD3F, 0x91BFFFFF, 0xFF3FFFFF, 0xFFFFFFFF,
+     0x7FFFFFFF, 0x0000FF80, 0x00000000, 0xF837FFFF},
+    {0x0FFFFFFF, 0x03FFFFFF, 0x00000000, 0x00000000,
+     0xFFFFFFFF, 0xF0FFFFFF, 0xFFFCFFFF, 0xFFFFFFFF},
+    {0xFEEFF06F, 0x873FFFFF, 0x000001FF, 0x7FFFFFFF,
+     0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0x0000F87F},
+    {0xFFFFFFFF, 0x003FFFFF, 0xFF3FFFFF, 0xFF07FFFF,
+     0x0003FFFF, 0x0000FE00, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x000001FF, 0x00000000,
+     0xFFFFFFFF, 0x0007FFFF, 0xFFFFFFFF, 0xFC07FFFF},
+    {0xFFFFFFFF, 0x03FF00FF, 0xFFFFFFFF, 0xFFFFBE3F,
+     0x0000003F, 0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0x00000000, 0x7FFFFFFF,
+     0xFFFFFFFF, 0x00031BFF, 0x0000001C, 0xF0000000},
+    {0xFFFFFFFF, 0xFFFF00FF, 0x001FFFFF, 0xFFFF0000,
+     0x0000003F, 0xFFFF0000, 0x00000FFF, 0x007FFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFC007F, 0x803FFFFF,
+     0xFFFFFFFF, 0x07FFFFFF, 0xFFFF0004, 0x03FF01FF},
+    {0xFFFFFFFF, 0xFFDFFFFF, 0xFFFF00F0, 0x004FFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x17FFDE1F, 0x001FFFFE},
+    {0xFFFBFFFF, 0xC0FFFFFF, 0x00000003, 0x00000000,
+     0xBFFFBD7F, 0xFFFF01FF, 0xFFFFFFFF, 0x03FF07FF},
+    {0xFFF99FEF, 0xFBEDFDFF, 0xE081399F, 0x001F1FCF,
+     0xFFFF4BFF, 0xFFBFFFFF, 0x000FF7A5, 0x00000006},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xC3FF07FF, 0x00000003,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x03FF00BF, 0x00000000},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0xFFFFFFFF, 0xFF3FFFFF, 0x3F000001, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x03FF0011, 0x00000000,
+     0xFFFFFFFF, 0x01FFFFFF, 0xFFFF03FF, 0x0000000F},
+    {0xE7FFFFFF, 0x8FFF0FFF, 0x0000007F, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0x07FFFFFF, 0x00000000, 0x00000000,
+     0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x8007FFFF},
+    {0xFF6FF27F, 0xF9BFFFFF, 0x03FF000F, 0x00000000,
+     0x00000000, 0xFFFFFCFF, 0xFCFFFFFF, 0x0000001B},
+    {0xFFFFFFFF, 0x7FFFFFFF, 0xFFFF0080, 0xFFFFFFFF,
+     0x23FFFFFF, 0xFFFF0000, 0xFFFFFFFF, 0x01FFFFFF},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0xFFFFFFFF, 0x03FF0001},
+    {0xFFFFFDFF, 0xFF7FFFFF, 0xFFFF0001, 0xFFFC1FFF,
+     0xFFFCFFFF, 0x007FFEFF, 0x00000000, 0x00000000},
+    {0xFFFFFB7F, 0xB47FFFFF, 0x03FF00FF, 0xFFFFFDBF,
+     0x01FB7FFF, 0x000003FF, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x007FFFFF},
+    {0xFFFDFFFF, 0xC7FFFFFF, 0x07FF0007, 0x00000000,
+     0x00000000, 0x00010000, 0xFFFFFFFF, 0x0003FFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0x03FFFFFF, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00007FFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x0000000F, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0xFFFF0000, 0xFFFFFFFF, 0xFFFFFFFF, 0x0001FFFF},
+    {0xFFFFFFFF, 0x0000FFFF, 0x003FFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x07FFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x0000007F, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0x03FFFFFF, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0x01FFFFFF, 0x7FFFFFFF, 0xFFFF03FF,
+     0xFFFFFFFF, 0x7FFFFFFF, 0xFFFF03FF, 0x001F3FFF},
+    {0xFFFFFFFF, 0xF07FFFFF, 0xFBFF002F, 0xE0FFFFFB,
+     0x0000FFFF, 0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0xFFFFFFFF, 0x03FF1FFF,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+     0x007FFFFF, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF87FF, 0xFFFFFFFF,
+     0xFFFF80FF, 0x00000000, 0x00000000, 0x0003001B},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00FFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x003FFFFF, 0x80000000},
+    {0x000001FF, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x6FEF0000},
+    {0xFFFFFFFF, 0x00040007, 0x00270000, 0xFFFF00F0,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0FFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x1FFF07FF,
+     0x73FF01FF, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0x000FFFFF, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFF3FFF, 0xFFFF007F, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x0000000F, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x003FFFFF},
+    {0xFFFFFFFF, 0xFFFFFE7F, 0xFFFFFFFF, 0xF807FFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000007FF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x0000003F, 0x00000000,
+     0x00000000, 0x00000000, 0x000FFFFF, 0x000FFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x007FFFFF, 0x01FFFFFF,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFDFFFFF, 0xFFFFFFFF,
+     0xDFFFFFFF, 0xEBFFDE64, 0xFFFFFFEF, 0xFFFFFFFF},
+    {0xDFDFE7BF, 0x7BFFFFFF, 0xFFFDFC5F, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFF3F, 0xF7FFFFFD, 0xF7FFFFFF},
+    {0xFFDFFFFF, 0xFFDFFFFF, 0xFFFF7FFF, 0xFFFF7FFF,
+     0xFFFFFDFF, 0xFFFFFDFF, 0xFFFFCFF7, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xF800007F, 0x0000FFFE, 0x00000000, 0x00000000},
+    {0x7FFFFFFF, 0x000007E0, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xF9FFFF7F, 0xFFFF07DB, 0xFFFFFFFF, 0x00003FFF,
+     0x00008000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0x3FFF1FFF, 0x0000C3FF, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0xFFFF0000, 0x00007FFF, 0xFFFFFFFF, 0x83FFFFFF},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0xFFFF0000, 0x03FFFFFF},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0xFFFF0000, 0x07FFFFFF},
+    {0x00000000, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x7FFF6F7F},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x007FFF9F, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x03FF0FFF, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00000000, 0x00000000, 0xFFFE0000,
+     0xFFFFFFFF, 0x001FFFFF, 0x00000000, 0x00000000},
+    {0xFFFFFFFE, 0x3FFFFFFF, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFEF, 0x0AF7FE96, 0xAA96EA84, 0x5EF7F796,
+     0x0FFFFBFF, 0x0FFFFBEE, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFF0FFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0x000FFFFF, 0xFFFE7FFF, 0xFFFEFFFE, 0x003FFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0x00003FFF, 0x00000000, 0xFFFFFFC0},
+    {0xFFFF0007, 0x0FFFFFFF, 0x000301FF, 0x0000003F,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xF0FFFFFF, 0x1FFF1FFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xF87FFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0x03FFFFFF, 0x00010FFF},
+    {0xFFFF0FFF, 0xFFFFFFFF, 0x03FF00FF, 0xFFFFFFFF,
+     0xFFFF00FF, 0x0FFF3FFF, 0x00000003, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x000FFFFF, 0x1FFF3FFF,
+     0xFFFF83FF, 0xFFFFFFFF, 0x9FFFC07F, 0x01FF03FF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFF7FFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000},
+    {0xFFFFFFFF, 0x03FFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0x3FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFF0003, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF0001},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0x3FFFFFFF, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0x3FFFFFFF, 0x00000000, 0x00000000, 0x00000000,
+     0x00000000, 0x00000000, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF07FF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0x0000FFFF, 0x00000000, 0x00000000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+     0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0000FFFF},
+};
+
+static inline bool unicode_is_word(int32_t c) {
+    if (c < 0 || c >= UNICODE_WORD_LIMIT) {
+        return false;
+    }
+    const uint32_t *block =
+        UNICODE_WORD_STAGE2[UNICODE_WORD_STAGE1[c >> 8]];
+    return (block[(c >> 5) & 7] >> (c & 31)) & 1;
+}
+
+#endif // TREE_SITTER_COOKLANG_SCANNER_UNICODE_H_
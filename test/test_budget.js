@@ -0,0 +1,117 @@
+// Budgeted parsing under mixed traffic: ordinary recipes from the test
+// corpus with adversarial inputs (the former hanging bugs, and generated
+// inputs that are huge, deeply unbalanced or one endless line) mixed in.
+// Every parse gets the same budget; the 99th percentile latency must stay
+// within the hard stop of twice the timeout, and ordinary recipes must
+// parse completely.
+
+const Parser = require('tree-sitter');
+const Cooklang = require('../bindings/node');
+const fs = require('fs');
+const path = require('path');
+
+const TIMEOUT_MS = 20;
+const MAX_BYTES = 256 * 1024;
+const REQUESTS = 2000;
+const ADVERSARIAL_EVERY = 20;
+// Timer and scheduling noise on a loaded machine.
+const SLACK_MS = 10;
+
+function loadCorpus(directory, files = []) {
+  for (const entry of fs.readdirSync(directory, { withFileTypes: true })) {
+    const file = path.join(directory, entry.name);
+    if (entry.isDirectory()) {
+      loadCorpus(file, files);
+    } else if (entry.name.endsWith('.cook')) {
+      files.push({ name: path.relative(__dirname, file), source: fs.readFileSync(file, 'utf8') });
+    }
+  }
+  return files;
+}
+
+const corpus = loadCorpus(path.join(__dirname, 'individual_tests'));
+const normal = corpus.filter(file => !file.name.includes('hanging_bugs'));
+const adversarial = [
+  ...corpus.filter(file => file.name.includes('hanging_bugs')),
+  { name: 'hyphen words', source: 'a - b - c -- d --- '.repeat(50000) },
+  { name: 'unclosed braces', source: '@a{'.repeat(100000) },
+  { name: 'nested braces', source: '{'.repeat(200000) + '}'.repeat(200000) },
+  { name: 'open frontmatter', source: '---\n' + 'key: - value -\n'.repeat(50000) },
+  { name: 'one long line', source: 'Add @salt{1%tsp} and ~{2%min} '.repeat(40000) },
+];
+
+const parser = new Parser();
+parser.setLanguage(Cooklang);
+
+let failures = 0;
+function check(passed, description) {
+  console.log(`${passed ? '✅' : '❌'} ${description}`);
+  if (!passed) {
+    failures++;
+  }
+}
+
+const latencies = { normal: [], adversarial: [] };
+const statuses = { complete: 0, budgetExceeded: 0, cancelled: 0 };
+const incomplete = [];
+for (let i = 0; i < REQUESTS; i++) {
+  const isAdversarial = i % ADVERSARIAL_EVERY === 0;
+  const pool = isAdversarial ? adversarial : normal;
+  const input = pool[Math.floor(i / ADVERSARIAL_EVERY) % pool.length];
+  const start = performance.now();
+  const result = Cooklang.parseWithBudget(parser, input.source,
+                                          { maxBytes: MAX_BYTES, timeoutMs: TIMEOUT_MS });
+  latencies[isAdversarial ? 'adversarial' : 'normal'].push(performance.now() - start);
+  statuses[result.status]++;
+  if (!isAdversarial && result.status !== 'complete') {
+    incomplete.push(input.name);
+  }
+}
+
+function percentile(samples, fraction) {
+  const sorted = [...samples].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * fraction))];
+}
+
+for (const [kind, samples] of Object.entries(latencies)) {
+  console.log(`${kind.padEnd(12)} p50 ${percentile(samples, 0.5).toFixed(2)} ms  ` +
+              `p99 ${percentile(samples, 0.99).toFixed(2)} ms  ` +
+              `max ${Math.max(...samples).toFixed(2)} ms`);
+}
+console.log(`statuses: ${JSON.stringify(statuses)}`);
+console.log();
+
+const all = [...latencies.normal, ...latencies.adversarial];
+check(percentile(all, 0.99) <= 2 * TIMEOUT_MS + SLACK_MS,
+      `p99 latency within ${2 * TIMEOUT_MS + SLACK_MS} ms`);
+check(incomplete.length === 0,
+      `ordinary recipes parse completely${incomplete.length ? ` (not: ${[...new Set(incomplete)].join(', ')})` : ''}`);
+
+const huge = 'Add @salt{}.\n'.repeat(100000);
+const truncated = Cooklang.parseWithBudget(parser, huge, { maxBytes: 1000 });
+check(truncated.status === 'budgetExceeded' && truncated.tree.rootNode.endIndex <= 1000,
+      'input beyond the byte budget is not parsed');
+const cancelled = Cooklang.parseWithBudget(parser, huge, { isCancelled: () => true });
+check(cancelled.status === 'cancelled' && cancelled.tree === null, 'cancelled parses have no tree');
+
+// Cancelling reaches the runtime only through progressCallback, so these
+// fail on a tree-sitter that ignores it. Each hanging input is repeated so
+// that the parse runs long enough for the callback to be called.
+for (const input of corpus.filter(file => file.name.includes('hanging_bugs'))) {
+  let asked = 0;
+  const isCancelled = () => {
+    asked++;
+    return true;
+  };
+  const result = Cooklang.parseWithBudget(parser, input.source.repeat(50), { isCancelled });
+  check(asked > 0 && result.status === 'cancelled' && result.tree === null,
+        `${input.name} is cancelled through the progress callback`);
+}
+
+const after = Cooklang.parseWithBudget(parser, 'Add @salt{}.\n');
+check(after.status === 'complete' && !after.tree.rootNode.hasError,
+      'the parser is reusable after a cancelled parse');
+
+if (failures > 0) {
+  process.exit(1);
+}
@@ -0,0 +1,57 @@
+"""Budgeted parsing through the real py-tree-sitter binding.
+
+The inputs from test/individual_tests/hanging_bugs are parsed with
+parse_with_budget: cancelled through the progress callback, stopped by
+the timeout and cut by the byte budget. Cancelling needs py-tree-sitter
+0.25 or later, so an older one fails here rather than passing unnoticed.
+
+    pip install .[core] && python test/test_budget.py
+"""
+
+import sys
+import threading
+from pathlib import Path
+
+from tree_sitter import Language, Parser
+
+import tree_sitter_cooklang as cooklang
+from tree_sitter_cooklang import ParseStatus, parse_with_budget
+
+HANGING_BUGS = Path(__file__).parent / "individual_tests" / "hanging_bugs"
+
+failures = 0
+
+
+def check(passed, description):
+    global failures
+    print(f"{'✅' if passed else '❌'} {description}")
+    if not passed:
+        failures += 1
+
+
+parser = Parser(Language(cooklang.language()))
+
+for path in sorted(HANGING_BUGS.glob("*.cook")):
+    # Repeated so that the parse runs long enough for the callback to be
+    # called.
+    source = path.read_bytes() * 50
+
+    cancel = threading.Event()
+    cancel.set()
+    result = parse_with_budget(parser, source, cancel=cancel)
+    check(result.status is ParseStatus.CANCELLED and result.tree is None,
+          f"{path.name} is cancelled through the progress callback")
+
+    result = parse_with_budget(parser, source, timeout=0)
+    check(result.status is ParseStatus.BUDGET_EXCEEDED and result.tree is not None,
+          f"{path.name} stops at the timeout with a partial tree")
+
+    result = parse_with_budget(parser, source, max_bytes=100)
+    check(result.status is ParseStatus.BUDGET_EXCEEDED and result.tree.root_node.end_byte <= 100,
+          f"{path.name} is not parsed beyond the byte budget")
+
+result = parse_with_budget(parser, b"Add @salt{}.\n")
+check(result.status is ParseStatus.COMPLETE and not result.tree.root_node.has_error,
+      "the parser is reusable after a cancelled parse")
+
+sys.exit(1 if failures else 0)
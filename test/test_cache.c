@@ -0,0 +1,227 @@
+// The content-addressed cache in bindings/c: hits and misses by content,
+// least recently used eviction under the capacity, entries outliving their
+// eviction while referenced, concurrent use, and the parsed recipe layer.
+
+#include "cooklang_parse_cache.h"
+#include "tree-sitter-cooklang.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+#define LIVE 0x600dcafe
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+typedef struct {
+    uint32_t magic;
+    uint32_t number;
+} Value;
+
+static void destroy_value(void *value, void *payload) {
+    ((Value *)value)->magic = 0;
+    free(value);
+    atomic_fetch_add((atomic_uint *)payload, 1);
+}
+
+static Value *new_value(uint32_t number) {
+    Value *value = malloc(sizeof(Value));
+    value->magic = LIVE;
+    value->number = number;
+    return value;
+}
+
+static CooklangCacheEntry *lookup(CooklangCache *cache, const char *key) {
+    return cooklang_cache_lookup(cache, key, (uint32_t)strlen(key));
+}
+
+static CooklangCacheEntry *insert(CooklangCache *cache, const char *key, uint32_t number,
+                                  uint64_t size) {
+    return cooklang_cache_insert(cache, key, (uint32_t)strlen(key), new_value(number), size);
+}
+
+static uint32_t number(const CooklangCacheEntry *entry) {
+    return ((const Value *)entry->value)->number;
+}
+
+static void test_hits_and_misses(void) {
+    atomic_uint destroyed = 0;
+    CooklangCache *cache = cooklang_cache_new(1 << 20, destroy_value, &destroyed);
+    check(!lookup(cache, "Add @salt{}.\n"), "an empty cache misses");
+
+    CooklangCacheEntry *entry = insert(cache, "Add @salt{}.\n", 1, 100);
+    check(entry && number(entry) == 1 && strcmp(entry->key, "Add @salt{}.\n") == 0,
+          "inserting returns the entry");
+    cooklang_cache_release(cache, entry);
+
+    char copy[] = "Add @salt{}.\n";
+    entry = lookup(cache, copy);
+    check(entry && number(entry) == 1, "equal content in another buffer hits");
+    cooklang_cache_release(cache, entry);
+    check(!lookup(cache, "Add @pepper{}.\n") && !cooklang_cache_lookup(cache, copy, 5),
+          "different content misses");
+
+    CooklangCacheEntry *again = insert(cache, "Add @salt{}.\n", 2, 100);
+    check(again && number(again) == 1 && destroyed == 1,
+          "inserting a cached key keeps the first value");
+    cooklang_cache_release(cache, again);
+
+    CooklangCacheStats stats;
+    cooklang_cache_stats(cache, &stats);
+    check(stats.hits == 1 && stats.misses == 3 && stats.evictions == 0 && stats.entries == 1 &&
+              stats.bytes == 100 + strlen("Add @salt{}.\n"),
+          "counters");
+    cooklang_cache_delete(cache);
+    check(destroyed == 2, "deleting the cache destroys its values");
+}
+
+static void test_eviction(void) {
+    atomic_uint destroyed = 0;
+    // Room for three entries of 100 bytes plus a one-byte key.
+    CooklangCache *cache = cooklang_cache_new(303, destroy_value, &destroyed);
+    cooklang_cache_release(cache, insert(cache, "a", 1, 100));
+    cooklang_cache_release(cache, insert(cache, "b", 2, 100));
+    cooklang_cache_release(cache, insert(cache, "c", 3, 100));
+    cooklang_cache_release(cache, lookup(cache, "a"));
+    cooklang_cache_release(cache, insert(cache, "d", 4, 100));
+
+    CooklangCacheEntry *a = lookup(cache, "a");
+    CooklangCacheEntry *b = lookup(cache, "b");
+    CooklangCacheStats stats;
+    cooklang_cache_stats(cache, &stats);
+    check(a && !b && stats.evictions == 1 && stats.entries == 3 && stats.bytes <= 303 &&
+              destroyed == 1,
+          "the least recently used entry is evicted");
+
+    // Three more entries push out `c`, `d` and then `a`, which must not be
+    // freed while it is referenced.
+    cooklang_cache_release(cache, insert(cache, "e", 5, 100));
+    cooklang_cache_release(cache, insert(cache, "f", 6, 100));
+    cooklang_cache_release(cache, insert(cache, "g", 7, 100));
+    check(!lookup(cache, "a") && destroyed == 3 && ((Value *)a->value)->magic == LIVE &&
+              number(a) == 1,
+          "an evicted entry lives while referenced");
+    cooklang_cache_release(cache, a);
+    check(destroyed == 4, "and is destroyed on release");
+
+    CooklangCacheEntry *huge = insert(cache, "huge", 8, 1000);
+    cooklang_cache_stats(cache, &stats);
+    check(huge && number(huge) == 8 && !lookup(cache, "huge") && stats.entries == 0 &&
+              stats.bytes == 0 && destroyed == 7,
+          "an entry larger than the capacity is not cached");
+    cooklang_cache_release(cache, huge);
+    cooklang_cache_delete(cache);
+    check(destroyed == 8, "every value is destroyed once");
+}
+
+// Threads looking up and inserting an overlapping set of keys in a cache
+// too small for all of them, checking every value they are handed.
+enum { THREAD_COUNT = 8, KEY_COUNT = 200, REQUESTS = 20000 };
+
+typedef struct {
+    CooklangCache *cache;
+    uint32_t seed;
+    uint32_t corrupt;
+} Worker;
+
+static void *run_worker(void *payload) {
+    Worker *worker = payload;
+    char key[32];
+    for (uint32_t i = 0; i < REQUESTS; i++) {
+        worker->seed = worker->seed * 1103515245u + 12345u;
+        uint32_t k = (worker->seed >> 16) % KEY_COUNT;
+        // Skew towards the low keys, as real traffic would.
+        k = k * k / KEY_COUNT;
+        snprintf(key, sizeof(key), "recipe %u", k);
+        CooklangCacheEntry *entry = lookup(worker->cache, key);
+        if (!entry) {
+            entry = insert(worker->cache, key, k, 64);
+        }
+        Value *value = entry->value;
+        worker->corrupt += value->magic != LIVE || value->number != k ||
+                           strcmp(entry->key, key) != 0;
+        cooklang_cache_release(worker->cache, entry);
+    }
+    return NULL;
+}
+
+static void test_threads(void) {
+    atomic_uint destroyed = 0;
+    CooklangCache *cache = cooklang_cache_new(KEY_COUNT / 2 * (64 + 10), destroy_value, &destroyed);
+    Worker workers[THREAD_COUNT];
+    pthread_t threads[THREAD_COUNT];
+    for (uint32_t t = 0; t < THREAD_COUNT; t++) {
+        workers[t] = (Worker){cache, t + 1, 0};
+        pthread_create(&threads[t], NULL, run_worker, &workers[t]);
+    }
+    uint32_t corrupt = 0;
+    for (uint32_t t = 0; t < THREAD_COUNT; t++) {
+        pthread_join(threads[t], NULL);
+        corrupt += workers[t].corrupt;
+    }
+    CooklangCacheStats stats;
+    cooklang_cache_stats(cache, &stats);
+    check(corrupt == 0, "threads only see live values for their key");
+    check(stats.hits + stats.misses == THREAD_COUNT * REQUESTS && stats.hits > stats.misses &&
+              stats.evictions > 0 && stats.bytes <= KEY_COUNT / 2 * (64 + 10),
+          "counters under contention");
+    cooklang_cache_delete(cache);
+    // Every miss inserted one value.
+    check(destroyed == stats.misses, "every value is destroyed once");
+}
+
+static void test_parsed_recipes(TSParser *parser) {
+    CooklangCache *cache = cooklang_parse_cache_new(1 << 20);
+    static const char RECIPE[] = "Boil @water{1%l} with @salt{} in a #pot{} for ~{10%min}.\n";
+    CooklangCacheEntry *first = cooklang_parse_cache_get(cache, parser, RECIPE, sizeof(RECIPE) - 1);
+    CooklangParsedRecipe *recipe = first ? first->value : NULL;
+    check(recipe && recipe->tree && recipe->entities.length == 4 &&
+              ts_node_end_byte(ts_tree_root_node(recipe->tree)) == sizeof(RECIPE) - 1,
+          "a miss parses and extracts");
+
+    char copy[sizeof(RECIPE)];
+    memcpy(copy, RECIPE, sizeof(RECIPE));
+    CooklangCacheEntry *second = cooklang_parse_cache_get(cache, parser, copy, sizeof(copy) - 1);
+    CooklangCacheStats stats;
+    cooklang_cache_stats(cache, &stats);
+    check(second == first && stats.hits == 1 && stats.misses == 1 &&
+              stats.bytes > sizeof(RECIPE) + COOKLANG_CACHE_NODE_BYTES,
+          "the same text is parsed once and charged per node");
+    cooklang_cache_release(cache, first);
+    cooklang_cache_release(cache, second);
+    cooklang_cache_delete(cache);
+}
+
+int main(void) {
+    printf("Cache test\n");
+    printf("======================================\n");
+
+    test_hits_and_misses();
+    test_eviction();
+    test_threads();
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    test_parsed_recipes(parser);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
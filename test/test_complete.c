@@ -0,0 +1,261 @@
+// Name completion in bindings/c: ranking by count and then alphabetically,
+// prefix normalization, incremental updates from extracted recipes, and a
+// randomized comparison against filtering and sorting every name.
+
+#include "cooklang_complete.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static void add(CooklangCompletions *completions, CooklangEntityKind kind, const char *name,
+                int32_t delta) {
+    cooklang_completions_add(completions, kind, name, (uint32_t)strlen(name), delta);
+}
+
+// Whether completing `prefix` gives exactly `expected`, a list of names
+// separated by commas, in order.
+static bool completes(const CooklangCompletions *completions, CooklangEntityKind kind,
+                      const char *prefix, const char *expected) {
+    CooklangCompletion results[16];
+    int32_t count =
+        cooklang_complete(completions, kind, prefix, (uint32_t)strlen(prefix), results, 16);
+    char joined[512] = "";
+    size_t length = 0;
+    for (int32_t i = 0; i < count; i++) {
+        length += (size_t)snprintf(joined + length, sizeof(joined) - length, "%s%s",
+                                   i ? "," : "", results[i].name);
+    }
+    if (count < 0 || strcmp(joined, expected) != 0) {
+        printf("    completing \"%s\": expected \"%s\", got \"%s\"\n", prefix, expected, joined);
+        return false;
+    }
+    return true;
+}
+
+static void test_ranking(void) {
+    CooklangCompletions completions;
+    cooklang_completions_init(&completions);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "olives", 1);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "Olive Oil", 3);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "oregano", 2);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "onion", 3);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "salt", 9);
+    add(&completions, COOKLANG_ENTITY_COOKWARE, "oven", 5);
+
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "o",
+                    "olive oil,onion,oregano,olives") &&
+              completes(&completions, COOKLANG_ENTITY_INGREDIENT, "", "salt,olive oil,onion,oregano,olives"),
+          "most frequent first, then alphabetical");
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "OLI", "olive oil,olives") &&
+              completes(&completions, COOKLANG_ENTITY_INGREDIENT, "olive ", "olive oil") &&
+              completes(&completions, COOKLANG_ENTITY_INGREDIENT, "  olive\t\to", "olive oil") &&
+              completes(&completions, COOKLANG_ENTITY_INGREDIENT, "olive oil", "olive oil"),
+          "prefixes are normalized, keeping a trailing space");
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "olive oil ", "") &&
+              completes(&completions, COOKLANG_ENTITY_INGREDIENT, "p", "") &&
+              completes(&completions, COOKLANG_ENTITY_INGREDIENT, "olx", ""),
+          "prefixes nothing starts with");
+    check(completes(&completions, COOKLANG_ENTITY_COOKWARE, "o", "oven") &&
+              completes(&completions, COOKLANG_ENTITY_TIMER, "", ""),
+          "kinds are completed separately");
+
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "olives", 4);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "olive oil", -3);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "salt", -20);
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, "never added", -1);
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "", "olives,onion,oregano"),
+          "counts go up and down, and names at zero are not offered");
+
+    CooklangCompletion results[2];
+    check(cooklang_complete(&completions, COOKLANG_ENTITY_INGREDIENT, "o", 1, results, 2) == 2 &&
+              results[0].count == 5 && results[0].length == 6 &&
+              cooklang_complete(&completions, COOKLANG_ENTITY_INGREDIENT, "o", 1, results, 0) == 0,
+          "the number of results is capped");
+
+    char long_prefix[600];
+    memset(long_prefix, 'a', sizeof(long_prefix) - 1);
+    long_prefix[sizeof(long_prefix) - 1] = '\0';
+    add(&completions, COOKLANG_ENTITY_INGREDIENT, long_prefix, 1);
+    long_prefix[400] = '\0';
+    check(cooklang_complete(&completions, COOKLANG_ENTITY_INGREDIENT, long_prefix, 400, results,
+                            2) == 1 &&
+              results[0].length == sizeof(long_prefix) - 1,
+          "long names and prefixes");
+    cooklang_completions_free(&completions);
+}
+
+// Names that are prefixes of each other, added in an order that splits
+// edges at every step.
+static void test_splits(void) {
+    static const char *const NAMES[] = {"teapot", "team", "te", "tea", "t", "teaspoon", "tear"};
+    CooklangCompletions completions;
+    cooklang_completions_init(&completions);
+    for (int i = 0; i < 7; i++) {
+        add(&completions, COOKLANG_ENTITY_COOKWARE, NAMES[i], 1);
+    }
+    check(completes(&completions, COOKLANG_ENTITY_COOKWARE, "t",
+                    "t,te,tea,team,teapot,tear,teaspoon") &&
+              completes(&completions, COOKLANG_ENTITY_COOKWARE, "tea",
+                        "tea,team,teapot,tear,teaspoon") &&
+              completes(&completions, COOKLANG_ENTITY_COOKWARE, "teap", "teapot") &&
+              completes(&completions, COOKLANG_ENTITY_COOKWARE, "teas", "teaspoon"),
+          "names that are prefixes of other names");
+    cooklang_completions_free(&completions);
+}
+
+static void add_recipe(CooklangCompletions *completions, const char *text, int32_t delta) {
+    CooklangEntityList entities;
+    cooklang_entity_list_init(&entities);
+    cooklang_extract(text, (uint32_t)strlen(text), &entities);
+    cooklang_completions_add_entities(completions, text, &entities, delta);
+    cooklang_entity_list_free(&entities);
+}
+
+static void test_recipes(void) {
+    static const char *const FIRST = "Fry the @onions{2} in @olive oil{} in a #pan{}.\n"
+                                     "Add @salt{} and wait ~resting{5%min}.\n";
+    static const char *const SECOND = "Chop the @onions{1} and @oregano{}.\n";
+    static const char *const SECOND_EDITED = "Chop the @onion{1} and @oregano{}, add @salt{}.\n";
+    CooklangCompletions completions;
+    cooklang_completions_init(&completions);
+    add_recipe(&completions, FIRST, 1);
+    add_recipe(&completions, SECOND, 1);
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "o", "onions,olive oil,oregano") &&
+              completes(&completions, COOKLANG_ENTITY_COOKWARE, "", "pan") &&
+              completes(&completions, COOKLANG_ENTITY_TIMER, "r", "resting"),
+          "names from extracted recipes");
+
+    // What an index does when the second recipe is saved again.
+    add_recipe(&completions, SECOND, -1);
+    add_recipe(&completions, SECOND_EDITED, 1);
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "", "salt,olive oil,onion,onions,oregano"),
+          "a reparsed recipe replaces its names");
+    add_recipe(&completions, FIRST, -1);
+    add_recipe(&completions, SECOND_EDITED, -1);
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "", "") &&
+              completes(&completions, COOKLANG_ENTITY_COOKWARE, "", ""),
+          "removing every recipe leaves nothing to offer");
+    add_recipe(&completions, SECOND, 1);
+    check(completes(&completions, COOKLANG_ENTITY_INGREDIENT, "o", "onions,oregano"),
+          "names come back when added again");
+    cooklang_completions_free(&completions);
+}
+
+typedef struct {
+    char name[8];
+    int32_t count;
+} Expected;
+
+static int compare_expected(const void *a, const void *b) {
+    const Expected *x = a, *y = b;
+    if (x->count != y->count) {
+        return x->count > y->count ? -1 : 1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+// Random names over a small alphabet, so that many share prefixes, with
+// random additions and removals, against filtering and sorting them all.
+static void test_random(void) {
+    enum { NAME_COUNT = 3000, UPDATES = 20000, MAX_RESULTS = 10 };
+    static Expected names[NAME_COUNT];
+    CooklangCompletions completions;
+    cooklang_completions_init(&completions);
+    srand(7);
+    for (int i = 0; i < NAME_COUNT; i++) {
+        int length = 1 + rand() % 6;
+        for (int j = 0; j < length; j++) {
+            names[i].name[j] = "abcd"[rand() % 4];
+        }
+        names[i].name[length] = '\0';
+        names[i].count = 0;
+    }
+    for (int u = 0; u < UPDATES; u++) {
+        Expected *name = &names[rand() % NAME_COUNT];
+        int32_t delta = rand() % 3 == 0 ? -(1 + rand() % 4) : 1 + rand() % 3;
+        add(&completions, COOKLANG_ENTITY_INGREDIENT, name->name, delta);
+        // Duplicate names share a count.
+        int32_t total = 0;
+        for (int i = 0; i < NAME_COUNT; i++) {
+            if (strcmp(names[i].name, name->name) == 0 && names[i].count > total) {
+                total = names[i].count;
+            }
+        }
+        total = total + delta > 0 ? total + delta : 0;
+        for (int i = 0; i < NAME_COUNT; i++) {
+            if (strcmp(names[i].name, name->name) == 0) {
+                names[i].count = total;
+            }
+        }
+    }
+
+    static Expected unique[NAME_COUNT];
+    uint32_t unique_count = 0;
+    for (int i = 0; i < NAME_COUNT; i++) {
+        bool seen = false;
+        for (uint32_t j = 0; !seen && j < unique_count; j++) {
+            seen = strcmp(unique[j].name, names[i].name) == 0;
+        }
+        if (!seen && names[i].count > 0) {
+            unique[unique_count++] = names[i];
+        }
+    }
+    qsort(unique, unique_count, sizeof(Expected), compare_expected);
+
+    bool same = true;
+    for (int p = 0; same && p < 1 + 4 + 16 + 64; p++) {
+        char prefix[4] = "";
+        int length = p == 0 ? 0 : p < 5 ? 1 : p < 21 ? 2 : 3;
+        for (int j = 0, rest = p - (length == 1 ? 1 : length == 2 ? 5 : 21); j < length; j++) {
+            prefix[length - 1 - j] = "abcd"[rest % 4];
+            rest /= 4;
+        }
+        Expected expected[MAX_RESULTS];
+        int32_t expected_count = 0;
+        for (uint32_t i = 0; i < unique_count && expected_count < MAX_RESULTS; i++) {
+            if (strncmp(unique[i].name, prefix, (size_t)length) == 0) {
+                expected[expected_count++] = unique[i];
+            }
+        }
+        CooklangCompletion results[MAX_RESULTS];
+        int32_t count = cooklang_complete(&completions, COOKLANG_ENTITY_INGREDIENT, prefix,
+                                          (uint32_t)length, results, MAX_RESULTS);
+        same = count == expected_count;
+        for (int32_t i = 0; same && i < count; i++) {
+            same = strcmp(results[i].name, expected[i].name) == 0 &&
+                   results[i].count == (uint32_t)expected[i].count;
+        }
+    }
+    check(same, "random updates match filtering every name");
+    cooklang_completions_free(&completions);
+}
+
+int main(void) {
+    printf("Completion test\n");
+    printf("======================================\n");
+
+    test_ranking();
+    test_splits();
+    test_recipes();
+    test_random();
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
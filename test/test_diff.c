@@ -0,0 +1,256 @@
+// Structural diff in bindings/c: edits for metadata, steps, sections and
+// the entities of a changed step, and on random edits of a long document,
+// an edit script that keeps every other node and costs no more than the
+// edits that were made.
+
+#include "cooklang_diff.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static TSParser *parser;
+static CooklangDiffScript script;
+
+// The script from `old_text` to `new_text`, or NULL.
+static CooklangDiffScript *diff(const char *old_text, const char *new_text) {
+    TSTree *old_tree = ts_parser_parse_string(parser, NULL, old_text, (uint32_t)strlen(old_text));
+    TSTree *new_tree = ts_parser_parse_string(parser, NULL, new_text, (uint32_t)strlen(new_text));
+    cooklang_diff_script_free(&script);
+    bool ok = cooklang_diff(old_text, ts_tree_root_node(old_tree), new_text,
+                            ts_tree_root_node(new_tree), &script);
+    ts_tree_delete(old_tree);
+    ts_tree_delete(new_tree);
+    return ok ? &script : NULL;
+}
+
+static bool is_text(const char *source, CooklangSpan span, const char *text) {
+    size_t length = strlen(text);
+    return span.end - span.start == length && memcmp(source + span.start, text, length) == 0;
+}
+
+static bool is_edit(const CooklangDiffScript *script, uint32_t index,
+                    CooklangDiffOperation operation, CooklangDiffKind kind, const char *old_text,
+                    const char *old_node, const char *new_text, const char *new_node) {
+    if (!script || index >= script->length) {
+        return false;
+    }
+    const CooklangDiffEdit *edit = &script->edits[index];
+    return edit->operation == operation && edit->kind == kind &&
+           is_text(old_text, edit->old_span, old_node) &&
+           is_text(new_text, edit->new_span, new_node);
+}
+
+static void test_edits(void) {
+    const char *old_text = ">> servings: 4\n\nMix @flour{500%g} and @water{}.\n\nBake.\n";
+    CooklangDiffScript *script = diff(old_text, old_text);
+    check(script && script->length == 0, "identical versions have no edits");
+
+    const char *new_text = ">> servings: 6\n\nMix @flour{500%g} and @water{}.\n\nBake.\n";
+    script = diff(old_text, new_text);
+    check(script && script->length == 1 &&
+              is_edit(script, 0, COOKLANG_DIFF_CHANGE, COOKLANG_DIFF_METADATA, old_text,
+                      ">> servings: 4", new_text, ">> servings: 6"),
+          "a changed metadata value");
+
+    new_text = ">> servings: 4\n\nMix @flour{500%g} and @water{}.\n\nRest.\n\nBake.\n";
+    script = diff(old_text, new_text);
+    check(script && script->length == 1 &&
+              is_edit(script, 0, COOKLANG_DIFF_INSERT, COOKLANG_DIFF_STEP, old_text, "", new_text,
+                      "Rest.") &&
+              old_text[script->edits[0].old_span.start] == 'B',
+          "an inserted step, at the step it comes before");
+
+    new_text = ">> servings: 4\n\nMix @flour{450%g} and @water{} in #bowl{}.\n\nBake.\n";
+    script = diff(old_text, new_text);
+    check(script && script->length == 3 &&
+              is_edit(script, 0, COOKLANG_DIFF_CHANGE, COOKLANG_DIFF_STEP, old_text,
+                      "Mix @flour{500%g} and @water{}.", new_text,
+                      "Mix @flour{450%g} and @water{} in #bowl{}.") &&
+              is_edit(script, 1, COOKLANG_DIFF_CHANGE, COOKLANG_DIFF_INGREDIENT, old_text,
+                      "@flour{500%g}", new_text, "@flour{450%g}") &&
+              is_edit(script, 2, COOKLANG_DIFF_INSERT, COOKLANG_DIFF_COOKWARE, old_text, "",
+                      new_text, "#bowl{}"),
+          "a changed step, with its changed and added entities");
+
+    old_text = "= Dough\n\n>> time: 1h\n\nKnead.\n\nShape.\n";
+    new_text = "= Bread dough\n\n>> yield: 2\n\nKnead.\n";
+    script = diff(old_text, new_text);
+    check(script && script->length == 4 &&
+              is_edit(script, 0, COOKLANG_DIFF_DELETE, COOKLANG_DIFF_METADATA, old_text,
+                      ">> time: 1h", new_text, "") &&
+              is_edit(script, 1, COOKLANG_DIFF_CHANGE, COOKLANG_DIFF_SECTION, old_text, "= Dough",
+                      new_text, "= Bread dough") &&
+              is_edit(script, 2, COOKLANG_DIFF_INSERT, COOKLANG_DIFF_METADATA, old_text, "",
+                      new_text, ">> yield: 2") &&
+              is_edit(script, 3, COOKLANG_DIFF_DELETE, COOKLANG_DIFF_STEP, old_text, "Shape.",
+                      new_text, ""),
+          "metadata is paired by key, sections in order");
+
+    script = diff("Knead.\n", "");
+    check(script && script->length == 1 && script->edits[0].operation == COOKLANG_DIFF_DELETE,
+          "everything deleted");
+}
+
+static const char *const PIECES[] = {
+    ">> servings: 4",
+    "= Dough",
+    "Mix @flour{500%g} with @water{300%ml} in a #bowl{}.",
+    "Knead for ~{10%minutes}.",
+    "> Keep the dough covered.",
+    "Fry @onions{2}(sliced) in @olive oil{}.",
+    "= Sauce",
+    "Simmer @tomatoes{3} gently.",
+    "Serve.",
+};
+
+#define PIECE_COUNT (sizeof(PIECES) / sizeof(PIECES[0]))
+#define LINES 400
+
+typedef struct {
+    uint32_t piece;
+    // Whether the line's first digit was changed.
+    bool changed;
+} Line;
+
+static char *make_document(const Line *lines, uint32_t count) {
+    char *text = malloc(count * 96 + 1), *end = text;
+    for (uint32_t i = 0; i < count; i++) {
+        int length = sprintf(end, "%s\n\n", PIECES[lines[i].piece]);
+        char *digit = lines[i].changed ? strpbrk(end, "0123456789") : NULL;
+        if (digit) {
+            *digit = *digit == '9' ? '1' : (char)(*digit + 1);
+        } else if (lines[i].changed) {
+            memcpy(end + length - 2, " Then wait.\n\n", 14);
+            length += 11;
+        }
+        end += length;
+    }
+    *end = '\0';
+    return text;
+}
+
+// The top-level nodes of `text` that the script leaves alone: not deleted
+// or changed if `old`, not inserted or changed otherwise.
+static uint32_t kept(const char *text, const CooklangDiffScript *script, bool old,
+                     CooklangSpan *spans) {
+    TSTree *tree = ts_parser_parse_string(parser, NULL, text, (uint32_t)strlen(text));
+    TSNode root = ts_tree_root_node(tree);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < ts_node_named_child_count(root); i++) {
+        TSNode node = ts_node_named_child(root, i);
+        uint32_t start = ts_node_start_byte(node);
+        bool edited = false;
+        for (uint32_t e = 0; e < script->length && !edited; e++) {
+            const CooklangDiffEdit *edit = &script->edits[e];
+            CooklangSpan span = old ? edit->old_span : edit->new_span;
+            edited = edit->kind <= COOKLANG_DIFF_NOTE && span.end > span.start &&
+                     span.start >= start && span.start < ts_node_end_byte(node);
+        }
+        if (!edited) {
+            spans[count++] = (CooklangSpan){start, ts_node_end_byte(node)};
+        }
+    }
+    ts_tree_delete(tree);
+    return count;
+}
+
+static void test_random_edits(void) {
+    srand(7);
+    bool kept_same = true, cheap = true;
+    static Line old_lines[LINES], new_lines[2 * LINES];
+    static CooklangSpan old_kept[2 * LINES], new_kept[2 * LINES];
+    for (uint32_t round = 0; round < 200; round++) {
+        uint32_t count = 1 + (uint32_t)rand() % LINES;
+        for (uint32_t i = 0; i < count; i++) {
+            old_lines[i] = (Line){(uint32_t)rand() % PIECE_COUNT, false};
+        }
+        memcpy(new_lines, old_lines, count * sizeof(Line));
+        uint32_t new_count = count, cost = 0, edits = (uint32_t)rand() % 8;
+        for (uint32_t e = 0; e < edits; e++) {
+            uint32_t at = (uint32_t)rand() % (new_count + 1);
+            switch (rand() % 3) {
+                case 0:
+                    if (at < new_count) {
+                        memmove(new_lines + at, new_lines + at + 1,
+                                (new_count - at - 1) * sizeof(Line));
+                        new_count--;
+                        cost++;
+                    }
+                    break;
+                case 1:
+                    memmove(new_lines + at + 1, new_lines + at, (new_count - at) * sizeof(Line));
+                    new_lines[at] = (Line){(uint32_t)rand() % PIECE_COUNT, false};
+                    new_count++;
+                    cost++;
+                    break;
+                default:
+                    if (at < new_count && !new_lines[at].changed) {
+                        new_lines[at].changed = true;
+                        cost += 2;
+                    }
+            }
+        }
+        char *old_text = make_document(old_lines, count);
+        char *new_text = make_document(new_lines, new_count);
+        CooklangDiffScript *script = diff(old_text, new_text);
+        if (!script) {
+            kept_same = false;
+            break;
+        }
+        // A change costs a deletion and an insertion.
+        uint32_t script_cost = 0;
+        for (uint32_t e = 0; e < script->length; e++) {
+            if (script->edits[e].kind <= COOKLANG_DIFF_NOTE) {
+                script_cost += script->edits[e].operation == COOKLANG_DIFF_CHANGE ? 2 : 1;
+            }
+        }
+        cheap = cheap && script_cost <= cost;
+
+        uint32_t old_count = kept(old_text, script, true, old_kept);
+        uint32_t kept_count = kept(new_text, script, false, new_kept);
+        kept_same = kept_same && old_count == kept_count;
+        for (uint32_t i = 0; i < old_count && kept_same; i++) {
+            uint32_t length = old_kept[i].end - old_kept[i].start;
+            kept_same = length == new_kept[i].end - new_kept[i].start &&
+                        memcmp(old_text + old_kept[i].start, new_text + new_kept[i].start,
+                               length) == 0;
+        }
+        free(old_text);
+        free(new_text);
+    }
+    check(kept_same, "the nodes a script keeps are the same in both versions");
+    check(cheap, "a script costs no more than the edits made");
+}
+
+int main(void) {
+    printf("Structural diff test\n");
+    printf("======================================\n");
+
+    parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    test_edits();
+    test_random_edits();
+    cooklang_diff_script_free(&script);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,345 @@
+// Differential test: the flat extractor in bindings/c must report the same
+// entities as the tree produced by the grammar for every corpus file that
+// parses without errors.
+//
+// Usage: test_differential [directory...]   (default: test/individual_tests)
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "cooklang_extract.h"
+#include "tree-sitter-cooklang.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define YELLOW "\033[0;33m"
+#define NC "\033[0m"
+
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} Text;
+
+static void text_append(Text *text, const char *data, size_t length) {
+    if (text->length + length + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity : 256;
+        while (capacity < text->length + length + 1) {
+            capacity *= 2;
+        }
+        text->data = realloc(text->data, capacity);
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+}
+
+static void text_printf_entity(Text *text, uint32_t row, const char *kind, const char *name,
+                               size_t name_length) {
+    char header[64];
+    int length = snprintf(header, sizeof(header), "%u %s ", row, kind);
+    text_append(text, header, (size_t)length);
+    text_append(text, name, name_length);
+}
+
+static void trim(const char **start, const char **end, const char *chars) {
+    while (*start < *end && strchr(chars, **start)) {
+        (*start)++;
+    }
+    while (*end > *start && strchr(chars, (*end)[-1])) {
+        (*end)--;
+    }
+}
+
+static void append_field(Text *text, const char *label, const char *start, const char *end) {
+    trim(&start, &end, " \t\r\n");
+    text_append(text, label, strlen(label));
+    text_append(text, start, (size_t)(end - start));
+}
+
+static const char *KIND_NAMES[] = {
+    [COOKLANG_ENTITY_INGREDIENT] = "ingredient",
+    [COOKLANG_ENTITY_COOKWARE] = "cookware",
+    [COOKLANG_ENTITY_TIMER] = "timer",
+    [COOKLANG_ENTITY_METADATA] = "metadata",
+    [COOKLANG_ENTITY_SECTION] = "section",
+    [COOKLANG_ENTITY_FRONTMATTER] = "frontmatter",
+};
+
+static void describe_extracted(const char *source, const CooklangEntityList *list, Text *out) {
+    for (uint32_t i = 0; i < list->length; i++) {
+        const CooklangEntity *entity = &list->entities[i];
+        text_printf_entity(out, entity->row, KIND_NAMES[entity->kind],
+                           source + entity->name.start, entity->name.end - entity->name.start);
+        switch (entity->kind) {
+            case COOKLANG_ENTITY_METADATA:
+            case COOKLANG_ENTITY_FRONTMATTER:
+                append_field(out, " = ", source + entity->value.start, source + entity->value.end);
+                break;
+            case COOKLANG_ENTITY_SECTION:
+                break;
+            default:
+                if (entity->flags & COOKLANG_ENTITY_HAS_QUANTITY) {
+                    append_field(out, " {", source + entity->quantity.start,
+                                 source + entity->quantity.end);
+                }
+                if (entity->flags & COOKLANG_ENTITY_HAS_NOTE) {
+                    append_field(out, " (", source + entity->note.start, source + entity->note.end);
+                }
+                break;
+        }
+        text_append(out, "\n", 1);
+    }
+}
+
+static bool node_is(TSNode node, const char *type) {
+    return !ts_node_is_null(node) && strcmp(ts_node_type(node), type) == 0;
+}
+
+static TSNode field(TSNode node, const char *name) {
+    return ts_node_child_by_field_name(node, name, (uint32_t)strlen(name));
+}
+
+static TSNode child_of_type(TSNode node, const char *type) {
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode child = ts_node_named_child(node, i);
+        if (node_is(child, type)) {
+            return child;
+        }
+    }
+    return (TSNode){0};
+}
+
+// Notes separated from their ingredient only by extras may be attached to
+// the step instead; the extractor always attaches them.
+static TSNode trailing_note(TSNode node) {
+    TSNode note = child_of_type(node, "note");
+    if (!ts_node_is_null(note)) {
+        return note;
+    }
+    TSNode sibling = ts_node_next_named_sibling(node);
+    while (node_is(sibling, "comment") || node_is(sibling, "block_comment")) {
+        sibling = ts_node_next_named_sibling(sibling);
+    }
+    return node_is(sibling, "note") ? sibling : (TSNode){0};
+}
+
+static void describe_node(const char *source, TSNode node, Text *out) {
+    const char *type = ts_node_type(node);
+    uint32_t row = ts_node_start_point(node).row;
+
+    if (!strcmp(type, "ingredient") || !strcmp(type, "cookware") || !strcmp(type, "timer")) {
+        TSNode name = field(node, "name");
+        const char *start = source, *end = source;
+        if (!ts_node_is_null(name)) {
+            start = source + ts_node_start_byte(name);
+            end = source + ts_node_end_byte(name);
+            trim(&start, &end, " \t\r\n");
+        }
+        text_printf_entity(out, row, type, start, (size_t)(end - start));
+
+        TSNode quantity = child_of_type(node, "quantity");
+        if (!ts_node_is_null(quantity)) {
+            append_field(out, " {", source + ts_node_start_byte(quantity) + 1,
+                         source + ts_node_end_byte(quantity) - 1);
+        }
+        TSNode note = trailing_note(node);
+        if (!ts_node_is_null(note)) {
+            TSNode content = field(note, "content");
+            append_field(out, " (", source + ts_node_start_byte(content),
+                         source + ts_node_end_byte(content));
+        }
+        text_append(out, "\n", 1);
+    } else if (!strcmp(type, "metadata")) {
+        TSNode key = field(node, "key");
+        TSNode value = field(node, "value");
+        const char *start = source + ts_node_start_byte(key);
+        const char *end = source + ts_node_end_byte(key);
+        trim(&start, &end, "> \t\r\n");
+        text_printf_entity(out, row, type, start, (size_t)(end - start));
+        append_field(out, " = ", source + ts_node_start_byte(value), source + ts_node_end_byte(value));
+        text_append(out, "\n", 1);
+    } else if (!strcmp(type, "section")) {
+        TSNode name = field(node, "name");
+        const char *start = source + ts_node_start_byte(name);
+        const char *end = source + ts_node_end_byte(name);
+        trim(&start, &end, "= \t\r\n");
+        text_printf_entity(out, row, type, start, (size_t)(end - start));
+        text_append(out, "\n", 1);
+    } else if (!strcmp(type, "frontmatter")) {
+        TSNode content = child_of_type(node, "frontmatter_content");
+        text_printf_entity(out, row, type, "", 0);
+        if (ts_node_is_null(content)) {
+            append_field(out, " = ", source, source);
+        } else {
+            append_field(out, " = ", source + ts_node_start_byte(content),
+                         source + ts_node_end_byte(content));
+        }
+        text_append(out, "\n", 1);
+    }
+
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        describe_node(source, ts_node_named_child(node, i), out);
+    }
+}
+
+static char *read_file(const char *path, uint32_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    char *data = malloc((size_t)size + 1);
+    if (fread(data, 1, (size_t)size, file) != (size_t)size) {
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    data[size] = '\0';
+    *length = (uint32_t)size;
+    return data;
+}
+
+typedef struct {
+    TSParser *parser;
+    unsigned pass;
+    unsigned fail;
+    unsigned skipped;
+} Context;
+
+static void check_file(Context *context, const char *path) {
+    uint32_t length;
+    char *source = read_file(path, &length);
+    if (!source) {
+        printf("  " RED "✗" NC " %s (unreadable)\n", path);
+        context->fail++;
+        return;
+    }
+
+    TSTree *tree = ts_parser_parse_string(context->parser, NULL, source, length);
+    TSNode root = ts_tree_root_node(tree);
+    if (ts_node_has_error(root)) {
+        printf("  " YELLOW "-" NC " %s (parse errors, skipped)\n", path);
+        context->skipped++;
+        ts_tree_delete(tree);
+        free(source);
+        return;
+    }
+
+    Text expected = {0};
+    describe_node(source, root, &expected);
+    text_append(&expected, "", 0);
+
+    static const CooklangBackend backends[] = {
+        COOKLANG_BACKEND_SCALAR,
+        COOKLANG_BACKEND_SSE2,
+        COOKLANG_BACKEND_AVX2,
+    };
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        if (!cooklang_extract_set_backend(backends[i])) {
+            continue;
+        }
+        CooklangEntityList list;
+        cooklang_entity_list_init(&list);
+        cooklang_extract(source, length, &list);
+        Text actual = {0};
+        describe_extracted(source, &list, &actual);
+        text_append(&actual, "", 0);
+        if (strcmp(expected.data, actual.data) != 0) {
+            if (ok) {
+                printf("  " RED "✗" NC " %s\n", path);
+            }
+            printf("    %s backend\n    tree:\n%s    extracted:\n%s",
+                   cooklang_backend_name(backends[i]), expected.data, actual.data);
+            ok = false;
+        }
+        free(actual.data);
+        cooklang_entity_list_free(&list);
+    }
+    cooklang_extract_set_backend(COOKLANG_BACKEND_AUTO);
+
+    if (ok) {
+        printf("  " GREEN "✓" NC " %s\n", path);
+        context->pass++;
+    } else {
+        context->fail++;
+    }
+
+    free(expected.data);
+    ts_tree_delete(tree);
+    free(source);
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void check_directory(Context *context, const char *directory) {
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        return;
+    }
+    char **names = NULL;
+    size_t count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        names = realloc(names, (count + 1) * sizeof(char *));
+        names[count++] = strdup(entry->d_name);
+    }
+    closedir(dir);
+    qsort(names, count, sizeof(char *), compare_names);
+
+    for (size_t i = 0; i < count; i++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+        struct stat info;
+        if (stat(path, &info) == 0) {
+            size_t length = strlen(path);
+            if (S_ISDIR(info.st_mode)) {
+                check_directory(context, path);
+            } else if (length > 5 && strcmp(path + length - 5, ".cook") == 0) {
+                check_file(context, path);
+            }
+        }
+        free(names[i]);
+    }
+    free(names);
+}
+
+int main(int argc, char **argv) {
+    Context context = {ts_parser_new(), 0, 0, 0};
+    ts_parser_set_language(context.parser, tree_sitter_cooklang());
+
+    printf("Differential test: extractor vs. tree-sitter-cooklang\n");
+    printf("======================================\n");
+    if (argc < 2) {
+        check_directory(&context, "test/individual_tests");
+    }
+    for (int i = 1; i < argc; i++) {
+        check_directory(&context, argv[i]);
+    }
+
+    printf("\nSummary:\n");
+    printf("  Matching: %u\n", context.pass);
+    printf("  Mismatching: %u\n", context.fail);
+    printf("  Skipped (parse errors): %u\n", context.skipped);
+
+    ts_parser_delete(context.parser);
+    return context.fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+// Edited documents in bindings/c: LSP positions, line-indexed edits,
+// diagnostics, and incremental diagnostics matching a fresh parse.
+
+#include "cooklang_document.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+// Run from the repository root, like the other tests.
+#define REFERENCE_DIRECTORY "test/examples"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static bool has_diagnostic(const CooklangDocument *document, CooklangDiagnosticKind kind,
+                           uint32_t line, const char *text) {
+    for (uint32_t i = 0; i < document->diagnostic_count; i++) {
+        const CooklangDiagnostic *diagnostic = &document->diagnostics[i];
+        uint32_t length = diagnostic->end - diagnostic->start;
+        if (diagnostic->kind == kind &&
+            cooklang_document_position(document, diagnostic->start).line == line &&
+            (!text || (strlen(text) == length &&
+                       memcmp(document->text.data + diagnostic->start, text, length) == 0))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool same_diagnostics(const CooklangDocument *a, const CooklangDocument *b) {
+    if (a->diagnostic_count != b->diagnostic_count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->diagnostic_count; i++) {
+        if (a->diagnostics[i].start != b->diagnostics[i].start ||
+            a->diagnostics[i].end != b->diagnostics[i].end ||
+            a->diagnostics[i].kind != b->diagnostics[i].kind) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_positions(void) {
+    CooklangDocument document;
+    cooklang_document_init(&document, NULL);
+    // `ü` is one UTF-16 unit in two bytes, the emoji two units in four.
+    static const char TEXT[] = "a\xc3\xbc\xf0\x9f\x98\x80x\r\nz";
+    cooklang_document_set_text(&document, TEXT, sizeof(TEXT) - 1);
+    check(cooklang_document_offset(&document, (CooklangPosition){0, 2}) == 3 &&
+              cooklang_document_offset(&document, (CooklangPosition){0, 4}) == 7 &&
+              cooklang_document_offset(&document, (CooklangPosition){1, 0}) == 10,
+          "UTF-16 positions map to byte offsets");
+    check(cooklang_document_offset(&document, (CooklangPosition){0, 99}) == 8 &&
+              cooklang_document_offset(&document, (CooklangPosition){9, 0}) == 11,
+          "positions past a line or the document are clamped");
+    CooklangPosition position = cooklang_document_position(&document, 8);
+    check(position.line == 0 && position.character == 5, "byte offsets map to UTF-16 positions");
+
+    cooklang_document_replace(&document, (CooklangPosition){0, 1}, (CooklangPosition){1, 0},
+                              "b\nc\n", 4);
+    check(strcmp(document.text.data, "ab\nc\nz") == 0 && document.line_count == 3 &&
+              document.lines[1] == 3 && document.lines[2] == 5,
+          "edits across lines update the line index");
+    cooklang_document_free(&document);
+}
+
+static void test_diagnostics(TSParser *parser) {
+    static const char TEXT[] = "Add @salt{1%tsp} and @x{2%blorps}.\n"
+                               "Use @./minimal{} and @./missing{}.\n";
+    CooklangDocument document;
+    cooklang_document_init(&document, REFERENCE_DIRECTORY);
+    cooklang_document_set_text(&document, TEXT, sizeof(TEXT) - 1);
+    bool parsed = cooklang_document_parse(&document, parser);
+    check(parsed && document.diagnostic_count == 2 &&
+              has_diagnostic(&document, COOKLANG_DIAGNOSTIC_UNKNOWN_UNIT, 0, "blorps") &&
+              has_diagnostic(&document, COOKLANG_DIAGNOSTIC_MISSING_REFERENCE, 1, "./missing"),
+          "unknown units and missing references");
+
+    // Open a quantity on the first line.
+    cooklang_document_replace(&document, (CooklangPosition){0, 4}, (CooklangPosition){0, 16},
+                              "@salt{1%tsp", 11);
+    parsed = cooklang_document_parse(&document, parser);
+    check(parsed && (has_diagnostic(&document, COOKLANG_DIAGNOSTIC_UNCLOSED_QUANTITY, 0, NULL) ||
+                     has_diagnostic(&document, COOKLANG_DIAGNOSTIC_SYNTAX_ERROR, 0, NULL)),
+          "unclosed quantities");
+    cooklang_document_free(&document);
+}
+
+// Type a recipe character by character, parsing after every keystroke.
+// Whenever a line is complete, the diagnostics must equal those of a fresh
+// document with the same text. (Half-typed lines are not compared: error
+// recovery may build different trees incrementally and from scratch.)
+static void test_incremental(TSParser *parser) {
+    static const char *const LINES[] = {
+        ">> servings: 2\n",
+        "Mix @flour{200%g} and @water{1%glug}.\n",
+        "= Sauce\n",
+        "Stir @./missing{} into #pan{} for ~{3%hours}.\n",
+        "Add @salt{a pinch%pinches}.\n",
+    };
+    CooklangDocument typed, fresh;
+    cooklang_document_init(&typed, REFERENCE_DIRECTORY);
+    cooklang_document_set_text(&typed, "", 0);
+    bool same = true;
+    uint32_t line = 0;
+    // Insert the lines in reverse order at the top, so that every edit
+    // shifts the diagnostics after it.
+    for (int i = (int)(sizeof(LINES) / sizeof(LINES[0])) - 1; same && i >= 0; i--) {
+        uint32_t length = (uint32_t)strlen(LINES[i]);
+        for (uint32_t j = 0; same && j < length; j++) {
+            CooklangPosition at = {0, j};
+            if (LINES[i][j] == '\n') {
+                line++;
+            }
+            cooklang_document_replace(&typed, at, at, LINES[i] + j, 1);
+            same = cooklang_document_parse(&typed, parser);
+            if (LINES[i][j] != '\n') {
+                continue;
+            }
+
+            cooklang_document_init(&fresh, REFERENCE_DIRECTORY);
+            cooklang_document_set_text(&fresh, typed.text.data, typed.text.length);
+            same = same && cooklang_document_parse(&fresh, parser) &&
+                   same_diagnostics(&fresh, &typed);
+            if (!same) {
+                printf("    differs after typing line %d\n", i);
+            }
+            cooklang_document_free(&fresh);
+        }
+    }
+    check(same && typed.line_count == line + 1, "incremental diagnostics match a fresh parse");
+    check(typed.diagnostic_count == 3, "diagnostics of the typed recipe");
+    cooklang_document_free(&typed);
+}
+
+int main(void) {
+    printf("Document test\n");
+    printf("======================================\n");
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    test_positions();
+    test_diagnostics(parser);
+    test_incremental(parser);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// Parsing files through the chunked inputs in bindings/c: with tiny chunks
+// that split UTF-8 characters, with memory-mapped files large enough for
+// pages to be released behind the parser, and with empty and missing files.
+// Every tree must match the one parsed from the whole text.
+
+#define _DEFAULT_SOURCE
+
+#include "cooklang_file_input.h"
+#include "tree-sitter-cooklang.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static char path[] = "/tmp/cooklang-file-input-XXXXXX";
+
+static bool write_file(const char *text, size_t length) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(text, 1, length, file) == length;
+    return fclose(file) == 0 && ok;
+}
+
+// Whether parsing the file at `path` gives the same tree as parsing `text`.
+static bool same_tree(TSParser *parser, const char *text, uint32_t length,
+                      CooklangFileInputMode mode, uint32_t chunk_size) {
+    TSTree *expected = ts_parser_parse_string(parser, NULL, text, length);
+    TSTree *actual = cooklang_parse_file(parser, path, mode, chunk_size);
+    bool same = false;
+    if (expected && actual) {
+        char *expected_string = ts_node_string(ts_tree_root_node(expected));
+        char *actual_string = ts_node_string(ts_tree_root_node(actual));
+        same = strcmp(expected_string, actual_string) == 0 &&
+               ts_node_end_byte(ts_tree_root_node(actual)) == length;
+        free(expected_string);
+        free(actual_string);
+    }
+    if (expected) {
+        ts_tree_delete(expected);
+    }
+    if (actual) {
+        ts_tree_delete(actual);
+    }
+    return same;
+}
+
+static void test_small_chunks(TSParser *parser) {
+    static const char RECIPE[] =
+        "---\ntitle: Crème brûlée\n---\n"
+        "Whisk @egg yolks{4} with @sugar{100%g} and @vanilla{½%pod} in a #bowl{}.\n"
+        "Bake for ~{40%minutes} at 150 °C — do not let it boil.\n";
+    bool written = write_file(RECIPE, sizeof(RECIPE) - 1);
+    bool read = true;
+    bool mapped = true;
+    for (uint32_t chunk_size = 1; chunk_size <= 9; chunk_size++) {
+        read = read && same_tree(parser, RECIPE, sizeof(RECIPE) - 1,
+                                 COOKLANG_FILE_INPUT_READ, chunk_size);
+        mapped = mapped && same_tree(parser, RECIPE, sizeof(RECIPE) - 1,
+                                     COOKLANG_FILE_INPUT_MMAP, chunk_size);
+    }
+    check(written && read, "buffered reads with chunks splitting characters");
+    check(written && mapped, "mapped reads with chunks splitting characters");
+
+    CooklangFileInput input;
+    char buffer[16] = {0};
+    const char *brulee = strstr(RECIPE, "brûlée");
+    uint32_t start = (uint32_t)(brulee - RECIPE);
+    check(cooklang_file_input_open(&input, path, COOKLANG_FILE_INPUT_READ, 4) &&
+              cooklang_file_input_slice(&input, start, start + 8, buffer) &&
+              memcmp(buffer, "brûlée", 8) == 0 &&
+              !cooklang_file_input_slice(&input, start, sizeof(RECIPE), buffer),
+          "slices of the file");
+    cooklang_file_input_close(&input);
+}
+
+// Several megabytes, so that the mapped input releases pages behind the
+// parser; the tree must not notice.
+static void test_large_file(TSParser *parser) {
+    static const char STEP[] = "Add @salt{1%tsp} and stir with a #spoon{} for ~{2%min}.\n\n";
+    uint32_t count = 4 * 1024 * 1024 / (sizeof(STEP) - 1);
+    uint32_t length = count * (uint32_t)(sizeof(STEP) - 1);
+    char *text = malloc(length + 1);
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(text + i * (sizeof(STEP) - 1), STEP, sizeof(STEP) - 1);
+    }
+    text[length] = '\0';
+    bool written = write_file(text, length);
+    check(written && same_tree(parser, text, length, COOKLANG_FILE_INPUT_MMAP, 0),
+          "a large mapped file");
+    check(written && same_tree(parser, text, length, COOKLANG_FILE_INPUT_READ, 4096),
+          "a large file read in chunks");
+    free(text);
+}
+
+static void test_edge_cases(TSParser *parser) {
+    bool written = write_file("", 0);
+    check(written && same_tree(parser, "", 0, COOKLANG_FILE_INPUT_MMAP, 0) &&
+              same_tree(parser, "", 0, COOKLANG_FILE_INPUT_READ, 0),
+          "an empty file");
+    unlink(path);
+    CooklangFileInput input;
+    errno = 0;
+    check(!cooklang_file_input_open(&input, path, COOKLANG_FILE_INPUT_READ, 0) && errno == ENOENT &&
+              !cooklang_parse_file(parser, path, COOKLANG_FILE_INPUT_MMAP, 0),
+          "a missing file");
+}
+
+int main(void) {
+    printf("File input test\n");
+    printf("======================================\n");
+
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    test_small_chunks(parser);
+    test_large_file(parser);
+    test_edge_cases(parser);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
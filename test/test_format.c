@@ -0,0 +1,147 @@
+// Recipe formatting in bindings/c: canonical output for whole documents,
+// idempotence, and incremental formatting that only touches edited lines.
+
+#include "cooklang_format.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+typedef struct {
+    const char *description;
+    const char *recipe;
+    const char *expected;
+} FormatCase;
+
+static const FormatCase CASES[] = {
+    {"already formatted", ">> servings: 4\n\nAdd @salt{1%tsp} to #pot{}.\n",
+     ">> servings: 4\n\nAdd @salt{1%tsp} to #pot{}.\n"},
+    {"metadata", ">>servings :  4  \n", ">> servings: 4\n"},
+    {"sections and notes", "== Dough ==\n\n>Rest it.\n", "= Dough\n\n> Rest it.\n"},
+    {"step whitespace", "  Mix \t the   batter.   \n", "Mix the batter.\n"},
+    {"entity padding", "Add @olive  oil{ 1 / 2 % cup }( cold ) to #pot{ }.\n",
+     "Add @olive oil{1/2%cup}(cold) to #pot{}.\n"},
+    {"ranges and fixed amounts", "Crack @eggs{= 2 - 3 }, wait ~{ 10 %  min }.\n",
+     "Crack @eggs{=2-3}, wait ~{10%min}.\n"},
+    {"text amounts", "Season with @salt{ a  pinch }.\n", "Season with @salt{a pinch}.\n"},
+    {"comments kept", "-- keep   this\nStir. -- and   this\n",
+     "-- keep   this\nStir. -- and   this\n"},
+};
+
+static unsigned failures;
+
+static void check(bool passed, const char *description, const char *expected, const char *actual) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n    expected: %s\n    actual:   %s\n", description, expected,
+               actual);
+    }
+}
+
+static bool format(TSParser *parser, const char *source, CooklangText *out) {
+    uint32_t length = (uint32_t)strlen(source);
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+    CooklangEditList edits;
+    cooklang_edit_list_init(&edits);
+    bool ok = cooklang_format_recipe(source, length, ts_tree_root_node(tree), &edits) &&
+              cooklang_edit_list_apply(&edits, source, length, out);
+    cooklang_edit_list_free(&edits);
+    ts_tree_delete(tree);
+    return ok;
+}
+
+// Replace OLD_TEXT with NEW_TEXT in a large recipe, reparse, and format
+// the changes: the edits must stay inside the edited line and produce the
+// same result as formatting the whole document.
+static void test_incremental(TSParser *parser, CooklangText *out) {
+    static const char LINE[] = "Add @salt{1%tsp} to #pot{}.\n";
+    static const char OLD_TEXT[] = "Add @salt{1%tsp} to #pot{}.";
+    static const char NEW_TEXT[] = "Add  @salt{ 1 %tsp} to #pot{}.";
+    enum { LINES = 200, EDITED = 120 };
+
+    char old_source[LINES * sizeof(LINE)];
+    char new_source[LINES * sizeof(LINE) + sizeof(NEW_TEXT)];
+    uint32_t old_length = 0;
+    for (int i = 0; i < LINES; i++) {
+        memcpy(old_source + old_length, LINE, sizeof(LINE) - 1);
+        old_length += sizeof(LINE) - 1;
+    }
+    uint32_t start = EDITED * (sizeof(LINE) - 1);
+    uint32_t old_end = start + sizeof(OLD_TEXT) - 1;
+    uint32_t new_end = start + sizeof(NEW_TEXT) - 1;
+    memcpy(new_source, old_source, start);
+    memcpy(new_source + start, NEW_TEXT, sizeof(NEW_TEXT) - 1);
+    memcpy(new_source + new_end, old_source + old_end, old_length - old_end);
+    uint32_t new_length = new_end + (old_length - old_end);
+    new_source[new_length] = '\0';
+
+    TSTree *old_tree = ts_parser_parse_string(parser, NULL, old_source, old_length);
+    TSInputEdit edit = {
+        start,
+        old_end,
+        new_end,
+        {EDITED, 0},
+        {EDITED, sizeof(OLD_TEXT) - 1},
+        {EDITED, sizeof(NEW_TEXT) - 1},
+    };
+    ts_tree_edit(old_tree, &edit);
+    TSTree *new_tree = ts_parser_parse_string(parser, old_tree, new_source, new_length);
+
+    CooklangEditList edits;
+    cooklang_edit_list_init(&edits);
+    bool ok = cooklang_format_changes(new_source, new_length, old_tree, new_tree, &edit, 1, &edits);
+    bool inside = ok && edits.length > 0;
+    for (uint32_t i = 0; inside && i < edits.length; i++) {
+        inside = edits.edits[i].start >= start && edits.edits[i].end <= new_end;
+    }
+    ok = ok && cooklang_edit_list_apply(&edits, new_source, new_length, out);
+    cooklang_edit_list_free(&edits);
+    ts_tree_delete(old_tree);
+    ts_tree_delete(new_tree);
+
+    bool restored = ok && out->length == old_length && memcmp(out->data, old_source, old_length) == 0;
+    check(inside, "incremental edits stay on the edited line", "edits inside the line",
+          inside ? "" : "edits outside the line");
+    check(restored, "incremental formatting matches the whole document", "original text",
+          ok ? "different text" : "(failed)");
+}
+
+int main(void) {
+    printf("Formatting test\n");
+    printf("======================================\n");
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText out, again;
+    cooklang_text_init(&out);
+    cooklang_text_init(&again);
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        const FormatCase *test = &CASES[i];
+        bool ok = format(parser, test->recipe, &out);
+        check(ok && strcmp(out.data, test->expected) == 0, test->description, test->expected,
+              ok ? out.data : "(failed)");
+
+        // Formatting formatted output changes nothing.
+        ok = ok && format(parser, out.data, &again);
+        if (!ok || strcmp(again.data, out.data) != 0) {
+            failures++;
+            printf("  " RED "✗" NC " %s is not idempotent: %s\n", test->description,
+                   ok ? again.data : "(failed)");
+        }
+    }
+    test_incremental(parser, &out);
+    cooklang_text_free(&again);
+    cooklang_text_free(&out);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
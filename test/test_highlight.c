@@ -0,0 +1,202 @@
+// Highlighting on several threads in bindings/c: the captures of
+// queries/highlights.scm over a long document must come out exactly as a
+// single query cursor over the whole tree returns them, whatever the
+// number of threads.
+
+#include "cooklang_highlight.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+#define HIGHLIGHTS_QUERY "queries/highlights.scm"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static const char *const PIECES[] = {
+    "---\ntitle: Soup\n---\n",
+    ">> servings: 4\n",
+    "= Dough\n",
+    "Mix @flour{500%g} with @water{300%ml} in a #bowl{}.\n",
+    "Knead for ~{10%minutes}, then rest ~proof{1%hour}.\n",
+    "> Keep the dough covered.\n",
+    "-- a comment\n",
+    "[- a block\ncomment -]\n",
+    "Fry @onions{2}(sliced) in @olive oil{} until golden.\n",
+    "\n",
+    "= Sauce\n",
+    "Simmer @tomatoes{3} gently.\n",
+};
+
+#define PIECE_COUNT (sizeof(PIECES) / sizeof(PIECES[0]))
+
+static char *read_file(const char *path, uint32_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    char *data = malloc((size_t)size + 1);
+    *length = (uint32_t)fread(data, 1, (size_t)size, file);
+    data[*length] = '\0';
+    fclose(file);
+    return data;
+}
+
+// The frontmatter only once, then the other pieces in a varying order.
+static char *make_document(uint32_t pieces, uint32_t *length) {
+    size_t capacity = 64 * pieces + 64, used = 0;
+    char *text = malloc(capacity);
+    used += (size_t)snprintf(text, capacity, "%s", PIECES[0]);
+    for (uint32_t i = 0; i < pieces; i++) {
+        const char *piece = PIECES[1 + (i * 7) % (PIECE_COUNT - 1)];
+        size_t piece_length = strlen(piece);
+        if (used + piece_length + 1 > capacity) {
+            capacity *= 2;
+            text = realloc(text, capacity);
+        }
+        memcpy(text + used, piece, piece_length);
+        used += piece_length;
+    }
+    text[used] = '\0';
+    *length = (uint32_t)used;
+    return text;
+}
+
+// What cooklang_highlight has to reproduce.
+static void highlight_directly(const TSQuery *query, const TSTree *tree,
+                               CooklangHighlightList *list) {
+    TSQueryCursor *cursor = ts_query_cursor_new();
+    ts_query_cursor_exec(cursor, query, ts_tree_root_node(tree));
+    TSQueryMatch match;
+    uint32_t index;
+    while (ts_query_cursor_next_capture(cursor, &match, &index)) {
+        TSNode node = match.captures[index].node;
+        if (list->length == list->capacity) {
+            list->capacity = list->capacity ? list->capacity * 2 : 256;
+            list->highlights = realloc(list->highlights, list->capacity * sizeof(CooklangHighlight));
+        }
+        list->highlights[list->length++] = (CooklangHighlight){
+            ts_node_start_byte(node), ts_node_end_byte(node), match.captures[index].index,
+            match.pattern_index};
+    }
+    ts_query_cursor_delete(cursor);
+}
+
+static bool same_highlights(const CooklangHighlightList *a, const CooklangHighlightList *b) {
+    return a->length == b->length &&
+           (a->length == 0 ||
+            memcmp(a->highlights, b->highlights, a->length * sizeof(CooklangHighlight)) == 0);
+}
+
+static bool has_capture(const TSQuery *query, const CooklangHighlightList *list, const char *name) {
+    for (uint32_t i = 0; i < list->length; i++) {
+        uint32_t length;
+        const char *capture = ts_query_capture_name_for_id(query, list->highlights[i].capture, &length);
+        if (length == strlen(name) && memcmp(capture, name, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_threads(const TSQuery *query, TSParser *parser) {
+    uint32_t length;
+    char *text = make_document(3000, &length);
+    TSTree *tree = ts_parser_parse_string(parser, NULL, text, length);
+
+    CooklangHighlightList expected, single;
+    cooklang_highlight_list_init(&expected);
+    cooklang_highlight_list_init(&single);
+    highlight_directly(query, tree, &expected);
+    check(cooklang_highlight(query, tree, 1, &single) && same_highlights(&single, &expected),
+          "one thread matches a single cursor");
+    check(expected.length > 3000 && has_capture(query, &expected, "constant") &&
+              has_capture(query, &expected, "number") && has_capture(query, &expected, "comment"),
+          "the document has ingredients, quantities and comments to highlight");
+
+    static const unsigned THREADS[] = {2, 3, 4, 7, 16, 64};
+    bool same = true;
+    for (size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); t++) {
+        CooklangHighlightList parallel;
+        cooklang_highlight_list_init(&parallel);
+        same = same && cooklang_highlight(query, tree, THREADS[t], &parallel) &&
+               same_highlights(&parallel, &expected);
+        cooklang_highlight_list_free(&parallel);
+    }
+    check(same, "2 to 64 threads give the same captures in the same order");
+
+    // Captures are appended after what the list holds.
+    uint32_t before = single.length;
+    check(cooklang_highlight(query, tree, 4, &single) && single.length == 2 * before &&
+              memcmp(single.highlights + before, expected.highlights,
+                     before * sizeof(CooklangHighlight)) == 0,
+          "captures are appended");
+
+    cooklang_highlight_list_free(&expected);
+    cooklang_highlight_list_free(&single);
+    ts_tree_delete(tree);
+    free(text);
+}
+
+static void test_small_documents(const TSQuery *query, TSParser *parser) {
+    static const char *const TEXTS[] = {"", "Add @salt{}.", "= Only a section\n",
+                                        "Add @salt{} and @pepper{}.\nStir.\n"};
+    bool same = true;
+    for (size_t i = 0; i < sizeof(TEXTS) / sizeof(TEXTS[0]); i++) {
+        TSTree *tree = ts_parser_parse_string(parser, NULL, TEXTS[i], (uint32_t)strlen(TEXTS[i]));
+        CooklangHighlightList expected, parallel;
+        cooklang_highlight_list_init(&expected);
+        cooklang_highlight_list_init(&parallel);
+        highlight_directly(query, tree, &expected);
+        same = same && cooklang_highlight(query, tree, 8, &parallel) &&
+               same_highlights(&parallel, &expected);
+        cooklang_highlight_list_free(&expected);
+        cooklang_highlight_list_free(&parallel);
+        ts_tree_delete(tree);
+    }
+    check(same, "more threads than steps");
+}
+
+int main(void) {
+    printf("Highlight test\n");
+    printf("======================================\n");
+
+    uint32_t source_length;
+    char *source = read_file(HIGHLIGHTS_QUERY, &source_length);
+    uint32_t error_offset;
+    TSQueryError error;
+    TSQuery *query = source ? ts_query_new(tree_sitter_cooklang(), source, source_length,
+                                           &error_offset, &error)
+                            : NULL;
+    check(query != NULL, "loading " HIGHLIGHTS_QUERY);
+    if (query) {
+        TSParser *parser = ts_parser_new();
+        ts_parser_set_language(parser, tree_sitter_cooklang());
+        test_threads(query, parser);
+        test_small_documents(query, parser);
+        ts_parser_delete(parser);
+        ts_query_delete(query);
+    }
+    free(source);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
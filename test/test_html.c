@@ -0,0 +1,134 @@
+// HTML rendering of parsed recipes in bindings/c: page structure, entity
+// lists and step markup, recipe references, metadata and escaping.
+
+#include "cooklang_html.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+typedef struct {
+    const char *description;
+    const char *recipe;
+    const char *title;
+    const char *expected;
+    // Whether to write a whole page rather than the article alone.
+    bool page;
+} HtmlCase;
+
+static const HtmlCase CASES[] = {
+    {"empty recipe", "", NULL, "<article class=\"recipe\">\n</article>\n", false},
+    {"fallback title", "Boil water.\n", "Tea",
+     "<article class=\"recipe\">\n<header>\n<h1>Tea</h1>\n</header>\n"
+     "<section class=\"method\">\n<ol class=\"steps\">\n<li>Boil water.</li>\n</ol>\n"
+     "</section>\n</article>\n", false},
+    {"metadata and entities",
+     ">> title: Soup\n>> servings: 4\n\nAdd @salt{1%tsp} to #pot{} and wait ~{10%min}.\n",
+     "Ignored",
+     "<article class=\"recipe\">\n<header>\n<h1>Soup</h1>\n"
+     "<dl class=\"metadata\"><dt>servings</dt><dd>4</dd></dl>\n</header>\n"
+     "<section class=\"ingredients\">\n<h2>Ingredients</h2>\n<ul>\n"
+     "<li><span class=\"quantity\">1 tsp</span> <span class=\"name\">salt</span></li>\n"
+     "</ul>\n</section>\n"
+     "<section class=\"cookware\">\n<h2>Cookware</h2>\n<ul>\n"
+     "<li><span class=\"name\">pot</span></li>\n</ul>\n</section>\n"
+     "<section class=\"method\">\n<ol class=\"steps\">\n"
+     "<li>Add <span class=\"ingredient\">salt</span> to <span class=\"cookware\">pot</span>"
+     " and wait <span class=\"timer\">10 min</span>.</li>\n</ol>\n</section>\n</article>\n", false},
+    {"frontmatter", "---\ntitle: \"Bread\"\ntags:\n  - baking\nsource: grandma\n---\nBake.\n",
+     NULL,
+     "<article class=\"recipe\">\n<header>\n<h1>Bread</h1>\n"
+     "<dl class=\"metadata\"><dt>source</dt><dd>grandma</dd></dl>\n</header>\n"
+     "<section class=\"method\">\n<ol class=\"steps\">\n<li>Bake.</li>\n</ol>\n</section>\n"
+     "</article>\n", false},
+    {"sections, notes and references",
+     "= Dough\n@flour{1/2%cup}(sifted) with @./sauces/base{}\n\n> Rest it.\n\nKnead -- well\n\n"
+     "= Bake\nBake ~oven{}.\n",
+     NULL,
+     "<article class=\"recipe\">\n"
+     "<section class=\"ingredients\">\n<h2>Ingredients</h2>\n<ul>\n"
+     "<li><span class=\"quantity\">1/2 cup</span> <span class=\"name\">flour</span>"
+     " <span class=\"note\">sifted</span></li>\n"
+     "<li><a class=\"name reference\" href=\"sauces/base.html\">base</a></li>\n"
+     "</ul>\n</section>\n"
+     "<section class=\"method\">\n<h2>Dough</h2>\n<ol class=\"steps\">\n"
+     "<li><span class=\"ingredient\">flour</span> with "
+     "<a class=\"ingredient reference\" href=\"sauces/base.html\">base</a></li>\n</ol>\n"
+     "<aside class=\"note\"><p>Rest it.</p></aside>\n"
+     "<ol class=\"steps\" start=\"2\">\n<li>Knead</li>\n</ol>\n</section>\n"
+     "<section class=\"method\">\n<h2>Bake</h2>\n<ol class=\"steps\">\n"
+     "<li>Bake <span class=\"timer\">oven</span>.</li>\n</ol>\n</section>\n</article>\n", false},
+    {"reference paths",
+     "Use @./my sauces/./crème fraîche{} and @./../../etc/passwd{}.\n", NULL,
+     "<article class=\"recipe\">\n"
+     "<section class=\"ingredients\">\n<h2>Ingredients</h2>\n<ul>\n"
+     "<li><a class=\"name reference\" href=\"my%20sauces/cr%C3%A8me%20fra%C3%AEche.html\">"
+     "crème fraîche</a></li>\n"
+     "<li><span class=\"name\">./../../etc/passwd</span></li>\n</ul>\n</section>\n"
+     "<section class=\"method\">\n<ol class=\"steps\">\n"
+     "<li>Use <a class=\"ingredient reference\""
+     " href=\"my%20sauces/cr%C3%A8me%20fra%C3%AEche.html\">crème fraîche</a>"
+     " and <span class=\"ingredient\">./../../etc/passwd</span>.</li>\n</ol>\n"
+     "</section>\n</article>\n", false},
+    {"escaping", ">> a<b: \"x\" & 'y'\n\nSay <b>hi</b> to @egg{2}(big & brown).\n", NULL,
+     "<article class=\"recipe\">\n<header>\n"
+     "<dl class=\"metadata\"><dt>a&lt;b</dt><dd>&quot;x&quot; &amp; &#39;y&#39;</dd></dl>\n"
+     "</header>\n"
+     "<section class=\"ingredients\">\n<h2>Ingredients</h2>\n<ul>\n"
+     "<li><span class=\"quantity\">2</span> <span class=\"name\">egg</span>"
+     " <span class=\"note\">big &amp; brown</span></li>\n</ul>\n</section>\n"
+     "<section class=\"method\">\n<ol class=\"steps\">\n"
+     "<li>Say &lt;b&gt;hi&lt;/b&gt; to <span class=\"ingredient\">egg</span>.</li>\n</ol>\n"
+     "</section>\n</article>\n", false},
+    {"whole page", ">> title: Fish & Chips\n", "Ignored",
+     "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+     "<title>Fish &amp; Chips</title>\n</head>\n<body>\n"
+     "<article class=\"recipe\">\n<header>\n<h1>Fish &amp; Chips</h1>\n</header>\n</article>\n"
+     "</body>\n</html>\n",
+     true},
+};
+
+static unsigned failures;
+
+int main(void) {
+    printf("HTML rendering test\n");
+    printf("======================================\n");
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText out;
+    cooklang_text_init(&out);
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        const HtmlCase *test = &CASES[i];
+        uint32_t length = (uint32_t)strlen(test->recipe);
+        TSTree *tree = ts_parser_parse_string(parser, NULL, test->recipe, length);
+        out.length = 0;
+        TSNode root = ts_tree_root_node(tree);
+        bool ok = test->page ? cooklang_html_write_page(test->recipe, root, test->title, &out)
+                             : cooklang_html_write_recipe(test->recipe, root, test->title, &out);
+        ok = ok && cooklang_text_reserve(&out, 0);
+        ts_tree_delete(tree);
+        if (ok) {
+            out.data[out.length] = '\0';
+        }
+
+        if (ok && strcmp(out.data, test->expected) == 0) {
+            printf("  " GREEN "✓" NC " %s\n", test->description);
+        } else {
+            failures++;
+            printf("  " RED "✗" NC " %s\n    expected: %s\n    actual:   %s\n", test->description,
+                   test->expected, ok ? out.data : "(failed)");
+        }
+    }
+    cooklang_text_free(&out);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
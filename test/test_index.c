@@ -0,0 +1,111 @@
+// The recipe index in bindings/c: adding, updating, removing and finding
+// recipes by path, with entities kept in step with the text.
+
+#include "cooklang_index.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static bool update(CooklangIndex *index, TSParser *parser, const char *path, const char *text) {
+    return cooklang_index_update(index, parser, path, text, (uint32_t)strlen(text));
+}
+
+static uint32_t count_kind(const CooklangIndexEntry *entry, CooklangEntityKind kind) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < entry->entities.length; i++) {
+        count += entry->entities.entities[i].kind == kind;
+    }
+    return count;
+}
+
+static void test_updates(TSParser *parser) {
+    CooklangIndex index;
+    cooklang_index_init(&index);
+    check(update(&index, parser, "soup.cook", "Boil @water{1%l} in a #pot{}.\n") &&
+              index.length == 1 && index.generation == 1,
+          "adding a recipe");
+    CooklangIndexEntry *entry = cooklang_index_find(&index, "soup.cook");
+    check(entry && entry->tree && count_kind(entry, COOKLANG_ENTITY_INGREDIENT) == 1 &&
+              count_kind(entry, COOKLANG_ENTITY_COOKWARE) == 1,
+          "entities are extracted");
+
+    update(&index, parser, "soup.cook", "Boil @water{1%l} in a #pot{}.\n");
+    check(index.generation == 1, "unchanged text is not reparsed");
+
+    static const char EDITED[] = "Boil @water{1%l} and @salt{} in a #pot{}.\nServe.\n";
+    entry = cooklang_index_find(&index, "soup.cook");
+    check(update(&index, parser, "soup.cook", EDITED) && index.length == 1 &&
+              index.generation == 2 && strcmp(entry->text.data, EDITED) == 0 &&
+              count_kind(entry, COOKLANG_ENTITY_INGREDIENT) == 2 &&
+              ts_node_end_byte(ts_tree_root_node(entry->tree)) == sizeof(EDITED) - 1,
+          "updates reparse and re-extract");
+
+    check(cooklang_index_remove(&index, "soup.cook") && index.length == 0 &&
+              !cooklang_index_find(&index, "soup.cook") && index.generation == 3,
+          "removing a recipe");
+    check(!cooklang_index_remove(&index, "soup.cook") && index.generation == 3,
+          "removing an unknown path");
+    cooklang_index_free(&index);
+}
+
+// Enough paths to grow the table several times, removed in an order that
+// moves entries around, with every remaining path still found afterwards.
+static void test_many_paths(TSParser *parser) {
+    enum { COUNT = 500 };
+    CooklangIndex index;
+    cooklang_index_init(&index);
+    char path[32];
+    bool added = true;
+    for (uint32_t i = 0; i < COUNT; i++) {
+        snprintf(path, sizeof(path), "recipes/%u.cook", i);
+        added = added && update(&index, parser, path, "Add @salt{}.\n");
+    }
+    check(added && index.length == COUNT, "indexing many recipes");
+
+    bool removed = true;
+    for (uint32_t i = 0; i < COUNT; i += 3) {
+        snprintf(path, sizeof(path), "recipes/%u.cook", i);
+        removed = removed && cooklang_index_remove(&index, path);
+    }
+    bool found = true;
+    for (uint32_t i = 0; i < COUNT; i++) {
+        snprintf(path, sizeof(path), "recipes/%u.cook", i);
+        CooklangIndexEntry *entry = cooklang_index_find(&index, path);
+        found = found && (i % 3 == 0 ? entry == NULL : entry && strcmp(entry->path, path) == 0);
+    }
+    check(removed && found && index.length == COUNT - (COUNT + 2) / 3,
+          "lookups after removals");
+    cooklang_index_free(&index);
+}
+
+int main(void) {
+    printf("Index test\n");
+    printf("======================================\n");
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    test_updates(parser);
+    test_many_paths(parser);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// Name interning in bindings/c: stable ids, normalization, growth, and
+// interning the entities of extracted recipes.
+
+#include "cooklang_intern.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static uint32_t intern(CooklangInternTable *table, const char *name) {
+    return cooklang_intern(table, name, (uint32_t)strlen(name));
+}
+
+static bool name_is(const CooklangInternTable *table, uint32_t id, const char *expected) {
+    uint32_t length;
+    const char *name = cooklang_intern_name(table, id, &length);
+    return length == strlen(expected) && strcmp(name, expected) == 0;
+}
+
+static void test_exact(void) {
+    CooklangInternTable table;
+    cooklang_intern_table_init(&table, false);
+    uint32_t salt = intern(&table, "salt");
+    uint32_t oil = intern(&table, "olive oil");
+    check(salt == 0 && oil == 1 && intern(&table, "salt") == salt &&
+              intern(&table, "Salt") == 2 && table.length == 3,
+          "ids in order of first appearance");
+    check(name_is(&table, salt, "salt") && name_is(&table, oil, "olive oil") &&
+              cooklang_intern_find(&table, "olive oil", 9) == oil &&
+              cooklang_intern_find(&table, "pepper", 6) == COOKLANG_INTERN_NONE &&
+              table.length == 3,
+          "names by id, and ids by name");
+    check(intern(&table, "") == 3 && name_is(&table, 3, "") && intern(&table, "") == 3,
+          "the empty name");
+
+    // Ids must survive every rehash and every move of the strings.
+    char name[32];
+    bool stable = true;
+    for (uint32_t i = 0; i < 20000; i++) {
+        snprintf(name, sizeof(name), "ingredient %u", i);
+        stable = stable && intern(&table, name) == 4 + i;
+    }
+    for (uint32_t i = 0; i < 20000; i += 7) {
+        snprintf(name, sizeof(name), "ingredient %u", i);
+        stable = stable && intern(&table, name) == 4 + i && name_is(&table, 4 + i, name);
+    }
+    check(stable && name_is(&table, salt, "salt") && table.length == 20004,
+          "ids are stable as the table grows");
+    cooklang_intern_table_free(&table);
+}
+
+static void test_normalizing(void) {
+    CooklangInternTable table;
+    cooklang_intern_table_init(&table, true);
+    uint32_t oil = intern(&table, "Olive Oil");
+    check(intern(&table, "  olive\t\n oil ") == oil && intern(&table, "OLIVE OIL") == oil &&
+              name_is(&table, oil, "olive oil") && table.length == 1,
+          "case and whitespace variants share an id");
+    check(cooklang_intern_find(&table, " Olive   OIL", 12) == oil &&
+              cooklang_intern_find(&table, "olive", 5) == COOKLANG_INTERN_NONE,
+          "finding by a variant");
+    check(intern(&table, "crème fraîche") == 1 && intern(&table, "CRèME FRAîCHE") == 1 &&
+              intern(&table, "CRÈME FRAÎCHE") == 2,
+          "only ASCII is lowercased");
+    cooklang_intern_table_free(&table);
+}
+
+static void test_entities(void) {
+    static const char RECIPE[] = ">> title: Eggs\n"
+                                 "Fry @eggs{2} in @Olive Oil{1%tbsp} in a #pan.\n"
+                                 "Salt with @salt{} and add @OLIVE oil{2%TBSP} from a #Pan{}.\n"
+                                 "Rest for ~{5%min}, then ~eat{1%min}.\n";
+    CooklangEntityList entities;
+    cooklang_entity_list_init(&entities);
+    cooklang_extract(RECIPE, sizeof(RECIPE) - 1, &entities);
+    CooklangInternTable names, units;
+    cooklang_intern_table_init(&names, true);
+    cooklang_intern_table_init(&units, true);
+    CooklangEntityIds ids[16];
+    bool interned = entities.length <= 16 &&
+                    cooklang_intern_entities(&names, &units, RECIPE, &entities, ids);
+
+    // metadata, eggs, olive oil, pan, salt, olive oil, pan, timer, eat
+    check(interned && entities.length == 9, "interning extracted entities");
+    check(interned && ids[0].name == COOKLANG_INTERN_NONE && ids[0].unit == COOKLANG_INTERN_NONE &&
+              name_is(&names, ids[1].name, "eggs") && ids[1].unit == COOKLANG_INTERN_NONE &&
+              ids[2].name == ids[5].name && name_is(&names, ids[2].name, "olive oil") &&
+              ids[3].name == ids[6].name && name_is(&names, ids[3].name, "pan") &&
+              ids[4].unit == COOKLANG_INTERN_NONE,
+          "names");
+    check(interned && ids[2].unit == ids[5].unit && name_is(&units, ids[2].unit, "tbsp") &&
+              ids[7].name == COOKLANG_INTERN_NONE && name_is(&units, ids[7].unit, "min") &&
+              name_is(&names, ids[8].name, "eat") && ids[8].unit == ids[7].unit &&
+              units.length == 2,
+          "units and timers");
+    cooklang_intern_table_free(&names);
+    cooklang_intern_table_free(&units);
+    cooklang_entity_list_free(&entities);
+}
+
+int main(void) {
+    printf("Intern test\n");
+    printf("======================================\n");
+
+    test_exact();
+    test_normalizing();
+    test_entities();
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
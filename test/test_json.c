@@ -0,0 +1,137 @@
+// JSON export of parsed recipes in bindings/c: document shape, step items
+// and their entity indices, quantities, and string escaping.
+
+#include "cooklang_json.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+typedef struct {
+    const char *description;
+    const char *recipe;
+    const char *expected;
+} JsonCase;
+
+static const JsonCase CASES[] = {
+    {"empty recipe", "",
+     "{\"metadata\":[],\"frontmatter\":null,\"sections\":[{\"name\":null,\"content\":[]}],"
+     "\"ingredients\":[],\"cookware\":[],\"timers\":[]}"},
+    {"metadata and entities", ">> servings: 4\n\nAdd @salt{1%tsp} to #pot{} and wait ~{10%min}.\n",
+     "{\"metadata\":[{\"key\":\"servings\",\"value\":\"4\"}],\"frontmatter\":null,"
+     "\"sections\":[{\"name\":null,\"content\":[{\"type\":\"step\",\"items\":["
+     "{\"type\":\"text\",\"value\":\"Add \"},{\"type\":\"ingredient\",\"index\":0},"
+     "{\"type\":\"text\",\"value\":\" to \"},{\"type\":\"cookware\",\"index\":0},"
+     "{\"type\":\"text\",\"value\":\" and wait \"},{\"type\":\"timer\",\"index\":0},"
+     "{\"type\":\"text\",\"value\":\".\"}]}]}],"
+     "\"ingredients\":[{\"name\":\"salt\",\"quantity\":{\"text\":\"1%tsp\",\"amount\":\"1\","
+     "\"unit\":\"tsp\",\"low\":1,\"high\":1,\"fixed\":false},\"note\":null,\"reference\":false}],"
+     "\"cookware\":[{\"name\":\"pot\",\"quantity\":null,\"note\":null}],"
+     "\"timers\":[{\"name\":null,\"quantity\":{\"text\":\"10%min\",\"amount\":\"10\","
+     "\"unit\":\"min\",\"low\":10,\"high\":10,\"fixed\":false},\"note\":null}]}"},
+    {"sections, notes and references",
+     "= Dough\n@flour{1/2%cup}(sifted) with @./sauces/base{}\n\n> Rest it.\n",
+     "{\"metadata\":[],\"frontmatter\":null,\"sections\":[{\"name\":\"Dough\",\"content\":["
+     "{\"type\":\"step\",\"items\":[{\"type\":\"ingredient\",\"index\":0},"
+     "{\"type\":\"text\",\"value\":\" with \"},{\"type\":\"ingredient\",\"index\":1}]},"
+     "{\"type\":\"note\",\"value\":\"Rest it.\"}]}],"
+     "\"ingredients\":[{\"name\":\"flour\",\"quantity\":{\"text\":\"1/2%cup\",\"amount\":\"1/2\","
+     "\"unit\":\"cup\",\"low\":0.5,\"high\":0.5,\"fixed\":false},\"note\":\"sifted\","
+     "\"reference\":false},{\"name\":\"./sauces/base\",\"quantity\":null,\"note\":null,"
+     "\"reference\":true}],\"cookware\":[],\"timers\":[]}"},
+    {"escaping and fixed amounts", "Say \"hi\"\tto @egg{=2}.\n",
+     "{\"metadata\":[],\"frontmatter\":null,\"sections\":[{\"name\":null,\"content\":["
+     "{\"type\":\"step\",\"items\":[{\"type\":\"text\",\"value\":\"Say \\\"hi\\\"\\tto \"},"
+     "{\"type\":\"ingredient\",\"index\":0},{\"type\":\"text\",\"value\":\".\"}]}]}],"
+     "\"ingredients\":[{\"name\":\"egg\",\"quantity\":{\"text\":\"=2\",\"amount\":\"2\","
+     "\"unit\":\"\",\"low\":2,\"high\":2,\"fixed\":true},\"note\":null,\"reference\":false}],"
+     "\"cookware\":[],\"timers\":[]}"},
+    {"shortest round-trip amounts", "@flour{1/3%cup}\n",
+     "{\"metadata\":[],\"frontmatter\":null,\"sections\":[{\"name\":null,\"content\":["
+     "{\"type\":\"step\",\"items\":[{\"type\":\"ingredient\",\"index\":0}]}]}],"
+     "\"ingredients\":[{\"name\":\"flour\",\"quantity\":{\"text\":\"1/3%cup\","
+     "\"amount\":\"1/3\",\"unit\":\"cup\",\"low\":0.3333333333333333,"
+     "\"high\":0.3333333333333333,\"fixed\":false},\"note\":null,\"reference\":false}],"
+     "\"cookware\":[],\"timers\":[]}"},
+};
+
+typedef struct {
+    const char *description;
+    const char *text;
+    const char *expected;
+} StringCase;
+
+static const StringCase STRING_CASES[] = {
+    {"valid UTF-8 is kept", "caf\xC3\xA9 \xE5\x91\xB3 \xF0\x9F\x8D\x85",
+     "\"caf\xC3\xA9 \xE5\x91\xB3 \xF0\x9F\x8D\x85\""},
+    {"stray continuation byte", "a\x80" "b", "\"a\\ufffdb\""},
+    {"overlong form", "\xC0\xAF", "\"\\ufffd\\ufffd\""},
+    {"surrogate", "\xED\xA0\x80", "\"\\ufffd\\ufffd\\ufffd\""},
+    {"beyond U+10FFFF", "\xF4\x90\x80\x80", "\"\\ufffd\\ufffd\\ufffd\\ufffd\""},
+    {"truncated sequence", "x\xE5\x91", "\"x\\ufffd\\ufffd\""},
+    {"control characters", "\x01\x1f", "\"\\u0001\\u001f\""},
+};
+
+static unsigned failures;
+
+static void test_strings(CooklangText *out) {
+    printf("Strings\n");
+    for (size_t i = 0; i < sizeof(STRING_CASES) / sizeof(STRING_CASES[0]); i++) {
+        const StringCase *test = &STRING_CASES[i];
+        out->length = 0;
+        bool ok = cooklang_json_write_string(out, test->text, (uint32_t)strlen(test->text)) &&
+                  cooklang_text_reserve(out, 0);
+        if (ok) {
+            out->data[out->length] = '\0';
+        }
+        if (ok && strcmp(out->data, test->expected) == 0) {
+            printf("  " GREEN "✓" NC " %s\n", test->description);
+        } else {
+            failures++;
+            printf("  " RED "✗" NC " %s\n    expected: %s\n    actual:   %s\n", test->description,
+                   test->expected, ok ? out->data : "(failed)");
+        }
+    }
+}
+
+int main(void) {
+    printf("JSON export test\n");
+    printf("======================================\n");
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText out;
+    cooklang_text_init(&out);
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        const JsonCase *test = &CASES[i];
+        uint32_t length = (uint32_t)strlen(test->recipe);
+        TSTree *tree = ts_parser_parse_string(parser, NULL, test->recipe, length);
+        out.length = 0;
+        bool ok = cooklang_json_write_recipe(test->recipe, ts_tree_root_node(tree), &out) &&
+                  cooklang_text_reserve(&out, 0);
+        ts_tree_delete(tree);
+        if (ok) {
+            out.data[out.length] = '\0';
+        }
+
+        if (ok && strcmp(out.data, test->expected) == 0) {
+            printf("  " GREEN "✓" NC " %s\n", test->description);
+        } else {
+            failures++;
+            printf("  " RED "✗" NC " %s\n    expected: %s\n    actual:   %s\n", test->description,
+                   test->expected, ok ? out.data : "(failed)");
+        }
+    }
+    test_strings(&out);
+    cooklang_text_free(&out);
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+// Recipe packs in bindings/c: building one, finding recipes by path,
+// precomputed metadata, parsing on demand, and rejecting damaged packs.
+
+#define _DEFAULT_SOURCE
+
+#include "cooklang_pack.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static char path[] = "/tmp/cooklang-pack-XXXXXX";
+
+static const struct {
+    const char *path;
+    const char *text;
+} RECIPES[] = {
+    {"soups/tomato.cook", ">> title: Tomato soup\n>> servings: 4\n\nSimmer @tomatoes{6} in a #pot{}.\n"},
+    {"desserts/flan.cook", "---\ntitle: Flan\ntags:\n  - dessert\ncourse: dessert \n---\nWhisk @eggs{4}.\n"},
+    {"bread.cook", "Knead @flour{500%g} with @water{300%ml}.\n"},
+};
+
+#define RECIPE_COUNT (sizeof(RECIPES) / sizeof(RECIPES[0]))
+
+static bool build(bool metadata) {
+    CooklangPackWriter writer;
+    if (!cooklang_pack_writer_open(&writer, path, metadata)) {
+        return false;
+    }
+    bool ok = true;
+    for (uint32_t i = 0; i < RECIPE_COUNT; i++) {
+        ok = ok && cooklang_pack_writer_add(&writer, RECIPES[i].path, RECIPES[i].text,
+                                            (uint32_t)strlen(RECIPES[i].text));
+    }
+    return cooklang_pack_writer_finish(&writer) && ok;
+}
+
+static bool metadata_is(const CooklangPackRecipe *recipe, const char *key, const char *value) {
+    CooklangSpan span;
+    return cooklang_pack_find_metadata(recipe, key, &span) &&
+           span.end - span.start == strlen(value) &&
+           memcmp(recipe->text + span.start, value, span.end - span.start) == 0;
+}
+
+static void test_reading(TSParser *parser) {
+    CooklangPack pack;
+    check(build(true) && cooklang_pack_open(&pack, path) && pack.count == RECIPE_COUNT,
+          "building and opening a pack");
+
+    bool found = true;
+    for (uint32_t i = 0; i < RECIPE_COUNT; i++) {
+        uint32_t index = cooklang_pack_find(&pack, RECIPES[i].path);
+        CooklangPackRecipe recipe;
+        found = found && index != UINT32_MAX;
+        if (found) {
+            found = cooklang_pack_recipe(&pack, index, &recipe) &&
+                    strcmp(recipe.path, RECIPES[i].path) == 0 &&
+                    recipe.length == strlen(RECIPES[i].text) &&
+                    strcmp(recipe.text, RECIPES[i].text) == 0;
+        }
+    }
+    check(found && cooklang_pack_find(&pack, "soups") == UINT32_MAX &&
+              cooklang_pack_find(&pack, "zzz.cook") == UINT32_MAX,
+          "finding recipes by path");
+
+    CooklangPackRecipe first;
+    check(cooklang_pack_recipe(&pack, 0, &first) && strcmp(first.path, "bread.cook") == 0,
+          "recipes are in path order");
+
+    CooklangPackRecipe soup, flan;
+    cooklang_pack_recipe(&pack, cooklang_pack_find(&pack, "soups/tomato.cook"), &soup);
+    cooklang_pack_recipe(&pack, cooklang_pack_find(&pack, "desserts/flan.cook"), &flan);
+    CooklangSpan span;
+    check(soup.metadata_count == 2 && metadata_is(&soup, "title", "Tomato soup") &&
+              metadata_is(&soup, "servings", "4") && !cooklang_pack_find_metadata(&soup, "tags", &span),
+          "metadata lines");
+    check(flan.metadata_count == 3 && metadata_is(&flan, "title", "Flan") &&
+              metadata_is(&flan, "course", "dessert") && metadata_is(&flan, "tags", "") &&
+              first.metadata_count == 0,
+          "top-level frontmatter keys");
+
+    TSTree *tree = cooklang_pack_parse(parser, &soup);
+    check(tree && ts_node_end_byte(ts_tree_root_node(tree)) == soup.length,
+          "parsing a recipe on demand");
+    if (tree) {
+        ts_tree_delete(tree);
+    }
+    cooklang_pack_close(&pack);
+
+    check(build(false) && cooklang_pack_open(&pack, path) && pack.count == RECIPE_COUNT,
+          "a pack without metadata");
+    cooklang_pack_recipe(&pack, cooklang_pack_find(&pack, "soups/tomato.cook"), &soup);
+    check(soup.metadata_count == 0 && !cooklang_pack_find_metadata(&soup, "title", &span),
+          "has no metadata");
+    cooklang_pack_close(&pack);
+}
+
+static bool read_pack(uint8_t **data, long *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    rewind(file);
+    *data = malloc((size_t)*size);
+    bool ok = fread(*data, 1, (size_t)*size, file) == (size_t)*size;
+    fclose(file);
+    return ok;
+}
+
+static void test_damage(void) {
+    uint8_t *data = NULL;
+    long size = 0;
+    CooklangPack pack;
+    bool built = build(true) && read_pack(&data, &size);
+    check(built && cooklang_pack_open_memory(&pack, data, (uint64_t)size), "an intact pack");
+
+    bool truncated_rejected = true;
+    for (long length = 0; built && length < size; length += 7) {
+        truncated_rejected = truncated_rejected &&
+                             !cooklang_pack_open_memory(&pack, data, (uint64_t)length);
+    }
+    check(built && truncated_rejected, "truncated packs are rejected");
+
+    // Damage each byte of the index in turn; whatever the pack still
+    // accepts, and whichever recipes it still reads, must only point
+    // inside it.
+    bool contained = true;
+    uint64_t index_offset = 0;
+    for (int i = 0; i < 8; i++) {
+        index_offset |= (uint64_t)data[16 + i] << (8 * i);
+    }
+    for (long offset = (long)index_offset; built && offset < size; offset++) {
+        uint8_t saved = data[offset];
+        data[offset] ^= 0xA5;
+        if (cooklang_pack_open_memory(&pack, data, (uint64_t)size)) {
+            for (uint32_t i = 0; i < pack.count; i++) {
+                CooklangPackRecipe recipe;
+                if (!cooklang_pack_recipe(&pack, i, &recipe)) {
+                    continue;
+                }
+                contained = contained && (const uint8_t *)recipe.text >= data &&
+                            (const uint8_t *)recipe.text + recipe.length < data + size &&
+                            recipe.text[recipe.length] == '\0';
+            }
+        }
+        data[offset] = saved;
+    }
+    check(built && contained, "damaged indexes never point outside the pack");
+
+    // Texts are only checked when read: a damaged one still opens, but
+    // cannot be read.
+    CooklangPackRecipe recipe;
+    bool damaged_rejected = built && cooklang_pack_open_memory(&pack, data, (uint64_t)size) &&
+                            cooklang_pack_recipe(&pack, 0, &recipe);
+    if (damaged_rejected) {
+        uint8_t *terminator = data + ((const uint8_t *)recipe.text + recipe.length - data);
+        *terminator = 'x';
+        damaged_rejected = cooklang_pack_open_memory(&pack, data, (uint64_t)size) &&
+                           !cooklang_pack_recipe(&pack, 0, &recipe) &&
+                           cooklang_pack_recipe(&pack, 1, &recipe);
+        *terminator = '\0';
+    }
+    check(damaged_rejected, "damaged recipes are rejected when read");
+    free(data);
+
+    CooklangPackWriter writer;
+    bool duplicate_rejected = cooklang_pack_writer_open(&writer, path, true);
+    cooklang_pack_writer_add(&writer, "a.cook", "", 0);
+    cooklang_pack_writer_add(&writer, "a.cook", "", 0);
+    duplicate_rejected = duplicate_rejected && !cooklang_pack_writer_finish(&writer);
+    check(duplicate_rejected, "duplicate paths are rejected");
+
+    check(cooklang_pack_writer_open(&writer, path, true) && cooklang_pack_writer_finish(&writer) &&
+              cooklang_pack_open(&pack, path) && pack.count == 0 &&
+              cooklang_pack_find(&pack, "a.cook") == UINT32_MAX,
+          "an empty pack");
+    cooklang_pack_close(&pack);
+}
+
+int main(void) {
+    printf("Pack test\n");
+    printf("======================================\n");
+
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    test_reading(parser);
+    test_damage();
+    ts_parser_delete(parser);
+    unlink(path);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Quantity evaluation, scaling and serialization in bindings/c, for single
+// quantities and for whole recipes through the parser.
+
+#include "cooklang_quantity.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+typedef struct {
+    const char *text;
+    CooklangRational factor;
+    const char *expected;
+} QuantityCase;
+
+static const QuantityCase QUANTITY_CASES[] = {
+    {"2%cups", {2, 1}, "4"},
+    {"1/2%cup", {3, 2}, "3/4"},
+    {"1 1/2%cups", {3, 2}, "2 1/4"},
+    {"1 / 3", {2, 1}, "2/3"},
+    {"0.25", {3, 2}, "0.375"},
+    {"2.5%tbsp", {1, 3}, "0.833"},
+    {"2-3%tbsp", {3, 2}, "3-4.5"},
+    {"1/2-1%cup", {3, 2}, "3/4-1 1/2"},
+    {"=2%pinch", {3, 1}, "2"},
+    {"18446744073709551615", {2, 1}, "18446744073709551615"},
+    {"some%g", {2, 1}, ""},
+    {"", {2, 1}, ""},
+};
+
+typedef struct {
+    const char *recipe;
+    CooklangRational factor;
+    const char *expected;
+} RecipeCase;
+
+static const RecipeCase RECIPE_CASES[] = {
+    {"Add @flour{1 1/2%cups} and @salt{=1%tsp}.\n", {2, 1},
+     "Add @flour{3%cups} and @salt{=1%tsp}.\n"},
+    {"Boil @water{2-3%l} in a #pot{2} for ~{10%minutes}.\n", {1, 2},
+     "Boil @water{1-1.5%l} in a #pot{2} for ~{10%minutes}.\n"},
+    {">> servings: 4\n\n@eggs{3} and @milk{ 0.5 % l }(cold)\n", {3, 4},
+     ">> servings: 4\n\n@eggs{2.25} and @milk{ 0.375 % l }(cold)\n"},
+};
+
+static unsigned failures;
+
+static void check(bool ok, const char *description, const char *actual, const char *expected) {
+    if (ok) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n    expected: %s\n    actual:   %s\n", description,
+               expected, actual);
+    }
+}
+
+static void test_quantities(void) {
+    printf("Quantities\n");
+    for (size_t i = 0; i < sizeof(QUANTITY_CASES) / sizeof(QUANTITY_CASES[0]); i++) {
+        const QuantityCase *test = &QUANTITY_CASES[i];
+        CooklangQuantity quantity;
+        cooklang_quantity_parse(test->text, (CooklangSpan){0, (uint32_t)strlen(test->text)},
+                                &quantity);
+        cooklang_quantity_scale(&quantity, test->factor);
+        char actual[128];
+        cooklang_quantity_format(&quantity, actual, sizeof(actual));
+
+        char description[128];
+        snprintf(description, sizeof(description), "{%s} x %llu/%llu", test->text,
+                 (unsigned long long)test->factor.numerator,
+                 (unsigned long long)test->factor.denominator);
+        check(strcmp(actual, test->expected) == 0, description, actual, test->expected);
+    }
+}
+
+static void test_recipes(void) {
+    printf("Recipes\n");
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText out;
+    cooklang_text_init(&out);
+    for (size_t i = 0; i < sizeof(RECIPE_CASES) / sizeof(RECIPE_CASES[0]); i++) {
+        const RecipeCase *test = &RECIPE_CASES[i];
+        uint32_t length = (uint32_t)strlen(test->recipe);
+        TSTree *tree = ts_parser_parse_string(parser, NULL, test->recipe, length);
+        bool ok = cooklang_scale_recipe(test->recipe, length, ts_tree_root_node(tree),
+                                        test->factor, &out, NULL);
+        ts_tree_delete(tree);
+
+        char description[64];
+        snprintf(description, sizeof(description), "recipe %zu", i + 1);
+        check(ok && strcmp(out.data, test->expected) == 0, description, ok ? out.data : "(failed)",
+              test->expected);
+    }
+    cooklang_text_free(&out);
+    ts_parser_delete(parser);
+}
+
+int main(void) {
+    printf("Quantity scaling test\n");
+    printf("======================================\n");
+    test_quantities();
+    test_recipes();
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+// The full-text index in bindings/c: words from each field, BM25 ranking
+// and field weights, long posting lists, and indexes built on several
+// threads matching the one built on one.
+
+#include "cooklang_search.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static unsigned failures;
+
+static void check(bool passed, const char *description) {
+    if (passed) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n", description);
+    }
+}
+
+static const char *const RECIPES[] = {
+    "Boil the @pasta{500%g} in a #pot{} of salted water.\n",
+    "Mix @tomato sauce{1%cup}(ripe plum tomatoes) with the pasta.\n> Serve with basil.\n",
+    "Slice the @basil{} thinly.\n",
+    "Roast the @tomatoes{4} until soft, then blend them with the other tomatoes and a "
+    "little water until the sauce is smooth and glossy.\n",
+    "-- A comment about pasta\nBake the @bread{} in a #Dutch oven{}.\n",
+};
+
+#define RECIPE_COUNT (sizeof(RECIPES) / sizeof(RECIPES[0]))
+
+static CooklangSearchIndex *build(const char *const *texts, uint32_t count, unsigned threads) {
+    CooklangSearchDocument *documents = malloc((count + 1) * sizeof(CooklangSearchDocument));
+    for (uint32_t i = 0; i < count; i++) {
+        documents[i] = (CooklangSearchDocument){texts[i], (uint32_t)strlen(texts[i])};
+    }
+    CooklangSearchIndex *index =
+        cooklang_search_index_build(tree_sitter_cooklang(), documents, count, threads);
+    free(documents);
+    return index;
+}
+
+static int32_t search(const CooklangSearchIndex *index, const char *query, const float *weights,
+                      CooklangSearchHit *hits, uint32_t max_hits) {
+    return cooklang_search(index, query, (uint32_t)strlen(query), weights, hits, max_hits);
+}
+
+static bool found_in_order(const CooklangSearchIndex *index, const char *query, const float *weights,
+                           const uint32_t *expected, int32_t expected_count) {
+    CooklangSearchHit hits[8];
+    int32_t count = search(index, query, weights, hits, 8);
+    bool same = count == expected_count;
+    for (int32_t i = 0; same && i < count; i++) {
+        same = hits[i].document == expected[i] && hits[i].score > 0 &&
+               (i == 0 || hits[i].score <= hits[i - 1].score);
+    }
+    return same;
+}
+
+static void test_fields(void) {
+    CooklangSearchIndex *index = build(RECIPES, RECIPE_COUNT, 1);
+    check(index != NULL, "building an index");
+    if (!index) {
+        return;
+    }
+
+    static const float NAMES_ONLY[COOKLANG_SEARCH_FIELD_COUNT] = {0, 0, 1};
+    static const float NOTES_ONLY[COOKLANG_SEARCH_FIELD_COUNT] = {0, 1, 0};
+    check(found_in_order(index, "basil", NAMES_ONLY, (uint32_t[]){2}, 1) &&
+              found_in_order(index, "basil", NOTES_ONLY, (uint32_t[]){1}, 1),
+          "names and recipe notes are separate fields");
+    check(found_in_order(index, "plum", NOTES_ONLY, (uint32_t[]){1}, 1) &&
+              found_in_order(index, "plum", NAMES_ONLY, NULL, 0),
+          "ingredient notes");
+    check(found_in_order(index, "oven", NULL, (uint32_t[]){4}, 1) &&
+              found_in_order(index, "comment", NULL, NULL, 0) &&
+              found_in_order(index, "500", NULL, NULL, 0),
+          "cookware names, but not comments or quantities");
+    check(found_in_order(index, "POT", NULL, (uint32_t[]){0}, 1) &&
+              found_in_order(index, "unknown", NULL, NULL, 0) &&
+              found_in_order(index, "", NULL, NULL, 0) &&
+              found_in_order(index, " ,.- ", NULL, NULL, 0),
+          "case, unknown words and empty queries");
+
+    // "pasta" is a name in recipe 0 and a word of the text in recipe 1.
+    check(found_in_order(index, "pasta", NULL, (uint32_t[]){0, 1}, 2),
+          "names weigh more than text");
+    // Recipe 3 says "tomatoes" twice, but is long; recipe 1's note is short.
+    check(found_in_order(index, "tomatoes", NULL, (uint32_t[]){3, 1}, 2) &&
+              found_in_order(index, "water tomatoes", NULL, (uint32_t[]){3, 0, 1}, 3),
+          "term counts, lengths and several words");
+
+    CooklangSearchHit hits[2];
+    check(search(index, "pasta water basil sauce", NULL, hits, 2) == 2 &&
+              search(index, "pasta", NULL, hits, 0) == 0,
+          "the number of hits is capped");
+
+    CooklangSearchStats stats;
+    cooklang_search_index_stats(index, &stats);
+    check(stats.documents == RECIPE_COUNT && stats.terms > 20 && stats.postings > stats.terms &&
+              stats.posting_bytes >= 2 * stats.postings && stats.bytes > stats.posting_bytes,
+          "statistics");
+    cooklang_search_index_delete(index);
+}
+
+// Recipes far enough apart, and words repeated often enough, that gaps and
+// counts take several bytes.
+static void test_long_lists(void) {
+    enum { COUNT = 20000 };
+    char **texts = malloc(COUNT * sizeof(char *));
+    for (uint32_t i = 0; i < COUNT; i++) {
+        texts[i] = malloc(1200);
+        int length = snprintf(texts[i], 1200, "Stir @flour%u{} well", i % 7);
+        if (i % 5000 == 1) {
+            for (int r = 0; r < 200; r++) {
+                length += snprintf(texts[i] + length, 1200 - length, " rare");
+            }
+        }
+        snprintf(texts[i] + length, 1200 - length, ".\n");
+    }
+
+    CooklangSearchIndex *single = build((const char *const *)texts, COUNT, 1);
+    CooklangSearchIndex *parallel = build((const char *const *)texts, COUNT, 7);
+    check(single && parallel, "building from one thread and from seven");
+    if (single && parallel) {
+        CooklangSearchHit hits[8];
+        bool rare = search(single, "rare", NULL, hits, 8) == 4;
+        for (uint32_t i = 0; rare && i < 4; i++) {
+            rare = hits[i].document == 1 + 5000 * i;
+        }
+        check(rare, "gaps and counts past one byte");
+        check(search(single, "flour3", NULL, hits, 8) == 8 && hits[0].document % 7 == 3,
+              "words in thousands of recipes");
+
+        static const char *const QUERIES[] = {"stir", "flour0 flour6", "rare well", "stir rare"};
+        bool same = true;
+        for (size_t q = 0; q < sizeof(QUERIES) / sizeof(QUERIES[0]); q++) {
+            CooklangSearchHit a[64], b[64];
+            int32_t count = search(single, QUERIES[q], NULL, a, 64);
+            same = same && count > 0 && search(parallel, QUERIES[q], NULL, b, 64) == count &&
+                   memcmp(a, b, (size_t)count * sizeof(CooklangSearchHit)) == 0;
+        }
+        CooklangSearchStats a, b;
+        cooklang_search_index_stats(single, &a);
+        cooklang_search_index_stats(parallel, &b);
+        check(same && a.postings == b.postings && a.posting_bytes == b.posting_bytes,
+              "a parallel build gives the same index");
+    }
+    cooklang_search_index_delete(single);
+    cooklang_search_index_delete(parallel);
+    for (uint32_t i = 0; i < COUNT; i++) {
+        free(texts[i]);
+    }
+    free(texts);
+}
+
+static void test_edge_cases(void) {
+    CooklangSearchIndex *empty = build(NULL, 0, 4);
+    CooklangSearchHit hit;
+    check(empty && search(empty, "pasta", NULL, &hit, 1) == 0, "an empty collection");
+    cooklang_search_index_delete(empty);
+
+    CooklangSearchIndex *few = build(RECIPES, 2, 16);
+    check(few && search(few, "pasta", NULL, &hit, 1) == 1 && hit.document == 0,
+          "more threads than recipes");
+    cooklang_search_index_delete(few);
+}
+
+int main(void) {
+    printf("Search test\n");
+    printf("======================================\n");
+
+    test_fields();
+    test_long_lists();
+    test_edge_cases();
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
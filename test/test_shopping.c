@@ -0,0 +1,112 @@
+// Shopping list aggregation in bindings/c: grouping by normalized name and
+// base unit, exact sums, and merging of partial lists.
+
+#include "cooklang_shopping.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+static const char *const RECIPES[] = {
+    "Whisk @eggs{2} with @Olive Oil{1/2%tbsp} and @salt.\n",
+    "Fry @eggs{3} in @olive oil{1 1/2%Tbsp}, add @flour{100%g}.\n",
+    "Add @flour{0.25%kg} and @./sauces/Hollandaise{} with @eggs{1-2}.\n",
+    "Rub with @butter{some%pinch}.\n",
+};
+
+// Name, unit, and the expected sum as printed by cooklang_quantity_format.
+static const char *const EXPECTED[][3] = {
+    {"eggs", "", "6-7"},
+    {"olive oil", "ml", "29.574"},
+    {"salt", "", ""},
+    {"flour", "g", "350"},
+    {"butter", "pinch", ""},
+};
+
+static unsigned failures;
+
+static void format_item(const CooklangShoppingList *list, const CooklangShoppingItem *item,
+                        char *out, size_t size) {
+    CooklangQuantity quantity = {
+        .kind = item->low.numerator == item->high.numerator &&
+                        item->low.denominator == item->high.denominator
+                    ? COOKLANG_QUANTITY_NUMBER
+                    : COOKLANG_QUANTITY_RANGE,
+        .low = item->low,
+        .high = item->high,
+    };
+    char amount[128] = "";
+    if (item->flags & COOKLANG_SHOPPING_HAS_AMOUNT) {
+        cooklang_quantity_format(&quantity, amount, sizeof(amount));
+    }
+    snprintf(out, size, "%.*s|%.*s|%s", (int)(item->name.end - item->name.start),
+             list->strings + item->name.start, (int)(item->unit.end - item->unit.start),
+             list->strings + item->unit.start, amount);
+}
+
+static void check_list(const char *description, const CooklangShoppingList *list) {
+    size_t expected_count = sizeof(EXPECTED) / sizeof(EXPECTED[0]);
+    bool ok = list->length == expected_count;
+    char actual[256] = "", expected[256] = "";
+    for (uint32_t i = 0; ok && i < list->length; i++) {
+        format_item(list, &list->items[i], actual, sizeof(actual));
+        snprintf(expected, sizeof(expected), "%s|%s|%s", EXPECTED[i][0], EXPECTED[i][1],
+                 EXPECTED[i][2]);
+        ok = strcmp(actual, expected) == 0;
+    }
+    if (ok) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s (%u items)\n    expected: %s\n    actual:   %s\n",
+               description, list->length, expected, actual);
+    }
+}
+
+int main(void) {
+    printf("Shopping list test\n");
+    printf("======================================\n");
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    size_t recipe_count = sizeof(RECIPES) / sizeof(RECIPES[0]);
+    TSTree *trees[sizeof(RECIPES) / sizeof(RECIPES[0])];
+    for (size_t i = 0; i < recipe_count; i++) {
+        trees[i] = ts_parser_parse_string(parser, NULL, RECIPES[i], (uint32_t)strlen(RECIPES[i]));
+    }
+
+    CooklangRational one = {1, 1};
+    CooklangShoppingList sequential;
+    cooklang_shopping_list_init(&sequential);
+    for (size_t i = 0; i < recipe_count; i++) {
+        cooklang_shopping_list_add_recipe(&sequential, RECIPES[i], ts_tree_root_node(trees[i]), one);
+    }
+    check_list("sequential", &sequential);
+
+    CooklangShoppingList merged, partial;
+    cooklang_shopping_list_init(&merged);
+    cooklang_shopping_list_init(&partial);
+    for (size_t i = 0; i < recipe_count; i++) {
+        cooklang_shopping_list_clear(&partial);
+        cooklang_shopping_list_add_recipe(&partial, RECIPES[i], ts_tree_root_node(trees[i]), one);
+        cooklang_shopping_list_merge(&merged, &partial);
+    }
+    check_list("merged partials", &merged);
+
+    cooklang_shopping_list_free(&partial);
+    cooklang_shopping_list_free(&merged);
+    cooklang_shopping_list_free(&sequential);
+    for (size_t i = 0; i < recipe_count; i++) {
+        ts_tree_delete(trees[i]);
+    }
+    ts_parser_delete(parser);
+
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// Word characters beyond ASCII: the generated table in src/scanner_unicode.h,
+// and the names the extractor in bindings/c reads with it. The grammar
+// reads the same names; test_differential holds the two together.
+
+#include "cooklang_extract.h"
+#include "scanner_unicode.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+typedef struct {
+    int32_t code_point;
+    bool word;
+    const char *description;
+} ClassCase;
+
+static const ClassCase CLASS_CASES[] = {
+    {'a', true, "ASCII letter"},
+    {'7', true, "ASCII digit"},
+    {'-', true, "ASCII hyphen, as the scanner has it"},
+    {' ', false, "ASCII space"},
+    {'{', false, "ASCII brace"},
+    {0x00E9, true, "é"},
+    {0x0301, true, "combining acute accent"},
+    {0x00DF, true, "ß"},
+    {0x0416, true, "Cyrillic Ж"},
+    {0x05D0, true, "Hebrew alef"},
+    {0x0661, true, "Arabic-Indic digit one"},
+    {0x0915, true, "Devanagari ka"},
+    {0x200D, true, "zero-width joiner"},
+    {0x2019, true, "typographic apostrophe"},
+    {0x4E2D, true, "CJK 中"},
+    {0x3042, true, "hiragana あ"},
+    {0xAC00, true, "Hangul 가"},
+    {0xFF21, true, "fullwidth Ａ"},
+    {0x00BD, true, "½, a number"},
+    {0x20000, true, "CJK extension B"},
+    {0xE0100, true, "variation selector 17, a mark"},
+    {0x00A0, false, "no-break space"},
+    {0x2009, false, "thin space"},
+    {0x3000, false, "ideographic space"},
+    {0x2013, false, "en dash"},
+    {0x2014, false, "em dash"},
+    {0x3001, false, "ideographic comma"},
+    {0x3002, false, "ideographic full stop"},
+    {0xFF0C, false, "fullwidth comma"},
+    {0x00B7, false, "middle dot"},
+    {0x201C, false, "left double quotation mark"},
+    {0x00D7, false, "multiplication sign, a math symbol"},
+    {0x00B0, true, "degree sign, a symbol"},
+    {0x00AE, true, "registered sign"},
+    {0x2122, true, "trade mark sign"},
+    {0x20AC, true, "euro sign"},
+    {0x02DC, true, "small tilde, a modifier symbol"},
+    {0x1F345, true, "tomato emoji"},
+    {0xD800, false, "surrogate"},
+    {0xFFFD, false, "replacement character"},
+    {0x10FFFF, false, "last code point"},
+    {0x110000, false, "beyond Unicode"},
+    {-1, false, "end of input"},
+};
+
+typedef struct {
+    const char *source;
+    // Name of the first entity.
+    const char *name;
+} NameCase;
+
+static const NameCase NAME_CASES[] = {
+    {"Add @café{2%cups}.", "café"},
+    {"Add @crème fraîche{1%tbsp}.", "crème fraîche"},
+    {"Season with @salt\xC2\xA0to taste.", "salt"},
+    {"Add @salt\xE2\x80\x94to taste.", "salt"},
+    {"Add @salt\xE2\x80\x94" "fine{1%tsp}.", "salt"},
+    {"Add @pepper\xE2\x80\x89{1%tsp}.", "pepper"},
+    {"加入 @味噌、@味醂{2%tbsp}。", "味噌"},
+    {"加入 @味醂{2%tbsp}。", "味醂"},
+    {"Use the #wok\xE3\x80\x82", "wok"},
+    {"Add @chef\xE2\x80\x99s salt{1%tsp}.", "chef\xE2\x80\x99s salt"},
+    {"Add @tomato\xF0\x9F\x8D\x85.", "tomato\xF0\x9F\x8D\x85"},
+    {"Add @🍅{1}.", "🍅"},
+    {"Melt @Kerrygold® butter{}.", "Kerrygold® butter"},
+    {"Serve @Häagen-Dazs™{}.", "Häagen-Dazs™"},
+    {"Heat to 180 °C with @oil{}.", "oil"},
+    {"Add @salt×2.", "salt"},
+    // Invalid and truncated sequences are read as U+FFFD.
+    {"Add @ab\xC3(", "ab"},
+    {"Add @ab\xC0\xA1.", "ab"},
+    {"Add @ab\xE0\x80\xA1.", "ab"},
+    {"Add @ab\xE4\xB8", "ab"},
+};
+
+static unsigned failures;
+
+static void check(bool ok, const char *description, const char *actual, const char *expected) {
+    if (ok) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n    expected: %s\n    actual:   %s\n", description,
+               expected, actual);
+    }
+}
+
+static void test_classes(void) {
+    printf("Word characters\n");
+    for (size_t i = 0; i < sizeof(CLASS_CASES) / sizeof(CLASS_CASES[0]); i++) {
+        const ClassCase *test = &CLASS_CASES[i];
+        bool word = unicode_is_word(test->code_point);
+        char description[128];
+        snprintf(description, sizeof(description), "U+%04X %s", (unsigned)test->code_point,
+                 test->description);
+        check(word == test->word, description, word ? "word" : "not word",
+              test->word ? "word" : "not word");
+    }
+}
+
+static void test_names(void) {
+    printf("Names\n");
+    CooklangEntityList list;
+    cooklang_entity_list_init(&list);
+    for (size_t i = 0; i < sizeof(NAME_CASES) / sizeof(NAME_CASES[0]); i++) {
+        const NameCase *test = &NAME_CASES[i];
+        list.length = 0;
+        cooklang_extract(test->source, (uint32_t)strlen(test->source), &list);
+        char actual[128] = "(none)";
+        if (list.length > 0) {
+            CooklangSpan name = list.entities[0].name;
+            snprintf(actual, sizeof(actual), "%.*s", (int)(name.end - name.start),
+                     test->source + name.start);
+        }
+        check(strcmp(actual, test->name) == 0, test->source, actual, test->name);
+    }
+    cooklang_entity_list_free(&list);
+}
+
+int main(void) {
+    printf("Unicode word test\n");
+    printf("======================================\n");
+    test_classes();
+    test_names();
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Unit lookup through the generated perfect hash in bindings/c, and
+// conversion of quantities to base units.
+
+#include "cooklang_units.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+typedef struct {
+    const char *text;
+    // Canonical name of the unit found, or NULL if there should be none.
+    const char *expected;
+} LookupCase;
+
+static const LookupCase LOOKUP_CASES[] = {
+    {"g", "g"},
+    {"Grams", "g"},
+    {"KG", "kg"},
+    {"tbsp", "tbsp"},
+    {"Tbsp.", "tbsp"},
+    {"T", "tbsp"},
+    {"t", "tsp"},
+    {" cups ", "cup"},
+    {"fl  oz", "fl oz"},
+    {"Fl. Oz.", "fl oz"},
+    {"°C", "°C"},
+    {"minutes", "min"},
+    {"pinch", NULL},
+    {"gg", NULL},
+    {"", NULL},
+    {".", NULL},
+    {"an unreasonably long unit that cannot be an alias", NULL},
+};
+
+typedef struct {
+    const char *text;
+    const char *unit;
+    const char *amount;
+} NormalizeCase;
+
+static const NormalizeCase NORMALIZE_CASES[] = {
+    {"0.25%kg", "g", "250"},
+    {"1 1/2%lb", "g", "680.389"},
+    {"2-3%tbsp", "ml", "29.574-44.36"},
+    {"1/2%cup", "ml", "118.294"},
+    {"1%l", "ml", "1000"},
+    {"10%minutes", "s", "600"},
+    {"180%°C", "°C", "180"},
+    {"some%kg", "kg", ""},
+    {"2%pinch", NULL, "2"},
+};
+
+static unsigned failures;
+
+static void check(bool ok, const char *description, const char *actual, const char *expected) {
+    if (ok) {
+        printf("  " GREEN "✓" NC " %s\n", description);
+    } else {
+        failures++;
+        printf("  " RED "✗" NC " %s\n    expected: %s\n    actual:   %s\n", description,
+               expected, actual);
+    }
+}
+
+static void test_lookup(void) {
+    printf("Lookup\n");
+    for (size_t i = 0; i < sizeof(LOOKUP_CASES) / sizeof(LOOKUP_CASES[0]); i++) {
+        const LookupCase *test = &LOOKUP_CASES[i];
+        const CooklangUnit *unit = cooklang_unit_lookup(test->text, (uint32_t)strlen(test->text));
+        const char *actual = unit ? unit->name : "(none)";
+        const char *expected = test->expected ? test->expected : "(none)";
+
+        char description[128];
+        snprintf(description, sizeof(description), "\"%s\"", test->text);
+        check(strcmp(actual, expected) == 0, description, actual, expected);
+    }
+}
+
+static void test_normalize(void) {
+    printf("Normalize\n");
+    for (size_t i = 0; i < sizeof(NORMALIZE_CASES) / sizeof(NORMALIZE_CASES[0]); i++) {
+        const NormalizeCase *test = &NORMALIZE_CASES[i];
+        CooklangQuantity quantity;
+        cooklang_quantity_parse(test->text, (CooklangSpan){0, (uint32_t)strlen(test->text)},
+                                &quantity);
+        const CooklangUnit *unit = cooklang_quantity_normalize(&quantity, test->text);
+        char amount[128];
+        cooklang_quantity_format(&quantity, amount, sizeof(amount));
+
+        char actual[160], expected[160];
+        snprintf(actual, sizeof(actual), "%s %s", amount, unit ? unit->name : "(none)");
+        snprintf(expected, sizeof(expected), "%s %s", test->amount,
+                 test->unit ? test->unit : "(none)");
+        char description[128];
+        snprintf(description, sizeof(description), "{%s}", test->text);
+        check(strcmp(actual, expected) == 0, description, actual, expected);
+    }
+}
+
+int main(void) {
+    printf("Unit table test\n");
+    printf("======================================\n");
+    test_lookup();
+    test_normalize();
+    printf("\nSummary:\n");
+    printf("  Failures: %u\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+// cook2html: render a directory of recipes as static HTML pages.
+//
+//   cook2html [-j THREADS] DIRECTORY OUTPUT
+//
+// Every `.cook` file under DIRECTORY, skipping names that start with a dot
+// and symbolic links, which could loop, becomes a page at the same
+// relative path under OUTPUT, with `.html` for `.cook`; directories are
+// created as needed. Each file is read and parsed once, and written
+// straight from the tree (see bindings/c/cooklang_html.h). THREADS
+// workers, one per CPU by default, each with its own parser and buffers,
+// take paths from a bounded queue that this thread fills while it walks
+// DIRECTORY, so rendering starts with the first file found and memory
+// stays flat however large the collection. The page count and rate are
+// reported on standard error.
+
+#define _DEFAULT_SOURCE
+
+#include "cooklang_html.h"
+#include "tools.h"
+#include "tree-sitter-cooklang.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Paths waiting per worker; enough to keep every worker busy while the
+// directory walk stalls on a slow directory.
+#define QUEUE_PER_THREAD 4
+
+typedef struct {
+    char **paths;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t length;
+    bool closed;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} Queue;
+
+typedef struct {
+    const char *root;
+    const char *output;
+    Queue queue;
+    // Updated under the queue's lock.
+    uint32_t pages;
+    bool failed;
+} Job;
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+// Wait for room, then queue `path`, which the queue now owns.
+static void push(Queue *queue, char *path) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->length == queue->capacity) {
+        pthread_cond_wait(&queue->not_full, &queue->lock);
+    }
+    queue->paths[(queue->head + queue->length) % queue->capacity] = path;
+    queue->length++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Wait for a path, which the caller frees. NULL once the queue is closed
+// and empty.
+static char *pop(Queue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->length == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->not_empty, &queue->lock);
+    }
+    char *path = NULL;
+    if (queue->length > 0) {
+        path = queue->paths[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->length--;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return path;
+}
+
+static void close_queue(Queue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Create the directories leading to `path`, from the first separator at
+// or after `from`; those that exist already are fine.
+static bool make_parents(char *path, size_t from) {
+    for (char *separator = strchr(path + from, '/'); separator;
+         separator = strchr(separator + 1, '/')) {
+        *separator = '\0';
+        bool made = mkdir(path, 0777) == 0 || errno == EEXIST;
+        *separator = '/';
+        if (!made) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool write_file(const char *path, const CooklangText *text) {
+    FILE *stream = fopen(path, "wb");
+    if (!stream) {
+        return false;
+    }
+    bool ok = fwrite(text->data, 1, text->length, stream) == text->length;
+    return fclose(stream) == 0 && ok;
+}
+
+// Render the recipe at `relative` under the job's root. The file name
+// without `.cook` is the title of recipes that have none.
+static bool render(Job *job, TSParser *parser, const char *relative, CooklangText *input,
+                   CooklangText *page) {
+    char *source_path = tools_join(job->root, relative);
+    char *target_path = tools_join(job->output, relative);
+    bool ok = source_path && target_path && tools_read_file(source_path, input);
+    if (!ok) {
+        fprintf(stderr, "cook2html: cannot read %s/%s\n", job->root, relative);
+    } else {
+        const char *name = strrchr(relative, '/');
+        name = name ? name + 1 : relative;
+        char title[256];
+        snprintf(title, sizeof(title), "%.*s", (int)(strlen(name) - 5), name);
+
+        TSTree *tree = ts_parser_parse_string(parser, NULL, input->data, input->length);
+        page->length = 0;
+        ok = cooklang_html_write_page(input->data, ts_tree_root_node(tree), title, page);
+        ts_tree_delete(tree);
+
+        // `.cook` becomes `.html`, which has the same length.
+        memcpy(target_path + strlen(target_path) - 5, ".html", 5);
+        ok = ok && make_parents(target_path, strlen(job->output) + 1) &&
+             write_file(target_path, page);
+        if (!ok) {
+            fprintf(stderr, "cook2html: cannot write %s\n", target_path);
+        }
+    }
+    free(source_path);
+    free(target_path);
+    return ok;
+}
+
+static void *worker_thread(void *payload) {
+    Job *job = payload;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText input, page;
+    cooklang_text_init(&input);
+    cooklang_text_init(&page);
+    char *path;
+    while ((path = pop(&job->queue))) {
+        bool ok = render(job, parser, path, &input, &page);
+        free(path);
+        pthread_mutex_lock(&job->queue.lock);
+        job->pages += ok;
+        job->failed = job->failed || !ok;
+        pthread_mutex_unlock(&job->queue.lock);
+    }
+    cooklang_text_free(&input);
+    cooklang_text_free(&page);
+    ts_parser_delete(parser);
+    return NULL;
+}
+
+// Queue the recipes under `path`, relative to the job's root.
+static bool add_directory(Job *job, const char *path) {
+    char *full = tools_join(job->root, path);
+    DIR *directory = full ? opendir(full) : NULL;
+    free(full);
+    if (!directory) {
+        fprintf(stderr, "cook2html: cannot open %s/%s\n", job->root, path);
+        return false;
+    }
+    bool ok = true;
+    struct dirent *item;
+    while (ok && (item = readdir(directory))) {
+        if (item->d_name[0] == '.') {
+            continue;
+        }
+        char *child = tools_join(path, item->d_name);
+        char *child_full = child ? tools_join(job->root, child) : NULL;
+        struct stat info;
+        if (!child_full || lstat(child_full, &info) != 0) {
+            ok = child_full != NULL;
+        } else if (S_ISDIR(info.st_mode)) {
+            ok = add_directory(job, child);
+        } else if (S_ISREG(info.st_mode) && tools_is_recipe(item->d_name)) {
+            push(&job->queue, child);
+            child = NULL;
+        }
+        free(child_full);
+        free(child);
+    }
+    closedir(directory);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned thread_count = cpus > 0 ? (unsigned)cpus : 1;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-j") == 0) {
+        thread_count = (unsigned)atoi(argv[2]);
+        first = 3;
+    }
+    if (argc != first + 2 || thread_count == 0) {
+        fprintf(stderr, "usage: cook2html [-j THREADS] DIRECTORY OUTPUT\n");
+        return 2;
+    }
+
+    Job job = {.root = argv[first], .output = argv[first + 1]};
+    if (mkdir(job.output, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "cook2html: cannot create %s\n", job.output);
+        return 1;
+    }
+    job.queue.capacity = thread_count * QUEUE_PER_THREAD;
+    job.queue.paths = malloc(job.queue.capacity * sizeof(char *));
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    if (!job.queue.paths || !threads) {
+        fprintf(stderr, "cook2html: out of memory\n");
+        return 1;
+    }
+    pthread_mutex_init(&job.queue.lock, NULL);
+    pthread_cond_init(&job.queue.not_empty, NULL);
+    pthread_cond_init(&job.queue.not_full, NULL);
+
+    double start = now();
+    unsigned started = 0;
+    while (started < thread_count &&
+           pthread_create(&threads[started], NULL, worker_thread, &job) == 0) {
+        started++;
+    }
+    bool walked = started > 0 && add_directory(&job, "");
+    if (started == 0) {
+        fprintf(stderr, "cook2html: cannot start a thread\n");
+    }
+    close_queue(&job.queue);
+    for (unsigned i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double seconds = now() - start;
+
+    fprintf(stderr, "cook2html: %u pages in %.3f s (%.0f pages/s, %u thread%s)\n", job.pages,
+            seconds, seconds > 0 ? job.pages / seconds : 0.0, started, started == 1 ? "" : "s");
+    pthread_cond_destroy(&job.queue.not_full);
+    pthread_cond_destroy(&job.queue.not_empty);
+    pthread_mutex_destroy(&job.queue.lock);
+    free(job.queue.paths);
+    free(threads);
+    return walked && !job.failed ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+// cook2json: convert recipes to JSON, one document per line (NDJSON).
+//
+//   cook2json [--path] [FILE...]
+//
+// Reads standard input when no files are given. With --path, every line is
+// {"path":"FILE","recipe":{...}} instead of the bare recipe. Output is
+// flushed whenever the buffer passes OUTPUT_FLUSH_SIZE, so memory stays
+// flat however many files are converted. See bindings/c/cooklang_json.h
+// for the document format.
+
+#include "cooklang_json.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define OUTPUT_FLUSH_SIZE (1 << 20)
+
+static bool read_stream(FILE *stream, CooklangText *text) {
+    text->length = 0;
+    for (;;) {
+        if (!cooklang_text_reserve(text, 65536)) {
+            return false;
+        }
+        size_t read = fread(text->data + text->length, 1, 65536, stream);
+        text->length += (uint32_t)read;
+        if (read < 65536) {
+            return !ferror(stream);
+        }
+    }
+}
+
+static bool flush(CooklangText *out) {
+    bool ok = fwrite(out->data, 1, out->length, stdout) == out->length;
+    out->length = 0;
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    bool with_path = false;
+    int first_file = 1;
+    if (argc > 1 && strcmp(argv[1], "--path") == 0) {
+        with_path = true;
+        first_file = 2;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText input, out;
+    cooklang_text_init(&input);
+    cooklang_text_init(&out);
+    int status = 0;
+
+    static const char *const STDIN_ONLY[] = {"-"};
+    int file_count = argc - first_file;
+    const char *const *paths = file_count > 0 ? (const char *const *)argv + first_file : STDIN_ONLY;
+    if (file_count == 0) {
+        file_count = 1;
+    }
+
+    for (int i = 0; i < file_count; i++) {
+        const char *path = paths[i];
+        FILE *stream = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+        bool read = stream && read_stream(stream, &input);
+        if (stream && stream != stdin) {
+            fclose(stream);
+        }
+        if (!read) {
+            fprintf(stderr, "cook2json: cannot read %s\n", path);
+            status = 1;
+            continue;
+        }
+
+        TSTree *tree = ts_parser_parse_string(parser, NULL, input.data, input.length);
+        bool ok = true;
+        if (with_path) {
+            ok = cooklang_text_append(&out, "{\"path\":", 8) &&
+                 cooklang_json_write_string(&out, path, (uint32_t)strlen(path)) &&
+                 cooklang_text_append(&out, ",\"recipe\":", 10);
+        }
+        ok = ok && cooklang_json_write_recipe(input.data, ts_tree_root_node(tree), &out);
+        ts_tree_delete(tree);
+        ok = ok && cooklang_text_append(&out, with_path ? "}\n" : "\n", with_path ? 2 : 1);
+        if (!ok) {
+            fprintf(stderr, "cook2json: out of memory converting %s\n", path);
+            status = 1;
+            break;
+        }
+        if (out.length >= OUTPUT_FLUSH_SIZE && !flush(&out)) {
+            status = 1;
+            break;
+        }
+    }
+    if (!flush(&out)) {
+        status = 1;
+    }
+
+    cooklang_text_free(&out);
+    cooklang_text_free(&input);
+    ts_parser_delete(parser);
+    return status;
+}
@@ -0,0 +1,663 @@
+// cookd: keep a directory of recipes parsed in memory and answer queries
+// about it over a Unix socket. Linux only (inotify).
+//
+//   cookd DIRECTORY SOCKET
+//
+// At startup every `.cook` file under DIRECTORY is read, parsed and its
+// entities extracted (see bindings/c/cooklang_index.h). inotify then
+// reports saved, moved and deleted files, and only those are reindexed;
+// a file that was indexed before is reparsed incrementally. New
+// directories are watched as they appear, and renamed ones follow their
+// new path. If the kernel's event queue overflows, the whole tree is
+// scanned again.
+//
+// Clients send one command per line and get one line of JSON back:
+//
+//   stats               {"recipes":N,"bytes":N,"entities":N,"generation":N}
+//   list                {"recipes":["path",...]}
+//   recipe PATH         the recipe as in cooklang_json.h, or {"error":...}
+//   ingredient NAME     {"recipes":["path",...]} using the ingredient,
+//                       compared ASCII case-insensitively
+//   complete KIND PREFIX
+//                       {"completions":[{"name":"...","count":N},...]}, the
+//                       most frequent ingredient, cookware or timer names
+//                       (KIND) starting with PREFIX, kept up to date as
+//                       files are reindexed (see cooklang_complete.h)
+//   wait                answered after the next change to the index, with
+//                       {"path":"...","generation":N}
+//
+// Paths are relative to DIRECTORY. Clients are never waited on: answers a
+// client is not reading are queued, and a client that lets too much pile
+// up, or sends a line longer than MAX_LINE, is disconnected.
+
+#define _GNU_SOURCE
+
+#include "cooklang_complete.h"
+#include "cooklang_index.h"
+#include "cooklang_json.h"
+#include "tools.h"
+#include "tree-sitter-cooklang.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+#define MAX_CLIENTS 64
+#define MAX_COMPLETIONS 20
+// A command line longer than this disconnects the client.
+#define MAX_LINE 65536
+// Answers queued for a client that is not reading; past this the client is
+// disconnected.
+#define MAX_PENDING (16u << 20)
+#define WATCH_EVENTS \
+    (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE | IN_DELETE_SELF)
+
+typedef struct {
+    int fd;
+    CooklangText input;
+    // Answered but not yet written, sent as the socket accepts it.
+    CooklangText pending;
+    bool waiting;
+    bool failed;
+} Client;
+
+typedef struct {
+    int watch;
+    // Relative to the root; empty for the root itself.
+    char *path;
+} Watch;
+
+typedef struct {
+    const char *root;
+    int inotify;
+    Watch *watches;
+    uint32_t watch_count;
+    uint32_t watch_capacity;
+    CooklangIndex index;
+    CooklangCompletions completions;
+    TSParser *parser;
+    Client clients[MAX_CLIENTS];
+    uint32_t client_count;
+    CooklangText file;
+    CooklangText output;
+} Daemon;
+
+static void put_string(Daemon *daemon, const char *text) {
+    cooklang_json_write_string(&daemon->output, text, (uint32_t)strlen(text));
+}
+
+#define PUT_LITERAL(daemon, literal) \
+    cooklang_text_append(&(daemon)->output, literal, sizeof(literal) - 1)
+
+static void put_number(Daemon *daemon, unsigned long long number) {
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%llu", number);
+    cooklang_text_append(&daemon->output, digits, (uint32_t)length);
+}
+
+// Write as much of the client's pending output as its socket takes without
+// blocking. A write error marks the client as failed.
+static void flush_client(Client *client) {
+    uint32_t sent = 0;
+    while (sent < client->pending.length) {
+        ssize_t written = write(client->fd, client->pending.data + sent,
+                                client->pending.length - sent);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (written <= 0) {
+            client->failed = true;
+            break;
+        }
+        sent += (uint32_t)written;
+    }
+    memmove(client->pending.data, client->pending.data + sent, client->pending.length - sent);
+    client->pending.length -= sent;
+}
+
+// Queue the output for a client, ending the line, and send what its socket
+// takes now; the rest goes out as it becomes writable. A client that lets
+// more than MAX_PENDING bytes pile up is disconnected rather than holding
+// memory for it or blocking the daemon.
+static void send_output(Daemon *daemon, Client *client) {
+    cooklang_text_append(&daemon->output, "\n", 1);
+    if (!client->failed) {
+        if (client->pending.length + (uint64_t)daemon->output.length > MAX_PENDING ||
+            !cooklang_text_append(&client->pending, daemon->output.data,
+                                  daemon->output.length)) {
+            client->failed = true;
+        } else {
+            flush_client(client);
+        }
+    }
+    daemon->output.length = 0;
+}
+
+static void notify_waiting(Daemon *daemon, const char *path) {
+    for (uint32_t i = 0; i < daemon->client_count; i++) {
+        Client *client = &daemon->clients[i];
+        if (client->waiting) {
+            client->waiting = false;
+            PUT_LITERAL(daemon, "{\"path\":");
+            put_string(daemon, path);
+            PUT_LITERAL(daemon, ",\"generation\":");
+            put_number(daemon, daemon->index.generation);
+            PUT_LITERAL(daemon, "}");
+            send_output(daemon, client);
+        }
+    }
+}
+
+// Count the names of the recipe indexed for `path`, if there is one, for
+// completion: `delta` is 1 once it is indexed and -1 before it changes.
+static void count_names(Daemon *daemon, const char *path, int32_t delta) {
+    const CooklangIndexEntry *entry = cooklang_index_find(&daemon->index, path);
+    if (entry && !cooklang_completions_add_entities(&daemon->completions, entry->text.data,
+                                                    &entry->entities, delta)) {
+        fprintf(stderr, "cookd: cannot count the names in %s\n", path);
+    }
+}
+
+static bool remove_file(Daemon *daemon, const char *path) {
+    count_names(daemon, path, -1);
+    return cooklang_index_remove(&daemon->index, path);
+}
+
+static void index_file(Daemon *daemon, const char *path) {
+    char *full = tools_join(daemon->root, path);
+    bool read = full && tools_read_file(full, &daemon->file);
+    free(full);
+    uint64_t generation = daemon->index.generation;
+    count_names(daemon, path, -1);
+    if (!read) {
+        cooklang_index_remove(&daemon->index, path);
+    } else if (!cooklang_index_update(&daemon->index, daemon->parser, path, daemon->file.data,
+                                      daemon->file.length)) {
+        fprintf(stderr, "cookd: cannot index %s\n", path);
+    }
+    count_names(daemon, path, 1);
+    if (daemon->index.generation != generation) {
+        notify_waiting(daemon, path);
+    }
+}
+
+static void watch_directory(Daemon *daemon, const char *path);
+
+// Index the recipes under `path` and watch its directories.
+static void scan(Daemon *daemon, const char *path) {
+    watch_directory(daemon, path);
+    char *full = tools_join(daemon->root, path);
+    DIR *directory = full ? opendir(full) : NULL;
+    if (!directory) {
+        free(full);
+        return;
+    }
+    struct dirent *item;
+    while ((item = readdir(directory))) {
+        if (item->d_name[0] == '.') {
+            continue;
+        }
+        char *child = tools_join(path, item->d_name);
+        char *full_child = child ? tools_join(daemon->root, child) : NULL;
+        struct stat status;
+        if (full_child && lstat(full_child, &status) == 0) {
+            if (S_ISDIR(status.st_mode)) {
+                scan(daemon, child);
+            } else if (S_ISREG(status.st_mode) && tools_is_recipe(item->d_name)) {
+                index_file(daemon, child);
+            }
+        }
+        free(full_child);
+        free(child);
+    }
+    closedir(directory);
+    free(full);
+}
+
+static void watch_directory(Daemon *daemon, const char *path) {
+    char *full = tools_join(daemon->root, path);
+    int watch = full ? inotify_add_watch(daemon->inotify, full, WATCH_EVENTS) : -1;
+    free(full);
+    if (watch < 0) {
+        return;
+    }
+    char *copy = tools_join(path, "");
+    if (!copy) {
+        return;
+    }
+    // A directory renamed inside the tree keeps its watch, so only its path
+    // changes.
+    for (uint32_t i = 0; i < daemon->watch_count; i++) {
+        if (daemon->watches[i].watch == watch) {
+            free(daemon->watches[i].path);
+            daemon->watches[i].path = copy;
+            return;
+        }
+    }
+    if (daemon->watch_count == daemon->watch_capacity) {
+        uint32_t capacity = daemon->watch_capacity ? daemon->watch_capacity * 2 : 16;
+        Watch *watches = realloc(daemon->watches, capacity * sizeof(Watch));
+        if (!watches) {
+            free(copy);
+            return;
+        }
+        daemon->watches = watches;
+        daemon->watch_capacity = capacity;
+    }
+    daemon->watches[daemon->watch_count++] = (Watch){watch, copy};
+}
+
+// Stop watching the directory `path` and those under it, after it moved
+// out of the tree.
+static void unwatch_directory(Daemon *daemon, const char *path) {
+    size_t length = strlen(path);
+    for (uint32_t i = 0; i < daemon->watch_count;) {
+        const char *watched = daemon->watches[i].path;
+        if (strncmp(watched, path, length) == 0 &&
+            (watched[length] == '\0' || watched[length] == '/')) {
+            inotify_rm_watch(daemon->inotify, daemon->watches[i].watch);
+            free(daemon->watches[i].path);
+            daemon->watches[i] = daemon->watches[--daemon->watch_count];
+        } else {
+            i++;
+        }
+    }
+}
+
+// Drop every indexed recipe under the directory `path`.
+static void remove_directory(Daemon *daemon, const char *path) {
+    size_t length = strlen(path);
+    for (uint32_t i = 0; i < daemon->index.length;) {
+        const char *indexed = daemon->index.entries[i].path;
+        if (strncmp(indexed, path, length) == 0 && indexed[length] == '/') {
+            char *copy = tools_join(indexed, "");
+            remove_file(daemon, indexed);
+            if (copy) {
+                notify_waiting(daemon, copy);
+            }
+            free(copy);
+        } else {
+            i++;
+        }
+    }
+}
+
+// Index the tree again from scratch, after the kernel dropped events: the
+// recipes still there are reindexed, where unchanged text costs nothing,
+// and those that are gone are removed.
+static void rescan(Daemon *daemon) {
+    scan(daemon, "");
+    for (uint32_t i = 0; i < daemon->index.length;) {
+        const char *indexed = daemon->index.entries[i].path;
+        char *full = tools_join(daemon->root, indexed);
+        struct stat status;
+        if (full && lstat(full, &status) != 0 && errno == ENOENT) {
+            char *copy = tools_join(indexed, "");
+            remove_file(daemon, indexed);
+            if (copy) {
+                notify_waiting(daemon, copy);
+            }
+            free(copy);
+        } else {
+            i++;
+        }
+        free(full);
+    }
+}
+
+// Whether the events from `offset` to `length` include the IN_MOVED_TO
+// half of a rename with `cookie`, that is whether a directory moved away
+// stays in the tree.
+static bool moved_within(const char *buffer, ssize_t offset, ssize_t length, uint32_t cookie) {
+    while (offset < length) {
+        const struct inotify_event *event = (const struct inotify_event *)(buffer + offset);
+        if ((event->mask & IN_MOVED_TO) && event->cookie == cookie) {
+            return true;
+        }
+        offset += sizeof(struct inotify_event) + event->len;
+    }
+    return false;
+}
+
+static void handle_events(Daemon *daemon) {
+    char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length = read(daemon->inotify, buffer, sizeof(buffer));
+    for (ssize_t offset = 0; offset < length;) {
+        const struct inotify_event *event = (const struct inotify_event *)(buffer + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+        if (event->mask & IN_Q_OVERFLOW) {
+            rescan(daemon);
+            continue;
+        }
+        const Watch *watch = NULL;
+        for (uint32_t i = 0; i < daemon->watch_count; i++) {
+            if (daemon->watches[i].watch == event->wd) {
+                watch = &daemon->watches[i];
+                break;
+            }
+        }
+        if (!watch) {
+            continue;
+        }
+        if (event->mask & (IN_DELETE_SELF | IN_IGNORED)) {
+            uint32_t i = (uint32_t)(watch - daemon->watches);
+            free(daemon->watches[i].path);
+            daemon->watches[i] = daemon->watches[--daemon->watch_count];
+            continue;
+        }
+        if (event->len == 0 || event->name[0] == '.') {
+            continue;
+        }
+        char *path = tools_join(watch->path, event->name);
+        if (!path) {
+            continue;
+        }
+        if (event->mask & IN_ISDIR) {
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                scan(daemon, path);
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                remove_directory(daemon, path);
+                // A directory renamed inside the tree keeps its watches,
+                // which IN_MOVED_TO points at the new path.
+                if ((event->mask & IN_MOVED_FROM) &&
+                    !moved_within(buffer, offset, length, event->cookie)) {
+                    unwatch_directory(daemon, path);
+                }
+            }
+        } else if (tools_is_recipe(event->name)) {
+            if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                index_file(daemon, path);
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                if (remove_file(daemon, path)) {
+                    notify_waiting(daemon, path);
+                }
+            }
+        }
+        free(path);
+    }
+}
+
+static bool same_name(const char *source, CooklangSpan span, const char *name, size_t length) {
+    if (span.end - span.start != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        char a = source[span.start + i], b = name[i];
+        if (a >= 'A' && a <= 'Z') {
+            a = (char)(a - 'A' + 'a');
+        }
+        if (b >= 'A' && b <= 'Z') {
+            b = (char)(b - 'A' + 'a');
+        }
+        if (a != b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void handle_command(Daemon *daemon, Client *client, char *line) {
+    CooklangIndex *index = &daemon->index;
+    char *argument = strchr(line, ' ');
+    if (argument) {
+        *argument++ = '\0';
+    }
+
+    if (strcmp(line, "stats") == 0) {
+        uint64_t bytes = 0, entities = 0;
+        for (uint32_t i = 0; i < index->length; i++) {
+            bytes += index->entries[i].text.length;
+            entities += index->entries[i].entities.length;
+        }
+        PUT_LITERAL(daemon, "{\"recipes\":");
+        put_number(daemon, index->length);
+        PUT_LITERAL(daemon, ",\"bytes\":");
+        put_number(daemon, bytes);
+        PUT_LITERAL(daemon, ",\"entities\":");
+        put_number(daemon, entities);
+        PUT_LITERAL(daemon, ",\"generation\":");
+        put_number(daemon, index->generation);
+        PUT_LITERAL(daemon, "}");
+    } else if (strcmp(line, "list") == 0 ||
+               (strcmp(line, "ingredient") == 0 && argument)) {
+        size_t length = argument ? strlen(argument) : 0;
+        bool first = true;
+        PUT_LITERAL(daemon, "{\"recipes\":[");
+        for (uint32_t i = 0; i < index->length; i++) {
+            const CooklangIndexEntry *entry = &index->entries[i];
+            bool match = !argument;
+            for (uint32_t j = 0; !match && j < entry->entities.length; j++) {
+                const CooklangEntity *entity = &entry->entities.entities[j];
+                match = entity->kind == COOKLANG_ENTITY_INGREDIENT &&
+                        same_name(entry->text.data, entity->name, argument, length);
+            }
+            if (match) {
+                if (!first) {
+                    PUT_LITERAL(daemon, ",");
+                }
+                first = false;
+                put_string(daemon, entry->path);
+            }
+        }
+        PUT_LITERAL(daemon, "]}");
+    } else if (strcmp(line, "recipe") == 0 && argument) {
+        const CooklangIndexEntry *entry = cooklang_index_find(index, argument);
+        if (entry) {
+            cooklang_json_write_recipe(entry->text.data, ts_tree_root_node(entry->tree),
+                                       &daemon->output);
+        } else {
+            PUT_LITERAL(daemon, "{\"error\":\"not indexed\"}");
+        }
+    } else if (strcmp(line, "complete") == 0 && argument) {
+        static const char *const KINDS[] = {"ingredient", "cookware", "timer"};
+        char *prefix = strchr(argument, ' ');
+        if (prefix) {
+            *prefix++ = '\0';
+        } else {
+            prefix = argument + strlen(argument);
+        }
+        int32_t count = -1;
+        CooklangCompletion completions[MAX_COMPLETIONS];
+        for (int kind = 0; kind < COOKLANG_COMPLETION_KIND_COUNT; kind++) {
+            if (strcmp(argument, KINDS[kind]) == 0) {
+                count = cooklang_complete(&daemon->completions, (CooklangEntityKind)kind, prefix,
+                                          (uint32_t)strlen(prefix), completions, MAX_COMPLETIONS);
+            }
+        }
+        if (count < 0) {
+            PUT_LITERAL(daemon, "{\"error\":\"unknown kind\"}");
+        } else {
+            PUT_LITERAL(daemon, "{\"completions\":[");
+            for (int32_t i = 0; i < count; i++) {
+                if (i > 0) {
+                    PUT_LITERAL(daemon, ",");
+                }
+                PUT_LITERAL(daemon, "{\"name\":");
+                put_string(daemon, completions[i].name);
+                PUT_LITERAL(daemon, ",\"count\":");
+                put_number(daemon, completions[i].count);
+                PUT_LITERAL(daemon, "}");
+            }
+            PUT_LITERAL(daemon, "]}");
+        }
+    } else if (strcmp(line, "wait") == 0) {
+        client->waiting = true;
+        return;
+    } else {
+        PUT_LITERAL(daemon, "{\"error\":\"unknown command\"}");
+    }
+    send_output(daemon, client);
+}
+
+// Read from a client and answer its complete lines. Returns false once the
+// client has gone, or sent a line longer than MAX_LINE.
+static bool handle_client(Daemon *daemon, Client *client) {
+    CooklangText *input = &client->input;
+    if (!cooklang_text_reserve(input, 4096)) {
+        return false;
+    }
+    ssize_t length = read(client->fd, input->data + input->length, 4096);
+    if (length <= 0) {
+        return length < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    input->length += (uint32_t)length;
+    uint32_t start = 0;
+    for (uint32_t i = 0; i < input->length; i++) {
+        if (input->data[i] == '\n') {
+            input->data[i] = '\0';
+            if (i > start && input->data[i - 1] == '\r') {
+                input->data[i - 1] = '\0';
+            }
+            handle_command(daemon, client, input->data + start);
+            start = i + 1;
+        }
+    }
+    memmove(input->data, input->data + start, input->length - start);
+    input->length -= start;
+    return input->length < MAX_LINE && !client->failed;
+}
+
+static void close_client(Daemon *daemon, uint32_t index) {
+    Client *client = &daemon->clients[index];
+    close(client->fd);
+    cooklang_text_free(&client->input);
+    cooklang_text_free(&client->pending);
+    *client = daemon->clients[--daemon->client_count];
+}
+
+static int listen_on(const char *path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(fd, 16) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+static volatile sig_atomic_t stopping;
+
+static void stop(int signal_number) {
+    (void)signal_number;
+    stopping = 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: cookd DIRECTORY SOCKET\n");
+        return 2;
+    }
+    Daemon daemon;
+    memset(&daemon, 0, sizeof(daemon));
+    daemon.root = argv[1];
+    daemon.inotify = inotify_init1(IN_CLOEXEC);
+    if (daemon.inotify < 0) {
+        fprintf(stderr, "cookd: cannot watch %s\n", argv[1]);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+
+    daemon.parser = ts_parser_new();
+    ts_parser_set_language(daemon.parser, tree_sitter_cooklang());
+    cooklang_index_init(&daemon.index);
+    cooklang_completions_init(&daemon.completions);
+    cooklang_text_init(&daemon.file);
+    cooklang_text_init(&daemon.output);
+    scan(&daemon, "");
+
+    // Listening only once the directory is indexed means that a client
+    // which connects sees a complete index.
+    int listener = listen_on(argv[2]);
+    if (listener < 0) {
+        fprintf(stderr, "cookd: cannot listen on %s\n", argv[2]);
+        return 1;
+    }
+
+    while (!stopping) {
+        struct pollfd descriptors[MAX_CLIENTS + 2];
+        descriptors[0] = (struct pollfd){daemon.inotify, POLLIN, 0};
+        descriptors[1] = (struct pollfd){listener, POLLIN, 0};
+        for (uint32_t i = 0; i < daemon.client_count; i++) {
+            short events = daemon.clients[i].pending.length > 0 ? POLLIN | POLLOUT : POLLIN;
+            descriptors[i + 2] = (struct pollfd){daemon.clients[i].fd, events, 0};
+        }
+        if (poll(descriptors, daemon.client_count + 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (descriptors[0].revents & POLLIN) {
+            handle_events(&daemon);
+        }
+        // Clients are served before accepting new ones, so that indices in
+        // `descriptors` still match `clients`. Answers to `wait` may have
+        // failed a client that did not poll this round.
+        for (uint32_t i = daemon.client_count; i-- > 0;) {
+            Client *client = &daemon.clients[i];
+            short revents = descriptors[i + 2].revents;
+            if (revents & POLLOUT) {
+                flush_client(client);
+            }
+            if (client->failed ||
+                ((revents & ~POLLOUT) && !handle_client(&daemon, client))) {
+                close_client(&daemon, i);
+            }
+        }
+        if (descriptors[1].revents & POLLIN) {
+            int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd >= 0 && daemon.client_count < MAX_CLIENTS) {
+                Client *client = &daemon.clients[daemon.client_count++];
+                client->fd = fd;
+                client->waiting = false;
+                client->failed = false;
+                cooklang_text_init(&client->input);
+                cooklang_text_init(&client->pending);
+            } else if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    while (daemon.client_count > 0) {
+        close_client(&daemon, daemon.client_count - 1);
+    }
+    for (uint32_t i = 0; i < daemon.watch_count; i++) {
+        free(daemon.watches[i].path);
+    }
+    free(daemon.watches);
+    close(listener);
+    unlink(argv[2]);
+    close(daemon.inotify);
+    cooklang_index_free(&daemon.index);
+    cooklang_completions_free(&daemon.completions);
+    cooklang_text_free(&daemon.file);
+    cooklang_text_free(&daemon.output);
+    ts_parser_delete(daemon.parser);
+    return 0;
+}
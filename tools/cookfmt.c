@@ -0,0 +1,127 @@
+// cookfmt: canonical formatting for recipes.
+//
+//   cookfmt [--check | -w] [FILE...]
+//
+// Writes the formatted recipe to standard output, reading standard input
+// when no files are given. With -w, files are rewritten in place, and only
+// when something changed. With --check, nothing is written; the names of
+// files that would change are printed and the exit status is 1. See
+// bindings/c/cooklang_format.h for the rules.
+
+#include "cooklang_format.h"
+#include "tree-sitter-cooklang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+typedef enum {
+    MODE_PRINT,
+    MODE_WRITE,
+    MODE_CHECK,
+} Mode;
+
+static bool read_stream(FILE *stream, CooklangText *text) {
+    text->length = 0;
+    for (;;) {
+        if (!cooklang_text_reserve(text, 65536)) {
+            return false;
+        }
+        size_t read = fread(text->data + text->length, 1, 65536, stream);
+        text->length += (uint32_t)read;
+        if (read < 65536) {
+            return !ferror(stream);
+        }
+    }
+}
+
+static bool write_file(const char *path, const CooklangText *text) {
+    FILE *stream = fopen(path, "wb");
+    if (!stream) {
+        return false;
+    }
+    bool ok = fwrite(text->data, 1, text->length, stream) == text->length;
+    return fclose(stream) == 0 && ok;
+}
+
+int main(int argc, char **argv) {
+    Mode mode = MODE_PRINT;
+    int first_file = 1;
+    if (argc > 1 && strcmp(argv[1], "--check") == 0) {
+        mode = MODE_CHECK;
+        first_file = 2;
+    } else if (argc > 1 && strcmp(argv[1], "-w") == 0) {
+        mode = MODE_WRITE;
+        first_file = 2;
+    }
+
+    static const char *const STDIN_ONLY[] = {"-"};
+    int file_count = argc - first_file;
+    const char *const *paths = file_count > 0 ? (const char *const *)argv + first_file : STDIN_ONLY;
+    if (file_count == 0) {
+        if (mode == MODE_WRITE) {
+            fprintf(stderr, "cookfmt: -w needs at least one file\n");
+            return 2;
+        }
+        file_count = 1;
+    }
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_cooklang());
+    CooklangText input, out;
+    cooklang_text_init(&input);
+    cooklang_text_init(&out);
+    CooklangEditList edits;
+    cooklang_edit_list_init(&edits);
+    int status = 0;
+
+    for (int i = 0; i < file_count; i++) {
+        const char *path = paths[i];
+        bool is_stdin = strcmp(path, "-") == 0;
+        FILE *stream = is_stdin ? stdin : fopen(path, "rb");
+        bool read = stream && read_stream(stream, &input);
+        if (stream && !is_stdin) {
+            fclose(stream);
+        }
+        if (!read) {
+            fprintf(stderr, "cookfmt: cannot read %s\n", path);
+            status = status ? status : 2;
+            continue;
+        }
+
+        TSTree *tree = ts_parser_parse_string(parser, NULL, input.data, input.length);
+        cooklang_edit_list_clear(&edits);
+        bool ok = cooklang_format_recipe(input.data, input.length, ts_tree_root_node(tree), &edits);
+        ts_tree_delete(tree);
+        if (ok && mode != MODE_CHECK) {
+            ok = cooklang_edit_list_apply(&edits, input.data, input.length, &out);
+        }
+        if (!ok) {
+            fprintf(stderr, "cookfmt: out of memory formatting %s\n", path);
+            status = 2;
+            break;
+        }
+
+        if (mode == MODE_CHECK) {
+            if (edits.length > 0) {
+                printf("%s\n", path);
+                status = status ? status : 1;
+            }
+        } else if (mode == MODE_WRITE && !is_stdin) {
+            if (edits.length > 0 && !write_file(path, &out)) {
+                fprintf(stderr, "cookfmt: cannot write %s\n", path);
+                status = 2;
+            }
+        } else if (fwrite(out.data, 1, out.length, stdout) != out.length) {
+            status = 2;
+            break;
+        }
+    }
+
+    cooklang_edit_list_free(&edits);
+    cooklang_text_free(&out);
+    cooklang_text_free(&input);
+    ts_parser_delete(parser);
+    return status;
+}
@@ -0,0 +1,872 @@
+// cooklsp: a language server for Cooklang recipes, over standard input and
+// output.
+//
+//   cooklsp [--debounce MS]
+//
+// Every open document keeps one tree (see bindings/c/cooklang_document.h).
+// `didChange` deltas are applied to the text and the tree as they arrive,
+// but reparsing waits until no message has come in for the debounce
+// interval (default DEFAULT_DEBOUNCE_MS), so a burst of keystrokes costs one
+// parse. Diagnostics are then recomputed for the changed lines only and
+// published for the whole document. Completion and document symbol
+// requests reparse first if they need to.
+//
+// Supported: initialize, shutdown, exit, textDocument/didOpen, didChange
+// (incremental), didClose, completion (ingredient and cookware names after
+// `@` and `#`, units after `%`) and documentSymbol (sections and metadata).
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "cooklang_document.h"
+#include "cooklang_json.h"
+#include "cooklang_units.h"
+#include "tree-sitter-cooklang.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+#define DEFAULT_DEBOUNCE_MS 50
+
+// JSON reading. Messages are read lazily: values are located by skipping
+// over the text, and only the ones a handler asks for are decoded.
+
+typedef struct {
+    const char *start;
+    const char *end;
+} Json;
+
+static const char *skip_space(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+// The end of the value at `p`, or NULL if it is malformed.
+static const char *skip_value(const char *p, const char *end) {
+    p = skip_space(p, end);
+    if (p == end) {
+        return NULL;
+    }
+    if (*p == '"') {
+        for (p++; p < end; p++) {
+            if (*p == '\\') {
+                p++;
+            } else if (*p == '"') {
+                return p + 1;
+            }
+        }
+        return NULL;
+    }
+    if (*p == '{' || *p == '[') {
+        char close = *p == '{' ? '}' : ']';
+        p = skip_space(p + 1, end);
+        if (p < end && *p == close) {
+            return p + 1;
+        }
+        for (;;) {
+            if (close == '}') {
+                p = skip_value(p, end);
+                p = p ? skip_space(p, end) : NULL;
+                if (!p || p == end || *p != ':') {
+                    return NULL;
+                }
+                p++;
+            }
+            p = skip_value(p, end);
+            p = p ? skip_space(p, end) : NULL;
+            if (!p || p == end) {
+                return NULL;
+            }
+            if (*p == close) {
+                return p + 1;
+            }
+            if (*p != ',') {
+                return NULL;
+            }
+            p++;
+        }
+    }
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' &&
+           *p != '\r' && *p != '\t') {
+        p++;
+    }
+    return p;
+}
+
+static Json json_value(const char *start, const char *end) {
+    start = skip_space(start, end);
+    const char *value_end = skip_value(start, end);
+    return value_end ? (Json){start, value_end} : (Json){NULL, NULL};
+}
+
+// Member `key` of an object, or a null Json.
+static Json json_member(Json object, const char *key) {
+    size_t key_length = strlen(key);
+    if (!object.start || *object.start != '{') {
+        return (Json){NULL, NULL};
+    }
+    const char *p = skip_space(object.start + 1, object.end);
+    while (p < object.end && *p == '"') {
+        const char *name_end = skip_value(p, object.end);
+        if (!name_end) {
+            break;
+        }
+        bool match = (size_t)(name_end - p) == key_length + 2 && !memcmp(p + 1, key, key_length);
+        p = skip_space(name_end, object.end);
+        if (p == object.end || *p != ':') {
+            break;
+        }
+        Json value = json_value(p + 1, object.end);
+        if (!value.start || match) {
+            return value;
+        }
+        p = skip_space(value.end, object.end);
+        if (p == object.end || *p != ',') {
+            break;
+        }
+        p = skip_space(p + 1, object.end);
+    }
+    return (Json){NULL, NULL};
+}
+
+static Json json_path(Json value, const char *first, const char *second, const char *third) {
+    value = json_member(value, first);
+    if (second) {
+        value = json_member(value, second);
+    }
+    if (third) {
+        value = json_member(value, third);
+    }
+    return value;
+}
+
+static bool json_int(Json value, int64_t *out) {
+    if (!value.start || (*value.start != '-' && (*value.start < '0' || *value.start > '9'))) {
+        return false;
+    }
+    char number[24];
+    size_t length = (size_t)(value.end - value.start);
+    if (length >= sizeof(number)) {
+        return false;
+    }
+    memcpy(number, value.start, length);
+    number[length] = '\0';
+    *out = strtoll(number, NULL, 10);
+    return true;
+}
+
+static uint32_t hex_digits(const char *p) {
+    uint32_t code = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        code = code * 16 + (c >= 'a' ? c - 'a' + 10 : c >= 'A' ? c - 'A' + 10 : c - '0');
+    }
+    return code;
+}
+
+static bool put_utf8(CooklangText *out, uint32_t code) {
+    char bytes[4];
+    uint32_t length;
+    if (code < 0x80) {
+        bytes[0] = (char)code;
+        length = 1;
+    } else if (code < 0x800) {
+        bytes[0] = (char)(0xC0 | code >> 6);
+        bytes[1] = (char)(0x80 | (code & 0x3F));
+        length = 2;
+    } else if (code < 0x10000) {
+        bytes[0] = (char)(0xE0 | code >> 12);
+        bytes[1] = (char)(0x80 | (code >> 6 & 0x3F));
+        bytes[2] = (char)(0x80 | (code & 0x3F));
+        length = 3;
+    } else {
+        bytes[0] = (char)(0xF0 | code >> 18);
+        bytes[1] = (char)(0x80 | (code >> 12 & 0x3F));
+        bytes[2] = (char)(0x80 | (code >> 6 & 0x3F));
+        bytes[3] = (char)(0x80 | (code & 0x3F));
+        length = 4;
+    }
+    return cooklang_text_append(out, bytes, length);
+}
+
+// Decode a string value into `out`, replacing its contents.
+static bool json_string(Json value, CooklangText *out) {
+    out->length = 0;
+    if (!value.start || *value.start != '"' || !cooklang_text_reserve(out, 0)) {
+        return false;
+    }
+    const char *p = value.start + 1;
+    const char *end = value.end - 1;
+    bool ok = true;
+    while (ok && p < end) {
+        const char *run = p;
+        while (p < end && *p != '\\') {
+            p++;
+        }
+        ok = cooklang_text_append(out, run, (uint32_t)(p - run));
+        if (!ok || p == end || p + 1 == end) {
+            break;
+        }
+        char c = p[1];
+        p += 2;
+        if (c == 'u' && end - p >= 4) {
+            uint32_t code = hex_digits(p);
+            p += 4;
+            if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                code = 0x10000 + ((code - 0xD800) << 10) + (hex_digits(p + 2) - 0xDC00);
+                p += 6;
+            }
+            ok = put_utf8(out, code);
+        } else {
+            char decoded = c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c == 'b' ? '\b'
+                         : c == 'f' ? '\f' : c;
+            ok = cooklang_text_append(out, &decoded, 1);
+        }
+    }
+    if (ok) {
+        out->data[out->length] = '\0';
+    }
+    return ok;
+}
+
+static bool json_position(Json value, CooklangPosition *position) {
+    int64_t line, character;
+    if (!json_int(json_member(value, "line"), &line) ||
+        !json_int(json_member(value, "character"), &character) || line < 0 || character < 0) {
+        return false;
+    }
+    position->line = (uint32_t)line;
+    position->character = (uint32_t)character;
+    return true;
+}
+
+// Transport: messages framed by a Content-Length header.
+
+typedef struct {
+    CooklangText buffer;
+    uint32_t consumed;
+} Input;
+
+// Wait at most `timeout` milliseconds (forever if negative) for the next
+// message. Returns 1 with the body in `message`, 0 on timeout and -1 at the
+// end of the input. The body stays valid until the next call.
+static int next_message(Input *input, int timeout, Json *message) {
+    CooklangText *buffer = &input->buffer;
+    if (input->consumed > 0) {
+        memmove(buffer->data, buffer->data + input->consumed, buffer->length - input->consumed);
+        buffer->length -= input->consumed;
+        input->consumed = 0;
+    }
+    for (;;) {
+        if (!cooklang_text_reserve(buffer, 0)) {
+            return -1;
+        }
+        buffer->data[buffer->length] = '\0';
+        char *header_end = strstr(buffer->data, "\r\n\r\n");
+        if (header_end) {
+            const char *field = strstr(buffer->data, "Content-Length:");
+            if (!field || field > header_end) {
+                return -1;
+            }
+            uint32_t body_start = (uint32_t)(header_end + 4 - buffer->data);
+            uint32_t body_length = (uint32_t)strtoul(field + 15, NULL, 10);
+            if (buffer->length - body_start >= body_length) {
+                message->start = buffer->data + body_start;
+                message->end = message->start + body_length;
+                input->consumed = body_start + body_length;
+                return 1;
+            }
+        }
+        struct pollfd descriptor = {STDIN_FILENO, POLLIN, 0};
+        int ready = poll(&descriptor, 1, timeout);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready == 0) {
+            return 0;
+        }
+        if (ready < 0 || !cooklang_text_reserve(buffer, 65536)) {
+            return -1;
+        }
+        ssize_t read_length = read(STDIN_FILENO, buffer->data + buffer->length, 65536);
+        if (read_length <= 0) {
+            return -1;
+        }
+        buffer->length += (uint32_t)read_length;
+    }
+}
+
+static CooklangText output;
+
+static void send_message(void) {
+    printf("Content-Length: %u\r\n\r\n", output.length);
+    fwrite(output.data, 1, output.length, stdout);
+    fflush(stdout);
+    output.length = 0;
+}
+
+#define PUT_LITERAL(literal) cooklang_text_append(&output, literal, sizeof(literal) - 1)
+
+static void put_number(int64_t number) {
+    char text[24];
+    int length = snprintf(text, sizeof(text), "%lld", (long long)number);
+    cooklang_text_append(&output, text, (uint32_t)length);
+}
+
+static void put_string(const char *data, uint32_t length) {
+    cooklang_json_write_string(&output, data, length);
+}
+
+static void put_response_start(Json id) {
+    PUT_LITERAL("{\"jsonrpc\":\"2.0\",\"id\":");
+    cooklang_text_append(&output, id.start, (uint32_t)(id.end - id.start));
+    PUT_LITERAL(",\"result\":");
+}
+
+static void put_position(CooklangPosition position) {
+    PUT_LITERAL("{\"line\":");
+    put_number(position.line);
+    PUT_LITERAL(",\"character\":");
+    put_number(position.character);
+    PUT_LITERAL("}");
+}
+
+static void put_range(const CooklangDocument *document, uint32_t start, uint32_t end) {
+    PUT_LITERAL("{\"start\":");
+    put_position(cooklang_document_position(document, start));
+    PUT_LITERAL(",\"end\":");
+    put_position(cooklang_document_position(document, end));
+    PUT_LITERAL("}");
+}
+
+// Open documents.
+
+typedef struct {
+    char *uri;
+    int64_t version;
+    CooklangDocument document;
+} OpenDocument;
+
+typedef struct {
+    TSParser *parser;
+    OpenDocument *documents;
+    uint32_t document_count;
+    uint32_t document_capacity;
+    int debounce;
+    // Changes are waiting for the debounce interval to pass.
+    bool pending;
+    double last_change;
+    bool shutdown;
+    CooklangText scratch;
+} Server;
+
+static double now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e3 + (double)now.tv_nsec * 1e-6;
+}
+
+static OpenDocument *find_document(Server *server, Json params) {
+    if (!json_string(json_path(params, "textDocument", "uri", NULL), &server->scratch)) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < server->document_count; i++) {
+        if (strcmp(server->documents[i].uri, server->scratch.data) == 0) {
+            return &server->documents[i];
+        }
+    }
+    return NULL;
+}
+
+// The directory of a `file://` URI, percent-decoded, or NULL.
+static char *uri_directory(const char *uri) {
+    if (strncmp(uri, "file://", 7) != 0) {
+        return NULL;
+    }
+    const char *path = uri + 7;
+    char *directory = malloc(strlen(path) + 1);
+    if (!directory) {
+        return NULL;
+    }
+    size_t length = 0;
+    for (const char *p = path; *p; p++) {
+        if (*p == '%' && p[1] && p[2]) {
+            char hex[3] = {p[1], p[2], '\0'};
+            directory[length++] = (char)strtol(hex, NULL, 16);
+            p += 2;
+        } else {
+            directory[length++] = *p;
+        }
+    }
+    while (length > 0 && directory[length - 1] != '/') {
+        length--;
+    }
+    directory[length > 1 ? length - 1 : length] = '\0';
+    return directory;
+}
+
+static const char *diagnostic_message(const CooklangDocument *document,
+                                      const CooklangDiagnostic *diagnostic, uint8_t *severity,
+                                      const char **quoted, uint32_t *quoted_length) {
+    *quoted = document->text.data + diagnostic->start;
+    *quoted_length = diagnostic->end - diagnostic->start;
+    switch (diagnostic->kind) {
+    case COOKLANG_DIAGNOSTIC_UNCLOSED_QUANTITY:
+        *severity = 1;
+        *quoted_length = 0;
+        return "unclosed quantity: missing `}`";
+    case COOKLANG_DIAGNOSTIC_UNKNOWN_UNIT:
+        *severity = 3;
+        return "unknown unit";
+    case COOKLANG_DIAGNOSTIC_MISSING_REFERENCE:
+        *severity = 2;
+        return "recipe not found";
+    default:
+        *severity = 1;
+        *quoted_length = 0;
+        return "syntax error";
+    }
+}
+
+static void publish_diagnostics(Server *server, OpenDocument *open) {
+    const CooklangDocument *document = &open->document;
+    PUT_LITERAL("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\","
+                "\"params\":{\"uri\":");
+    put_string(open->uri, (uint32_t)strlen(open->uri));
+    PUT_LITERAL(",\"version\":");
+    put_number(open->version);
+    PUT_LITERAL(",\"diagnostics\":[");
+    for (uint32_t i = 0; i < document->diagnostic_count; i++) {
+        const CooklangDiagnostic *diagnostic = &document->diagnostics[i];
+        uint8_t severity;
+        const char *quoted;
+        uint32_t quoted_length;
+        const char *message =
+            diagnostic_message(document, diagnostic, &severity, &quoted, &quoted_length);
+        CooklangText *text = &server->scratch;
+        text->length = 0;
+        cooklang_text_append(text, message, (uint32_t)strlen(message));
+        if (quoted_length > 0) {
+            cooklang_text_append(text, ": `", 3);
+            cooklang_text_append(text, quoted, quoted_length);
+            cooklang_text_append(text, "`", 1);
+        }
+        if (i > 0) {
+            PUT_LITERAL(",");
+        }
+        PUT_LITERAL("{\"range\":");
+        put_range(document, diagnostic->start, diagnostic->end);
+        PUT_LITERAL(",\"severity\":");
+        put_number(severity);
+        PUT_LITERAL(",\"source\":\"cooklang\",\"message\":");
+        put_string(text->data, text->length);
+        PUT_LITERAL("}");
+    }
+    PUT_LITERAL("]}}");
+    send_message();
+}
+
+// Parse a document whose tree is out of date and publish its diagnostics.
+static bool ensure_parsed(Server *server, OpenDocument *open) {
+    if (!cooklang_document_needs_parse(&open->document)) {
+        return true;
+    }
+    if (!cooklang_document_parse(&open->document, server->parser)) {
+        return false;
+    }
+    publish_diagnostics(server, open);
+    return true;
+}
+
+static void parse_pending(Server *server) {
+    for (uint32_t i = 0; i < server->document_count; i++) {
+        ensure_parsed(server, &server->documents[i]);
+    }
+    server->pending = false;
+}
+
+static void did_open(Server *server, Json params) {
+    Json text_document = json_member(params, "textDocument");
+    if (!json_string(json_member(text_document, "uri"), &server->scratch) ||
+        find_document(server, params)) {
+        return;
+    }
+    if (server->document_count == server->document_capacity) {
+        uint32_t capacity = server->document_capacity ? server->document_capacity * 2 : 4;
+        OpenDocument *documents = realloc(server->documents, capacity * sizeof(OpenDocument));
+        if (!documents) {
+            return;
+        }
+        server->documents = documents;
+        server->document_capacity = capacity;
+    }
+    size_t uri_length = server->scratch.length;
+    char *uri = malloc(uri_length + 1);
+    if (!uri) {
+        return;
+    }
+    memcpy(uri, server->scratch.data, uri_length + 1);
+    OpenDocument *open = &server->documents[server->document_count++];
+    open->uri = uri;
+    open->version = 0;
+    json_int(json_member(text_document, "version"), &open->version);
+    char *directory = uri_directory(uri);
+    cooklang_document_init(&open->document, directory);
+    free(directory);
+    if (json_string(json_member(text_document, "text"), &server->scratch)) {
+        cooklang_document_set_text(&open->document, server->scratch.data, server->scratch.length);
+    }
+    ensure_parsed(server, open);
+}
+
+static void did_change(Server *server, Json params) {
+    OpenDocument *open = find_document(server, params);
+    Json changes = json_member(params, "contentChanges");
+    if (!open || !changes.start || *changes.start != '[') {
+        return;
+    }
+    json_int(json_path(params, "textDocument", "version", NULL), &open->version);
+    const char *p = skip_space(changes.start + 1, changes.end);
+    while (p < changes.end && *p == '{') {
+        Json change = json_value(p, changes.end);
+        if (!change.start || !json_string(json_member(change, "text"), &server->scratch)) {
+            break;
+        }
+        Json range = json_member(change, "range");
+        CooklangPosition start, end;
+        if (!range.start) {
+            cooklang_document_set_text(&open->document, server->scratch.data,
+                                       server->scratch.length);
+        } else if (json_position(json_member(range, "start"), &start) &&
+                   json_position(json_member(range, "end"), &end)) {
+            cooklang_document_replace(&open->document, start, end, server->scratch.data,
+                                      server->scratch.length);
+        }
+        p = skip_space(change.end, changes.end);
+        p = p < changes.end && *p == ',' ? skip_space(p + 1, changes.end) : changes.end;
+    }
+    server->pending = true;
+    server->last_change = now_ms();
+}
+
+static void did_close(Server *server, Json params) {
+    OpenDocument *open = find_document(server, params);
+    if (!open) {
+        return;
+    }
+    // Clear the client's diagnostics for the document.
+    open->document.diagnostic_count = 0;
+    publish_diagnostics(server, open);
+    free(open->uri);
+    cooklang_document_free(&open->document);
+    *open = server->documents[--server->document_count];
+}
+
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+} Name;
+
+static const char *name_source;
+
+static int compare_names(const void *a, const void *b) {
+    const Name *left = a;
+    const Name *right = b;
+    uint32_t left_length = left->end - left->start;
+    uint32_t right_length = right->end - right->start;
+    int order = memcmp(name_source + left->start, name_source + right->start,
+                       left_length < right_length ? left_length : right_length);
+    return order ? order : (left_length > right_length) - (left_length < right_length);
+}
+
+// Ingredient or cookware names used in the document, sorted and unique.
+static uint32_t collect_names(const CooklangDocument *document, const char *symbol_name,
+                              Name **names) {
+    TSNode root = ts_tree_root_node(document->tree);
+    TSSymbol symbol = ts_language_symbol_for_name(ts_node_language(root), symbol_name,
+                                                  (uint32_t)strlen(symbol_name), true);
+    const char *source = document->text.data;
+    uint32_t count = 0, capacity = 0;
+    *names = NULL;
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    for (bool done = false; !done;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        if (ts_node_symbol(node) == symbol) {
+            uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+            while (start < end && (source[start] == ' ' || source[start] == '\t')) {
+                start++;
+            }
+            while (end > start && (source[end - 1] == ' ' || source[end - 1] == '\t')) {
+                end--;
+            }
+            if (end > start && count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                Name *grown = realloc(*names, capacity * sizeof(Name));
+                if (!grown) {
+                    break;
+                }
+                *names = grown;
+            }
+            if (end > start) {
+                (*names)[count++] = (Name){start, end};
+            }
+        } else if (ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                done = true;
+                break;
+            }
+        }
+    }
+    ts_tree_cursor_delete(&cursor);
+
+    name_source = source;
+    qsort(*names, count, sizeof(Name), compare_names);
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (unique == 0 || compare_names(&(*names)[unique - 1], &(*names)[i]) != 0) {
+            (*names)[unique++] = (*names)[i];
+        }
+    }
+    return unique;
+}
+
+typedef enum {
+    COMPLETE_NOTHING,
+    COMPLETE_INGREDIENTS,
+    COMPLETE_COOKWARE,
+    COMPLETE_UNITS,
+} Completion;
+
+// What to complete at `offset`, from the text before it on its line.
+static Completion completion_at(const CooklangDocument *document, uint32_t offset) {
+    const char *text = document->text.data;
+    bool percent = false, space = false;
+    for (uint32_t i = offset; i > 0 && text[i - 1] != '\n'; i--) {
+        char c = text[i - 1];
+        if (c == '}') {
+            break;
+        } else if (c == '{') {
+            return percent ? COMPLETE_UNITS : COMPLETE_NOTHING;
+        } else if (c == '%') {
+            percent = true;
+        } else if (c == ' ' || c == '\t') {
+            space = true;
+        } else if ((c == '@' || c == '#') && !space && !percent) {
+            return c == '@' ? COMPLETE_INGREDIENTS : COMPLETE_COOKWARE;
+        }
+    }
+    return COMPLETE_NOTHING;
+}
+
+static void put_completion_item(const char *label, uint32_t length, int kind, const char *detail) {
+    PUT_LITERAL("{\"label\":");
+    put_string(label, length);
+    PUT_LITERAL(",\"kind\":");
+    put_number(kind);
+    PUT_LITERAL(",\"detail\":");
+    put_string(detail, (uint32_t)strlen(detail));
+    PUT_LITERAL("}");
+}
+
+static void completion(Server *server, Json id, Json params) {
+    OpenDocument *open = find_document(server, params);
+    CooklangPosition position;
+    bool parsed = open && json_position(json_member(params, "position"), &position) &&
+                  ensure_parsed(server, open);
+    put_response_start(id);
+    PUT_LITERAL("{\"isIncomplete\":false,\"items\":[");
+    if (parsed) {
+        CooklangDocument *document = &open->document;
+        Completion kind = completion_at(document, cooklang_document_offset(document, position));
+        if (kind == COMPLETE_UNITS) {
+            for (uint32_t i = 0; i < cooklang_unit_count(); i++) {
+                const char *name = cooklang_unit_at(i)->name;
+                if (i > 0) {
+                    PUT_LITERAL(",");
+                }
+                put_completion_item(name, (uint32_t)strlen(name), 11, "unit");
+            }
+        } else if (kind != COMPLETE_NOTHING) {
+            bool ingredients = kind == COMPLETE_INGREDIENTS;
+            Name *names;
+            uint32_t count = collect_names(
+                document, ingredients ? "ingredient_name" : "cookware_name", &names);
+            for (uint32_t i = 0; i < count; i++) {
+                if (i > 0) {
+                    PUT_LITERAL(",");
+                }
+                put_completion_item(document->text.data + names[i].start,
+                                    names[i].end - names[i].start, 6,
+                                    ingredients ? "ingredient" : "cookware");
+            }
+            free(names);
+        }
+    }
+    PUT_LITERAL("]}}");
+    send_message();
+}
+
+static void put_symbol(const CooklangDocument *document, TSNode node, TSNode name, char marker,
+                       const char *fallback, int kind) {
+    const char *source = document->text.data;
+    uint32_t start = 0, end = 0;
+    if (!ts_node_is_null(name)) {
+        start = ts_node_start_byte(name);
+        end = ts_node_end_byte(name);
+        while (start < end && (source[start] == ' ' || source[start] == marker)) {
+            start++;
+        }
+        while (end > start && (source[end - 1] == ' ' || source[end - 1] == marker)) {
+            end--;
+        }
+    }
+    PUT_LITERAL("{\"name\":");
+    if (end > start) {
+        put_string(source + start, end - start);
+    } else {
+        put_string(fallback, (uint32_t)strlen(fallback));
+    }
+    PUT_LITERAL(",\"kind\":");
+    put_number(kind);
+    PUT_LITERAL(",\"range\":");
+    put_range(document, ts_node_start_byte(node), ts_node_end_byte(node));
+    PUT_LITERAL(",\"selectionRange\":");
+    put_range(document, ts_node_start_byte(node), ts_node_end_byte(node));
+    PUT_LITERAL("}");
+}
+
+static void document_symbol(Server *server, Json id, Json params) {
+    OpenDocument *open = find_document(server, params);
+    bool parsed = open && ensure_parsed(server, open);
+    put_response_start(id);
+    PUT_LITERAL("[");
+    if (parsed) {
+        const CooklangDocument *document = &open->document;
+        TSNode root = ts_tree_root_node(document->tree);
+        const TSLanguage *language = ts_node_language(root);
+        TSSymbol section = ts_language_symbol_for_name(language, "section", 7, true);
+        TSSymbol metadata = ts_language_symbol_for_name(language, "metadata", 8, true);
+        bool first = true;
+        uint32_t count = ts_node_child_count(root);
+        for (uint32_t i = 0; i < count; i++) {
+            TSNode node = ts_node_child(root, i);
+            TSSymbol symbol = ts_node_symbol(node);
+            if (symbol != section && symbol != metadata) {
+                continue;
+            }
+            if (!first) {
+                PUT_LITERAL(",");
+            }
+            first = false;
+            // Namespace and Property in the protocol's SymbolKind.
+            if (symbol == section) {
+                put_symbol(document, node, ts_node_named_child(node, 0), '=', "Section", 3);
+            } else {
+                put_symbol(document, node, ts_node_named_child(node, 0), '>', "metadata", 7);
+            }
+        }
+    }
+    PUT_LITERAL("]}");
+    send_message();
+}
+
+static void handle_message(Server *server, Json message) {
+    Json id = json_member(message, "id");
+    Json params = json_member(message, "params");
+    if (!json_string(json_member(message, "method"), &server->scratch)) {
+        return;
+    }
+    char method[64];
+    snprintf(method, sizeof(method), "%s", server->scratch.data);
+
+    if (strcmp(method, "initialize") == 0) {
+        put_response_start(id);
+        PUT_LITERAL("{\"capabilities\":{\"textDocumentSync\":{\"openClose\":true,\"change\":2},"
+                    "\"completionProvider\":{\"triggerCharacters\":[\"@\",\"#\",\"%\"]},"
+                    "\"documentSymbolProvider\":true},\"serverInfo\":{\"name\":\"cooklsp\"}}}");
+        send_message();
+    } else if (strcmp(method, "shutdown") == 0) {
+        server->shutdown = true;
+        put_response_start(id);
+        PUT_LITERAL("null}");
+        send_message();
+    } else if (strcmp(method, "textDocument/didOpen") == 0) {
+        did_open(server, params);
+    } else if (strcmp(method, "textDocument/didChange") == 0) {
+        did_change(server, params);
+    } else if (strcmp(method, "textDocument/didClose") == 0) {
+        did_close(server, params);
+    } else if (!id.start) {
+        // Other notifications, such as `initialized`, need no answer.
+    } else if (strcmp(method, "textDocument/completion") == 0) {
+        completion(server, id, params);
+    } else if (strcmp(method, "textDocument/documentSymbol") == 0) {
+        document_symbol(server, id, params);
+    } else {
+        PUT_LITERAL("{\"jsonrpc\":\"2.0\",\"id\":");
+        cooklang_text_append(&output, id.start, (uint32_t)(id.end - id.start));
+        PUT_LITERAL(",\"error\":{\"code\":-32601,\"message\":\"method not found\"}}");
+        send_message();
+    }
+}
+
+int main(int argc, char **argv) {
+    Server server = {0};
+    server.debounce = DEFAULT_DEBOUNCE_MS;
+    if (argc == 3 && strcmp(argv[1], "--debounce") == 0) {
+        server.debounce = atoi(argv[2]);
+    } else if (argc != 1) {
+        fprintf(stderr, "usage: cooklsp [--debounce MS]\n");
+        return 2;
+    }
+    server.parser = ts_parser_new();
+    ts_parser_set_language(server.parser, tree_sitter_cooklang());
+    cooklang_text_init(&server.scratch);
+    cooklang_text_init(&output);
+    Input input = {{NULL, 0, 0}, 0};
+    int status = 1;
+
+    for (;;) {
+        int timeout = -1;
+        if (server.pending) {
+            double remaining = server.last_change + server.debounce - now_ms();
+            timeout = remaining > 0 ? (int)remaining + 1 : 0;
+        }
+        Json message;
+        int result = timeout == 0 ? 0 : next_message(&input, timeout, &message);
+        if (result < 0) {
+            break;
+        }
+        if (result == 0) {
+            parse_pending(&server);
+            continue;
+        }
+        handle_message(&server, message);
+        Json method = json_member(message, "method");
+        if (method.start && method.end - method.start == 6 && !memcmp(method.start, "\"exit\"", 6)) {
+            status = server.shutdown ? 0 : 1;
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < server.document_count; i++) {
+        free(server.documents[i].uri);
+        cooklang_document_free(&server.documents[i].document);
+    }
+    free(server.documents);
+    cooklang_text_free(&input.buffer);
+    cooklang_text_free(&server.scratch);
+    cooklang_text_free(&output);
+    ts_parser_delete(server.parser);
+    return status;
+}
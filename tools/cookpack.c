@@ -0,0 +1,164 @@
+// cookpack: build and read recipe packs.
+//
+//   cookpack build [--no-metadata] DIRECTORY PACK
+//   cookpack list PACK
+//   cookpack cat PACK PATH
+//   cookpack meta PACK PATH
+//
+// build packs every `.cook` file under DIRECTORY, skipping names that
+// start with a dot and symbolic links, under its path relative to
+// DIRECTORY. list prints each recipe's path and, when the pack has
+// metadata, its title. cat prints a recipe's text, and meta its metadata
+// as `key: value` lines. See bindings/c/cooklang_pack.h for the format.
+
+#define _DEFAULT_SOURCE
+
+#include "cooklang_pack.h"
+#include "cooklang_quantity.h"
+#include "tools.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// Add the recipes under `path`, relative to `root`, to the pack.
+static bool add_directory(CooklangPackWriter *writer, const char *root, const char *path,
+                          CooklangText *text) {
+    char *full = tools_join(root, path);
+    DIR *directory = full ? opendir(full) : NULL;
+    free(full);
+    if (!directory) {
+        fprintf(stderr, "cookpack: cannot open %s/%s\n", root, path);
+        return false;
+    }
+    bool ok = true;
+    struct dirent *item;
+    while (ok && (item = readdir(directory))) {
+        if (item->d_name[0] == '.') {
+            continue;
+        }
+        char *child = tools_join(path, item->d_name);
+        char *child_full = child ? tools_join(root, child) : NULL;
+        struct stat info;
+        if (!child_full || lstat(child_full, &info) != 0) {
+            ok = child_full != NULL;
+        } else if (S_ISDIR(info.st_mode)) {
+            ok = add_directory(writer, root, child, text);
+        } else if (S_ISREG(info.st_mode) && tools_is_recipe(item->d_name)) {
+            if (!tools_read_file(child_full, text)) {
+                fprintf(stderr, "cookpack: cannot read %s\n", child_full);
+                ok = false;
+            } else {
+                ok = cooklang_pack_writer_add(writer, child, text->data, text->length);
+            }
+        }
+        free(child_full);
+        free(child);
+    }
+    closedir(directory);
+    return ok;
+}
+
+static int build(int argc, char **argv) {
+    bool metadata = true;
+    int first = 2;
+    if (argc > first && strcmp(argv[first], "--no-metadata") == 0) {
+        metadata = false;
+        first++;
+    }
+    if (argc != first + 2) {
+        fprintf(stderr, "usage: cookpack build [--no-metadata] DIRECTORY PACK\n");
+        return 2;
+    }
+    CooklangPackWriter writer;
+    if (!cooklang_pack_writer_open(&writer, argv[first + 1], metadata)) {
+        fprintf(stderr, "cookpack: cannot create %s\n", argv[first + 1]);
+        return 1;
+    }
+    CooklangText text;
+    cooklang_text_init(&text);
+    bool added = add_directory(&writer, argv[first], "", &text);
+    cooklang_text_free(&text);
+    uint32_t count = writer.length;
+    if (!cooklang_pack_writer_finish(&writer) || !added) {
+        fprintf(stderr, "cookpack: cannot write %s\n", argv[first + 1]);
+        remove(argv[first + 1]);
+        return 1;
+    }
+    fprintf(stderr, "cookpack: packed %u recipes\n", count);
+    return 0;
+}
+
+static void print_span(const CooklangPackRecipe *recipe, CooklangSpan span) {
+    fwrite(recipe->text + span.start, 1, span.end - span.start, stdout);
+}
+
+static int read_pack(int argc, char **argv) {
+    const char *command = argv[1];
+    bool listing = strcmp(command, "list") == 0;
+    if (argc != (listing ? 3 : 4)) {
+        fprintf(stderr, listing ? "usage: cookpack list PACK\n"
+                                : "usage: cookpack %s PACK PATH\n",
+                command);
+        return 2;
+    }
+    CooklangPack pack;
+    if (!cooklang_pack_open(&pack, argv[2])) {
+        fprintf(stderr, "cookpack: %s is not a readable pack\n", argv[2]);
+        return 1;
+    }
+    int status = 0;
+    CooklangPackRecipe recipe;
+    if (listing) {
+        for (uint32_t i = 0; i < pack.count; i++) {
+            if (!cooklang_pack_recipe(&pack, i, &recipe)) {
+                fprintf(stderr, "cookpack: %s is damaged\n", recipe.path);
+                status = 1;
+                continue;
+            }
+            fputs(recipe.path, stdout);
+            CooklangSpan title;
+            if (cooklang_pack_find_metadata(&recipe, "title", &title)) {
+                putchar('\t');
+                print_span(&recipe, title);
+            }
+            putchar('\n');
+        }
+    } else {
+        uint32_t index = cooklang_pack_find(&pack, argv[3]);
+        if (index == UINT32_MAX) {
+            fprintf(stderr, "cookpack: no recipe %s in %s\n", argv[3], argv[2]);
+            status = 1;
+        } else if (!cooklang_pack_recipe(&pack, index, &recipe)) {
+            fprintf(stderr, "cookpack: %s is damaged\n", argv[3]);
+            status = 1;
+        } else if (strcmp(command, "cat") == 0) {
+            fwrite(recipe.text, 1, recipe.length, stdout);
+        } else {
+            for (uint32_t i = 0; i < recipe.metadata_count; i++) {
+                CooklangSpan key, value;
+                cooklang_pack_metadata(&recipe, i, &key, &value);
+                print_span(&recipe, key);
+                fputs(": ", stdout);
+                print_span(&recipe, value);
+                putchar('\n');
+            }
+        }
+    }
+    cooklang_pack_close(&pack);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "build") == 0) {
+        return build(argc, argv);
+    }
+    if (argc > 1 && (strcmp(argv[1], "list") == 0 || strcmp(argv[1], "cat") == 0 ||
+                     strcmp(argv[1], "meta") == 0)) {
+        return read_pack(argc, argv);
+    }
+    fprintf(stderr, "usage: cookpack build|list|cat|meta ...\n");
+    return 2;
+}
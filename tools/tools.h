@@ -0,0 +1,62 @@
+// Shared helpers for the programs in this directory: recipe file names,
+// path joining and whole-file reads. Each tool sets its own feature macros
+// before including this.
+
+#ifndef COOKLANG_TOOLS_H_
+#define COOKLANG_TOOLS_H_
+
+#include "cooklang_quantity.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline bool tools_is_recipe(const char *name) {
+    size_t length = strlen(name);
+    return length > 5 && strcmp(name + length - 5, ".cook") == 0;
+}
+
+// `directory/name`, or whichever is not empty, in a buffer the caller
+// frees.
+static inline char *tools_join(const char *directory, const char *name) {
+    size_t directory_length = strlen(directory);
+    size_t name_length = strlen(name);
+    char *path = malloc(directory_length + name_length + 2);
+    if (!path) {
+        return NULL;
+    }
+    memcpy(path, directory, directory_length);
+    size_t length = directory_length;
+    if (directory_length > 0 && name_length > 0) {
+        path[length++] = '/';
+    }
+    memcpy(path + length, name, name_length + 1);
+    return path;
+}
+
+// Replace the contents of `text` with the file at `path`.
+static inline bool tools_read_file(const char *path, CooklangText *text) {
+    FILE *stream = fopen(path, "rb");
+    if (!stream) {
+        return false;
+    }
+    text->length = 0;
+    bool ok = true;
+    for (;;) {
+        if (!cooklang_text_reserve(text, 65536)) {
+            ok = false;
+            break;
+        }
+        size_t read = fread(text->data + text->length, 1, 65536, stream);
+        text->length += (uint32_t)read;
+        if (read < 65536) {
+            ok = !ferror(stream);
+            break;
+        }
+    }
+    fclose(stream);
+    return ok;
+}
+
+#endif // COOKLANG_TOOLS_H_